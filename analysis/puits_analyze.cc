@@ -0,0 +1,614 @@
+//
+// ********************************************************************
+// * puits_analyze - Post-traitement compilé des sorties puits_couronne *
+// * Remplace les macros ROOT analyse_dose_anneaux.C,                 *
+// * analyze_puits_couronne.C, plot_container_planes.C,               *
+// * analyse_absorption_raies.C et compare_dose_anneau_central.C      *
+// ********************************************************************
+//
+// Usage :
+//   puits_analyze [-o dossier] [--paired] [label=]fichier.root [[label=]fichier2.root ...]
+//
+// Un fichier <nom>_files.txt (index des sorties par thread,
+// /puits/output/perThread) est lu comme une chaîne (TChain) de ses fichiers.
+//
+// Chaque fichier est lu en UNE passe par arbre (TTreeReader), les fichiers
+// sont traités en parallèle. Pour chaque configuration :
+//   <label>_rings.csv     dose moyenne par anneau, erreur standard, erreur relative
+//   <label>_lines.csv     statistiques par raie Eu-152 (entrée / absorption eau)
+//   <label>_planes.csv    spectres des plans PreContainer / PostContainer
+//   <label>_summary.json  résumé complet
+// et pour l'ensemble :
+//   comparison_rings.csv  dose par anneau de chaque configuration, rapport et
+//                         z-score par rapport à la première configuration
+//   comparison_lines.csv  taux d'absorption par raie de chaque configuration
+// et avec --paired (jobs en échantillonnage corrélé, /puits/corr/) :
+//   paired_rings.csv      différence de dose par rapport à la première
+//                         configuration, appariée événement par événement
+//                         (eventID) : erreur avec covariance, corrélation,
+//                         gain de variance par rapport à des jobs indépendants
+//
+
+#include "Eu152Data.hh"
+
+#include "TChain.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TTree.h"
+#include "TTreeReader.h"
+#include "TTreeReaderValue.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // ═══════════════════════════════════════════════════════════════
+    // ACCUMULATEUR DE WELFORD
+    // ═══════════════════════════════════════════════════════════════
+
+    struct Welford {
+        long long n = 0;
+        double mean = 0.;
+        double m2 = 0.;
+
+        void Add(double x)
+        {
+            n++;
+            double delta = x - mean;
+            mean += delta / n;
+            m2 += delta * (x - mean);
+        }
+        double SigmaMean() const { return (n > 1) ? std::sqrt(m2 / (n - 1) / n) : 0.; }
+    };
+
+    // ═══════════════════════════════════════════════════════════════
+    // MOMENTS D'UNE PAIRE (a, b) : variances, covariance, différence
+    // ═══════════════════════════════════════════════════════════════
+
+    struct PairedWelford {
+        long long n = 0;
+        double meanA = 0., meanB = 0.;
+        double m2A = 0., m2B = 0., cAB = 0.;
+
+        void Add(double a, double b)
+        {
+            n++;
+            double dA = a - meanA;
+            meanA += dA / n;
+            double dB = b - meanB;
+            meanB += dB / n;
+            m2A += dA * (a - meanA);
+            m2B += dB * (b - meanB);
+            cAB += dA * (b - meanB);
+        }
+        double VarA() const { return (n > 1) ? m2A / (n - 1) : 0.; }
+        double VarB() const { return (n > 1) ? m2B / (n - 1) : 0.; }
+        double Cov() const { return (n > 1) ? cAB / (n - 1) : 0.; }
+        // Erreur de la différence moyenne b - a : appariée et indépendante
+        double SigmaPaired() const { return (n > 1) ? std::sqrt(std::max(0., VarA() + VarB() - 2. * Cov()) / n) : 0.; }
+        double SigmaIndependent() const { return (n > 1) ? std::sqrt((VarA() + VarB()) / n) : 0.; }
+        double Correlation() const { return (VarA() > 0. && VarB() > 0.) ? Cov() / std::sqrt(VarA() * VarB()) : 0.; }
+    };
+
+    // ═══════════════════════════════════════════════════════════════
+    // SPECTRE 1D À PAS FIXE
+    // ═══════════════════════════════════════════════════════════════
+
+    struct Spectrum {
+        static constexpr int kNbBins = 200;
+        static constexpr double kMax_keV = 2000.;
+
+        std::vector<long long> counts = std::vector<long long>(kNbBins + 1, 0);  // + débordement
+        long long nParticles = 0;
+        double sumE_keV = 0.;
+
+        void Fill(int n, double sumE)
+        {
+            if (n <= 0) return;
+            nParticles += n;
+            sumE_keV += sumE;
+            int bin = static_cast<int>(sumE / kMax_keV * kNbBins);
+            counts[(bin >= 0 && bin < kNbBins) ? bin : kNbBins]++;
+        }
+    };
+
+    // Plans et espèces suivis
+    enum PlaneChannel {
+        kPrePhotons = 0, kPreElectrons,
+        kPostPhotonsFwd, kPostPhotonsBack,
+        kPostElectronsFwd, kPostElectronsBack,
+        kNbChannels
+    };
+
+    const char* kChannelNames[kNbChannels] = {
+        "pre_photons", "pre_electrons",
+        "post_photons_fwd", "post_photons_back",
+        "post_electrons_fwd", "post_electrons_back"
+    };
+
+    // ═══════════════════════════════════════════════════════════════
+    // RÉSULTAT D'UNE CONFIGURATION
+    // ═══════════════════════════════════════════════════════════════
+
+    struct LineStats {
+        long long emitted = 0;
+        long long entered = 0;
+        double absorbed = 0.;       // somme des poids (collision forcée) ou comptage
+    };
+
+    struct ConfigResult {
+        std::string label;
+        std::string path;
+        bool ok = false;
+        std::string error;
+
+        long long nEvents = 0;
+        std::vector<Welford> ringDose;          // nGy par événement
+        Welford totalDose;
+        std::vector<LineStats> lines = std::vector<LineStats>(Eu152::kNbLines);
+        std::vector<Spectrum> planes = std::vector<Spectrum>(kNbChannels);
+
+        // Doses par événement triées par eventID (--paired) : nRings + 1
+        // colonnes par événement, la dernière est la dose totale
+        std::vector<int> eventIDs;
+        std::vector<double> eventDoses;
+    };
+
+    // ═══════════════════════════════════════════════════════════════
+    // SOURCE DES ARBRES : FICHIER ROOT OU INDEX DE FICHIERS PAR THREAD
+    // ═══════════════════════════════════════════════════════════════
+
+    class TreeSource {
+    public:
+        bool Open(const std::string& path, std::string& error)
+        {
+            const std::string suffix = "_files.txt";
+            const bool isIndex = path.size() > suffix.size()
+                && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+            if (!isIndex) {
+                fFile.reset(TFile::Open(path.c_str(), "READ"));
+                if (!fFile || fFile->IsZombie()) {
+                    error = "impossible d'ouvrir " + path;
+                    return false;
+                }
+                return true;
+            }
+
+            std::ifstream index(path);
+            std::string line;
+            while (std::getline(index, line)) {
+                if (!line.empty()) fFiles.push_back(line);
+            }
+            if (fFiles.empty()) {
+                error = "index vide ou illisible : " + path;
+                return false;
+            }
+            return true;
+        }
+
+        // Arbre du fichier, ou chaîne des fichiers de l'index qui le contiennent
+        // (gamma_lines est dans le fichier du maître, les autres par thread)
+        TTree* Get(const char* name)
+        {
+            if (fFile) {
+                TTree* tree = nullptr;
+                fFile->GetObject(name, tree);
+                return tree;
+            }
+
+            auto chain = std::make_unique<TChain>(name);
+            for (const auto& path : fFiles) {
+                std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+                if (file && !file->IsZombie() && file->Get(name)) chain->Add(path.c_str());
+            }
+            if (chain->GetNtrees() == 0) return nullptr;
+            fChains.push_back(std::move(chain));
+            return fChains.back().get();
+        }
+
+    private:
+        std::unique_ptr<TFile> fFile;
+        std::vector<std::string> fFiles;
+        std::vector<std::unique_ptr<TChain>> fChains;
+    };
+
+    // ═══════════════════════════════════════════════════════════════
+    // LECTURE D'UN FICHIER (une passe par arbre)
+    // ═══════════════════════════════════════════════════════════════
+
+    void ReadDoses(TreeSource& source, ConfigResult& result, bool keepEvents)
+    {
+        TTree* tree = source.Get("doses");
+        if (!tree) return;
+
+        // Nombre d'anneaux : colonnes dose_nGy_ring<k> présentes
+        int nRings = 0;
+        while (tree->GetBranch(("dose_nGy_ring" + std::to_string(nRings)).c_str())) nRings++;
+
+        TTreeReader reader(tree);
+        std::vector<std::unique_ptr<TTreeReaderValue<double>>> ringValues;
+        for (int i = 0; i < nRings; ++i) {
+            ringValues.emplace_back(std::make_unique<TTreeReaderValue<double>>(
+                reader, ("dose_nGy_ring" + std::to_string(i)).c_str()));
+        }
+        TTreeReaderValue<double> total(reader, "dose_nGy_total");
+        TTreeReaderValue<int> eventID(reader, "eventID");
+
+        const int nColumns = nRings + 1;
+        std::vector<int> ids;
+        std::vector<double> doses;
+        if (keepEvents) {
+            ids.reserve(tree->GetEntries());
+            doses.reserve(tree->GetEntries() * nColumns);
+        }
+
+        result.ringDose.assign(nRings, Welford());
+        while (reader.Next()) {
+            for (int i = 0; i < nRings; ++i) result.ringDose[i].Add(**ringValues[i]);
+            result.totalDose.Add(*total);
+            if (keepEvents) {
+                ids.push_back(*eventID);
+                for (int i = 0; i < nRings; ++i) doses.push_back(**ringValues[i]);
+                doses.push_back(*total);
+            }
+        }
+        result.nEvents = result.totalDose.n;
+
+        // En MT, les lignes des threads sont entrelacées : tri par eventID
+        if (keepEvents) {
+            std::vector<size_t> order(ids.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&ids](size_t a, size_t b) { return ids[a] < ids[b]; });
+            result.eventIDs.reserve(ids.size());
+            result.eventDoses.reserve(doses.size());
+            for (size_t k : order) {
+                result.eventIDs.push_back(ids[k]);
+                result.eventDoses.insert(result.eventDoses.end(),
+                                         doses.begin() + k * nColumns, doses.begin() + (k + 1) * nColumns);
+            }
+        }
+    }
+
+    void ReadGammaLines(TreeSource& source, ConfigResult& result)
+    {
+        TTree* tree = source.Get("gamma_lines");
+        if (!tree) return;
+
+        // En MT, une ligne par raie et par thread : on somme par lineIndex
+        TTreeReader reader(tree);
+        TTreeReaderValue<int> lineIndex(reader, "lineIndex");
+        TTreeReaderValue<int> emitted(reader, "emitted");
+        TTreeReaderValue<int> entered(reader, "enteredWater");
+        TTreeReaderValue<int> absorbed(reader, "absorbedWater");
+
+        // Absorption pondérée si présente (sorties avec collision forcée)
+        const bool weighted = tree->GetBranch("absorbedWater_w") != nullptr;
+        std::unique_ptr<TTreeReaderValue<double>> absorbedW;
+        if (weighted) absorbedW = std::make_unique<TTreeReaderValue<double>>(reader, "absorbedWater_w");
+
+        while (reader.Next()) {
+            int i = *lineIndex;
+            if (i < 0 || i >= Eu152::kNbLines) continue;
+            result.lines[i].emitted += *emitted;
+            result.lines[i].entered += *entered;
+            result.lines[i].absorbed += weighted ? **absorbedW : *absorbed;
+        }
+    }
+
+    void ReadPlanes(TreeSource& source, ConfigResult& result)
+    {
+        TTree* pre = source.Get("precontainer");
+        if (pre) {
+            TTreeReader reader(pre);
+            TTreeReaderValue<int> nPh(reader, "nPhotons");
+            TTreeReaderValue<double> ePh(reader, "sumEPhotons_keV");
+            TTreeReaderValue<int> nEl(reader, "nElectrons");
+            TTreeReaderValue<double> eEl(reader, "sumEElectrons_keV");
+            while (reader.Next()) {
+                result.planes[kPrePhotons].Fill(*nPh, *ePh);
+                result.planes[kPreElectrons].Fill(*nEl, *eEl);
+            }
+        }
+
+        TTree* post = source.Get("postcontainer");
+        if (post) {
+            TTreeReader reader(post);
+            TTreeReaderValue<int> nPhF(reader, "nPhotons_fwd");
+            TTreeReaderValue<double> ePhF(reader, "sumEPhotons_fwd_keV");
+            TTreeReaderValue<int> nPhB(reader, "nPhotons_back");
+            TTreeReaderValue<double> ePhB(reader, "sumEPhotons_back_keV");
+            TTreeReaderValue<int> nElF(reader, "nElectrons_fwd");
+            TTreeReaderValue<double> eElF(reader, "sumEElectrons_fwd_keV");
+            TTreeReaderValue<int> nElB(reader, "nElectrons_back");
+            TTreeReaderValue<double> eElB(reader, "sumEElectrons_back_keV");
+            while (reader.Next()) {
+                result.planes[kPostPhotonsFwd].Fill(*nPhF, *ePhF);
+                result.planes[kPostPhotonsBack].Fill(*nPhB, *ePhB);
+                result.planes[kPostElectronsFwd].Fill(*nElF, *eElF);
+                result.planes[kPostElectronsBack].Fill(*nElB, *eElB);
+            }
+        }
+    }
+
+    ConfigResult AnalyzeFile(const std::string& label, const std::string& path, bool keepEvents)
+    {
+        ConfigResult result;
+        result.label = label;
+        result.path = path;
+
+        TreeSource source;
+        if (!source.Open(path, result.error)) return result;
+
+        ReadDoses(source, result, keepEvents);
+        ReadGammaLines(source, result);
+        ReadPlanes(source, result);
+
+        result.ok = true;
+        return result;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // ÉCRITURE DES RÉSUMÉS
+    // ═══════════════════════════════════════════════════════════════
+
+    double Ratio(double num, long long den) { return (den > 0) ? num / den : 0.; }
+
+    void WriteConfig(const ConfigResult& r, const std::string& outDir)
+    {
+        const std::string base = outDir + "/" + r.label;
+
+        std::ofstream rings(base + "_rings.csv");
+        rings << "ring,n_events,dose_nGy_per_evt,sem_nGy,rel_error\n" << std::setprecision(10);
+        for (size_t i = 0; i < r.ringDose.size(); ++i) {
+            const Welford& w = r.ringDose[i];
+            double rel = (w.mean > 0.) ? w.SigmaMean() / w.mean : 0.;
+            rings << i << "," << w.n << "," << w.mean << "," << w.SigmaMean() << "," << rel << "\n";
+        }
+        rings << "total," << r.totalDose.n << "," << r.totalDose.mean << ","
+              << r.totalDose.SigmaMean() << ","
+              << ((r.totalDose.mean > 0.) ? r.totalDose.SigmaMean() / r.totalDose.mean : 0.) << "\n";
+
+        std::ofstream lines(base + "_lines.csv");
+        lines << "line,name,energy_keV,intensity_pct,emitted,entered_water,absorbed_water,"
+                 "water_entry_rate,water_abs_rate\n" << std::setprecision(10);
+        for (int i = 0; i < Eu152::kNbLines; ++i) {
+            const LineStats& l = r.lines[i];
+            lines << i << ",\"" << Eu152::kLineNames[i] << "\"," << Eu152::kLineEnergies_keV[i] << ","
+                  << Eu152::kLineIntensities_pct[i] << "," << l.emitted << "," << l.entered << ","
+                  << l.absorbed << "," << Ratio(l.entered, l.emitted) << "," << Ratio(l.absorbed, l.entered) << "\n";
+        }
+
+        std::ofstream planes(base + "_planes.csv");
+        planes << "channel,bin_low_keV,bin_high_keV,events\n";
+        const double width = Spectrum::kMax_keV / Spectrum::kNbBins;
+        for (int c = 0; c < kNbChannels; ++c) {
+            for (int b = 0; b <= Spectrum::kNbBins; ++b) {
+                if (r.planes[c].counts[b] == 0) continue;
+                planes << kChannelNames[c] << "," << b * width << ","
+                       << ((b < Spectrum::kNbBins) ? (b + 1) * width : INFINITY) << ","
+                       << r.planes[c].counts[b] << "\n";
+            }
+        }
+
+        std::ofstream json(base + "_summary.json");
+        json << std::setprecision(10);
+        json << "{\n  \"label\": \"" << r.label << "\",\n  \"file\": \"" << r.path << "\",\n"
+             << "  \"n_events\": " << r.nEvents << ",\n  \"rings\": [";
+        for (size_t i = 0; i < r.ringDose.size(); ++i) {
+            const Welford& w = r.ringDose[i];
+            json << (i ? "," : "") << "\n    {\"ring\": " << i << ", \"dose_nGy_per_evt\": " << w.mean
+                 << ", \"sem_nGy\": " << w.SigmaMean() << "}";
+        }
+        json << "\n  ],\n  \"lines\": [";
+        for (int i = 0; i < Eu152::kNbLines; ++i) {
+            const LineStats& l = r.lines[i];
+            json << (i ? "," : "") << "\n    {\"line\": " << i << ", \"energy_keV\": " << Eu152::kLineEnergies_keV[i]
+                 << ", \"emitted\": " << l.emitted << ", \"entered_water\": " << l.entered
+                 << ", \"absorbed_water\": " << l.absorbed << "}";
+        }
+        json << "\n  ],\n  \"planes\": {";
+        for (int c = 0; c < kNbChannels; ++c) {
+            json << (c ? "," : "") << "\n    \"" << kChannelNames[c] << "\": {\"particles\": "
+                 << r.planes[c].nParticles << ", \"sumE_keV\": " << r.planes[c].sumE_keV << "}";
+        }
+        json << "\n  }\n}\n";
+    }
+
+    void WriteComparison(const std::vector<ConfigResult>& results, const std::string& outDir)
+    {
+        const ConfigResult& ref = results.front();
+
+        std::ofstream rings(outDir + "/comparison_rings.csv");
+        rings << "label,ring,dose_nGy_per_evt,sem_nGy,ratio_to_" << ref.label << ",z_score\n"
+              << std::setprecision(10);
+        for (const auto& r : results) {
+            for (size_t i = 0; i < r.ringDose.size(); ++i) {
+                const Welford& w = r.ringDose[i];
+                double ratio = 0., z = 0.;
+                if (i < ref.ringDose.size()) {
+                    const Welford& w0 = ref.ringDose[i];
+                    ratio = (w0.mean > 0.) ? w.mean / w0.mean : 0.;
+                    double sigma = std::hypot(w.SigmaMean(), w0.SigmaMean());
+                    z = (sigma > 0.) ? (w.mean - w0.mean) / sigma : 0.;
+                }
+                rings << r.label << "," << i << "," << w.mean << "," << w.SigmaMean() << ","
+                      << ratio << "," << z << "\n";
+            }
+        }
+
+        std::ofstream lines(outDir + "/comparison_lines.csv");
+        lines << "line,energy_keV";
+        for (const auto& r : results) lines << "," << r.label;
+        lines << "\n" << std::setprecision(6);
+        for (int i = 0; i < Eu152::kNbLines; ++i) {
+            lines << i << "," << Eu152::kLineEnergies_keV[i];
+            for (const auto& r : results) lines << "," << Ratio(r.lines[i].absorbed, r.lines[i].entered);
+            lines << "\n";
+        }
+    }
+
+    // Différences appariées par eventID par rapport à la première configuration
+    void WritePaired(const std::vector<ConfigResult>& results, const std::string& outDir)
+    {
+        const ConfigResult& ref = results.front();
+        const size_t nColumns = ref.ringDose.size() + 1;
+
+        std::ofstream paired(outDir + "/paired_rings.csv");
+        paired << "label,ring,n_paired,diff_nGy_per_evt,sem_paired_nGy,sem_independent_nGy,"
+                  "correlation,variance_gain,z_score\n" << std::setprecision(10);
+
+        for (size_t c = 1; c < results.size(); ++c) {
+            const ConfigResult& r = results[c];
+            if (r.ringDose.size() + 1 != nColumns) {
+                std::cerr << "puits_analyze: " << r.label << " - nombre d'anneaux different, non apparie\n";
+                continue;
+            }
+
+            // Fusion des deux listes triées d'eventID
+            std::vector<PairedWelford> stats(nColumns);
+            long long unmatched = 0;
+            size_t i = 0, j = 0;
+            while (i < ref.eventIDs.size() && j < r.eventIDs.size()) {
+                if (ref.eventIDs[i] < r.eventIDs[j]) { unmatched++; i++; continue; }
+                if (r.eventIDs[j] < ref.eventIDs[i]) { unmatched++; j++; continue; }
+                for (size_t k = 0; k < nColumns; ++k) {
+                    stats[k].Add(ref.eventDoses[i * nColumns + k], r.eventDoses[j * nColumns + k]);
+                }
+                i++;
+                j++;
+            }
+            unmatched += (ref.eventIDs.size() - i) + (r.eventIDs.size() - j);
+
+            for (size_t k = 0; k < nColumns; ++k) {
+                const PairedWelford& p = stats[k];
+                double diff = p.meanB - p.meanA;
+                double sigma = p.SigmaPaired();
+                double gain = (sigma > 0.) ? std::pow(p.SigmaIndependent() / sigma, 2) : 0.;
+                paired << r.label << "," << ((k + 1 < nColumns) ? std::to_string(k) : std::string("total")) << ","
+                       << p.n << "," << diff << "," << sigma << "," << p.SigmaIndependent() << ","
+                       << p.Correlation() << "," << gain << "," << ((sigma > 0.) ? diff / sigma : 0.) << "\n";
+            }
+
+            std::cout << std::left << std::setw(40) << (r.label + " - " + ref.label) << " "
+                      << stats.front().n << " evenements apparies";
+            if (unmatched > 0) std::cout << ", " << unmatched << " sans correspondance";
+            std::cout << "\n";
+        }
+    }
+
+    // Label par défaut : dossier parent du fichier, sinon nom sans extension ;
+    // withStem : dossier_nom, pour départager deux fichiers du même dossier
+    std::string DefaultLabel(const std::string& path, bool withStem = false)
+    {
+        std::string dir, stem = path;
+        size_t slash = path.find_last_of('/');
+        if (slash != std::string::npos) {
+            dir = path.substr(0, slash);
+            stem = path.substr(slash + 1);
+            size_t slash2 = dir.find_last_of('/');
+            dir = (slash2 != std::string::npos) ? dir.substr(slash2 + 1) : dir;
+        }
+        size_t dot = stem.find_last_of('.');
+        if (dot != std::string::npos) stem = stem.substr(0, dot);
+        if (dir.empty() || dir == ".") return stem;
+        return withStem ? dir + "_" + stem : dir;
+    }
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage: puits_analyze [-o dossier] [--paired] [label=]fichier.root|<nom>_files.txt [...]\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string outDir = ".";
+    bool paired = false;
+    std::vector<std::pair<std::string, std::string>> inputs;
+    std::vector<bool> explicitLabel;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outDir = argv[++i];
+        } else if (arg == "--paired") {
+            paired = true;
+        } else if (arg == "-h" || arg == "--help") {
+            PrintUsage();
+            return 0;
+        } else {
+            size_t eq = arg.find('=');
+            if (eq != std::string::npos) {
+                inputs.emplace_back(arg.substr(0, eq), arg.substr(eq + 1));
+                explicitLabel.push_back(true);
+            } else {
+                inputs.emplace_back(DefaultLabel(arg), arg);
+                explicitLabel.push_back(false);
+            }
+        }
+    }
+
+    if (inputs.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    // Deux fichiers du même dossier : label dossier_nom ; un label encore en
+    // double écraserait les sorties de l'autre configuration
+    std::map<std::string, int> nLabels;
+    for (const auto& in : inputs) nLabels[in.first]++;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!explicitLabel[i] && nLabels[inputs[i].first] > 1) {
+            inputs[i].first = DefaultLabel(inputs[i].second, true);
+        }
+    }
+    nLabels.clear();
+    for (const auto& in : inputs) {
+        if (++nLabels[in.first] > 1) {
+            std::cerr << "puits_analyze: ERREUR - label en double : " << in.first
+                      << " (" << in.second << "), donner label=fichier\n";
+            return 1;
+        }
+    }
+
+    // Un fichier par tâche : la lecture ROOT est le coût dominant
+    ROOT::EnableThreadSafety();
+    std::vector<std::future<ConfigResult>> futures;
+    for (const auto& in : inputs) {
+        futures.push_back(std::async(std::launch::async, AnalyzeFile, in.first, in.second, paired));
+    }
+
+    std::vector<ConfigResult> results;
+    int status = 0;
+    for (auto& f : futures) {
+        ConfigResult r = f.get();
+        if (!r.ok) {
+            std::cerr << "puits_analyze: ERREUR - " << r.error << "\n";
+            status = 1;
+            continue;
+        }
+        WriteConfig(r, outDir);
+        std::cout << std::left << std::setw(40) << r.label << " " << r.nEvents << " evenements\n";
+        results.push_back(std::move(r));
+    }
+
+    if (!results.empty()) {
+        WriteComparison(results, outDir);
+        if (paired && results.size() > 1) {
+            WritePaired(results, outDir);
+        }
+    }
+    return status;
+}
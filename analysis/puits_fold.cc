@@ -0,0 +1,302 @@
+//
+// ********************************************************************
+// * puits_fold - Repliement d'une matrice de réponse par raie        *
+// * avec une table d'intensités quelconque (sans ROOT ni Geant4)     *
+// ********************************************************************
+//
+// Usage :
+//   puits_fold response_<hash>.csv [intensites.csv] [-a activite_Bq] [-o sortie.csv]
+//              [--extrapolate]
+//
+// response_<hash>.csv : produit par /puits/response/ (une ligne par énergie,
+//                       grandeurs par photon émis dans le cône)
+// intensites.csv      : lignes "energie_keV,intensite_pct" ('#' = commentaire) ;
+//                       par défaut la table Eu-152 de include/Eu152Data.hh
+//
+// Pour chaque raie k d'intensité I_k (photons par désintégration) :
+//   dose par événement simulé = Σ_k I_k · D_k         (même normalisation que
+//                                                     le mode spectre complet)
+//   débit de dose (nGy/s)     = A · f · Σ_k I_k · D_k (A sur 4π, f fraction du cône)
+// Une raie absente de la matrice est interpolée linéairement en énergie. Une
+// raie hors de la plage d'énergies de la matrice est refusée ; avec
+// --extrapolate, elle reçoit la réponse de l'énergie la plus proche
+// (avertissement avec la raie et la plage).
+//
+
+#include "Eu152Data.hh"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct ResponseRow {
+        double energy_keV = 0.;
+        double coneFraction = 0.;
+        std::vector<double> dose;
+        std::vector<double> sem;
+        double prePhotons = 0.;
+        double postPhotonsFwd = 0.;
+        double enteredWater = 0.;
+        double absorbedWater = 0.;
+    };
+
+    struct Line {
+        double energy_keV;
+        double intensity;   // photons par désintégration
+    };
+
+    std::vector<std::string> Split(const std::string& line)
+    {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) fields.push_back(field);
+        return fields;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // LECTURE DE LA MATRICE DE RÉPONSE
+    // ═══════════════════════════════════════════════════════════════
+
+    bool ReadResponse(const std::string& path, std::vector<ResponseRow>& rows,
+                      int& nRings, std::string& hash)
+    {
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+
+        std::vector<std::string> header;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.rfind("# geometry_hash=", 0) == 0) {
+                hash = line.substr(16);
+                continue;
+            }
+            if (line.empty() || line[0] == '#') continue;
+            if (header.empty()) {
+                header = Split(line);
+                nRings = 0;
+                for (const auto& h : header) {
+                    if (h.rfind("dose_nGy_ring", 0) == 0) nRings++;
+                }
+                continue;
+            }
+
+            std::vector<std::string> f = Split(line);
+            if (f.size() != header.size()) continue;
+
+            ResponseRow row;
+            for (size_t c = 0; c < f.size(); ++c) {
+                const std::string& h = header[c];
+                double v = std::atof(f[c].c_str());
+                if (h == "energy_keV") row.energy_keV = v;
+                else if (h == "cone_fraction") row.coneFraction = v;
+                else if (h.rfind("dose_nGy_ring", 0) == 0) row.dose.push_back(v);
+                else if (h.rfind("sem_nGy_ring", 0) == 0) row.sem.push_back(v);
+                else if (h == "pre_photons") row.prePhotons = v;
+                else if (h == "post_photons_fwd") row.postPhotonsFwd = v;
+                else if (h == "entered_water") row.enteredWater = v;
+                else if (h == "absorbed_water") row.absorbedWater = v;
+            }
+            rows.push_back(row);
+        }
+        return !rows.empty();
+    }
+
+    bool ReadIntensities(const std::string& path, std::vector<Line>& lines)
+    {
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::vector<std::string> f = Split(line);
+            if (f.size() < 2) continue;
+            char* end = nullptr;
+            double e = std::strtod(f[0].c_str(), &end);
+            if (end == f[0].c_str()) continue;   // ligne d'en-tête
+            lines.push_back({e, std::atof(f[1].c_str()) / 100.});
+        }
+        return !lines.empty();
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // RÉPONSE À UNE ÉNERGIE (ligne exacte, interpolation ou extrapolation)
+    // ═══════════════════════════════════════════════════════════════
+
+    enum ResponseKind { kExact, kInterpolated, kExtrapolated };
+
+    ResponseRow ResponseAt(const std::vector<ResponseRow>& rows, double energy_keV, ResponseKind& kind)
+    {
+        kind = kExact;
+        const double tolerance = 0.5;
+        for (const auto& r : rows) {
+            if (std::abs(r.energy_keV - energy_keV) < tolerance) return r;
+        }
+
+        // Lignes triées par énergie dans le fichier de réponse ; hors de la
+        // plage, réponse de l'énergie la plus proche (valeur du bord)
+        kind = kExtrapolated;
+        if (energy_keV <= rows.front().energy_keV) return rows.front();
+        if (energy_keV >= rows.back().energy_keV) return rows.back();
+
+        kind = kInterpolated;
+
+        size_t k = 1;
+        while (rows[k].energy_keV < energy_keV) k++;
+        const ResponseRow& a = rows[k - 1];
+        const ResponseRow& b = rows[k];
+        double t = (energy_keV - a.energy_keV) / (b.energy_keV - a.energy_keV);
+
+        ResponseRow r = a;
+        r.energy_keV = energy_keV;
+        for (size_t i = 0; i < r.dose.size(); ++i) {
+            r.dose[i] = (1. - t) * a.dose[i] + t * b.dose[i];
+            r.sem[i] = std::hypot((1. - t) * a.sem[i], t * b.sem[i]);
+        }
+        r.prePhotons = (1. - t) * a.prePhotons + t * b.prePhotons;
+        r.postPhotonsFwd = (1. - t) * a.postPhotonsFwd + t * b.postPhotonsFwd;
+        r.enteredWater = (1. - t) * a.enteredWater + t * b.enteredWater;
+        r.absorbedWater = (1. - t) * a.absorbedWater + t * b.absorbedWater;
+        return r;
+    }
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage: puits_fold response.csv [intensites.csv] [-a activite_Bq] [-o sortie.csv]"
+                     " [--extrapolate]\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string responsePath, intensityPath, outPath;
+    double activity = 0.;
+    bool extrapolate = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-a" && i + 1 < argc) {
+            activity = std::atof(argv[++i]);
+        } else if (arg == "-o" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "--extrapolate") {
+            extrapolate = true;
+        } else if (arg == "-h" || arg == "--help") {
+            PrintUsage();
+            return 0;
+        } else if (responsePath.empty()) {
+            responsePath = arg;
+        } else {
+            intensityPath = arg;
+        }
+    }
+
+    if (responsePath.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<ResponseRow> rows;
+    int nRings = 0;
+    std::string hash;
+    if (!ReadResponse(responsePath, rows, nRings, hash)) {
+        std::cerr << "puits_fold: ERREUR - matrice de reponse illisible : " << responsePath << "\n";
+        return 1;
+    }
+
+    std::vector<Line> lines;
+    if (intensityPath.empty()) {
+        for (int k = 0; k < Eu152::kNbLines; ++k) {
+            lines.push_back({Eu152::kLineEnergies_keV[k], Eu152::kLineIntensities_pct[k] / 100.});
+        }
+    } else if (!ReadIntensities(intensityPath, lines)) {
+        std::cerr << "puits_fold: ERREUR - table d'intensites illisible : " << intensityPath << "\n";
+        return 1;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // REPLIEMENT
+    // ═══════════════════════════════════════════════════════════════
+
+    std::vector<double> dose(nRings, 0.), var(nRings, 0.);
+    double photonsPerDecay = 0., pre = 0., post = 0., entered = 0., absorbed = 0.;
+    const double coneFraction = rows.front().coneFraction;
+
+    for (const auto& line : lines) {
+        ResponseKind kind = kExact;
+        ResponseRow r = ResponseAt(rows, line.energy_keV, kind);
+        if (kind == kInterpolated) {
+            std::cerr << "puits_fold: raie " << line.energy_keV
+                      << " keV absente de la matrice, interpolee\n";
+        } else if (kind == kExtrapolated) {
+            std::cerr << "puits_fold: " << (extrapolate ? "ATTENTION" : "ERREUR") << " - raie "
+                      << line.energy_keV << " keV hors de la plage de la matrice ("
+                      << rows.front().energy_keV << " - " << rows.back().energy_keV << " keV)";
+            if (!extrapolate) {
+                std::cerr << ", --extrapolate pour utiliser la reponse a " << r.energy_keV << " keV\n";
+                return 1;
+            }
+            std::cerr << ", extrapolee : reponse a " << r.energy_keV << " keV\n";
+        }
+        if (std::abs(r.coneFraction - coneFraction) > 1e-9) {
+            std::cerr << "puits_fold: ATTENTION - fractions de cone differentes entre sous-runs\n";
+        }
+        for (int i = 0; i < nRings && i < static_cast<int>(r.dose.size()); ++i) {
+            dose[i] += line.intensity * r.dose[i];
+            var[i] += line.intensity * line.intensity * r.sem[i] * r.sem[i];
+        }
+        photonsPerDecay += line.intensity;
+        pre += line.intensity * r.prePhotons;
+        post += line.intensity * r.postPhotonsFwd;
+        entered += line.intensity * r.enteredWater;
+        absorbed += line.intensity * r.absorbedWater;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // SORTIE
+    // ═══════════════════════════════════════════════════════════════
+
+    std::cout << "Matrice : " << responsePath << " (geometrie " << hash << ", "
+              << rows.size() << " energies)\n"
+              << "Raies   : " << lines.size() << ", " << photonsPerDecay << " photons/desintegration\n"
+              << "Cone    : f = " << coneFraction << "\n\n"
+              << " anneau   dose (nGy/evt)     err. std        err. rel";
+    if (activity > 0.) std::cout << "     debit (nGy/s)";
+    std::cout << "\n";
+
+    for (int i = 0; i < nRings; ++i) {
+        double sem = std::sqrt(var[i]);
+        std::cout << std::setw(7) << i << "  " << std::scientific << std::setprecision(5)
+                  << std::setw(15) << dose[i] << "  " << std::setw(14) << sem << "  "
+                  << std::fixed << std::setprecision(3) << std::setw(8)
+                  << ((dose[i] > 0.) ? 100. * sem / dose[i] : 0.) << " %";
+        if (activity > 0.) {
+            std::cout << "  " << std::scientific << std::setprecision(5) << std::setw(15)
+                      << activity * coneFraction * dose[i];
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6)
+              << "\nPar evenement : PreContainer " << pre << " photons, PostContainer (+z) " << post
+              << " photons, entree eau " << entered << ", absorption eau " << absorbed << "\n";
+
+    if (!outPath.empty()) {
+        std::ofstream out(outPath);
+        out << "ring,dose_nGy_per_evt,sem_nGy";
+        if (activity > 0.) out << ",dose_rate_nGy_per_s";
+        out << "\n" << std::setprecision(10);
+        for (int i = 0; i < nRings; ++i) {
+            out << i << "," << dose[i] << "," << std::sqrt(var[i]);
+            if (activity > 0.) out << "," << activity * coneFraction * dose[i];
+            out << "\n";
+        }
+    }
+    return 0;
+}
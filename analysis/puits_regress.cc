@@ -0,0 +1,350 @@
+//
+// ********************************************************************
+// * puits_regress - Contrôle statistique de non-régression           *
+// * d'un run par rapport à un run de référence (sans ROOT ni Geant4) *
+// ********************************************************************
+//
+// Usage :
+//   puits_regress reference run [-z zmax] [-p alpha] [-m min] [-o rapport.csv]
+//
+// reference, run : préfixes de sortie (/puits/output/name) ; lit
+//                  <préfixe>_rings.csv, _lines.csv et _planes.csv
+//
+// Les deux runs ont des graines différentes : la comparaison ne suppose
+// jamais l'égalité bit à bit, seulement la compatibilité statistique.
+// Pour chaque grandeur, z = (x_run - x_ref) / sqrt(σ_run² + σ_ref²) :
+//   anneaux : dose par événement, σ = erreur standard du run
+//   raies   : taux d'entrée dans l'eau (entrés / émis) et d'absorption
+//             (absorbés / entrés), σ binomiale
+//   plans   : comptages par événement, σ de Poisson
+// Les grandeurs à moins de 'min' comptages (défaut 25) ne sont pas testées.
+// Par groupe, χ² = Σ z² à n degrés de liberté donne une probabilité p.
+//
+// Échec si une grandeur a |z| > zmax (défaut 4 : ~0.4 % de fausse alerte
+// pour 60 grandeurs) ou si un groupe a p < alpha (défaut 0.001 : petits
+// écarts systématiques répartis sur tout un groupe).
+// Code de sortie : 0 compatible, 1 erreur de lecture, 2 écart détecté.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Table CSV : colonnes par nom, une ligne par entrée
+    struct CsvTable {
+        std::vector<std::string> header;
+        std::vector<std::vector<std::string>> rows;
+
+        int Column(const std::string& name) const
+        {
+            for (size_t c = 0; c < header.size(); ++c) {
+                if (header[c] == name) return static_cast<int>(c);
+            }
+            return -1;
+        }
+        double Value(size_t row, int column) const
+        {
+            return (column >= 0) ? std::atof(rows[row][column].c_str()) : 0.;
+        }
+    };
+
+    // Grandeur comparée
+    struct Observable {
+        std::string group;
+        std::string name;
+        double reference = 0.;
+        double run = 0.;
+        double z = 0.;
+        bool tested = false;
+    };
+
+    std::vector<std::string> Split(const std::string& line)
+    {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) fields.push_back(field);
+        return fields;
+    }
+
+    bool ReadCsv(const std::string& path, CsvTable& table)
+    {
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::vector<std::string> f = Split(line);
+            if (table.header.empty()) {
+                table.header = f;
+            } else if (f.size() == table.header.size()) {
+                table.rows.push_back(f);
+            }
+        }
+        return !table.header.empty();
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // LOI DU χ² : p = Q(n/2, χ²/2), gamma incomplète régularisée
+    // ═══════════════════════════════════════════════════════════════
+
+    double UpperGammaQ(double a, double x)
+    {
+        if (x <= 0.) return 1.;
+        const double lnPrefactor = -x + a * std::log(x) - std::lgamma(a);
+        if (x < a + 1.) {
+            // Série de P(a, x)
+            double term = 1. / a, sum = term;
+            for (int n = 1; n < 500 && std::abs(term) > 1e-15 * std::abs(sum); ++n) {
+                term *= x / (a + n);
+                sum += term;
+            }
+            return 1. - sum * std::exp(lnPrefactor);
+        }
+        // Fraction continue de Q(a, x) (méthode de Lentz)
+        const double tiny = 1e-300;
+        double b = x + 1. - a, c = 1. / tiny, d = 1. / b, h = d;
+        for (int i = 1; i < 500; ++i) {
+            double an = -i * (i - a);
+            b += 2.;
+            d = an * d + b;
+            if (std::abs(d) < tiny) d = tiny;
+            c = b + an / c;
+            if (std::abs(c) < tiny) c = tiny;
+            d = 1. / d;
+            double delta = d * c;
+            h *= delta;
+            if (std::abs(delta - 1.) < 1e-15) break;
+        }
+        return h * std::exp(lnPrefactor);
+    }
+
+    double ZScore(double x, double sx, double y, double sy)
+    {
+        double sigma = std::sqrt(sx * sx + sy * sy);
+        return (sigma > 0.) ? (y - x) / sigma : 0.;
+    }
+
+    // Taux binomial k/n : valeur et écart type
+    void Rate(double k, double n, double& rate, double& sigma)
+    {
+        rate = (n > 0.) ? k / n : 0.;
+        sigma = (n > 0.) ? std::sqrt(std::max(0., rate * (1. - rate)) / n) : 0.;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // GRANDEURS COMPARÉES
+    // ═══════════════════════════════════════════════════════════════
+
+    void CompareRings(const CsvTable& ref, const CsvTable& run, std::vector<Observable>& obs)
+    {
+        const int dRef = ref.Column("dose_nGy_per_evt"), sRef = ref.Column("sem_nGy");
+        const int dRun = run.Column("dose_nGy_per_evt"), sRun = run.Column("sem_nGy");
+        if (ref.rows.size() != run.rows.size()) {
+            std::cerr << "puits_regress: ATTENTION - " << ref.rows.size() << " anneaux en reference, "
+                      << run.rows.size() << " dans le run : anneaux communs seulement\n";
+        }
+        for (size_t i = 0; i < ref.rows.size() && i < run.rows.size(); ++i) {
+            Observable o;
+            o.group = "rings";
+            o.name = "dose_ring" + std::to_string(i);
+            o.reference = ref.Value(i, dRef);
+            o.run = run.Value(i, dRun);
+            o.tested = ref.Value(i, sRef) > 0. && run.Value(i, sRun) > 0.;
+            if (o.tested) o.z = ZScore(o.reference, ref.Value(i, sRef), o.run, run.Value(i, sRun));
+            obs.push_back(o);
+        }
+    }
+
+    void CompareLines(const CsvTable& ref, const CsvTable& run, double minCounts, std::vector<Observable>& obs)
+    {
+        const int eRef = ref.Column("emitted"), nRef = ref.Column("entered_water"), aRef = ref.Column("absorbed_water_w");
+        const int eRun = run.Column("emitted"), nRun = run.Column("entered_water"), aRun = run.Column("absorbed_water_w");
+        const int energy = ref.Column("energy_keV");
+
+        for (size_t i = 0; i < ref.rows.size() && i < run.rows.size(); ++i) {
+            std::ostringstream label;
+            label << std::fixed << std::setprecision(1) << ref.Value(i, energy) << "keV";
+
+            // Entrée dans l'eau par photon émis
+            double r1, s1, r2, s2;
+            Rate(ref.Value(i, nRef), ref.Value(i, eRef), r1, s1);
+            Rate(run.Value(i, nRun), run.Value(i, eRun), r2, s2);
+            Observable entry;
+            entry.group = "lines";
+            entry.name = "entry_" + label.str();
+            entry.reference = r1;
+            entry.run = r2;
+            entry.tested = ref.Value(i, nRef) >= minCounts && run.Value(i, nRun) >= minCounts;
+            if (entry.tested) entry.z = ZScore(r1, s1, r2, s2);
+            obs.push_back(entry);
+
+            // Absorption dans l'eau par photon entré
+            Rate(ref.Value(i, aRef), ref.Value(i, nRef), r1, s1);
+            Rate(run.Value(i, aRun), run.Value(i, nRun), r2, s2);
+            Observable absorption;
+            absorption.group = "lines";
+            absorption.name = "absorption_" + label.str();
+            absorption.reference = r1;
+            absorption.run = r2;
+            absorption.tested = ref.Value(i, aRef) >= minCounts && run.Value(i, aRun) >= minCounts;
+            if (absorption.tested) absorption.z = ZScore(r1, s1, r2, s2);
+            obs.push_back(absorption);
+        }
+    }
+
+    void ComparePlanes(const CsvTable& ref, const CsvTable& run, double minCounts, std::vector<Observable>& obs)
+    {
+        const int nameRef = ref.Column("name");
+        const int evRef = ref.Column("events"), cRef = ref.Column("count");
+        const int evRun = run.Column("events"), cRun = run.Column("count");
+
+        for (size_t i = 0; i < ref.rows.size() && i < run.rows.size(); ++i) {
+            double n1 = ref.Value(i, evRef), k1 = ref.Value(i, cRef);
+            double n2 = run.Value(i, evRun), k2 = run.Value(i, cRun);
+            Observable o;
+            o.group = "planes";
+            o.name = (nameRef >= 0) ? ref.rows[i][nameRef] : std::to_string(i);
+            o.reference = (n1 > 0.) ? k1 / n1 : 0.;
+            o.run = (n2 > 0.) ? k2 / n2 : 0.;
+            o.tested = k1 >= minCounts && k2 >= minCounts;
+            if (o.tested) o.z = ZScore(o.reference, std::sqrt(k1) / n1, o.run, std::sqrt(k2) / n2);
+            obs.push_back(o);
+        }
+    }
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage: puits_regress reference run [-z zmax] [-p alpha] [-m min] [-o rapport.csv]\n"
+                  << "  reference, run : prefixes de sortie (<prefixe>_rings.csv, _lines.csv, _planes.csv)\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string refPrefix, runPrefix, outPath;
+    double zMax = 4.;
+    double alpha = 1e-3;
+    double minCounts = 25.;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-z" && i + 1 < argc) {
+            zMax = std::atof(argv[++i]);
+        } else if (arg == "-p" && i + 1 < argc) {
+            alpha = std::atof(argv[++i]);
+        } else if (arg == "-m" && i + 1 < argc) {
+            minCounts = std::atof(argv[++i]);
+        } else if (arg == "-o" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            PrintUsage();
+            return 0;
+        } else if (refPrefix.empty()) {
+            refPrefix = arg;
+        } else {
+            runPrefix = arg;
+        }
+    }
+
+    if (refPrefix.empty() || runPrefix.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    // ═══════════════════════════════════════════════════════════════
+    // LECTURE DES DEUX RUNS
+    // ═══════════════════════════════════════════════════════════════
+
+    const char* kSuffixes[3] = {"_rings.csv", "_lines.csv", "_planes.csv"};
+    CsvTable ref[3], run[3];
+    for (int k = 0; k < 3; ++k) {
+        if (!ReadCsv(refPrefix + kSuffixes[k], ref[k])) {
+            std::cerr << "puits_regress: ERREUR - reference illisible : " << refPrefix + kSuffixes[k] << "\n";
+            return 1;
+        }
+        if (!ReadCsv(runPrefix + kSuffixes[k], run[k])) {
+            std::cerr << "puits_regress: ERREUR - run illisible : " << runPrefix + kSuffixes[k] << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<Observable> obs;
+    CompareRings(ref[0], run[0], obs);
+    CompareLines(ref[1], run[1], minCounts, obs);
+    ComparePlanes(ref[2], run[2], minCounts, obs);
+
+    // ═══════════════════════════════════════════════════════════════
+    // TESTS : |z| PAR GRANDEUR, χ² PAR GROUPE
+    // ═══════════════════════════════════════════════════════════════
+
+    std::cout << "Reference : " << refPrefix << "\nRun       : " << runPrefix
+              << "\nSeuils    : |z| <= " << zMax << ", p(chi2) >= " << alpha
+              << ", au moins " << minCounts << " comptages\n\n"
+              << std::setw(8) << "groupe" << std::setw(22) << "grandeur"
+              << std::setw(16) << "reference" << std::setw(16) << "run" << std::setw(8) << "z" << "\n";
+
+    std::map<std::string, std::pair<double, int>> chi2;   // groupe -> (χ², n)
+    int outliers = 0, skipped = 0;
+    for (const auto& o : obs) {
+        std::cout << std::setw(8) << o.group << std::setw(22) << o.name
+                  << std::scientific << std::setprecision(5)
+                  << std::setw(16) << o.reference << std::setw(16) << o.run;
+        if (!o.tested) {
+            std::cout << "        -  (statistique insuffisante)\n";
+            skipped++;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(2) << std::setw(8) << o.z;
+        if (std::abs(o.z) > zMax) {
+            std::cout << "  <<<";
+            outliers++;
+        }
+        std::cout << "\n";
+        chi2[o.group].first += o.z * o.z;
+        chi2[o.group].second++;
+    }
+
+    std::cout << "\n" << std::setw(8) << "groupe" << std::setw(10) << "n"
+              << std::setw(12) << "chi2" << std::setw(12) << "chi2/n" << std::setw(13) << "p" << "\n";
+    int badGroups = 0;
+    for (const auto& g : chi2) {
+        const double value = g.second.first;
+        const int n = g.second.second;
+        const double p = UpperGammaQ(0.5 * n, 0.5 * value);
+        std::cout << std::setw(8) << g.first << std::setw(10) << n
+                  << std::fixed << std::setprecision(2) << std::setw(12) << value
+                  << std::setw(12) << value / n
+                  << std::scientific << std::setprecision(3) << std::setw(13) << p
+                  << (p < alpha ? "  <<<" : "") << "\n";
+        if (p < alpha) badGroups++;
+    }
+
+    if (!outPath.empty()) {
+        std::ofstream out(outPath);
+        out << "group,observable,reference,run,z,tested\n" << std::setprecision(10);
+        for (const auto& o : obs) {
+            out << o.group << "," << o.name << "," << o.reference << "," << o.run
+                << "," << o.z << "," << (o.tested ? 1 : 0) << "\n";
+        }
+    }
+
+    std::cout << std::defaultfloat << std::setprecision(6)
+              << "\n" << obs.size() - skipped << " grandeurs testees, " << skipped << " ignorees\n";
+    if (outliers > 0 || badGroups > 0) {
+        std::cout << "ECART DETECTE : " << outliers << " grandeur(s) avec |z| > " << zMax
+                  << ", " << badGroups << " groupe(s) avec p < " << alpha << "\n";
+        return 2;
+    }
+    std::cout << "Resultats compatibles avec la reference\n";
+    return 0;
+}
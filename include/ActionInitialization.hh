@@ -9,6 +9,7 @@ public:
     ActionInitialization();
     virtual ~ActionInitialization();
 
+    virtual void BuildForMaster() const;
     virtual void Build() const;
 };
 
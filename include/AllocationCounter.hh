@@ -0,0 +1,128 @@
+#ifndef AllocationCounter_h
+#define AllocationCounter_h 1
+
+#include "globals.hh"
+#include <array>
+#include <mutex>
+#include <ostream>
+
+class G4GenericMessenger;
+
+/// @brief Comptage des allocations du code utilisateur dans la boucle d'événements
+///
+/// Singleton. Avec l'option CMake PUITS_COUNT_ALLOCATIONS, malloc/calloc/
+/// realloc et les allocations alignées memalign/aligned_alloc/posix_memalign/
+/// valloc/pvalloc (glibc), ou operator new, y compris aligné (autres
+/// bibliothèques C), sont remplacés
+/// par des versions qui comptent, par thread, les allocations faites à
+/// l'intérieur des actions utilisateur marquées par PUITS_ALLOCATION_SCOPE :
+/// événement (génération, début et fin d'événement), pas (SteppingAction)
+/// et détecteurs sensibles (PlaneSD). Les remplissages G4AnalysisManager
+/// faits depuis ces actions (PUITS_ALLOCATION_ANALYSIS) sont comptés à part
+/// et hors contrôle : un ntuple alloue en vidant ses paniers, au rythme de
+/// la taille des paniers et non du code utilisateur.
+///
+/// Après la chauffe (warmup événements par thread), la boucle doit être
+/// sans allocation : le rapport de fin de run donne les allocations par
+/// événement et par pas, avant et après la chauffe ; en mode strict, une
+/// allocation en régime établi (hors analyse), ou une chauffe jamais
+/// terminée, arrête le programme (G4Exception fatale, code de retour non
+/// nul : test ctest alloc_check).
+/// Sans l'option, les portées sont vides et ne coûtent rien.
+///
+/// Commandes : /puits/alloc/warmup, /puits/alloc/strict
+
+class AllocationCounter
+{
+public:
+    static AllocationCounter* GetInstance();
+
+    enum Scope { kEvent = 0, kStep, kHits, kAnalysis, kNbScopes };
+
+    /// Comptage compilé (option PUITS_COUNT_ALLOCATIONS)
+    static G4bool IsCompiled();
+
+    /// Portée d'une action utilisateur sur le thread courant (imbricable :
+    /// la portée la plus externe reçoit les allocations)
+    static void Enter(Scope scope);
+    static void Leave();
+
+    /// Remplissage d'analyse dans la portée courante : allocations attribuées
+    /// à kAnalysis jusqu'à LeaveAnalysis (rend la portée précédente, -1 hors portée)
+    static G4int EnterAnalysis();
+    static void LeaveAnalysis(G4int previous);
+
+    /// Fin d'un événement du thread courant (décompte de la chauffe)
+    static void EndOfEvent();
+
+    /// Ajoute les compteurs du thread courant au run (fin de run, chaque thread)
+    void FlushThread();
+
+    /// Rapport du run (maître), puis remise à zéro ; mode strict : fatal si
+    /// des allocations subsistent après la chauffe ou si elle n'est pas finie
+    void Report(std::ostream& os);
+
+    class ScopeGuard
+    {
+    public:
+        explicit ScopeGuard(Scope scope) { Enter(scope); }
+        ~ScopeGuard() { Leave(); }
+        ScopeGuard(const ScopeGuard&) = delete;
+        ScopeGuard& operator=(const ScopeGuard&) = delete;
+    };
+
+    class AnalysisGuard
+    {
+    public:
+        AnalysisGuard() : fPrevious(EnterAnalysis()) {}
+        ~AnalysisGuard() { LeaveAnalysis(fPrevious); }
+        AnalysisGuard(const AnalysisGuard&) = delete;
+        AnalysisGuard& operator=(const AnalysisGuard&) = delete;
+    private:
+        G4int fPrevious;
+    };
+
+private:
+    AllocationCounter();
+    ~AllocationCounter();
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    void DefineCommands();
+
+    struct Totals
+    {
+        G4long events = 0;
+        G4long steps = 0;
+        G4long steadyEvents = 0;
+        G4long steadySteps = 0;
+        std::array<G4long, kNbScopes> allocations {};
+        std::array<G4long, kNbScopes> bytes {};
+        std::array<G4long, kNbScopes> steadyAllocations {};
+    };
+
+    static AllocationCounter* fInstance;
+
+    std::mutex fMutex;          // fusion des threads en fin de run
+    Totals fTotals;
+
+    G4int fWarmupEvents;        // événements de chauffe par thread
+    G4bool fStrict;
+
+    G4GenericMessenger* fMessenger;
+};
+
+#ifdef PUITS_COUNT_ALLOCATIONS
+#define PUITS_ALLOCATION_SCOPE(scope) \
+    AllocationCounter::ScopeGuard puitsAllocationScope(AllocationCounter::scope)
+#define PUITS_ALLOCATION_ANALYSIS() \
+    AllocationCounter::AnalysisGuard puitsAllocationAnalysis
+#define PUITS_ALLOCATION_END_OF_EVENT() AllocationCounter::EndOfEvent()
+#else
+#define PUITS_ALLOCATION_SCOPE(scope)
+#define PUITS_ALLOCATION_ANALYSIS()
+#define PUITS_ALLOCATION_END_OF_EVENT()
+#endif
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef AttenuatorFastModel_h
+#define AttenuatorFastModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+
+class AttenuatorKernel;
+
+/// @brief Modèle de simulation rapide de la plaque atténuatrice
+///
+/// Attaché à la région de la plaque (une instance par thread). Un gamma qui
+/// entre par une face est remplacé, en un seul pas, par l'état de sortie
+/// tiré du noyau AttenuatorKernel (énergie, position sur la face ou le bord,
+/// direction), ou absorbé. Le modèle ne se déclenche pas tant que le noyau
+/// n'est pas tabulé, ni pour les cases trop peu peuplées : ces photons
+/// suivent le transport complet.
+
+class AttenuatorFastModel : public G4VFastSimulationModel
+{
+public:
+    AttenuatorFastModel(const G4String& name, G4Region* envelope);
+    virtual ~AttenuatorFastModel();
+
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+    virtual void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+private:
+    const AttenuatorKernel* fKernel;
+};
+
+#endif
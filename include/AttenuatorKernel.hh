@@ -0,0 +1,130 @@
+#ifndef AttenuatorKernel_h
+#define AttenuatorKernel_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <mutex>
+#include <vector>
+
+class G4GenericMessenger;
+
+/// @brief Noyau de transmission/diffusion d'une plaque atténuatrice
+///
+/// Singleton. Tabule, par énergie incidente (grille log de 10 keV à 2 MeV)
+/// et par cosinus d'incidence sur la plaque, l'état de sortie du photon
+/// incident : rapport d'énergie, décalage de position entre l'entrée et la
+/// sortie, direction de sortie (0 = photon absorbé dans la plaque). Le
+/// repère local est (u, v, n) : n normale à la plaque dans le sens de la
+/// pénétration, u projection de la direction incidente sur la plaque.
+///
+/// Chaque case garde au plus maxSamples états (échantillonnage par
+/// réservoir) ; le modèle rapide AttenuatorFastModel rééchantillonne ces
+/// états. Le noyau est rempli par la simulation elle-même lors d'un run en
+/// transport complet, puis mis en cache dans un fichier texte (rechargé si
+/// le matériau et l'épaisseur correspondent).
+///
+/// Seul le photon incident est suivi : la fluorescence et les électrons
+/// émis par la plaque ne sont pas reproduits en mode rapide.
+///
+/// Commandes : /puits/attenuator/kernel/file, maxSamples, minSamples, retabulate
+
+class AttenuatorKernel
+{
+public:
+    static AttenuatorKernel* GetInstance();
+
+    /// Plaque décrite par DetectorConstruction (appelé à la construction)
+    void SetSlab(const G4String& materialName, G4double thickness, G4double radius);
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+
+    G4bool IsEnabled() const { return fEnabled; }
+    G4bool IsRecording() const { return fRecording; }
+    G4bool IsSampling() const { return fSampling; }
+    G4double GetThickness() const { return fThickness; }
+    G4double GetRadius() const { return fRadius; }
+
+    /// Début de run (maître) : charge le cache, sinon tabule pendant ce run
+    void PrepareForRun();
+
+    /// Fin de run (maître) : sauvegarde le noyau tabulé
+    void FinishRun();
+
+    /// Point d'entrée sur une face de la plaque (repère local), direction rentrante
+    G4bool IsFaceEntry(const G4ThreeVector& localPosition, const G4ThreeVector& direction) const;
+
+    /// Enregistre la sortie d'un photon (exitEnergy = 0 : absorbé). Thread-safe.
+    void Record(G4double energy, const G4ThreeVector& entryDirection,
+                const G4ThreeVector& offset, const G4ThreeVector& exitDirection,
+                G4double exitEnergy);
+
+    /// Case assez peuplée pour le rééchantillonnage
+    G4bool HasSamples(G4double energy, const G4ThreeVector& entryDirection) const;
+
+    /// Tire un état de sortie (exitEnergy = 0 : absorbé)
+    void Sample(G4double energy, const G4ThreeVector& entryDirection,
+                G4ThreeVector& offset, G4ThreeVector& exitDirection,
+                G4double& exitEnergy) const;
+
+private:
+    AttenuatorKernel();
+    ~AttenuatorKernel();
+
+    AttenuatorKernel(const AttenuatorKernel&) = delete;
+    AttenuatorKernel& operator=(const AttenuatorKernel&) = delete;
+
+    /// État de sortie dans le repère (u, v, n) de l'entrée
+    struct ExitRecord
+    {
+        float energyRatio;               // E_sortie / E_incident (0 = absorbé)
+        float offsetU, offsetV, offsetN; // décalage entrée -> sortie (mm)
+        float dirU, dirV, dirN;          // direction de sortie
+    };
+
+    struct KernelBin
+    {
+        G4long seen = 0;                 // photons enregistrés dans la case
+        std::vector<ExitRecord> records; // réservoir
+    };
+
+    void DefineCommands();
+    void Retabulate(G4bool retabulate) { fRetabulate = retabulate; }
+    void Clear();
+    G4bool Load(const G4String& fileName);
+    void Save(const G4String& fileName) const;
+    void Print() const;
+
+    /// Index de case (-1 hors grille)
+    G4int GetBinIndex(G4double energy, const G4ThreeVector& direction) const;
+
+    /// Repère (u, v, n) associé à une direction incidente
+    static void BuildFrame(const G4ThreeVector& direction,
+                           G4ThreeVector& u, G4ThreeVector& v, G4ThreeVector& n);
+
+    static AttenuatorKernel* fInstance;
+
+    // Grille (énergie incidente × cosinus d'incidence)
+    static const G4int kNbEnergyBins = 60;
+    static const G4int kNbCosBins = 10;
+    static const G4double kEnergyMin;
+    static const G4double kEnergyMax;
+
+    std::vector<KernelBin> fBins;
+    std::mutex fMutex;                   // enregistrement concurrent des threads
+
+    G4String fMaterialName;
+    G4double fThickness;
+    G4double fRadius;
+
+    G4bool fEnabled;
+    G4bool fRecording;
+    G4bool fSampling;
+    G4bool fRetabulate;
+
+    G4String fFileName;
+    G4int fMaxSamples;
+    G4int fMinSamples;
+
+    G4GenericMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef CascadeLibrary_h
+#define CascadeLibrary_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+class G4GenericMessenger;
+class G4ParticleDefinition;
+
+/// @brief Bibliothèque de cascades de désintégration Eu-152 (mode source)
+///
+/// Singleton. /puits/cascade/build N désintègre N noyaux d'Eu-152 au repos
+/// avec G4RadioactiveDecay (données de décroissance de Geant4 : branches
+/// β-/CE, cascades gamma corrélées, conversion interne, relaxation atomique
+/// X/Auger) et écrit les produits dans un fichier binaire compact : espèce
+/// (gamma, e-, e+), énergie et direction de chaque particule. Les neutrinos
+/// et les noyaux de recul sont écartés.
+///
+/// Quand le mode est actif (/puits/cascade/enable), PrimaryGeneratorAction
+/// tire une désintégration uniformément dans la bibliothèque (O(1)) et la
+/// tourne en bloc par une rotation aléatoire uniforme : les corrélations
+/// entre particules d'une même désintégration sont conservées. Avec coneOnly
+/// (défaut), seules les particules dans le cône d'émission sont émises ; les
+/// désintégrations sans particule dans le cône sont comptées mais ne donnent
+/// pas d'événement, et RunAction normalise par désintégration (f = événements
+/// / désintégrations). Le mode raies indépendantes reste le défaut.
+///
+/// Format du fichier : en-tête "PUITSCAS", version, nombre de désintégrations
+/// et de particules (entiers 32/64 bits), nombre de particules par
+/// désintégration (octet), puis les particules (espèce sur un octet, 4
+/// flottants). Boutisme de la machine qui l'a écrit.
+///
+/// Commandes : /puits/cascade/enable, file, build, coneOnly
+
+class CascadeLibrary
+{
+public:
+    static CascadeLibrary* GetInstance();
+
+    enum Species { kGamma = 0, kElectron, kPositron, kNbSpecies };
+
+    /// Particule d'une désintégration (repère de la bibliothèque)
+    struct Particle
+    {
+        float energy_keV;
+        float dirX, dirY, dirZ;
+        std::uint8_t species;
+    };
+
+    G4bool IsEnabled() const { return fEnabled; }
+    G4bool IsConeOnly() const { return fConeOnly; }
+    std::size_t GetNbDecays() const { return fFirst.empty() ? 0 : fFirst.size() - 1; }
+
+    /// Début de run (maître) : charge la bibliothèque si le mode est actif
+    void PrepareForRun();
+
+    /// Tire une désintégration : première particule et nombre de particules
+    const Particle* SampleDecay(G4int& count) const;
+
+    /// Repère orthonormé aléatoire uniforme (rotation de la cascade entière)
+    static void SampleRotation(G4ThreeVector& e1, G4ThreeVector& e2, G4ThreeVector& e3);
+
+    static const G4ParticleDefinition* GetDefinition(G4int species);
+    static const char* GetSpeciesName(G4int species);
+
+    /// Multiplicités et énergies moyennes par désintégration, par espèce
+    void Print(std::ostream& os) const;
+
+private:
+    CascadeLibrary();
+    ~CascadeLibrary();
+
+    CascadeLibrary(const CascadeLibrary&) = delete;
+    CascadeLibrary& operator=(const CascadeLibrary&) = delete;
+
+    void DefineCommands();
+
+    /// Génère nDecays cascades avec G4RadioactiveDecay et les écrit dans fFileName
+    void Build(G4int nDecays);
+
+    G4bool Load(const G4String& fileName);
+    G4bool Save(const G4String& fileName) const;
+
+    static CascadeLibrary* fInstance;
+
+    // Particules de toutes les désintégrations, bout à bout ; la
+    // désintégration i occupe [fFirst[i], fFirst[i+1])
+    std::vector<Particle> fParticles;
+    std::vector<std::uint32_t> fFirst;
+    G4String fLoadedFile;                // Fichier en mémoire (vide : aucun)
+
+    G4bool fEnabled;
+    G4bool fConeOnly;
+    G4String fFileName;
+
+    G4GenericMessenger* fMessenger;
+};
+
+#endif
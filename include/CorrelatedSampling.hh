@@ -0,0 +1,56 @@
+#ifndef CorrelatedSampling_h
+#define CorrelatedSampling_h 1
+
+#include "globals.hh"
+
+class G4GenericMessenger;
+
+/// @brief Échantillonnage corrélé entre variantes de géométrie
+///
+/// Singleton. Quand le mode est actif, PrimaryGeneratorAction réinitialise
+/// le générateur aléatoire au début de chaque événement avec une graine
+/// dérivée de la graine de base et du numéro d'événement seulement. Deux
+/// jobs lancés avec la même graine de base sur deux géométries (feuille W
+/// ou non, épaisseur de plaque...) transportent alors les mêmes primaires,
+/// avec le même flux aléatoire tant que les histoires ne divergent pas,
+/// quel que soit le nombre de threads.
+///
+/// La différence de dose est estimée événement par événement
+/// (puits_analyze --paired) : sa variance tient compte de la covariance
+/// entre variantes et est bien plus faible que celle de deux jobs
+/// indépendants.
+///
+/// Incompatible avec la source QMC et l'allocation stratifiée adaptative
+/// (état par thread qui dépend de l'historique des doses).
+///
+/// Commandes : /puits/corr/enable, /puits/corr/seed
+
+class CorrelatedSampling
+{
+public:
+    static CorrelatedSampling* GetInstance();
+
+    G4bool IsEnabled() const { return fEnabled; }
+    G4int GetBaseSeed() const { return fBaseSeed; }
+
+    /// Graines du moteur courant (thread appelant) pour l'événement donné
+    void SeedEvent(G4int eventID) const;
+
+private:
+    CorrelatedSampling();
+    ~CorrelatedSampling();
+
+    CorrelatedSampling(const CorrelatedSampling&) = delete;
+    CorrelatedSampling& operator=(const CorrelatedSampling&) = delete;
+
+    void DefineCommands();
+
+    static CorrelatedSampling* fInstance;
+
+    G4bool fEnabled;
+    G4int fBaseSeed;
+
+    G4GenericMessenger* fMessenger;
+};
+
+#endif
@@ -8,6 +8,9 @@
 class G4VPhysicalVolume;
 class G4LogicalVolume;
 class G4Material;
+class G4GenericMessenger;
+class G4Region;
+class G4UserLimits;
 
 /// @brief Construction du détecteur - CONFIGURATION OPTIMISÉE
 ///
@@ -16,8 +19,13 @@ class G4Material;
 /// - PreContainer Plane (AIR, 1 mm, r=25mm) : z = 99-100 mm (AVANT surface eau)
 /// - Première tranche d'eau (2 mm) : z = 100-102 mm
 /// - Deuxième tranche d'eau (1 mm) : z = 102-103 mm (anneaux concentriques)
+///   5 anneaux de 5 mm par défaut ; nombre, largeur et construction réglables
+///   (/puits/geometry/rings, ringWidth, ringLayout)
 /// - PostContainer = Polystyrène (1 mm) : z = 103-104 mm (fond boîte de Petri)
 /// - Feuille de tungstène (50 µm) : z = 104-104.05 mm (rétrodiffusion)
+///
+/// Option : plaque atténuatrice (matériau NIST, /puits/attenuator/) juste
+/// avant le PreContainer, avec simulation rapide optionnelle par noyau tabulé.
 
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -26,25 +34,82 @@ public:
     virtual ~DetectorConstruction();
     
     virtual G4VPhysicalVolume* Construct();
+    
+    /// Détecteurs des plans container, modèle rapide de la plaque et
+    /// opérateurs de biaisage (par thread) si la collision forcée est active
+    virtual void ConstructSDandField();
 
     // ═══════════════════════════════════════════════════════════════
     // ACCESSEURS POUR LES VOLUMES SENSIBLES (ANNEAUX D'EAU)
     // ═══════════════════════════════════════════════════════════════
 
+    /// Nombre maximal d'anneaux d'eau (capacité des tableaux de comptage)
+    static const G4int kMaxWaterRings = 100;
+
+    /// Construction de la couche d'anneaux :
+    /// - kPlacement     : un G4Tubs par anneau, placé dans l'enveloppe
+    /// - kReplica       : tube conteneur divisé en rayon (G4PVReplica, kRho)
+    /// - kParameterised : tube conteneur, anneaux G4PVParameterised
+    /// Dans les trois cas, le numéro de copie est l'index de l'anneau.
+    enum RingLayout { kPlacement = 0, kReplica, kParameterised };
+
     /// Nombre d'anneaux d'eau (incluant le disque central)
-    static const G4int kNbWaterRings = 5;
+    G4int GetNbWaterRings() const { return fNbWaterRings; }
     
-    /// Retourne le nom du volume logique pour l'anneau i
+    /// Retourne le nom du volume (placement) pour l'anneau i
     static G4String GetWaterRingName(G4int ringIndex);
 
-    /// Retourne le rayon interne de l'anneau i (mm)
-    static G4double GetRingInnerRadius(G4int ringIndex);
+    /// Retourne le rayon interne de l'anneau i
+    G4double GetRingInnerRadius(G4int ringIndex) const { return ringIndex * fRingWidth; }
 
-    /// Retourne le rayon externe de l'anneau i (mm)
-    static G4double GetRingOuterRadius(G4int ringIndex);
+    /// Retourne le rayon externe de l'anneau i
+    G4double GetRingOuterRadius(G4int ringIndex) const { return (ringIndex + 1) * fRingWidth; }
+    
+    /// Largeur des anneaux (rayon du container / nombre d'anneaux par défaut)
+    G4double GetRingWidth() const { return fRingWidth; }
+    
+    RingLayout GetRingLayout() const { return fRingLayout; }
+    G4String GetRingLayoutName() const;
+    
+    /// Volumes logiques des anneaux (un seul en replica / paramétré)
+    const std::vector<G4LogicalVolume*>& GetWaterRingLogicals() const { return fWaterRingLogicals; }
     
     /// Retourne la masse de l'anneau i (g)
     G4double GetRingMass(G4int ringIndex) const { return fRingMasses[ringIndex]; }
+    
+    /// Épaisseur de la tranche d'eau des anneaux
+    G4double GetRingThickness() const { return fWaterThickness2; }
+
+    /// Rayon de l'empilement et distance source-eau (cône d'émission)
+    G4double GetContainerRadius() const { return fContainerRadius; }
+    G4double GetSourceToWaterDistance() const { return fSourceToWaterDistance; }
+    G4bool HasTungstenFoil() const { return fTungstenFoil; }
+
+    /// Demi-dimensions du monde et de l'enveloppe (ajustées si tightWorld)
+    G4bool IsTightWorld() const { return fTightWorld; }
+    G4double GetWorldHalfXY() const { return fWorldHalfXY; }
+    G4double GetWorldHalfZ() const { return fWorldHalfZ; }
+    G4double GetEnvelopeHalfXY() const { return fEnvelopeHalfXY; }
+    G4double GetEnvelopeHalfZ() const { return fEnvelopeHalfZ; }
+    G4double GetEnvelopeCenterZ() const { return fEnvelopeCenterZ; }
+
+    // ═══════════════════════════════════════════════════════════════
+    // RÉDUCTION DE VARIANCE (/puits/vr/)
+    // ═══════════════════════════════════════════════════════════════
+
+    /// Collision forcée des gammas dans les anneaux (PreInit uniquement)
+    void SetForceCollision(G4bool enable);
+    G4bool IsForceCollisionEnabled() const { return fForceCollision; }
+
+    // ═══════════════════════════════════════════════════════════════
+    // PLAQUE ATTÉNUATRICE (/puits/attenuator/)
+    // ═══════════════════════════════════════════════════════════════
+
+    /// Simulation rapide de la plaque par noyau tabulé (PreInit uniquement)
+    void SetAttenuatorFastSim(G4bool enable);
+    G4bool HasAttenuator() const { return fAttenuatorRegion != nullptr; }
+    G4double GetAttenuatorThickness() const { return fAttenuatorThickness; }
+    const G4String& GetAttenuatorMaterialName() const { return fAttenuatorMaterialName; }
 
 private:
 
@@ -66,7 +131,10 @@ private:
     // ═══════════════════════════════════════════════════════════════
     G4double fWaterThickness1;          // Première tranche : 2 mm (volume uniforme)
     G4double fWaterThickness2;          // Deuxième tranche : 1 mm (anneaux concentriques)
-    G4double fRingWidth;                // Largeur des anneaux : 5 mm
+    G4int fNbWaterRings;                // Nombre d'anneaux : 5 (/puits/geometry/rings)
+    G4double fRingWidth;                // Largeur des anneaux : 5 mm (fixée dans Construct)
+    G4double fRingWidthRequest;         // /puits/geometry/ringWidth (0 = rayon / nombre)
+    RingLayout fRingLayout;             // /puits/geometry/ringLayout
     
     // Masses des anneaux (calculées dans Construct())
     std::vector<G4double> fRingMasses;
@@ -88,12 +156,82 @@ private:
     // ═══════════════════════════════════════════════════════════════
     G4double fTungstenFoilThickness;    // Épaisseur feuille W : 50 µm
     G4double fTungstenFoilRadius;       // Rayon feuille W : 25 mm
+    G4bool fTungstenFoil;               // Feuille présente (/puits/geometry/tungstenFoil)
 
     // ═══════════════════════════════════════════════════════════════
     // PARAMÈTRES DE POSITIONNEMENT
     // ═══════════════════════════════════════════════════════════════
     G4double fSourceToWaterDistance;    // Distance source-eau : 25 mm
 
+    // ═══════════════════════════════════════════════════════════════
+    // MONDE ET ENVELOPPE (/puits/geometry/tightWorld, worldMargin)
+    // Par défaut : monde de 50 cm, enveloppe de 40 cm centrés à l'origine.
+    // Ajustés : enveloppe = boîte englobante des volumes placés et de la
+    // source + marge ; monde centré à l'origine (coordonnées globales
+    // inchangées) contenant l'enveloppe à 1 mm près.
+    // ═══════════════════════════════════════════════════════════════
+    G4bool fTightWorld;
+    G4double fWorldMargin;              // Marge autour de l'empilement : 10 mm
+    G4double fWorldHalfXY;
+    G4double fWorldHalfZ;
+    G4double fEnvelopeHalfXY;
+    G4double fEnvelopeHalfZ;
+    G4double fEnvelopeCenterZ;
+
+    // ═══════════════════════════════════════════════════════════════
+    // RÉDUCTION DE VARIANCE
+    // ═══════════════════════════════════════════════════════════════
+    G4bool fForceCollision;             // G4BOptrForceCollision sur les anneaux
+
+    // ═══════════════════════════════════════════════════════════════
+    // PLAQUE ATTÉNUATRICE
+    // Face aval contre le PreContainer, rayon du container
+    // ═══════════════════════════════════════════════════════════════
+    G4String fAttenuatorMaterialName;   // Matériau NIST ("none" : pas de plaque)
+    G4double fAttenuatorThickness;      // Épaisseur : 10 mm par défaut
+    G4bool fAttenuatorFastSim;          // AttenuatorFastModel sur la région de la plaque
+    G4Region* fAttenuatorRegion;        // Enveloppe du modèle rapide
+    G4LogicalVolume* fAttenuatorLogical;
+
+    // ═══════════════════════════════════════════════════════════════
+    // PLANS DE COMPTAGE ET LIMITES DE PAS
+    // ═══════════════════════════════════════════════════════════════
+    G4LogicalVolume* fPreContainerPlaneLogical;
+    G4LogicalVolume* fPostContainerPlaneLogical;
+    G4double fWaterMaxStep;             // Pas maximal dans l'eau : 0.1 mm (G4UserLimits)
+
+    // ═══════════════════════════════════════════════════════════════
+    // GDML (/puits/geometry/gdmlExport, /puits/geometry/gdmlImport)
+    // Étiquettes auxiliaires : Role (WaterRing, PreContainerPlane,
+    // PostContainerPlane, Attenuator) et StepLimit par volume logique ;
+    // paramètres de configuration dans <userinfo>
+    // ═══════════════════════════════════════════════════════════════
+    G4String fGdmlExportFile;           // Écrit à la fin de Construct() si non vide
+    G4String fGdmlImportFile;           // Remplace la construction si non vide
+
+    void DefineCommands();
+    void SetRingLayout(const G4String& name);
+    
+    /// Construit la couche d'anneaux (selon fRingLayout) et calcule les masses
+    void ConstructWaterRings(G4LogicalVolume* logicEnveloppe, G4double centerZ,
+                             G4UserLimits* waterLimits);
+    
+    /// Réduit l'enveloppe à la boîte englobante de ses filles et de la
+    /// source (+ fWorldMargin), puis le monde autour de l'enveloppe
+    void FitWorldToStack(G4LogicalVolume* logicEnveloppe, G4VPhysicalVolume* physEnveloppe,
+                         G4double sourceZ);
+    
+    /// Monde lu dans fGdmlImportFile (étiquettes auxiliaires -> anneaux, plans,
+    /// limites de pas, plaque, cône d'émission)
+    G4VPhysicalVolume* ConstructFromGdml();
+    
+    /// Écrit le monde construit et ses étiquettes dans fGdmlExportFile
+    void ExportGdml(const G4LogicalVolume* logicWorld, G4double sourceZ,
+                    G4double stackFrontZ, G4double stackRadius) const;
+    
+    G4GenericMessenger* fMessenger;
+    G4GenericMessenger* fAttenuatorMessenger;
+    G4GenericMessenger* fGeometryMessenger;
 };
 
 #endif
@@ -0,0 +1,91 @@
+#ifndef EmissionCone_h
+#define EmissionCone_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+class G4GenericMessenger;
+
+/// @brief Cône d'émission de la source et normalisation en angle solide
+///
+/// Singleton partagé par PrimaryGeneratorAction (tirage des directions) et
+/// RunAction (renormalisation temporelle) : les deux lisent le même demi-angle,
+/// la fraction d'angle solide f = (1 - cos θ) / 2 ne peut donc plus diverger.
+///
+/// Deux modes :
+/// - "fixed"    : demi-angle fixé par /puits/source/coneAngle (45° par défaut)
+/// - "geometry" : demi-angle sous-tendu par l'empilement, calculé à partir de
+///                la géométrie construite (position source, face avant de
+///                l'empilement, rayon cible + marge)
+///
+/// La position de la source et l'empilement sont fournis par
+/// DetectorConstruction::Construct().
+///
+/// Commandes : /puits/source/coneMode, coneAngle, coneMargin, targetRadius
+
+class EmissionCone
+{
+public:
+    static EmissionCone* GetInstance();
+
+    enum Mode { kFixed = 0, kGeometry };
+
+    /// Géométrie courante (appelé par DetectorConstruction::Construct)
+    void SetGeometry(G4double sourceZ, G4double stackFrontZ, G4double stackRadius);
+
+    /// Demi-angle effectif du cône d'émission
+    G4double GetHalfAngle() const;
+
+    /// Demi-angle pour une source placée en 'source' (balayage de positions) :
+    /// en mode "geometry", le cône couvre l'empilement malgré le décalage latéral
+    G4double GetHalfAngle(const G4ThreeVector& source) const;
+
+    /// Fraction de 4π couverte par le cône : (1 - cos θ) / 2
+    G4double GetSolidAngleFraction() const;
+
+    /// Tire une direction uniforme dans le cône (axe +z)
+    G4ThreeVector SampleDirection(G4double& theta, G4double& phi) const;
+    
+    /// Même tirage à partir de deux uniformes fournies (suite quasi-aléatoire)
+    G4ThreeVector SampleDirection(G4double uCosTheta, G4double uPhi,
+                                  G4double& theta, G4double& phi) const;
+
+    /// Mêmes tirages pour un demi-angle donné (cône d'une position de balayage)
+    G4ThreeVector SampleDirection(G4double halfAngle, G4double& theta, G4double& phi) const;
+    G4ThreeVector SampleDirection(G4double halfAngle, G4double uCosTheta, G4double uPhi,
+                                  G4double& theta, G4double& phi) const;
+
+    /// Début de run (maître) : avertit si targetRadius tronque le cône
+    void PrepareForRun() const;
+
+    G4ThreeVector GetSourcePosition() const { return G4ThreeVector(0., 0., fSourceZ); }
+    G4double GetStackFrontZ() const { return fStackFrontZ; }
+    Mode GetMode() const { return fMode; }
+    G4String GetModeName() const { return (fMode == kGeometry) ? "geometry" : "fixed"; }
+
+private:
+    EmissionCone();
+    ~EmissionCone();
+
+    EmissionCone(const EmissionCone&) = delete;
+    EmissionCone& operator=(const EmissionCone&) = delete;
+
+    void DefineCommands();
+    void SetModeByName(const G4String& name);
+
+    static EmissionCone* fInstance;
+
+    Mode fMode;
+    G4double fFixedAngle;       // Demi-angle en mode "fixed"
+    G4double fMargin;           // Marge radiale sur la face avant (mode "geometry")
+    G4double fTargetRadius;     // Rayon visé (0 = rayon complet de l'empilement)
+
+    // Géométrie (DetectorConstruction)
+    G4double fSourceZ;
+    G4double fStackFrontZ;
+    G4double fStackRadius;
+
+    G4GenericMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef Eu152Data_h
+#define Eu152Data_h 1
+
+/// @brief Table de référence des raies Eu-152 utilisées par la simulation
+///
+/// Source unique partagée par PrimaryGeneratorAction, EventAction et les
+/// outils d'analyse (puits_analyze) : les 13 raies (2 raies X + 11 gamma)
+/// avec leur énergie (keV), leur intensité (% par désintégration) et leur
+/// nom d'affichage. En C++ pur pour pouvoir être inclus hors Geant4.
+/// Source : NNDC/ENSDF.
+
+namespace Eu152
+{
+    constexpr int kNbLines = 13;
+
+    constexpr double kLineEnergies_keV[kNbLines] = {
+        39.52,    // 0: raie X
+        40.12,    // 1: raie X
+        121.78,   // 2
+        244.70,   // 3
+        344.28,   // 4
+        411.12,   // 5
+        443.97,   // 6
+        778.90,   // 7
+        867.38,   // 8
+        964.08,   // 9
+        1085.87,  // 10
+        1112.07,  // 11
+        1408.01   // 12
+    };
+
+    constexpr double kLineIntensities_pct[kNbLines] = {
+        20.8,
+        37.7,
+        28.41,
+        7.53,
+        26.59,
+        2.24,
+        2.83,
+        12.97,
+        4.24,
+        14.63,
+        10.21,
+        13.64,
+        21.01
+    };
+
+    constexpr const char* kLineNames[kNbLines] = {
+        "40 keV (X)",
+        "40 keV (X)",
+        "122 keV",
+        "245 keV",
+        "344 keV",
+        "411 keV",
+        "444 keV",
+        "779 keV",
+        "867 keV",
+        "964 keV",
+        "1086 keV",
+        "1112 keV",
+        "1408 keV"
+    };
+}
+
+#endif
@@ -3,13 +3,14 @@
 
 #include "G4UserEventAction.hh"
 #include "DetectorConstruction.hh"
+#include "PlaneSD.hh"
 #include "globals.hh"
 #include <vector>
-#include <map>
-#include <set>
+#include <utility>
 #include <array>
 
 class RunAction;
+class PrimaryGeneratorAction;
 class G4Event;
 
 /// @brief Gestion des événements avec suivi des primaires par raie gamma
@@ -20,11 +21,15 @@ class G4Event;
 /// - Suit leur passage dans les volumes de détection
 /// - Accumule les dépôts d'énergie par anneau d'eau
 /// - Identifie les raies gamma Eu-152 associées à chaque dépôt
+///
+/// Sans allocation en régime établi : les conteneurs par événement sont
+/// vidés (clear) sans libérer leur capacité, les noms sont rendus par
+/// référence.
 
 class EventAction : public G4UserEventAction
 {
 public:
-    EventAction(RunAction* runAction);
+    EventAction(RunAction* runAction, PrimaryGeneratorAction* generator);
     virtual ~EventAction();
     
     virtual void BeginOfEventAction(const G4Event*);
@@ -45,7 +50,7 @@ public:
     static G4double GetGammaLineEnergy(G4int lineIndex);
     
     /// Retourne le nom de la raie gamma
-    static G4String GetGammaLineName(G4int lineIndex);
+    static const G4String& GetGammaLineName(G4int lineIndex);
 
     // ═══════════════════════════════════════════════════════════════
     // CONSTANTES POUR LES PROCESSUS D'ABSORPTION
@@ -55,7 +60,7 @@ public:
     enum ProcessType { kPhotoelectric = 0, kCompton = 1, kPairProduction = 2, kOther = 3 };
     
     static G4int GetProcessIndex(const G4String& processName);
-    static G4String GetProcessName(G4int processIndex);
+    static const G4String& GetProcessName(G4int processIndex);
 
     // ═══════════════════════════════════════════════════════════════
     // ENREGISTREMENT DES PASSAGES (appelé par SteppingAction)
@@ -64,6 +69,10 @@ public:
     /// Enregistre un gamma primaire avec son vrai trackID (appelé au premier step)
     void RegisterPrimaryGamma(G4int trackID, G4double energy, G4double theta, G4double phi);
     
+    /// Associe au gamma primaire parent le clone créé par la collision forcée
+    /// (même photon, poids partagé) : raie, absorption et dépôts lui sont attribués
+    void RegisterPrimaryClone(G4int cloneTrackID, G4int parentTrackID);
+    
     /// Enregistre l'entrée d'un gamma primaire dans l'eau
     void RecordWaterEntry(G4int trackID, G4double energy);
     
@@ -76,8 +85,9 @@ public:
     /// Vérifie si un gamma primaire a déjà été compté comme entrant dans le container
     G4bool HasEnteredContainer(G4int trackID) const;
     
-    /// Enregistre l'absorption d'un gamma primaire
-    void RecordGammaAbsorbed(G4int trackID, const G4String& volumeName, const G4String& processName);
+    /// Enregistre l'absorption d'un gamma primaire (ou de son clone, avec son poids)
+    void RecordGammaAbsorbed(G4int trackID, const G4String& volumeName, const G4String& processName,
+                             G4double weight = 1.);
 
     // ═══════════════════════════════════════════════════════════════
     // DOSE DANS LES ANNEAUX D'EAU
@@ -89,6 +99,9 @@ public:
     /// Ajoute l'énergie déposée par raie gamma
     void AddRingEnergyByLine(G4int ringIndex, G4int lineIndex, G4double edep);
     
+    /// Ajoute la contribution kerma d'un pas de photon (w · E · ℓ · µen)
+    void AddRingKerma(G4int ringIndex, G4double kermaEnergy);
+    
     /// Retourne l'énergie déposée dans un anneau
     G4double GetRingEnergy(G4int ringIndex) const;
     
@@ -99,12 +112,9 @@ public:
     // COMPTAGES AUX PLANS CONTAINER
     // ═══════════════════════════════════════════════════════════════
     
-    void AddPreContainerPhoton(G4double energy);
-    void AddPreContainerElectron(G4double energy);
-    void AddPostContainerPhotonBack(G4double energy);
-    void AddPostContainerElectronBack(G4double energy);
-    void AddPostContainerPhotonFwd(G4double energy);
-    void AddPostContainerElectronFwd(G4double energy);
+    /// Traversée d'un plan (appelé par PlaneSD) : index PlaneSD::GetTallyIndex,
+    /// énergie cinétique à l'entrée, poids statistique (spectre du plan)
+    void AddPlaneCrossing(G4int tallyIndex, G4double energy, G4double weight);
 
     // ═══════════════════════════════════════════════════════════════
     // ACCESSEURS
@@ -123,6 +133,11 @@ public:
 
 private:
     RunAction* fRunAction;
+    PrimaryGeneratorAction* fGenerator;
+    
+    // Temps CPU du thread au début de l'événement (mode stratifié
+    // uniquement : coût par raie)
+    G4double fEventStartCPU_s;
     
     // ═══════════════════════════════════════════════════════════════
     // STRUCTURE POUR LES GAMMAS PRIMAIRES
@@ -136,41 +151,48 @@ private:
         G4double phi;
         G4bool enteredWater;
         G4bool absorbedInWater;
+        G4double absorbedWeight;   // Somme des poids absorbés dans l'eau (1 en analogue)
         G4int absorptionProcess;   // Index du processus d'absorption
     };
     
     std::vector<PrimaryGammaInfo> fPrimaryGammas;
-    std::map<G4int, size_t> fTrackIDtoIndex;  // trackID -> index dans fPrimaryGammas
     
-    // Sets pour éviter le double-comptage des entrées
-    std::set<G4int> fGammasEnteredWater;
-    std::set<G4int> fGammasEnteredContainer;
+    // trackID (primaire ou clone) -> index dans fPrimaryGammas ; quelques
+    // entrées par événement : recherche linéaire, sans nœud alloué
+    std::vector<std::pair<G4int, G4int>> fTrackIndex;
+    
+    /// Index du gamma primaire associé à ce trackID (-1 si aucun)
+    G4int FindPrimary(G4int trackID) const;
+    
+    // trackIDs déjà comptés, pour éviter le double-comptage des entrées
+    std::vector<G4int> fGammasEnteredWater;
+    std::vector<G4int> fGammasEnteredContainer;
 
     // ═══════════════════════════════════════════════════════════════
     // DÉPÔTS D'ÉNERGIE PAR ANNEAU
     // ═══════════════════════════════════════════════════════════════
     
-    std::array<G4double, DetectorConstruction::kNbWaterRings> fRingEnergyDeposit;
-    std::array<std::array<G4double, kNbGammaLines>, DetectorConstruction::kNbWaterRings> fRingEnergyByLine;
+    std::array<G4double, DetectorConstruction::kMaxWaterRings> fRingEnergyDeposit;
+    std::array<std::array<G4double, kNbGammaLines>, DetectorConstruction::kMaxWaterRings> fRingEnergyByLine;
+    
+    // Kerma par longueur de trace (équivalent en énergie, mode /puits/kerma/)
+    std::array<G4double, DetectorConstruction::kMaxWaterRings> fRingKermaEnergy;
 
     // ═══════════════════════════════════════════════════════════════
     // COMPTAGES AUX PLANS CONTAINER
     // ═══════════════════════════════════════════════════════════════
     
-    G4int fPreContainerNPhotons;
-    G4double fPreContainerSumEPhotons;
-    G4int fPreContainerNElectrons;
-    G4double fPreContainerSumEElectrons;
-    
-    G4int fPostContainerNPhotonsBack;
-    G4double fPostContainerSumEPhotonsBack;
-    G4int fPostContainerNElectronsBack;
-    G4double fPostContainerSumEElectronsBack;
+    // [plan][particule][sens], rempli par PlaneSD
+    struct PlaneTally {
+        G4int count = 0;
+        G4double sumEnergy = 0.;
+        G4double weightedCount = 0.;        // Σ poids des traces
+        G4double weightedEnergy = 0.;       // Σ poids × énergie
+    };
+    std::array<PlaneTally, PlaneSD::kNbTallies> fPlaneTallies;
     
-    G4int fPostContainerNPhotonsFwd;
-    G4double fPostContainerSumEPhotonsFwd;
-    G4int fPostContainerNElectronsFwd;
-    G4double fPostContainerSumEElectronsFwd;
+    const PlaneTally& GetPlaneTally(G4int plane, G4int particle, G4int direction) const
+    { return fPlaneTallies[PlaneSD::GetTallyIndex(plane, particle, direction)]; }
 
     G4int fVerboseLevel;
 };
@@ -0,0 +1,67 @@
+#ifndef JobServer_h
+#define JobServer_h 1
+
+#include "globals.hh"
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+/// @brief Mode serveur : file de jobs locale
+///
+/// Après une seule initialisation (géométrie, tables de physique), le
+/// serveur surveille un dossier et exécute les macros déposées (*.mac)
+/// l'une après l'autre, par ordre de nom :
+///   <dossier>/job.mac -> running/ -> done/ ou failed/
+///
+/// Un job est une macro d'état Idle : graine (/random/setSeeds), paramètres
+/// de source et de scoring, /run/beamOn N. Ses sorties vont par défaut dans
+/// <dossier>/results/<job>.root et .log (/puits/output/name pour changer).
+/// Les commandes PreInit (géométrie, physique) appartiennent à la macro
+/// d'initialisation du serveur : une géométrie par serveur. Un job qui en
+/// contient une, directement ou dans une macro appelée par /control/execute,
+/// est refusé avant exécution (failed/, motif dans server.log) ;
+/// /control/loop et /control/foreach sont refusés.
+///
+/// Avant chaque job, l'état réglable par un job (balayage, cône, strat,
+/// qmc, corr, kerma, cascade, réponse, stats, sorties, avancement, noyau de
+/// l'atténuateur) est remis aux valeurs par défaut, la sortie console à
+/// celle du démarrage du serveur, puis <dossier>/defaults.mac est rejoué
+/// s'il existe (réglages communs à tous les jobs) : un job n'hérite jamais
+/// du précédent.
+///
+/// Dépôt atomique : écrire job.mac.tmp puis renommer en job.mac.
+/// Arrêt : fichier <dossier>/STOP, ou SIGINT / SIGTERM (après le job en cours).
+/// Une ligne par job dans <dossier>/server.log : statut, durée d'exécution,
+/// attente dans la file et délai de rendu (dépôt -> résultats), à comparer
+/// au temps d'initialisation écrit au démarrage.
+
+class JobServer
+{
+public:
+    /// initTime_s : durée de l'initialisation (macro + /run/initialize), pour le journal
+    JobServer(const G4String& jobDirectory, G4double initTime_s);
+    ~JobServer();
+
+    /// Boucle de surveillance, rend la main à l'arrêt
+    void Run();
+
+private:
+    /// Macros en attente, par ordre de nom
+    std::vector<std::filesystem::path> PendingJobs() const;
+
+    /// Exécute les commandes du job ; false si le job contient une commande
+    /// PreInit (refusé en entier) ou à la première commande en échec
+    G4bool RunJob(const std::filesystem::path& jobFile, G4String& error);
+
+    /// Remise à zéro avant un job : valeurs par défaut puis defaults.mac
+    G4bool ResetState(G4String& error);
+
+    G4bool StopRequested() const;
+
+    std::filesystem::path fJobDirectory;
+    G4double fPollInterval_s;
+    G4double fInitTime_s;
+    G4bool fQuiet;                  // Sortie console au démarrage du serveur
+};
+
+#endif
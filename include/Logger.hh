@@ -3,12 +3,17 @@
 
 #include "globals.hh"
 #include <fstream>
+#include <ostream>
 #include <string>
 
 /// @brief Système de logging pour rediriger les diagnostics vers un fichier
 ///
 /// Singleton qui gère l'écriture des messages de diagnostic dans output.log
 /// Utilisation: Logger::GetInstance()->Log("message");
+///
+/// Une instance par thread (G4ThreadLocal) : en mode MT, chaque thread de
+/// travail écrit son propre fichier (<préfixe>_t<N>.log, ouvert par
+/// RunAction), sans verrou. Le mode silencieux est commun à tous les threads.
 
 class Logger
 {
@@ -47,6 +52,14 @@ public:
     /// Active/désactive l'écho sur la console
     void SetEchoToConsole(G4bool echo) { fEchoToConsole = echo; }
     G4bool GetEchoToConsole() const { return fEchoToConsole; }
+    
+    /// Mode silencieux : bannières console supprimées (option --quiet,
+    /// /puits/output/quiet), les résultats restent dans les fichiers
+    void SetQuiet(G4bool quiet) { fQuiet = quiet; }
+    G4bool IsQuiet() const { return fQuiet; }
+    
+    /// Flux des bannières : G4cout, ou flux muet en mode silencieux
+    std::ostream& Banner() { return fQuiet ? fNullStream : G4cout; }
 
 private:
     Logger();
@@ -56,11 +69,13 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     
-    static Logger* fInstance;
+    static G4ThreadLocal Logger* fInstance;
     std::ofstream fLogFile;
     G4bool fEnabled;
     G4bool fEchoToConsole;
+    static G4bool fQuiet;       // partagé : fixé avant le démarrage des threads
     G4String fFilename;
+    std::ostream fNullStream;   // sans tampon : toute écriture est ignorée
 };
 
 // Macro pour simplifier l'utilisation
@@ -1,14 +1,54 @@
 #ifndef PHYSICSLIST_HH
 #define PHYSICSLIST_HH
 
-#include "FTFP_BERT.hh"
+#include "G4VModularPhysicsList.hh"
 
-class PhysicsList : public FTFP_BERT {
+class G4GenericBiasingPhysics;
+class G4FastSimulationPhysics;
+class G4GenericMessenger;
+
+/// Liste de physique réduite : EM seule (photons et électrons de quelques
+/// keV à 1,4 MeV), Step Limiter et biaisage optionnel. Les constructeurs
+/// EM créent eux-mêmes les particules nécessaires ; aucune table hadronique
+/// n'est construite.
+///
+/// Commandes (état PreInit) :
+///   /puits/physics/em livermore|penelope|option4
+///   /puits/physics/hadronic true   (référence : constructeurs de FTFP_BERT)
+class PhysicsList : public G4VModularPhysicsList {
 public:
   PhysicsList();
-  ~PhysicsList() override = default;
+  ~PhysicsList() override;
 
   void SetCuts() override;
+
+  /// Enregistre G4GenericBiasingPhysics pour les gammas (collision forcée).
+  /// À appeler avant /run/initialize (état PreInit).
+  void EnableForcedCollision();
+  G4bool IsForcedCollisionEnabled() const { return fBiasingPhysics != nullptr; }
+
+  /// Enregistre G4FastSimulationPhysics pour les gammas (plaque atténuatrice).
+  /// À appeler avant /run/initialize (état PreInit).
+  void EnableFastSimulation();
+  G4bool IsFastSimulationEnabled() const { return fFastSimulationPhysics != nullptr; }
+
+  /// Remplace la physique EM (livermore, penelope, option4)
+  void SelectEmPhysics(const G4String& name);
+  const G4String& GetEmPhysicsName() const { return fEmName; }
+
+  /// Ajoute les constructeurs hadroniques et de décroissance de FTFP_BERT
+  /// (liste de référence pour la validation)
+  void EnableHadronicPhysics();
+  G4bool IsHadronicEnabled() const { return fHadronic; }
+
+private:
+  void DefineCommands();
+
+  G4GenericBiasingPhysics* fBiasingPhysics = nullptr;  // possédé par la liste modulaire
+  G4FastSimulationPhysics* fFastSimulationPhysics = nullptr;
+  G4String fEmName = "livermore";
+  G4bool fHadronic = false;
+  G4GenericMessenger* fMessenger = nullptr;
 };
 
 #endif
@@ -0,0 +1,52 @@
+#ifndef PlaneSD_h
+#define PlaneSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+#include "globals.hh"
+
+class EventAction;
+
+/// @brief Courant de surface à l'entrée d'un plan de comptage
+///
+/// Détecteur sensible attaché aux volumes PreContainerPlaneLog et
+/// PostContainerPlaneLog. Seul le premier pas dans le plan (point pré-pas
+/// sur la frontière) est compté : c'est une traversée de la face d'entrée.
+/// Un filtre G4SDParticleFilter ne laisse passer que les photons et les
+/// électrons ; le sens de traversée (+z ou -z) est donné par la direction
+/// au point d'entrée. Chaque traversée est ajoutée au tableau de comptage
+/// de l'événement (EventAction) et au spectre en énergie du plan, pondéré
+/// par le poids statistique de la trace.
+///
+/// Ces comptages ne coûtent rien aux pas hors des plans : Geant4 n'appelle
+/// le détecteur que pour les pas dans les volumes sensibles.
+
+class PlaneSD : public G4VSensitiveDetector
+{
+public:
+    enum Plane { kPreContainer = 0, kPostContainer = 1, kNbPlanes = 2 };
+    enum Particle { kPhoton = 0, kElectron = 1, kNbParticles = 2 };
+    enum Direction { kForward = 0, kBackward = 1, kNbDirections = 2 };   // +z, -z
+
+    static const G4int kNbTallies = kNbPlanes * kNbParticles * kNbDirections;
+
+    /// Index dans le tableau de comptage [plan][particule][sens]
+    static G4int GetTallyIndex(G4int plane, G4int particle, G4int direction)
+    { return (plane * kNbParticles + particle) * kNbDirections + direction; }
+
+    /// Nom court d'un comptage (ex. « pre_photon_fwd »)
+    static G4String GetTallyName(G4int tallyIndex);
+
+    PlaneSD(const G4String& name, Plane plane);
+    ~PlaneSD() override = default;
+
+    void Initialize(G4HCofThisEvent*) override;
+    G4bool ProcessHits(G4Step* step, G4TouchableHistory*) override;
+
+private:
+    Plane fPlane;
+    EventAction* fEventAction;   // action d'événement du thread (relue à chaque événement)
+    G4bool fVerbose;             // traces coupées par --quiet (/puits/output/quiet)
+    G4int fVerboseMaxEvents;     // traces dans output.log pour les premiers événements
+};
+
+#endif
@@ -4,16 +4,28 @@
 #include "G4VUserPrimaryGeneratorAction.hh"
 #include "G4ParticleGun.hh"
 #include "G4ThreeVector.hh"
+#include "SobolSequence.hh"
 #include "globals.hh"
+#include <array>
 #include <vector>
 
 class G4ParticleGun;
 class G4Event;
+class StratifiedSampler;
 
 /// @brief Génération des particules primaires selon le spectre Eu-152
 ///
 /// Cette classe génère des gammas selon le spectre de l'Europium-152.
 /// Plusieurs gammas peuvent être émis par événement (désintégration).
+/// En mode stratifié (/puits/strat/enable), un seul gamma pondéré par
+/// événement, la raie étant tirée par StratifiedSampler.
+/// Option QMC (/puits/qmc/enable) : raie et direction tirées dans une suite
+/// de Sobol brouillée au lieu du flux pseudo-aléatoire.
+/// Mode cascades (/puits/cascade/enable) : une désintégration complète tirée
+/// dans CascadeLibrary (gammas, X, électrons corrélés) au lieu des raies
+/// indépendantes ; stratification et QMC n'y sont pas appliquées.
+/// Balayage (/puits/scan/) : la position de la source et le cône changent
+/// d'un événement à l'autre (SourceScan), dans tous les modes.
 /// Les informations sont stockées automatiquement dans G4Event et
 /// récupérées par EventAction::BeginOfEventAction().
 
@@ -31,23 +43,47 @@ public:
     // ACCESSEURS POUR DIAGNOSTIC
     // ═══════════════════════════════════════════════════════════════
     G4int GetLastEventGammaCount() const { return fLastEventGammaCount; }
+    
+    /// Raie tirée au dernier événement en mode stratifié (-1 sinon)
+    G4int GetLastEventLine() const { return fLastEventLine; }
+    
+    /// Poids source du dernier événement (p/q en mode stratifié, 1 sinon)
+    G4double GetLastEventWeight() const { return fLastEventWeight; }
+    
+    /// Désintégrations tirées pour le dernier événement (mode cascades : les
+    /// désintégrations sans particule dans le cône sont passées ; 1 sinon)
+    G4long GetLastEventDecays() const { return fLastEventDecays; }
+    
+    /// Position de source du dernier événement (/puits/scan/ ; -1 sans balayage)
+    G4int GetLastEventPosition() const { return fLastEventPosition; }
+    
+    StratifiedSampler* GetStratifiedSampler() const { return fSampler; }
 
     // Accès au spectre (pour vérification)
     const std::vector<G4double>& GetGammaEnergies() const { return fGammaEnergies; }
     const std::vector<G4double>& GetGammaProbabilities() const { return fGammaProbabilities; }
     
     // ═══════════════════════════════════════════════════════════════
-    // ACCESSEURS ET MODIFICATEURS POUR LE CÔNE D'ÉMISSION
+    // CÔNE D'ÉMISSION : partagé avec RunAction via EmissionCone
     // ═══════════════════════════════════════════════════════════════
-    void SetConeAngle(G4double angle) { fConeAngle = angle; }
-    G4double GetConeAngle() const { return fConeAngle; }
+    G4double GetConeAngle() const;
     
     /// @brief Retourne le nombre moyen de gammas par désintégration Eu-152
     /// Valeur arrondie de la somme des 13 intensités (202.78% ≈ 203%)
     static G4double GetMeanGammasPerDecay() { return 2.03; }
     
 private:
+    /// Point suivant de la suite de Sobol si /puits/qmc/enable (false sinon)
+    G4bool NextSourcePoint(std::array<G4double, SobolSequence::kNbDimensions>& u);
+    
+    /// Mode cascades : émet la prochaine désintégration ayant au moins une
+    /// particule dans le cône (toutes si coneOnly est désactivé)
+    void GenerateCascade(G4Event* anEvent, const G4ThreeVector& sourcePosition, G4double halfAngle);
+    
     G4ParticleGun* fParticleGun;
+    StratifiedSampler* fSampler;
+    SobolSequence* fSobol;
+    G4int fSobolRunID;            // Run du dernier brouillage
 
     // ═══════════════════════════════════════════════════════════════
     // SPECTRE GAMMA Europium-152
@@ -60,20 +96,11 @@ private:
     // COMPTEUR POUR LE DERNIER ÉVÉNEMENT
     // ═══════════════════════════════════════════════════════════════
     G4int fLastEventGammaCount;
+    G4int fLastEventLine;
+    G4double fLastEventWeight;
+    G4long fLastEventDecays;
+    G4int fLastEventPosition;
 
-    // ═══════════════════════════════════════════════════════════════
-    // PARAMÈTRES DE LA SOURCE
-    // ═══════════════════════════════════════════════════════════════
-    G4double fConeAngle;        // Demi-angle du cône d'émission
-    G4ThreeVector fSourcePosition;  // Position de la source
-
-    // ═══════════════════════════════════════════════════════════════
-    // MÉTHODE POUR GÉNÉRER UNE DIRECTION DANS LE CÔNE
-    // ═══════════════════════════════════════════════════════════════
-    void GenerateDirectionInCone(G4double coneAngle,
-                                 G4double& theta,
-                                 G4double& phi,
-                                 G4ThreeVector& direction);
 };
 
 #endif
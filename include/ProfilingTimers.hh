@@ -0,0 +1,126 @@
+#ifndef ProfilingTimers_h
+#define ProfilingTimers_h 1
+
+#include "globals.hh"
+#include <array>
+#include <mutex>
+#include <ostream>
+
+class G4GenericMessenger;
+
+/// @brief Temps passé dans les actions utilisateur par rapport au transport
+///
+/// Singleton. Avec l'option CMake PUITS_PROFILING, des minuteries de portée
+/// (TSC sur x86, steady_clock ailleurs) entourent chaque action utilisateur
+/// et les remplissages G4AnalysisManager. Le temps est compté en exclusif :
+/// une portée imbriquée (remplissage d'histogramme dans SteppingAction) est
+/// retirée de la portée englobante. La portée « transport » va du début de
+/// GeneratePrimaries à la fin de EndOfEventAction : son temps propre est
+/// celui de Geant4 (navigation, physique, pile de traces).
+///
+/// Par thread : nombre d'appels, temps inclusif et propre, histogramme en
+/// log2(ns) du temps propre par appel. Le maître fusionne en fin de run et
+/// écrit un tableau de répartition et la section "profiling" du JSON.
+///
+/// /puits/profile/hardware lit en plus cycles, instructions et défauts de
+/// cache (perf_event_open, Linux) à chaque portée : coût d'un appel système
+/// par portée, pour comparer les sections entre elles seulement.
+/// Sans l'option, les portées sont vides et ne coûtent rien.
+
+class ProfilingTimers
+{
+public:
+    static ProfilingTimers* GetInstance();
+
+    enum Section {
+        kTransport = 0,
+        kGeneratePrimaries,
+        kBeginOfEvent,
+        kEndOfEvent,
+        kStepping,
+        kSensitiveDetector,
+        kHistogramFill,
+        kNtupleFill,
+        kDoseStatistics,
+        kNbSections
+    };
+
+    static const G4int kNbHistogramBins = 40;   // bin b : [2^(b-1), 2^b[ ns
+    static const G4int kNbHardwareCounters = 3; // cycles, instructions, défauts de cache
+
+    /// Minuteries compilées (option PUITS_PROFILING)
+    static G4bool IsCompiled();
+
+    /// Portée d'une section sur le thread courant (imbricable)
+    static void Enter(Section section);
+    static void Leave();
+
+    /// Début d'événement (ouvre la portée transport) ; fin d'événement
+    /// (la portée transport se ferme avec la dernière portée ouverte)
+    static void BeginEvent();
+    static void EndOfEvent();
+
+    /// Ajoute les compteurs du thread courant au run (fin de run, chaque thread)
+    void FlushThread();
+
+    /// Tableau de répartition du run (maître), puis remise à zéro
+    void Report(std::ostream& os);
+
+    /// Section "profiling" du JSON de résultats (dernier run rapporté)
+    void WriteJson(std::ostream& os) const;
+
+    class ScopeGuard
+    {
+    public:
+        explicit ScopeGuard(Section section) { Enter(section); }
+        ~ScopeGuard() { Leave(); }
+        ScopeGuard(const ScopeGuard&) = delete;
+        ScopeGuard& operator=(const ScopeGuard&) = delete;
+    };
+
+private:
+    ProfilingTimers();
+    ~ProfilingTimers();
+
+    ProfilingTimers(const ProfilingTimers&) = delete;
+    ProfilingTimers& operator=(const ProfilingTimers&) = delete;
+
+    void DefineCommands();
+
+    struct Totals
+    {
+        std::array<G4long, kNbSections> calls {};
+        std::array<G4double, kNbSections> inclusiveNs {};
+        std::array<G4double, kNbSections> selfNs {};
+        std::array<std::array<G4long, kNbHistogramBins>, kNbSections> histogram {};
+        std::array<std::array<G4double, kNbHardwareCounters>, kNbSections> hardware {};
+        G4bool hardwareValid = false;
+    };
+
+    /// Borne supérieure (ns) du quantile q du temps propre par appel
+    static G4double Quantile(const std::array<G4long, kNbHistogramBins>& histogram, G4double q);
+
+    static ProfilingTimers* fInstance;
+    static G4double fNsPerTick;         // étalonné une fois (TSC invariant)
+
+    std::mutex fMutex;                  // fusion des threads en fin de run
+    Totals fTotals;
+    Totals fLastRun;
+
+    G4bool fHardware;
+
+    G4GenericMessenger* fMessenger;
+};
+
+#ifdef PUITS_PROFILING
+#define PUITS_PROFILE_SCOPE(section) \
+    ProfilingTimers::ScopeGuard puitsProfileScope(ProfilingTimers::section)
+#define PUITS_PROFILE_BEGIN_EVENT() ProfilingTimers::BeginEvent()
+#define PUITS_PROFILE_END_OF_EVENT() ProfilingTimers::EndOfEvent()
+#else
+#define PUITS_PROFILE_SCOPE(section)
+#define PUITS_PROFILE_BEGIN_EVENT()
+#define PUITS_PROFILE_END_OF_EVENT()
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef ProgressReporter_h
+#define ProgressReporter_h 1
+
+#include "RingDoseStatistics.hh"
+#include "globals.hh"
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class G4GenericMessenger;
+
+/// @brief Rapport d'avancement périodique (console + fichier JSON-lines)
+///
+/// Singleton. Un thread de fond se réveille toutes les N secondes et
+/// affiche : événements traités, événements/s, ETA, dose et erreur
+/// relative par anneau, mémoire résidente. La boucle d'événements ne
+/// fait que publier périodiquement une copie de ses statistiques
+/// (PublishInterval événements), sans horloge ni verrou par événement.
+/// Fonctionne en séquentiel (un seul emplacement) comme en MT (un
+/// emplacement par thread de travail).
+///
+/// Commandes : /puits/progress/interval, /puits/progress/heartbeatFile
+
+class ProgressReporter
+{
+public:
+    static ProgressReporter* GetInstance();
+
+    /// Nombre d'événements entre deux publications d'un thread
+    static const G4int kPublishInterval = 1024;
+
+    /// Réserve un emplacement de publication (un par RunAction)
+    G4int RegisterSlot();
+
+    /// Publie l'état courant d'un thread (copie sous verrou de l'emplacement)
+    void Publish(G4int slot, const RingDoseStatistics& stats);
+
+    /// Démarre / arrête le thread de rapport (appelé par le RunAction maître)
+    void Start(G4int runID, G4long eventsToProcess);
+    void Stop();
+
+    G4bool IsEnabled() const { return fInterval > 0.; }
+
+    /// Mémoire résidente du processus (MB), 0 si indisponible
+    static G4double GetResidentMemoryMB();
+
+private:
+    ProgressReporter();
+    ~ProgressReporter();
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    void DefineCommands();
+    void Loop();
+    void Report(G4bool finalReport);
+
+    struct Slot {
+        std::mutex mutex;
+        std::unique_ptr<RingDoseStatistics> stats;
+    };
+
+    static ProgressReporter* fInstance;
+
+    std::mutex fSlotsMutex;
+    std::vector<std::unique_ptr<Slot>> fSlots;
+
+    // Thread de fond
+    std::thread fThread;
+    std::mutex fWakeMutex;
+    std::condition_variable fWake;
+    G4bool fStopRequested;
+
+    // État du run
+    G4int fRunID;
+    G4long fEventsToProcess;
+    std::chrono::steady_clock::time_point fStartTime;
+    std::chrono::steady_clock::time_point fLastTime;
+    G4long fLastEvents;
+
+    // Configuration
+    G4double fInterval;             // Période (s), 0 = désactivé
+    G4String fHeartbeatFileName;    // Fichier JSON-lines ("" = aucun)
+    std::ofstream fHeartbeat;
+
+    G4GenericMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef QmcSampling_h
+#define QmcSampling_h 1
+
+#include "globals.hh"
+#include <ostream>
+#include <vector>
+
+class G4GenericMessenger;
+
+/// @brief Option quasi-Monte Carlo de la source et étude de gain
+///
+/// Singleton. Quand l'option est active, PrimaryGeneratorAction tire la
+/// raie (mode stratifié), cos θ et φ dans une suite de Sobol brouillée
+/// (SobolSequence, un nouveau brouillage par run) au lieu du flux
+/// pseudo-aléatoire ; le transport n'est pas modifié.
+///
+/// Les événements d'un run QMC ne sont plus indépendants : l'erreur par
+/// événement (Welford) n'a plus de sens. Le mode étude traite chaque run
+/// comme une réplique : les moyennes par anneau et le temps CPU sont
+/// conservés séparément pour les runs QMC et pseudo-aléatoires, et la
+/// dispersion entre répliques donne la FOM de chaque générateur et le gain.
+///
+/// Commandes : /puits/qmc/enable, study, resetStudy
+
+class QmcSampling
+{
+public:
+    static QmcSampling* GetInstance();
+
+    G4bool IsEnabled() const { return fEnabled; }
+    G4bool IsStudyEnabled() const { return fStudy; }
+
+    /// Ajoute une réplique (dose moyenne par anneau, temps CPU) au générateur courant
+    void RecordReplicate(const std::vector<G4double>& ringMeans, G4double cpuTime_s);
+
+    /// Tableau FOM par anneau : pseudo-aléatoire, QMC et gain
+    void PrintStudy(std::ostream& os) const;
+
+private:
+    QmcSampling();
+    ~QmcSampling();
+
+    QmcSampling(const QmcSampling&) = delete;
+    QmcSampling& operator=(const QmcSampling&) = delete;
+
+    void DefineCommands();
+    void ResetStudy();
+
+    /// FOM = 1 / (R² · T) d'un générateur pour un anneau (0 si < 2 répliques)
+    G4double ComputeFOM(G4int mode, G4int ring, G4double& relError) const;
+
+    static QmcSampling* fInstance;
+
+    G4bool fEnabled;
+    G4bool fStudy;
+
+    // Répliques par générateur : [0] pseudo-aléatoire, [1] QMC
+    std::vector<std::vector<G4double>> fReplicateMeans[2];
+    std::vector<G4double> fReplicateTimes[2];
+
+    G4GenericMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef ResponseMatrix_h
+#define ResponseMatrix_h 1
+
+#include "globals.hh"
+#include <vector>
+
+class G4GenericMessenger;
+
+/// @brief Mode matrice de réponse : un sous-run monoénergétique par raie
+///
+/// Singleton. Quand une énergie est fixée (/puits/response/energy ou
+/// /puits/response/line), PrimaryGeneratorAction émet UN photon de cette
+/// énergie par événement dans le cône d'émission, et RunAction (maître)
+/// ajoute en fin de run une ligne au fichier de réponse : dose par anneau,
+/// comptages aux plans et fractions d'entrée/absorption dans l'eau, tous
+/// par photon émis dans le cône.
+///
+/// Le fichier est identifié par un hachage de la géométrie construite : une
+/// ligne déjà présente pour la même énergie est remplacée, un fichier d'une
+/// autre géométrie est réécrit. L'outil puits_fold combine ensuite les
+/// lignes avec n'importe quelle table d'intensités.
+///
+/// Commandes : /puits/response/energy, line, off, file
+
+class ResponseMatrix
+{
+public:
+    static ResponseMatrix* GetInstance();
+
+    /// Résultat d'un sous-run monoénergétique (grandeurs par photon émis)
+    struct Row {
+        G4double energy_keV = 0.;
+        G4long nPhotons = 0;
+        G4double coneFraction = 0.;
+        std::vector<G4double> dose_nGy;         // dose moyenne par photon, par anneau
+        std::vector<G4double> doseSem_nGy;      // erreur standard associée
+        G4double prePhotons = 0.;               // photons traversant PreContainer (+z)
+        G4double postPhotonsFwd = 0.;           // photons traversant PostContainer (+z)
+        G4double enteredWater = 0.;             // fraction entrant dans les anneaux
+        G4double absorbedWater = 0.;            // fraction absorbée dans l'eau
+    };
+
+    G4bool IsEnabled() const { return fEnergy > 0.; }
+    G4double GetEnergy() const { return fEnergy; }
+
+    /// Ajoute (ou remplace) la ligne du sous-run dans le fichier de réponse
+    void Record(const Row& row);
+
+    /// Hachage FNV-1a 64 bits de la géométrie construite (volumes, matériaux,
+    /// positions, dimensions des solides) et du cône d'émission
+    static G4String ComputeGeometryHash();
+
+private:
+    ResponseMatrix();
+    ~ResponseMatrix();
+
+    ResponseMatrix(const ResponseMatrix&) = delete;
+    ResponseMatrix& operator=(const ResponseMatrix&) = delete;
+
+    void DefineCommands();
+    void SetLine(G4int lineIndex);
+    void Disable();
+
+    static ResponseMatrix* fInstance;
+
+    G4double fEnergy;           // Énergie du sous-run (0 = spectre Eu-152 complet)
+    G4String fFileName;         // "" = response_<hash>.csv
+
+    G4GenericMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef RingDoseStatistics_h
+#define RingDoseStatistics_h 1
+
+#include "G4VAccumulable.hh"
+#include "globals.hh"
+#include <vector>
+
+/// @brief Statistiques en ligne de la dose par anneau
+///
+/// Accumulateur numériquement stable (algorithme de Welford) de la dose
+/// par événement dans chaque anneau, TOUS les événements étant comptés
+/// (y compris ceux sans dépôt). En parallèle, les événements sont groupés
+/// en lots de taille fixe : la dispersion des moyennes de lots donne une
+/// erreur standard robuste aux corrélations entre événements.
+///
+/// Dérive de G4VAccumulable : la fusion des threads (mode MT) se fait
+/// par la formule parallèle de Chan et al.
+
+class RingDoseStatistics : public G4VAccumulable
+{
+public:
+    /// Résultat pour un anneau
+    struct Summary {
+        G4double mean;            // Dose moyenne par événement
+        G4double sigmaMean;       // Erreur standard retenue
+        G4double sigmaWelford;    // Erreur standard événement par événement
+        G4double sigmaBatch;      // Erreur standard des moyennes de lots (0 si < 2 lots)
+        G4double relError;        // sigmaMean / mean
+        G4double fom;             // 1 / (relError² · T)
+        G4int nBatches;           // Nombre de lots complets
+    };
+
+    RingDoseStatistics(const G4String& name, G4int nRings, G4int batchSize = 10000);
+    virtual ~RingDoseStatistics() = default;
+
+    /// Ajoute un événement : une valeur par anneau (values[0..nRings-1])
+    void Fill(const G4double* values);
+
+    virtual void Merge(const G4VAccumulable& other);
+    virtual void Reset();
+
+    /// Taille des lots (ne modifier qu'entre deux runs)
+    void SetBatchSize(G4int batchSize);
+    G4int GetBatchSize() const { return fBatchSize; }
+
+    /// Nombre d'anneaux (géométrie du run ; remet à zéro s'il change)
+    void SetNbRings(G4int nRings);
+    G4int GetNbRings() const { return fNbRings; }
+    G4long GetNbEvents() const { return fNbEvents; }
+
+    /// Nombre minimal de lots pour préférer l'erreur par lots à Welford
+    static const G4int kMinBatches = 10;
+
+    /// Calcule le résumé d'un anneau pour un temps de calcul T (s)
+    Summary GetSummary(G4int ring, G4double time_s) const;
+
+private:
+    struct Welford {
+        G4long n = 0;
+        G4double mean = 0.;
+        G4double m2 = 0.;
+
+        void Add(G4double x);
+        void Merge(const Welford& other);
+        G4double Variance() const { return (n > 1) ? m2 / (n - 1) : 0.; }
+    };
+
+    G4int fNbRings;
+    G4int fBatchSize;
+    G4long fNbEvents;
+
+    std::vector<Welford> fEvent;       // Welford sur les valeurs par événement
+    std::vector<Welford> fBatch;       // Welford sur les moyennes de lots
+    std::vector<G4double> fBatchSum;   // Somme du lot en cours
+    G4int fEventsInBatch;
+};
+
+#endif
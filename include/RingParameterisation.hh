@@ -0,0 +1,32 @@
+#ifndef RingParameterisation_h
+#define RingParameterisation_h 1
+
+#include "G4VPVParameterisation.hh"
+#include "globals.hh"
+
+class G4VPhysicalVolume;
+class G4Tubs;
+
+/// @brief Anneaux d'eau concentriques d'un G4PVParameterised
+///
+/// La copie i est le tube [i·w, (i+1)·w] centré dans le tube conteneur
+/// WaterRingLayer : le numéro de copie est l'index de l'anneau.
+
+class RingParameterisation : public G4VPVParameterisation
+{
+public:
+    RingParameterisation(G4double ringWidth, G4double halfThickness);
+    ~RingParameterisation() override = default;
+
+    void ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* physVol) const override;
+
+    using G4VPVParameterisation::ComputeDimensions;
+    void ComputeDimensions(G4Tubs& ring, const G4int copyNo,
+                           const G4VPhysicalVolume* physVol) const override;
+
+private:
+    G4double fRingWidth;
+    G4double fHalfThickness;
+};
+
+#endif
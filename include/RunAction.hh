@@ -4,11 +4,18 @@
 #include "G4UserRunAction.hh"
 #include "DetectorConstruction.hh"
 #include "EventAction.hh"
+#include "RingDoseStatistics.hh"
+#include "RunCounters.hh"
+#include "ScanTallies.hh"
 #include "globals.hh"
 #include <array>
+#include <chrono>
+#include <ctime>
+#include <ostream>
 #include <vector>
 
 class G4Run;
+class G4GenericMessenger;
 
 /// @brief Gestion du run avec sortie ROOT et statistiques de dose
 /// VERSION SANS FILTRE - Avec output ROOT
@@ -18,6 +25,8 @@ class G4Run;
 /// - Le calcul des débits de dose
 /// - La création et remplissage des histogrammes ROOT
 /// - Les statistiques par raie gamma Eu-152
+/// - Les incertitudes en ligne sur la dose par anneau (RingDoseStatistics)
+/// - Les résultats par position de source en balayage (ScanTallies)
 
 class RunAction : public G4UserRunAction
 {
@@ -27,7 +36,7 @@ public:
     
     virtual void BeginOfRunAction(const G4Run*);
     virtual void EndOfRunAction(const G4Run*);
-
+    
     // ═══════════════════════════════════════════════════════════════
     // MÉTHODES POUR REMPLIR LES HISTOGRAMMES ROOT
     // (appelées depuis SteppingAction ou EventAction)
@@ -35,14 +44,16 @@ public:
     
     void FillGammaEmittedSpectrum(G4double energy_keV);
     void FillGammaEnteringWater(G4double energy_keV);
-    void FillEdepWater(G4double edep_keV);
-    void FillEdepRing(G4int ringID, G4double edep_keV);
-    void FillElectronSpectrum(G4double energy_keV);
+    void FillEdepWater(G4double edep_keV, G4double weight = 1.0);
+    void FillEdepRing(G4int ringID, G4double edep_keV, G4double weight = 1.0);
+    void FillElectronSpectrum(G4double energy_keV, G4double weight = 1.0);
+    void FillPlaneSpectrum(G4int tallyIndex, G4double energy_keV, G4double weight = 1.0);
     void FillEdepXY(G4double x_mm, G4double y_mm, G4double weight = 1.0);
     void FillEdepRZ(G4double r_mm, G4double z_mm, G4double weight = 1.0);
     void FillStepNtuple(G4int eventID, G4double x, G4double y, G4double z, 
                         G4double edep, G4int ringID, 
-                        const G4String& particleName, const G4String& processName);
+                        const G4String& particleName, const G4String& processName,
+                        G4double weight = 1.0);
 
     // ═══════════════════════════════════════════════════════════════
     // MÉTHODES POUR REMPLIR LES NTUPLES PRECONTAINER/POSTCONTAINER
@@ -59,7 +70,7 @@ public:
                                   G4int nElectrons_back, G4double sumEElectrons_back_keV);
     
     void FillDosesNtuple(G4int eventID,
-                          const std::array<G4double, DetectorConstruction::kNbWaterRings>& ringDeposits,
+                          const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringDeposits,
                           G4double totalDeposit,
                           G4int nPrimaries, G4int nTransmitted, G4int nAbsorbed);
 
@@ -80,38 +91,65 @@ public:
     /// Ajoute l'énergie déposée dans un anneau
     void AddRingEnergy(G4int ringIndex, G4double edep);
     
+    /// Enregistre la dose de l'événement dans chaque anneau (appelé pour
+    /// TOUS les événements, y compris sans dépôt)
+    void RecordRingDoses(const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringDeposits);
+    
+    /// Kerma par longueur de trace de l'événement (équivalent énergie par anneau)
+    void RecordRingKerma(const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringKerma);
+    
     /// Ajoute l'énergie déposée par raie gamma
     void AddRingEnergyByLine(G4int ringIndex, G4int lineIndex, G4double edep);
     
-    /// Enregistre les statistiques par raie gamma
+    /// Enregistre les statistiques par raie gamma (absorbedWeight : poids
+    /// statistique absorbé dans l'eau, égal à 0 ou 1 en transport analogue)
     void RecordGammaLineStatistics(G4int lineIndex, G4bool enteredWater, 
-                                    G4bool absorbedInWater, G4int absorptionProcess);
+                                    G4bool absorbedInWater, G4int absorptionProcess,
+                                    G4double absorbedWeight);
     
     /// Enregistre les statistiques globales de l'événement
     void RecordEventStatistics(G4int nPrimaries, 
-                               const std::vector<G4double>& primaryEnergies,
                                G4int nTransmitted, G4int nAbsorbed,
                                G4double totalDeposit,
-                               const std::array<G4double, DetectorConstruction::kNbWaterRings>& ringDeposits);
+                               const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringDeposits);
+    
+    /// Ajoute un comptage de plan de l'événement (index PlaneSD::GetTallyIndex) :
+    /// traversées et énergie bruts, puis pondérés par le poids des traces
+    void AddPlaneTally(G4int tallyIndex, G4int count, G4double sumEnergy,
+                       G4double weightedCount, G4double weightedEnergy);
+    
+    // ═══════════════════════════════════════════════════════════════
+    // BALAYAGE DE POSITIONS (appelées par EventAction si /puits/scan/)
+    // ═══════════════════════════════════════════════════════════════
+    
+    /// Dose par anneau et désintégrations de l'événement, à sa position
+    void RecordScanEvent(G4int position,
+                         const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringDeposits,
+                         G4long decays);
+    
+    void RecordScanLine(G4int position, G4int lineIndex, G4bool enteredWater,
+                        G4bool absorbedInWater, G4double absorbedWeight) {
+        fScanTallies.AddLine(position, lineIndex, enteredWater, absorbedInWater, absorbedWeight);
+    }
     
-    /// Enregistre les comptages aux plans container
-    void RecordContainerPlaneStatistics(
-        G4int preNPhotons, G4double preSumEPhotons,
-        G4int preNElectrons, G4double preSumEElectrons,
-        G4int postNPhotonsBack, G4double postSumEPhotonsBack,
-        G4int postNElectronsBack, G4double postSumEElectronsBack,
-        G4int postNPhotonsFwd, G4double postSumEPhotonsFwd,
-        G4int postNElectronsFwd, G4double postSumEElectronsFwd);
+    void AddScanPlaneTally(G4int position, G4int tallyIndex, G4int count, G4double sumEnergy,
+                           G4double weightedCount, G4double weightedEnergy) {
+        fScanTallies.AddPlane(position, tallyIndex, count, sumEnergy, weightedCount, weightedEnergy);
+    }
 
     // ═══════════════════════════════════════════════════════════════
     // COMPTEURS DE VÉRIFICATION (appelées par SteppingAction)
     // ═══════════════════════════════════════════════════════════════
     
-    void IncrementContainerEntry() { fGammasEnteringContainer++; }
-    void IncrementWaterEntry() { fGammasEnteringWater++; }
-    void IncrementElectronsInWater() { fElectronsInWater++; }
-    void IncrementPreContainerPlane() { fGammasPreContainerPlane++; }
-    void IncrementPostContainerPlane() { fGammasPostContainerPlane++; }
+    void IncrementContainerEntry() { fCounters.gammasEnteringContainer++; }
+    void IncrementWaterEntry() { fCounters.gammasEnteringWater++; }
+    void IncrementElectronsInWater() { fCounters.electronsInWater++; }
+    void AddStep() { fCounters.steps++; }
+    void AddDecays(G4long n) { fCounters.decays += n; }
+    
+    /// Événement stratifié : raie tirée et poids p/q (fusionnés pour le maître,
+    /// qui n'a pas de générateur en MT)
+    void RecordStratifiedLine(G4int lineIndex, G4double weight);
 
     // ═══════════════════════════════════════════════════════════════
     // ACCESSEURS
@@ -120,25 +158,36 @@ public:
     /// Retourne le nom du fichier ROOT de sortie
     const G4String& GetOutputFileName() const { return fOutputFileName; }
     
-    /// Retourne la fraction d'angle solide interceptée par le cône
+    /// Préfixe des sorties du run : <nom>.root et <nom>.log (/puits/output/name)
+    void SetOutputName(const G4String& name);
+    
+    /// Bannières console (/puits/output/quiet)
+    void SetQuiet(G4bool quiet);
+    
+    /// Retourne la fraction d'angle solide du cône d'émission (EmissionCone,
+    /// le même cône que celui tiré par PrimaryGeneratorAction) ; source unique
+    /// seulement, voir GetScanSolidAngleFraction en balayage
     G4double GetSolidAngleFraction() const;
     
+    /// Nombre d'anneaux construits (fixé en début de run)
+    G4int GetNbRings() const { return fNbRings; }
+    
     /// Retourne la masse d'un anneau (en grammes)
     G4double GetRingMass(G4int ringIndex) const { 
-        return (ringIndex >= 0 && ringIndex < DetectorConstruction::kNbWaterRings) 
+        return (ringIndex >= 0 && ringIndex < DetectorConstruction::kMaxWaterRings) 
                ? fRingMasses[ringIndex] : 0.; 
     }
     
     /// Retourne l'énergie totale déposée dans un anneau
     G4double GetRingTotalEnergy(G4int ringIndex) const {
-        return (ringIndex >= 0 && ringIndex < DetectorConstruction::kNbWaterRings)
-               ? fRingTotalEnergy[ringIndex] : 0.;
+        return (ringIndex >= 0 && ringIndex < DetectorConstruction::kMaxWaterRings)
+               ? fCounters.ringEnergy[ringIndex] : 0.;
     }
     
     // Paramètres géométriques
     G4double GetActivity4pi() const { return fActivity4pi; }
-    G4double GetConeAngle() const { return fConeAngle; }
-    G4double GetSourcePosZ() const { return fSourcePosZ; }
+    G4double GetConeAngle() const;
+    G4double GetSourcePosZ() const;
     G4double GetWaterRadius() const { return fWaterRadius; }
     G4double GetWaterBottomZ() const { return fWaterBottomZ; }
 
@@ -152,62 +201,105 @@ public:
     /// Calcule le débit de dose à partir de la dose totale et du nombre d'événements
     G4double CalculateDoseRate(G4double totalDose_Gy, G4int nEvents) const;
 
+    // ═══════════════════════════════════════════════════════════════
+    // INCERTITUDES ET FIGURE DE MÉRITE
+    // ═══════════════════════════════════════════════════════════════
+    
+    const RingDoseStatistics& GetDoseStatistics() const { return fDoseStats; }
+    
+    /// Temps CPU écoulé depuis le début du run (s, tous threads confondus)
+    G4double GetElapsedCPUTime() const;
+
 private:
+    /// Écrit le tableau dose / erreur / FOM par anneau
+    void PrintDoseStatistics(std::ostream& os, G4bool finalReport) const;
+    
+    /// Allocation stratifiée réalisée sur le run (compteurs fusionnés)
+    void PrintStratifiedAllocation(std::ostream& os) const;
+    
+    /// Dose (dépôt) et kerma (longueur de trace) côte à côte, avec incertitudes
+    void PrintKermaComparison(std::ostream& os) const;
+    
+    void DefineCommands();
+    
+    /// Crée les histogrammes et ntuples (une seule fois par session)
+    void BookHistograms();
+    
+    /// Ajoute le sous-run monoénergétique au fichier de réponse (maître)
+    void RecordResponse(G4int nEvents) const;
+    
+    /// Sorties par thread : écrit <préfixe>_files.txt et lance hadd si demandé
+    void MergePerThreadFiles() const;
+    
+    /// Fichiers de résultats du run : <préfixe>_results.json, _rings.csv, _lines.csv, _planes.csv
+    void WriteResults(const G4Run* run) const;
+    
+    /// Balayage : fraction d'angle solide de la position (cône, ou
+    /// événements / désintégrations en mode cascades)
+    G4double GetScanSolidAngleFraction(G4int position) const;
+    
+    /// Tableau dose-position du balayage
+    void PrintScanResults(std::ostream& os) const;
+    
+    /// <préfixe>_scan.csv, _scan_lines.csv, _scan_planes.csv
+    void WriteScanResults() const;
+
     // ═══════════════════════════════════════════════════════════════
     // PARAMÈTRES DE LA SOURCE
     // ═══════════════════════════════════════════════════════════════
     G4double fActivity4pi;          // Activité 4π de la source (Bq)
-    G4double fConeAngle;            // Demi-angle du cône d'émission
-    G4double fSourcePosZ;           // Position Z de la source
     G4double fMeanGammasPerDecay;   // Nombre moyen de gammas par désintégration
     G4double fWaterRadius;          // Rayon de la zone d'eau
     G4double fWaterBottomZ;         // Position Z du bas de l'eau
 
     // ═══════════════════════════════════════════════════════════════
-    // COMPTEURS GLOBAUX
+    // COMPTEURS DU RUN (fusionnés entre threads, voir RunCounters)
     // ═══════════════════════════════════════════════════════════════
-    G4int fTotalPrimariesGenerated;
-    G4int fTotalEventsWithZeroGamma;
-    G4int fTotalTransmitted;
-    G4int fTotalAbsorbed;
-    G4int fTotalEvents;
-    G4double fTotalWaterEnergy;
-    G4int fTotalWaterEventCount;
-
-    // ═══════════════════════════════════════════════════════════════
-    // COMPTEURS DE VÉRIFICATION
-    // ═══════════════════════════════════════════════════════════════
-    G4int fGammasEnteringContainer;
-    G4int fGammasEnteringWater;
-    G4int fElectronsInWater;
-    G4int fGammasPreContainerPlane;
-    G4int fGammasPostContainerPlane;
+    RunCounters fCounters;
 
     // ═══════════════════════════════════════════════════════════════
     // STATISTIQUES PAR ANNEAU D'EAU
     // ═══════════════════════════════════════════════════════════════
-    std::array<G4double, DetectorConstruction::kNbWaterRings> fRingTotalEnergy;
-    std::array<G4double, DetectorConstruction::kNbWaterRings> fRingTotalEnergy2;  // Pour variance
-    std::array<G4int, DetectorConstruction::kNbWaterRings> fRingEventCount;
-    std::array<G4double, DetectorConstruction::kNbWaterRings> fRingMasses;
+    std::array<G4double, DetectorConstruction::kMaxWaterRings> fRingMasses;
+    G4double fTotalRingMass;          // somme des masses (g), calculée en début de run
+    G4int fNbRings;                   // anneaux construits (DetectorConstruction), en début de run
     
-    // Énergie par anneau ET par raie gamma
-    std::array<std::array<G4double, EventAction::kNbGammaLines>, DetectorConstruction::kNbWaterRings> fRingEnergyByLine;
-
-    // ═══════════════════════════════════════════════════════════════
-    // STATISTIQUES PAR RAIE GAMMA Eu-152
-    // ═══════════════════════════════════════════════════════════════
-    std::array<G4int, EventAction::kNbGammaLines> fLineEmitted;
-    std::array<G4int, EventAction::kNbGammaLines> fLineEnteredWater;
-    std::array<G4int, EventAction::kNbGammaLines> fLineAbsorbedWater;
+    // Identifiants H1 réservés par BookHistograms (blocs par anneau : fNbRings histogrammes)
+    G4int fEdepRingFirstH1;
+    G4int fElectronSpectrumH1;
+    G4int fDoseRingFirstH1;
+    G4int fDoseTotalH1;
+    G4int fPlaneSpectrumFirstH1;
+    
+    // Dose par événement (nGy) : Welford + moyennes par lots
+    RingDoseStatistics fDoseStats;
+    RingDoseStatistics fKermaStats;   // Kerma de collision (nGy/evt), mode /puits/kerma/
+    ScanTallies fScanTallies;         // Par position de source (/puits/scan/)
+    G4int fStatsBatchSize;          // Taille des lots (événements)
+    G4int fStatsReportEvery;        // Rapport intermédiaire tous les N événements (0 = jamais)
+    std::clock_t fRunStartCPU;      // Horloge CPU au début du run
+    std::chrono::steady_clock::time_point fRunStartWall;
+    G4double fStartupCPU_s;         // Démarrage (géométrie + tables), premier run
+    G4double fStartupMemory_MB;
+    std::array<long, 2> fRunSeeds;  // Graines du moteur au début du run
+    
+    // Publication vers le rapport d'avancement (ProgressReporter)
+    G4int fProgressSlot;
+    G4int fEventsSincePublish;
     
-    // Comptage par processus d'absorption pour chaque raie
-    std::array<std::array<G4int, EventAction::kNbProcesses>, EventAction::kNbGammaLines> fLineAbsorbedByProcess;
-
     // ═══════════════════════════════════════════════════════════════
     // FICHIER DE SORTIE ROOT
     // ═══════════════════════════════════════════════════════════════
+    G4bool fHistogramsBooked;
     G4String fOutputFileName;
+    G4String fLogFileName;
+    G4String fOutputPrefix;         // <préfixe>.root, .log, _results.json...
+    G4bool fWriteResults;
+    G4bool fPerThreadOutput;        // Un fichier d'ntuples par thread (MT)
+    G4String fMergeMode;            // none, end ou background (hadd)
+    
+    G4GenericMessenger* fMessenger;
+    G4GenericMessenger* fOutputMessenger;
 };
 
 #endif
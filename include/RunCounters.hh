@@ -0,0 +1,71 @@
+#ifndef RunCounters_h
+#define RunCounters_h 1
+
+#include "G4VAccumulable.hh"
+#include "DetectorConstruction.hh"
+#include "EventAction.hh"
+#include "PlaneSD.hh"
+#include "globals.hh"
+#include <array>
+
+/// @brief Compteurs d'un run (gammas, dépôts, raies, plans)
+///
+/// Dérive de G4VAccumulable : chaque thread de travail remplit ses propres
+/// compteurs sans verrou, le maître les additionne en fin de run
+/// (G4AccumulableManager::Merge). En séquentiel, la fusion est sans effet.
+
+class RunCounters : public G4VAccumulable
+{
+public:
+    static const G4int kNbRings = DetectorConstruction::kMaxWaterRings;
+    static const G4int kNbLines = EventAction::kNbGammaLines;
+    static const G4int kNbProcesses = EventAction::kNbProcesses;
+
+    explicit RunCounters(const G4String& name);
+    virtual ~RunCounters() = default;
+
+    virtual void Merge(const G4VAccumulable& other);
+    virtual void Reset();
+
+    // Compteurs globaux
+    G4int primariesGenerated;
+    G4int eventsWithZeroGamma;
+    G4int transmitted;
+    G4int absorbed;
+    G4int events;
+    G4long decays;                      // Désintégrations tirées (mode cascades)
+    G4double waterEnergy;
+    G4int waterEventCount;
+
+    // Compteurs de vérification
+    G4int gammasEnteringContainer;
+    G4int gammasEnteringWater;
+    G4int electronsInWater;
+    G4long steps;                       // Pas de transport (coût de la géométrie)
+
+    // Dépôts par anneau, et par anneau et raie
+    std::array<G4double, kNbRings> ringEnergy;
+    std::array<std::array<G4double, kNbLines>, kNbRings> ringEnergyByLine;
+
+    // Statistiques par raie Eu-152
+    std::array<G4int, kNbLines> lineEmitted;
+    std::array<G4int, kNbLines> lineEnteredWater;
+    std::array<G4int, kNbLines> lineAbsorbedWater;
+    std::array<G4double, kNbLines> lineAbsorbedWaterWeighted;
+    std::array<std::array<G4int, kNbProcesses>, kNbLines> lineAbsorbedByProcess;
+
+    // Allocation stratifiée (/puits/strat/) : événements et somme des poids
+    // p/q par raie tirée, remplis par tous les threads de travail
+    G4long stratifiedEvents;
+    std::array<G4long, kNbLines> stratLineEvents;
+    std::array<G4double, kNbLines> stratLineWeight;
+
+    // Plans container (PlaneSD), [plan][particule][sens] : traversées et
+    // énergie brutes, puis pondérées par le poids des traces
+    std::array<G4int, PlaneSD::kNbTallies> planeCounts;
+    std::array<G4double, PlaneSD::kNbTallies> planeEnergy;
+    std::array<G4double, PlaneSD::kNbTallies> planeWeightedCounts;
+    std::array<G4double, PlaneSD::kNbTallies> planeWeightedEnergy;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef ScanTallies_h
+#define ScanTallies_h 1
+
+#include "G4VAccumulable.hh"
+#include "EventAction.hh"
+#include "PlaneSD.hh"
+#include "globals.hh"
+#include <vector>
+
+/// @brief Résultats du run répartis par position de source (SourceScan)
+///
+/// Pour chaque position : événements et désintégrations, dose par anneau
+/// (somme et somme des carrés de la dose par événement, TOUS les événements
+/// de la position comptés), statistiques par raie et comptages aux plans.
+/// Les tableaux sont à plat, indice position × taille + élément.
+///
+/// Dérive de G4VAccumulable : chaque thread remplit ses propres tableaux,
+/// le maître les additionne en fin de run.
+
+class ScanTallies : public G4VAccumulable
+{
+public:
+    static const G4int kNbLines = EventAction::kNbGammaLines;
+    static const G4int kNbPlaneTallies = PlaneSD::kNbTallies;
+
+    explicit ScanTallies(const G4String& name);
+    virtual ~ScanTallies() = default;
+
+    /// Positions et anneaux du run (remet à zéro si l'un change)
+    void SetLayout(G4int nPositions, G4int nRings);
+    G4int GetNbPositions() const { return fNbPositions; }
+    G4int GetNbRings() const { return fNbRings; }
+
+    /// Événement de la position : dose par anneau (nGy, dose[0..nRings-1])
+    void FillEvent(G4int position, const G4double* dose_nGy, G4long decays);
+
+    void AddLine(G4int position, G4int line, G4bool enteredWater,
+                 G4bool absorbedInWater, G4double absorbedWeight);
+    void AddPlane(G4int position, G4int tally, G4int count, G4double sumEnergy,
+                  G4double weightedCount, G4double weightedEnergy);
+
+    virtual void Merge(const G4VAccumulable& other);
+    virtual void Reset();
+
+    G4long GetEvents(G4int position) const { return fEvents[position]; }
+    G4long GetDecays(G4int position) const { return fDecays[position]; }
+
+    /// Dose moyenne par événement de la position (nGy) et son erreur standard
+    G4double GetMeanDose(G4int position, G4int ring) const;
+    G4double GetSemDose(G4int position, G4int ring) const;
+
+    G4long GetLineEmitted(G4int position, G4int line) const { return fLineEmitted[position * kNbLines + line]; }
+    G4long GetLineEntered(G4int position, G4int line) const { return fLineEntered[position * kNbLines + line]; }
+    G4long GetLineAbsorbed(G4int position, G4int line) const { return fLineAbsorbed[position * kNbLines + line]; }
+    G4double GetLineAbsorbedWeighted(G4int position, G4int line) const {
+        return fLineAbsorbedWeighted[position * kNbLines + line];
+    }
+
+    G4long GetPlaneCount(G4int position, G4int tally) const { return fPlaneCounts[position * kNbPlaneTallies + tally]; }
+    G4double GetPlaneEnergy(G4int position, G4int tally) const { return fPlaneEnergy[position * kNbPlaneTallies + tally]; }
+    G4double GetPlaneWeightedCount(G4int position, G4int tally) const {
+        return fPlaneWeightedCounts[position * kNbPlaneTallies + tally];
+    }
+    G4double GetPlaneWeightedEnergy(G4int position, G4int tally) const {
+        return fPlaneWeightedEnergy[position * kNbPlaneTallies + tally];
+    }
+
+private:
+    G4int fNbPositions;
+    G4int fNbRings;
+
+    std::vector<G4long> fEvents;
+    std::vector<G4long> fDecays;
+    std::vector<G4double> fDoseSum;         // [position × nRings + anneau]
+    std::vector<G4double> fDoseSum2;
+
+    std::vector<G4long> fLineEmitted;       // [position × kNbLines + raie]
+    std::vector<G4long> fLineEntered;
+    std::vector<G4long> fLineAbsorbed;
+    std::vector<G4double> fLineAbsorbedWeighted;
+
+    std::vector<G4long> fPlaneCounts;       // [position × kNbPlaneTallies + comptage]
+    std::vector<G4double> fPlaneEnergy;
+    std::vector<G4double> fPlaneWeightedCounts;
+    std::vector<G4double> fPlaneWeightedEnergy;
+};
+
+#endif
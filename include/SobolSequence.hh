@@ -0,0 +1,46 @@
+#ifndef SobolSequence_h
+#define SobolSequence_h 1
+
+#include "globals.hh"
+#include <array>
+#include <cstdint>
+
+/// @brief Suite de Sobol brouillée (Owen) pour les dimensions de la source
+///
+/// Trois dimensions : tirage de la raie, cos θ, φ. Les nombres directeurs
+/// sont ceux de Joe et Kuo (dimension 0 = van der Corput). Chaque dimension
+/// est brouillée par permutation emboîtée uniforme (brouillage d'Owen par
+/// hachage, Burley 2020) : chaque point est uniforme sur [0,1)³ et deux
+/// brouillages indépendants donnent deux répliques indépendantes (RQMC).
+///
+/// Les graines de brouillage sont tirées dans le moteur aléatoire Geant4 :
+/// la suite est reproductible avec la graine du run. Le transport garde
+/// le flux pseudo-aléatoire habituel.
+
+class SobolSequence
+{
+public:
+    static const G4int kNbDimensions = 3;
+    enum Dimension { kLine = 0, kCosTheta = 1, kPhi = 2 };
+
+    SobolSequence();
+    ~SobolSequence() = default;
+
+    /// Nouveau brouillage (graines tirées par G4UniformRand) et retour au point 0
+    void Rescramble();
+
+    /// Point suivant de la suite brouillée, coordonnées dans ]0,1[
+    void Next(std::array<G4double, kNbDimensions>& u);
+
+    std::uint32_t GetIndex() const { return fIndex; }
+
+private:
+    static std::uint32_t ReverseBits(std::uint32_t x);
+    static std::uint32_t NestedUniformScramble(std::uint32_t x, std::uint32_t seed);
+
+    std::array<std::array<std::uint32_t, 32>, kNbDimensions> fDirections;
+    std::array<std::uint32_t, kNbDimensions> fSeeds;
+    std::uint32_t fIndex;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef SourceScan_h
+#define SourceScan_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+#include <ostream>
+#include <vector>
+
+class G4GenericMessenger;
+
+/// @brief Balayage de plusieurs positions de source dans un seul run
+///
+/// Singleton. Chaque position est donnée par un décalage latéral (x, y) et
+/// une distance source-eau d : la source est en (x, y, z_eau - d). Tant que
+/// la liste n'est pas vide, PrimaryGeneratorAction place la source de
+/// l'événement i à la position i mod N (tirage équilibré et reproductible,
+/// indépendant du nombre de threads) et l'indique à EventAction, qui répartit
+/// doses, raies et plans par position (ScanTallies). Un seul run donne ainsi
+/// la courbe dose-position, sans réinitialiser la géométrie ni les tables.
+///
+/// Le cône d'émission est calculé pour chaque position (EmissionCone) : en
+/// mode "geometry", il couvre l'empilement vu de la position décalée, et la
+/// normalisation temporelle se fait position par position. Les résultats
+/// globaux du run restent la moyenne sur les positions.
+///
+/// Commandes : /puits/scan/position, grid, clear, list
+
+class SourceScan
+{
+public:
+    static SourceScan* GetInstance();
+
+    /// Position demandée : décalage latéral et distance source-eau
+    struct Position
+    {
+        G4double x;
+        G4double y;
+        G4double distance;
+    };
+
+    G4bool IsEnabled() const { return !fPositions.empty(); }
+    G4int GetNbPositions() const { return static_cast<G4int>(fPositions.size()); }
+    const Position& GetPosition(G4int index) const { return fPositions[index]; }
+
+    /// Surface de l'eau (appelé par DetectorConstruction à la construction)
+    void SetWaterSurfaceZ(G4double z) { fWaterSurfaceZ = z; }
+
+    /// z de la source la plus éloignée et décalage latéral maximal (monde ajusté)
+    G4double GetMinSourceZ() const;
+    G4double GetMaxLateralOffset() const;
+
+    /// Début de run (maître) : positions absolues et cônes, contrôle de la
+    /// géométrie (source hors de l'empilement et dans le monde)
+    void PrepareForRun();
+
+    /// Position de l'événement : eventID mod N
+    G4int GetPositionIndex(G4int eventID) const { return eventID % GetNbPositions(); }
+
+    /// Position absolue de la source et demi-angle du cône (après PrepareForRun)
+    const G4ThreeVector& GetSourcePosition(G4int index) const { return fSourcePositions[index]; }
+    G4double GetHalfAngle(G4int index) const { return fHalfAngles[index]; }
+
+    /// Fraction de 4π couverte par le cône de la position
+    G4double GetSolidAngleFraction(G4int index) const;
+
+    void Print(std::ostream& os) const;
+
+private:
+    SourceScan();
+    ~SourceScan();
+
+    SourceScan(const SourceScan&) = delete;
+    SourceScan& operator=(const SourceScan&) = delete;
+
+    void DefineCommands();
+
+    /// "x y d [unité]" : ajoute une position
+    void AddPosition(const G4String& text);
+
+    /// "dMin dMax n [unité]" : n distances régulières sur l'axe
+    void AddGrid(const G4String& text);
+
+    void Clear();
+    void List();
+
+    static SourceScan* fInstance;
+
+    std::vector<Position> fPositions;
+    G4double fWaterSurfaceZ;
+
+    // Préparé en début de run
+    std::vector<G4ThreeVector> fSourcePositions;
+    std::vector<G4double> fHalfAngles;
+
+    G4GenericMessenger* fMessenger;
+};
+
+#endif
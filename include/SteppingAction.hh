@@ -3,11 +3,13 @@
 
 #include "G4UserSteppingAction.hh"
 #include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <utility>
 #include <vector>
-#include <set>
 
 class EventAction;
 class RunAction;
+class G4StepPoint;
 
 /// @brief Suivi pas-à-pas des particules
 ///
@@ -16,6 +18,11 @@ class RunAction;
 /// les structures de EventAction.
 ///
 /// Identification des primaires : parentID == 0
+///
+/// Aucune allocation par pas : les noms de volumes et de processus sont lus
+/// par référence. L'anneau est identifié par le volume logique (table indexée
+/// par GetInstanceID, construite au premier pas) et le numéro de copie, quelle
+/// que soit la construction (placements, replica, paramétrisation).
 
 class SteppingAction : public G4UserSteppingAction
 {
@@ -26,6 +33,12 @@ public:
     virtual void UserSteppingAction(const G4Step*);
     
 private:
+    /// Index de l'anneau d'eau d'un point du pas (-1 si ce n'est pas un anneau)
+    G4int GetRingIndex(const G4StepPoint* point) const;
+    
+    /// Table des volumes logiques d'anneau (premier pas du thread)
+    void BuildRingLookup();
+    
     EventAction* fEventAction;
     RunAction* fRunAction;
 
@@ -36,9 +49,23 @@ private:
     G4int fVerboseMaxEvents;
     
     // ═══════════════════════════════════════════════════════════════
-    // NOMS DES VOLUMES D'EAU (pour identification rapide)
+    // VOLUMES D'EAU (pour identification rapide)
+    // ═══════════════════════════════════════════════════════════════
+    std::vector<G4bool> fIsRingLogical;   // indexée par G4LogicalVolume::GetInstanceID()
+    
+    // ═══════════════════════════════════════════════════════════════
+    // TABULATION DU NOYAU DE LA PLAQUE ATTÉNUATRICE
     // ═══════════════════════════════════════════════════════════════
-    std::set<G4String> fWaterRingNames;
+    struct AttenuatorEntry
+    {
+        G4double energy;
+        G4ThreeVector position;
+        G4ThreeVector direction;
+    };
+    // (trackID, entrée) jusqu'à la sortie ; capacité réservée, retrait par échange
+    std::vector<std::pair<G4int, AttenuatorEntry>> fAttenuatorEntries;
+    AttenuatorEntry* FindAttenuatorEntry(G4int trackID);
+    void EraseAttenuatorEntry(G4int trackID);
 };
 
 #endif
@@ -0,0 +1,87 @@
+#ifndef StratifiedSampler_h
+#define StratifiedSampler_h 1
+
+#include "globals.hh"
+#include <ostream>
+#include <vector>
+
+class G4GenericMessenger;
+
+/// @brief Allocation stratifiée des histoires entre les raies gamma
+///
+/// En mode analogue, chaque raie k est émise avec la probabilité p_k = I_k/100 :
+/// les raies faibles (411 keV, 444 keV) n'ont que quelques pour cent des
+/// histoires. En mode stratifié, chaque événement émet UN seul photon, de la
+/// raie k tirée avec la probabilité q_k, et porte le poids p_k / q_k : la dose
+/// par événement reste un estimateur sans biais de la dose par désintégration.
+///
+/// Les q_k sont recalculés à la fin de chaque lot pilote à partir des scores
+/// observés par raie (allocation de Neyman pour un coût par événement) :
+///
+///     q_k ∝ p_k · sqrt(M_k / c_k)
+///
+/// M_k : moment d'ordre 2 de la dose par photon sommée sur les anneaux,
+/// c_k : temps de calcul moyen d'un photon de la raie k. La raie étant tirée
+/// au hasard à chaque événement (événements indépendants, erreurs existantes
+/// valables), c'est le moment d'ordre 2 et non l'écart-type qui intervient.
+/// Un mélange défensif (fraction ε répartie uniformément) borne les poids.
+///
+/// Un objet par thread (possédé par PrimaryGeneratorAction). Les réglages sont
+/// communs au processus : leurs commandes sont créées sur le thread maître
+/// (constructeur de RunAction), donc disponibles avant /run/initialize, et
+/// lues par les échantillonneurs de chaque thread.
+///
+/// Commandes : /puits/strat/enable, batchSize, defensiveFraction
+
+class StratifiedSampler
+{
+public:
+    /// @param probabilities probabilités d'émission p_k par désintégration
+    explicit StratifiedSampler(const std::vector<G4double>& probabilities);
+    ~StratifiedSampler() = default;
+
+    /// Crée les commandes /puits/strat/ (premier appel, thread maître)
+    static void DefineCommands();
+
+    G4bool IsEnabled() const { return fEnabled; }
+
+    /// Tire la raie de l'événement ; weight reçoit p_k / q_k
+    G4int SampleLine(G4double& weight) const;
+    
+    /// Même tirage par inversion d'une uniforme fournie (suite quasi-aléatoire)
+    G4int SampleLine(G4double u, G4double& weight) const;
+
+    /// Score d'un événement stratifié : raie tirée, somme sur les anneaux du
+    /// carré de la dose PAR PHOTON (poids source retiré) et temps CPU du
+    /// thread (s, CLOCK_THREAD_CPUTIME_ID)
+    void RecordEvent(G4int line, G4double sumDoseSquared, G4double cpuTime_s);
+
+    /// Allocation courante q_k
+    const std::vector<G4double>& GetAllocation() const { return fAllocation; }
+
+    /// Tableau des allocations et des scores par raie
+    void Print(std::ostream& os) const;
+
+private:
+    void UpdateAllocation();
+
+    std::vector<G4double> fProbabilities;   // p_k
+    std::vector<G4double> fAllocation;      // q_k (somme = 1)
+    std::vector<G4double> fCumulative;      // Σ_{j<=k} q_j
+
+    // Scores par raie, cumulés sur toute la session
+    std::vector<G4long> fCount;
+    std::vector<G4double> fSumScore;        // Σ Σ_anneaux dose²
+    std::vector<G4double> fSumTime;         // Σ temps CPU (s)
+
+    G4int fEventsInBatch;
+    G4int fNbUpdates;
+
+    // Réglages du processus (commandes non diffusées aux threads)
+    static G4bool fEnabled;
+    static G4int fBatchSize;                // Événements par lot pilote
+    static G4double fDefensiveFraction;     // ε
+    static G4GenericMessenger* fMessenger;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef ThreadingConfig_h
+#define ThreadingConfig_h 1
+
+#include "globals.hh"
+#include <vector>
+
+class G4GenericMessenger;
+
+/// @brief Gestionnaire de run, granularité des tâches et placement des threads
+///
+/// Singleton du processus. Le type de gestionnaire (serial, mt, tasking) et
+/// le nombre de threads viennent de la ligne de commande (--run-manager,
+/// --threads) ; la granularité et le placement se règlent par macro.
+///
+/// Un événement ne contient qu'une désintégration (~2 photons) : avec
+/// G4TaskRunManager, le coût d'ordonnancement par tâche n'est amorti que si
+/// chaque tâche traite assez d'événements (grain).
+///
+/// Placement des threads de travail (Linux, appliqué au démarrage de chaque
+/// thread par ActionInitialization::Build) :
+/// - "none"    : laissé à l'ordonnanceur du système
+/// - "compact" : thread i sur le i-ème CPU autorisé (remplit un socket d'abord)
+/// - "scatter" : threads répartis à tour de rôle sur les nœuds NUMA
+///               (/sys/devices/system/node), puis sur les CPU de chaque nœud
+///
+/// Commandes : /puits/mt/grain, /puits/mt/pinning
+
+class ThreadingConfig
+{
+public:
+    static ThreadingConfig* GetInstance();
+
+    enum Pinning { kNone = 0, kCompact, kScatter };
+
+    /// Choix de la ligne de commande (appelé par main avant la création du gestionnaire)
+    void SetRunManager(const G4String& type, G4int nThreads);
+
+    const G4String& GetRunManagerName() const { return fRunManagerName; }
+    G4int GetNumberOfThreads() const { return fNbThreads; }
+    G4int GetGrainSize() const { return fGrainSize; }
+    Pinning GetPinning() const { return fPinning; }
+    G4String GetPinningName() const;
+
+    /// Événements par tâche (tasking) ou par lot distribué (mt) ; 0 = défaut Geant4
+    void SetGrainSize(G4int nEvents);
+
+    /// Place le thread courant selon la politique choisie (thread de travail)
+    void PinCurrentThread(G4int threadId) const;
+
+private:
+    ThreadingConfig();
+    ~ThreadingConfig();
+
+    ThreadingConfig(const ThreadingConfig&) = delete;
+    ThreadingConfig& operator=(const ThreadingConfig&) = delete;
+
+    void DefineCommands();
+    void SetPinningByName(const G4String& name);
+
+    /// CPU autorisés pour le processus, regroupés par nœud NUMA
+    std::vector<std::vector<G4int>> GetNodeCpus() const;
+
+    static ThreadingConfig* fInstance;
+
+    G4String fRunManagerName;
+    G4int fNbThreads;
+    G4int fGrainSize;
+    Pinning fPinning;
+
+    G4GenericMessenger* fMessenger;
+};
+
+#endif
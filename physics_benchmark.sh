@@ -0,0 +1,62 @@
+#!/bin/sh
+# ═══════════════════════════════════════════════════════════════════════════
+# LISTE DE PHYSIQUE RÉDUITE : DOSES ET COÛT DE DÉMARRAGE (EM seule / FTFP_BERT)
+# ═══════════════════════════════════════════════════════════════════════════
+#
+# Usage :
+#   ./physics_benchmark.sh [exécutable] [threads]
+#   ./physics_benchmark.sh ./puits_couronne 1
+#
+# Deux processus : physics_lean.mac (EM Livermore seule, graines 1001 1002)
+# puis physics_reference.mac (mêmes réglages + constructeurs hadroniques et
+# de décroissance de FTFP_BERT, graines 2001 2002), 10⁶ événements chacun.
+#
+# Démarrage : temps CPU d'initialisation (géométrie + tables) et mémoire
+# résidente au premier run, lus dans physics/<liste>_results.json
+# (startup_cpu_s, startup_rss_mb), écrits dans physics/startup.csv.
+# Doses : puits_regress compare la liste réduite à la référence (dose par
+# anneau avec erreurs standard, entrée et absorption par raie, plans) ;
+# rapport complet dans physics/comparison.csv. Code de sortie de
+# puits_regress : 0 compatible, 1 erreur, 2 écart hors statistique.
+# Variable PUITS_REGRESS : chemin de puits_regress (défaut ./puits_regress).
+# ═══════════════════════════════════════════════════════════════════════════
+
+EXE=${1:-./puits_couronne}
+THREADS=${2:-1}
+REGRESS=${PUITS_REGRESS:-./puits_regress}
+
+mkdir -p physics
+
+# Valeur numérique d'une clé du fichier de résultats
+json_value() {
+    sed -n "s/.*\"$2\": \([0-9.eE+-]*\).*/\1/p" "$1" | head -n 1
+}
+
+for list in lean reference; do
+    "$EXE" --quiet --threads "$THREADS" physics_$list.mac \
+        > physics/$list.out 2>&1 || { echo "echec : liste $list (voir physics/$list.out)"; exit 1; }
+done
+
+echo "list,events,startup_cpu_s,startup_rss_mb,cpu_s" > physics/startup.csv
+printf "\n%10s %10s %16s %16s %10s\n" liste events demarrage_cpu_s demarrage_rss_mb cpu_s
+for list in lean reference; do
+    RESULTS=physics/$list"_results.json"
+    [ -f "$RESULTS" ] || { echo "resultats absents : $RESULTS (/puits/output/results)"; exit 1; }
+    LINE=$(awk -v l="$list" -v n="$(json_value "$RESULTS" events)" \
+               -v t0="$(json_value "$RESULTS" startup_cpu_s)" \
+               -v m0="$(json_value "$RESULTS" startup_rss_mb)" \
+               -v t="$(json_value "$RESULTS" cpu_s)" 'BEGIN {
+        printf "%s,%d,%.3f,%.1f,%.3f", l, n, t0, m0, t
+    }')
+    echo "$LINE" >> physics/startup.csv
+    echo "$LINE" | awk -F, '{ printf "%10s %10d %16.2f %16.1f %10.2f\n", $1, $2, $3, $4, $5 }'
+done
+
+awk -F, '$1 == "reference" { t = $3; m = $4 }
+         $1 == "lean" { tl = $3; ml = $4 }
+         END { if (t > 0 && m > 0)
+                   printf "\nReduction au demarrage : %.1f %% de CPU, %.1f %% de memoire residente\n",
+                          100 * (1 - tl / t), 100 * (1 - ml / m) }' physics/startup.csv
+
+echo
+"$REGRESS" physics/reference physics/lean -o physics/comparison.csv
@@ -5,20 +5,65 @@
 // ********************************************************************
 //
 
-#include "G4RunManager.hh"
+#include "G4RunManagerFactory.hh"
 #include "G4UImanager.hh"
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
+#include "G4StateManager.hh"
 
 #include "DetectorConstruction.hh"
 #include "PhysicsList.hh"
 #include "ActionInitialization.hh"
+#include "JobServer.hh"
+#include "ThreadingConfig.hh"
+#include "Logger.hh"
 
 #include "Randomize.hh"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <ctime>
+#include <iomanip>
+
+// Usage :
+//   puits_couronne                              mode interactif
+//   puits_couronne macro.mac                    mode batch
+//   puits_couronne --server dossier [init.mac]  mode serveur (file de jobs)
+//   --quiet : bannières console supprimées (résultats dans <nom>_results.json)
+//   --threads N : N threads de travail (G4TaskRunManager sauf --run-manager mt)
+//   --run-manager serial|mt|tasking : type de gestionnaire (serial par défaut)
 
 int main(int argc, char** argv)
 {
+    // ═══════════════════════════════════════════════════════════════
+    // LIGNE DE COMMANDE
+    // ═══════════════════════════════════════════════════════════════
+    
+    G4String macroFile;
+    G4String serverDirectory;
+    G4String runManagerName;
+    G4int nThreads = 1;
+    for (G4int i = 1; i < argc; ++i) {
+        G4String arg = argv[i];
+        if ((arg == "--server" || arg == "-s") && i + 1 < argc) {
+            serverDirectory = argv[++i];
+        } else if ((arg == "--threads" || arg == "-t") && i + 1 < argc) {
+            nThreads = std::max(std::atoi(argv[++i]), 1);
+            if (runManagerName.empty()) runManagerName = "tasking";
+        } else if ((arg == "--run-manager" || arg == "-r") && i + 1 < argc) {
+            runManagerName = argv[++i];
+        } else if (arg == "--quiet" || arg == "-q") {
+            Logger::GetInstance()->SetQuiet(true);
+        } else {
+            macroFile = arg;
+        }
+    }
+    
+    if (runManagerName != "mt" && runManagerName != "tasking") {
+        runManagerName = "serial";
+    }
+    ThreadingConfig::GetInstance()->SetRunManager(runManagerName, nThreads);
+    
     // ═══════════════════════════════════════════════════════════════
     // INITIALISATION DU GÉNÉRATEUR ALÉATOIRE
     // ═══════════════════════════════════════════════════════════════
@@ -27,20 +72,32 @@ int main(int argc, char** argv)
     G4long seed = time(NULL);
     G4Random::setTheSeed(seed);
     
-    G4cout << "\n";
-    G4cout << "╔═══════════════════════════════════════════════════════════════╗\n";
-    G4cout << "║         PUITS COURONNE - Mode Séquentiel                      ║\n";
-    G4cout << "║         Dose dans l'eau - Source Eu-152                       ║\n";
-    G4cout << "╠═══════════════════════════════════════════════════════════════╣\n";
-    G4cout << "║  Seed aléatoire: " << seed << "                              ║\n";
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n";
-    G4cout << G4endl;
+    std::ostream& banner = Logger::GetInstance()->Banner();
+    banner << "\n";
+    banner << "╔═══════════════════════════════════════════════════════════════╗\n";
+    if (runManagerName == "serial") {
+        banner << "║         PUITS COURONNE - Mode Séquentiel                      ║\n";
+    } else {
+        banner << "║         PUITS COURONNE - Mode " << std::setw(7) << std::left << runManagerName
+               << std::right << " (" << std::setw(3) << nThreads << " threads)          ║\n";
+    }
+    banner << "║         Dose dans l'eau - Source Eu-152                       ║\n";
+    banner << "╠═══════════════════════════════════════════════════════════════╣\n";
+    banner << "║  Seed aléatoire: " << seed << "                              ║\n";
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n";
+    banner << G4endl;
 
     // ═══════════════════════════════════════════════════════════════
-    // CRÉATION DU RUN MANAGER (MODE SÉQUENTIEL)
+    // CRÉATION DU RUN MANAGER (séquentiel, MT ou tâches)
     // ═══════════════════════════════════════════════════════════════
     
-    auto* runManager = new G4RunManager;
+    G4RunManagerType runManagerType = G4RunManagerType::Serial;
+    if (runManagerName == "mt") {
+        runManagerType = G4RunManagerType::MT;
+    } else if (runManagerName == "tasking") {
+        runManagerType = G4RunManagerType::Tasking;
+    }
+    auto* runManager = G4RunManagerFactory::CreateRunManager(runManagerType, nThreads);
 
     // ═══════════════════════════════════════════════════════════════
     // INITIALISATION DES COMPOSANTS OBLIGATOIRES
@@ -59,8 +116,33 @@ int main(int argc, char** argv)
     // DÉTECTION DU MODE INTERACTIF OU BATCH
     // ═══════════════════════════════════════════════════════════════
     
+    G4UImanager* UImanager = G4UImanager::GetUIpointer();
+
+    // ═══════════════════════════════════════════════════════════════
+    // MODE SERVEUR : une initialisation, puis les jobs à la suite
+    // ═══════════════════════════════════════════════════════════════
+    
+    if (!serverDirectory.empty()) {
+        // Commandes PreInit (géométrie, physique) de la macro d'initialisation
+        auto initStart = std::chrono::steady_clock::now();
+        if (!macroFile.empty()) {
+            UImanager->ApplyCommand("/control/execute " + macroFile);
+        }
+        if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_PreInit) {
+            UImanager->ApplyCommand("/run/initialize");
+        }
+        
+        G4double initTime = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - initStart).count();
+        
+        JobServer server(serverDirectory, initTime);
+        server.Run();
+        
+        delete runManager;
+        return 0;
+    }
+    
     G4UIExecutive* ui = nullptr;
-    if (argc == 1) {
+    if (macroFile.empty()) {
         // Mode interactif (pas d'arguments)
         ui = new G4UIExecutive(argc, argv);
     }
@@ -76,13 +158,10 @@ int main(int argc, char** argv)
     // GESTIONNAIRE D'INTERFACE UTILISATEUR
     // ═══════════════════════════════════════════════════════════════
     
-    G4UImanager* UImanager = G4UImanager::GetUIpointer();
-
     if (!ui) {
         // Mode batch - exécuter la macro passée en argument
         G4String command = "/control/execute ";
-        G4String fileName = argv[1];
-        UImanager->ApplyCommand(command + fileName);
+        UImanager->ApplyCommand(command + macroFile);
     }
     else {
         // Mode interactif
@@ -0,0 +1,82 @@
+#!/bin/sh
+# ═══════════════════════════════════════════════════════════════════════════
+# CONTRÔLE STATISTIQUE DE NON-RÉGRESSION (doses, raies, plans)
+# ═══════════════════════════════════════════════════════════════════════════
+#
+# Usage :
+#   ./regression_check.sh --update [exécutable] [événements] [threads]
+#   ./regression_check.sh [exécutable] [événements] [threads]
+#
+# --update : run de référence (graines 1001 1002) dans regression/reference/,
+#            à refaire uniquement quand un changement de physique est voulu.
+#            Écrit aussi regression.meta (graines, événements, threads, commit,
+#            date) ; les CSV, le JSON et le .meta sont à committer ensemble.
+# Sinon    : run de contrôle (graines 2001 2002) dans regression/run, avec le
+#            nombre d'événements de la référence (sauf s'il est donné), comparé
+#            à la référence par puits_regress (z par grandeur, χ² par groupe :
+#            dose par anneau, entrée et absorption par raie, plans).
+#
+# Les graines diffèrent : un changement du flux aléatoire (ordre des tirages,
+# nouvelle optimisation) est toléré, un écart de physique au-delà de la
+# statistique ne l'est pas. Code de sortie de puits_regress : 0 compatible,
+# 1 erreur (dont référence absente : le test ctest « regression_check »
+# échoue tant qu'elle n'est pas committée), 2 écart détecté (rapport dans
+# regression/report.csv).
+# Variables : PUITS_REGRESS (chemin de puits_regress, défaut ./puits_regress),
+# PUITS_REGRESS_REFERENCE (préfixe de la référence, défaut
+# regression/reference/regression).
+# ═══════════════════════════════════════════════════════════════════════════
+
+UPDATE=false
+if [ "$1" = "--update" ]; then
+    UPDATE=true
+    shift
+fi
+
+EXE=${1:-./puits_couronne}
+THREADS=${3:-1}
+REGRESS=${PUITS_REGRESS:-./puits_regress}
+REFERENCE=${PUITS_REGRESS_REFERENCE:-regression/reference/regression}
+
+if [ "$UPDATE" = true ]; then
+    EVENTS=${2:-50000}
+    NAME=$REFERENCE
+    mkdir -p "$(dirname "$REFERENCE")"
+    export PUITS_REGRESS_SEED1=1001
+    export PUITS_REGRESS_SEED2=1002
+else
+    if [ ! -f "${REFERENCE}_rings.csv" ] || [ ! -f "${REFERENCE}.meta" ]; then
+        echo "reference absente (${REFERENCE}_rings.csv, .meta) :"
+        echo "lancer ./regression_check.sh --update puis committer regression/reference/"
+        exit 1
+    fi
+    # Même statistique que la référence, sauf demande explicite
+    EVENTS=${2:-$(sed -n 's/^events=//p' "${REFERENCE}.meta")}
+    NAME=regression/run
+    mkdir -p regression
+    export PUITS_REGRESS_SEED1=2001
+    export PUITS_REGRESS_SEED2=2002
+fi
+
+export PUITS_REGRESS_NAME=$NAME
+export PUITS_REGRESS_EVENTS=$EVENTS
+"$EXE" --quiet --threads "$THREADS" regression.mac \
+    > $NAME.out 2>&1 || { echo "echec du run (voir $NAME.out)"; exit 1; }
+
+if [ "$UPDATE" = true ]; then
+    # Provenance de la référence : relue par le contrôle (nombre d'événements)
+    {
+        echo "# Reference de non-regression (regression_check.sh --update, regression.mac)"
+        echo "events=$EVENTS"
+        echo "seeds=$PUITS_REGRESS_SEED1 $PUITS_REGRESS_SEED2"
+        echo "threads=$THREADS"
+        echo "commit=$(git rev-parse --short HEAD 2>/dev/null || echo inconnu)"
+        echo "date=$(date -u +%Y-%m-%dT%H:%M:%SZ)"
+    } > ${REFERENCE}.meta
+    rm -f ${REFERENCE}.out ${REFERENCE}.root ${REFERENCE}.log
+    echo "Reference ecrite : ${REFERENCE}_rings.csv, _lines.csv, _planes.csv, _results.json, .meta"
+    echo "($EVENTS evenements, graines 1001 1002) : a committer"
+    exit 0
+fi
+
+"$REGRESS" $REFERENCE $NAME -o regression/report.csv
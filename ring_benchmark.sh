@@ -0,0 +1,56 @@
+#!/bin/sh
+# ═══════════════════════════════════════════════════════════════════════════
+# COÛT DE NAVIGATION : 5, 25 ET 100 ANNEAUX × PLACEMENT / REPLICA / PARAMÉTRÉ
+# ═══════════════════════════════════════════════════════════════════════════
+#
+# Usage :
+#   ./ring_benchmark.sh [exécutable] [événements] [threads]
+#   ./ring_benchmark.sh ./puits_couronne 200000 1
+#
+# Chaque point est un processus séparé (la géométrie est fixée avant
+# /run/initialize) qui exécute bench_rings.mac. Un seul thread par défaut :
+# le débit mesure la navigation sans bruit d'ordonnancement. Le tableau est
+# aussi écrit dans bench/rings.csv ; relatif = débit / débit en placements
+# pour le même nombre d'anneaux.
+# ═══════════════════════════════════════════════════════════════════════════
+
+EXE=${1:-./puits_couronne}
+EVENTS=${2:-200000}
+THREADS=${3:-1}
+
+mkdir -p bench
+export PUITS_BENCH_EVENTS=$EVENTS
+
+# Valeur numérique d'une clé du fichier de résultats (section "run")
+json_value() {
+    sed -n "s/.*\"$2\": \([0-9.eE+-]*\).*/\1/p" "$1" | head -n 1
+}
+
+echo "rings,layout,events,wall_s,events_per_s,us_per_event,relative" > bench/rings.csv
+printf "\n%6s %14s %12s %10s %12s %10s %9s\n" anneaux construction events wall_s evt/s us/evt relatif
+
+for n in 5 25 100; do
+    BASE=""
+    for layout in placement replica parameterised; do
+        NAME=bench/rings_${n}_$layout
+        export PUITS_BENCH_NAME=$NAME
+        export PUITS_BENCH_RINGS=$n
+        export PUITS_BENCH_LAYOUT=$layout
+        "$EXE" --quiet --threads "$THREADS" bench_rings.mac \
+            > $NAME.out 2>&1 || { echo "echec : $n anneaux, $layout (voir $NAME.out)"; exit 1; }
+
+        RESULTS=$NAME"_results.json"
+        WALL=$(json_value "$RESULTS" wall_s)
+        NEVT=$(json_value "$RESULTS" events)
+        LINE=$(awk -v r="$n" -v l="$layout" -v n="$NEVT" -v w="$WALL" -v b="$BASE" 'BEGIN {
+            rate = (w > 0) ? n / w : 0
+            if (b == "") b = rate
+            printf "%d,%s,%d,%.3f,%.1f,%.2f,%.3f", r, l, n, w, rate, (n > 0) ? 1e6 * w / n : 0, (b > 0) ? rate / b : 0
+        }')
+        [ -z "$BASE" ] && BASE=$(echo "$LINE" | cut -d, -f5)
+        echo "$LINE" >> bench/rings.csv
+        echo "$LINE" | awk -F, '{ printf "%6d %14s %12d %10.2f %12.1f %10.2f %9.3f\n", $1, $2, $3, $4, $5, $6, $7 }'
+    done
+done
+
+printf "\nTableau : bench/rings.csv (%s thread(s))\n" "$THREADS"
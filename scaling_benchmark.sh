@@ -0,0 +1,64 @@
+#!/bin/sh
+# ═══════════════════════════════════════════════════════════════════════════
+# MISE À L'ÉCHELLE MULTI-THREAD : 1..N threads, événements/s et efficacité
+# ═══════════════════════════════════════════════════════════════════════════
+#
+# Usage :
+#   ./scaling_benchmark.sh [exécutable] [threads max] [événements] [grain] [placement] [gestionnaire]
+#   ./scaling_benchmark.sh ./puits_couronne 32 2000000 100 scatter tasking
+#
+# Nombres de threads testés : 1, 2, 4, ... jusqu'à N (N inclus). Chaque point
+# est un processus séparé (le nombre de threads est fixé au lancement) qui
+# exécute bench_scaling.mac. Le tableau est aussi écrit dans
+# bench/scaling.csv ; efficacité = débit(N) / (N × débit(1)).
+# ═══════════════════════════════════════════════════════════════════════════
+
+EXE=${1:-./puits_couronne}
+MAX_THREADS=${2:-$(nproc)}
+EVENTS=${3:-1000000}
+GRAIN=${4:-0}
+PINNING=${5:-none}
+MANAGER=${6:-tasking}
+
+mkdir -p bench
+export PUITS_BENCH_EVENTS=$EVENTS
+export PUITS_BENCH_GRAIN=$GRAIN
+export PUITS_BENCH_PINNING=$PINNING
+
+# Valeur numérique d'une clé du fichier de résultats (section "run")
+json_value() {
+    sed -n "s/.*\"$2\": \([0-9.eE+-]*\).*/\1/p" "$1" | head -n 1
+}
+
+THREADS=""
+n=1
+while [ "$n" -lt "$MAX_THREADS" ]; do
+    THREADS="$THREADS $n"
+    n=$((n * 2))
+done
+THREADS="$THREADS $MAX_THREADS"
+
+echo "threads,events,wall_s,events_per_s,speedup,efficiency" > bench/scaling.csv
+printf "\n%8s %12s %10s %14s %9s %11s\n" threads events wall_s evt/s speedup efficacite
+
+BASE=""
+for t in $THREADS; do
+    export PUITS_BENCH_NAME=bench/scaling_t$t
+    "$EXE" --quiet --run-manager "$MANAGER" --threads "$t" bench_scaling.mac \
+        > bench/scaling_t$t.out 2>&1 || { echo "echec a $t threads (voir bench/scaling_t$t.out)"; exit 1; }
+
+    RESULTS=bench/scaling_t$t"_results.json"
+    WALL=$(json_value "$RESULTS" wall_s)
+    NEVT=$(json_value "$RESULTS" events)
+    LINE=$(awk -v t="$t" -v n="$NEVT" -v w="$WALL" -v b="$BASE" 'BEGIN {
+        rate = (w > 0) ? n / w : 0
+        if (b == "") b = rate
+        speedup = (b > 0) ? rate / b : 0
+        printf "%d,%d,%.3f,%.1f,%.3f,%.3f", t, n, w, rate, speedup, speedup / t
+    }')
+    [ -z "$BASE" ] && BASE=$(echo "$LINE" | cut -d, -f4)
+    echo "$LINE" >> bench/scaling.csv
+    echo "$LINE" | awk -F, '{ printf "%8d %12d %10.2f %14.1f %9.2f %10.1f%%\n", $1, $2, $3, $4, $5, 100 * $6 }'
+done
+
+printf "\nTableau : bench/scaling.csv (gestionnaire %s, grain %s, placement %s)\n" "$MANAGER" "$GRAIN" "$PINNING"
@@ -3,6 +3,9 @@
 #include "RunAction.hh"
 #include "EventAction.hh"
 #include "SteppingAction.hh"
+#include "ThreadingConfig.hh"
+
+#include "G4Threading.hh"
 
 ActionInitialization::ActionInitialization()
 : G4VUserActionInitialization()
@@ -11,10 +14,22 @@ ActionInitialization::ActionInitialization()
 ActionInitialization::~ActionInitialization()
 {}
 
+void ActionInitialization::BuildForMaster() const
+{
+    // Maître MT/tasking : fusion des compteurs, rapport et fichiers de résultats
+    SetUserAction(new RunAction());
+}
+
 void ActionInitialization::Build() const
 {
-    // Set primary generator action
-    SetUserAction(new PrimaryGeneratorAction);
+    // Appelé une fois au démarrage de chaque thread de travail
+    if (G4Threading::IsWorkerThread()) {
+        ThreadingConfig::GetInstance()->PinCurrentThread(G4Threading::G4GetThreadId());
+    }
+
+    // Set primary generator action (EventAction lit le poids source et l'allocation)
+    PrimaryGeneratorAction* generator = new PrimaryGeneratorAction;
+    SetUserAction(generator);
 
     // ═══════════════════════════════════════════════════════════════
     // Set run action - STOCKER le pointeur pour le passer à EventAction
@@ -23,9 +38,9 @@ void ActionInitialization::Build() const
     SetUserAction(runAction);
 
     // ═══════════════════════════════════════════════════════════════
-    // Set event action - MODIFIÉ : Passer runAction au constructeur
+    // Set event action - MODIFIÉ : Passer runAction et le générateur au constructeur
     // ═══════════════════════════════════════════════════════════════
-    EventAction* eventAction = new EventAction(runAction);
+    EventAction* eventAction = new EventAction(runAction, generator);
     SetUserAction(eventAction);
 
     // Set stepping action (needs EventAction AND RunAction pointers)
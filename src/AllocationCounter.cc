@@ -0,0 +1,374 @@
+#include "AllocationCounter.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4ios.hh"
+#include <cerrno>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+AllocationCounter* AllocationCounter::fInstance = nullptr;
+
+namespace {
+
+// Compteurs du thread courant : type trivial, initialisé statiquement (lu
+// depuis malloc, y compris au démarrage et à l'arrêt des threads)
+struct ThreadCounts
+{
+    G4int depth;
+    G4int scope;
+    G4bool steady;
+    G4long lifetimeEvents;      // toute la vie du thread (chauffe)
+    G4long events;
+    G4long steps;
+    G4long steadyEvents;
+    G4long steadySteps;
+    G4long allocations[AllocationCounter::kNbScopes];
+    G4long bytes[AllocationCounter::kNbScopes];
+    G4long steadyAllocations[AllocationCounter::kNbScopes];
+};
+
+G4ThreadLocal ThreadCounts tCounts = {};
+
+#ifdef PUITS_COUNT_ALLOCATIONS
+inline void CountAllocation(std::size_t size)
+{
+    ThreadCounts& counts = tCounts;
+    if (counts.depth == 0) return;
+    counts.allocations[counts.scope]++;
+    counts.bytes[counts.scope] += static_cast<G4long>(size);
+    if (counts.steady) counts.steadyAllocations[counts.scope]++;
+}
+#endif
+
+const char* kScopeNames[AllocationCounter::kNbScopes] = {
+    "Evenement (generation, debut/fin)",
+    "Pas (SteppingAction)",
+    "Detecteurs (PlaneSD)",
+    "Analyse (hors controle)"
+};
+
+}
+
+// ═══════════════════════════════════════════════════════════════
+// REMPLACEMENT DES FONCTIONS D'ALLOCATION (option de compilation)
+// ═══════════════════════════════════════════════════════════════
+
+#ifdef PUITS_COUNT_ALLOCATIONS
+#if defined(__GLIBC__)
+// glibc : operator new passe par malloc, operator new aligné (C++17) par
+// aligned_alloc ; les allocations alignées sont comptées au même titre.
+// Reste hors comptage : mmap direct et allocateurs qui ne passent pas par
+// la glibc (tcmalloc, jemalloc préchargés)
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void* __libc_valloc(std::size_t size);
+void* __libc_pvalloc(std::size_t size);
+
+void* malloc(std::size_t size)
+{
+    CountAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+    CountAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size)
+{
+    CountAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size)
+{
+    CountAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size)
+{
+    CountAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, std::size_t alignment, std::size_t size)
+{
+    // Alignement : puissance de deux, multiple de sizeof(void*)
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0) {
+        return EINVAL;
+    }
+    CountAllocation(size);
+    void* result = __libc_memalign(alignment, size);
+    if (result == nullptr) return ENOMEM;
+    *pointer = result;
+    return 0;
+}
+
+void* valloc(std::size_t size)
+{
+    CountAllocation(size);
+    return __libc_valloc(size);
+}
+
+void* pvalloc(std::size_t size)
+{
+    CountAllocation(size);
+    return __libc_pvalloc(size);
+}
+}
+#else
+void* operator new(std::size_t size)
+{
+    CountAllocation(size);
+    if (void* pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    CountAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+// Versions alignées (C++17, types sur-alignés)
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    CountAllocation(size);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    CountAllocation(size);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, alignment, tag);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+#endif
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// SINGLETON ET COMMANDES (/puits/alloc/)
+// ═══════════════════════════════════════════════════════════════
+
+AllocationCounter::AllocationCounter()
+: fWarmupEvents(1000),
+  fStrict(false),
+  fMessenger(nullptr)
+{
+    DefineCommands();
+}
+
+AllocationCounter::~AllocationCounter()
+{
+    delete fMessenger;
+}
+
+AllocationCounter* AllocationCounter::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de RunAction)
+    if (fInstance == nullptr) {
+        fInstance = new AllocationCounter();
+    }
+    return fInstance;
+}
+
+void AllocationCounter::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/alloc/",
+        "Allocations du code utilisateur (option PUITS_COUNT_ALLOCATIONS)");
+
+    auto& warmupCmd = fMessenger->DeclareProperty("warmup", fWarmupEvents,
+        "Evenements de chauffe par thread avant le regime etabli");
+    warmupCmd.SetParameterName("nEvents", false);
+    warmupCmd.SetRange("nEvents>=0");
+    warmupCmd.SetStates(G4State_PreInit, G4State_Idle);
+    warmupCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& strictCmd = fMessenger->DeclareProperty("strict", fStrict,
+        "Erreur fatale en fin de run si une allocation subsiste apres la chauffe");
+    strictCmd.SetParameterName("enable", true);
+    strictCmd.SetDefaultValue("true");
+    strictCmd.SetStates(G4State_PreInit, G4State_Idle);
+    strictCmd.SetToBeBroadcasted(false);
+}
+
+G4bool AllocationCounter::IsCompiled()
+{
+#ifdef PUITS_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════
+// PORTÉES ET ÉVÉNEMENTS (thread courant, sans verrou)
+// ═══════════════════════════════════════════════════════════════
+
+void AllocationCounter::Enter(Scope scope)
+{
+    ThreadCounts& counts = tCounts;
+    if (counts.depth++ > 0) return;
+    counts.scope = scope;
+    if (scope == kStep) {
+        counts.steps++;
+        if (counts.steady) counts.steadySteps++;
+    }
+}
+
+void AllocationCounter::Leave()
+{
+    tCounts.depth--;
+}
+
+G4int AllocationCounter::EnterAnalysis()
+{
+    ThreadCounts& counts = tCounts;
+    if (counts.depth == 0) return -1;
+    G4int previous = counts.scope;
+    counts.scope = kAnalysis;
+    return previous;
+}
+
+void AllocationCounter::LeaveAnalysis(G4int previous)
+{
+    if (previous >= 0) tCounts.scope = previous;
+}
+
+void AllocationCounter::EndOfEvent()
+{
+    ThreadCounts& counts = tCounts;
+    counts.events++;
+    if (counts.steady) counts.steadyEvents++;
+    if (++counts.lifetimeEvents >= fInstance->fWarmupEvents) counts.steady = true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// FUSION ET RAPPORT
+// ═══════════════════════════════════════════════════════════════
+
+void AllocationCounter::FlushThread()
+{
+    ThreadCounts& counts = tCounts;
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fTotals.events += counts.events;
+        fTotals.steps += counts.steps;
+        fTotals.steadyEvents += counts.steadyEvents;
+        fTotals.steadySteps += counts.steadySteps;
+        for (G4int s = 0; s < kNbScopes; ++s) {
+            fTotals.allocations[s] += counts.allocations[s];
+            fTotals.bytes[s] += counts.bytes[s];
+            fTotals.steadyAllocations[s] += counts.steadyAllocations[s];
+        }
+    }
+
+    // Le décompte de la chauffe (lifetimeEvents, steady) est conservé d'un run à l'autre
+    counts.events = counts.steps = 0;
+    counts.steadyEvents = counts.steadySteps = 0;
+    for (G4int s = 0; s < kNbScopes; ++s) {
+        counts.allocations[s] = counts.bytes[s] = counts.steadyAllocations[s] = 0;
+    }
+}
+
+void AllocationCounter::Report(std::ostream& os)
+{
+    Totals totals;
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        totals = fTotals;
+        fTotals = Totals();
+    }
+
+    if (!IsCompiled()) return;
+
+    auto perUnit = [](G4long n, G4long units) {
+        return (units > 0) ? static_cast<G4double>(n) / units : 0.;
+    };
+
+    // Remplissages d'analyse : affichés, hors contrôle du régime établi
+    G4long steadyTotal = 0;
+    for (G4int s = 0; s < kAnalysis; ++s) steadyTotal += totals.steadyAllocations[s];
+
+    os << "\n╔═══════════════════════════════════════════════════════════════════════════════════════╗\n";
+    os << "║                    ALLOCATIONS DU CODE UTILISATEUR (PUITS_COUNT_ALLOCATIONS)          ║\n";
+    os << "╠═══════════════════════════════════════════════════════════════════════════════════════╣\n";
+    os << "║  Événements : " << totals.events << " (dont " << totals.steadyEvents
+       << " après chauffe)   Pas : " << totals.steps << " (dont " << totals.steadySteps << ")\n";
+    os << "╠═══════════════════════════════════════╦════════════╦═══════════╦════════════╦══════════╣\n";
+    os << "║ Portée                                ║   Allocs   ║  / evt    ║   / pas    ║ Régime   ║\n";
+    os << "╠═══════════════════════════════════════╬════════════╬═══════════╬════════════╬══════════╣\n";
+    for (G4int s = 0; s < kNbScopes; ++s) {
+        os << "║ " << std::left << std::setw(37) << kScopeNames[s] << std::right << " ║"
+           << std::setw(11) << totals.allocations[s] << " ║"
+           << std::setw(10) << std::fixed << std::setprecision(3) << perUnit(totals.allocations[s], totals.events) << " ║"
+           << std::setw(11) << std::setprecision(5) << perUnit(totals.allocations[s], totals.steps) << " ║"
+           << std::setw(9) << totals.steadyAllocations[s] << " ║\n";
+    }
+    os << "╚═══════════════════════════════════════╩════════════╩═══════════╩════════════╩══════════╝\n";
+    os << std::defaultfloat << std::setprecision(6);
+
+    if (totals.steadyEvents == 0) {
+        os << "  Chauffe non terminée (" << fWarmupEvents << " événements par thread) : "
+           << "régime établi non vérifié\n";
+        // Mode strict : un contrôle qui n'a rien vérifié ne passe pas
+        if (fStrict) {
+            G4ExceptionDescription description;
+            description << "Aucun evenement apres la chauffe (" << fWarmupEvents
+                        << " evenements par thread) : augmenter /run/beamOn ou reduire /puits/alloc/warmup";
+            G4Exception("AllocationCounter::Report", "Alloc002", FatalException, description);
+        }
+    } else if (steadyTotal == 0) {
+        os << "  Régime établi : aucune allocation (OK)\n";
+    } else {
+        os << "  Régime établi : " << steadyTotal << " allocations ("
+           << perUnit(steadyTotal, totals.steadyEvents) << " par événement)\n";
+        if (fStrict) {
+            G4ExceptionDescription description;
+            description << steadyTotal << " allocations du code utilisateur apres "
+                        << fWarmupEvents << " evenements de chauffe :";
+            for (G4int s = 0; s < kAnalysis; ++s) {
+                description << "\n  " << kScopeNames[s] << " : " << totals.steadyAllocations[s];
+            }
+            G4Exception("AllocationCounter::Report", "Alloc001", FatalException, description);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "AttenuatorFastModel.hh"
+#include "AttenuatorKernel.hh"
+
+#include "G4Gamma.hh"
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4Track.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
+
+AttenuatorFastModel::AttenuatorFastModel(const G4String& name, G4Region* envelope)
+: G4VFastSimulationModel(name, envelope),
+  fKernel(AttenuatorKernel::GetInstance())
+{}
+
+AttenuatorFastModel::~AttenuatorFastModel()
+{}
+
+G4bool AttenuatorFastModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+    return &particle == G4Gamma::GammaDefinition();
+}
+
+G4bool AttenuatorFastModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+    if (!fKernel->IsSampling()) return false;
+
+    // Uniquement à l'entrée par une face : un photon sorti (ou entré par le
+    // bord) continue en transport complet
+    const G4ThreeVector& direction = fastTrack.GetPrimaryTrackLocalDirection();
+    if (!fKernel->IsFaceEntry(fastTrack.GetPrimaryTrackLocalPosition(), direction)) return false;
+
+    return fKernel->HasSamples(fastTrack.GetPrimaryTrack()->GetKineticEnergy(), direction);
+}
+
+void AttenuatorFastModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+    const G4Track* track = fastTrack.GetPrimaryTrack();
+    G4double energy = track->GetKineticEnergy();
+
+    G4ThreeVector offset, exitDirection;
+    G4double exitEnergy = 0.;
+    fKernel->Sample(energy, fastTrack.GetPrimaryTrackLocalDirection(),
+                    offset, exitDirection, exitEnergy);
+
+    // Photon absorbé dans la plaque (énergie déposée, non scorée)
+    if (exitEnergy <= 0.) {
+        fastStep.KillPrimaryTrack();
+        fastStep.ProposeTotalEnergyDeposited(energy);
+        return;
+    }
+
+    // Position de sortie (repère local de la plaque) : sur une face, ou
+    // ramenée sur le bord si le décalage latéral dépasse le rayon
+    G4ThreeVector exitPosition = fastTrack.GetPrimaryTrackLocalPosition() + offset;
+    const G4double halfThickness = 0.5 * fKernel->GetThickness();
+    exitPosition.setZ(std::clamp(exitPosition.z(), -halfThickness, halfThickness));
+    if (exitPosition.perp() > fKernel->GetRadius()) {
+        exitPosition.setPerp(fKernel->GetRadius());
+    }
+
+    G4double pathLength = offset.mag();
+    fastStep.ProposePrimaryTrackFinalPosition(exitPosition);
+    fastStep.ProposePrimaryTrackFinalMomentumDirection(exitDirection);
+    fastStep.ProposePrimaryTrackFinalKineticEnergy(exitEnergy);
+    fastStep.ProposePrimaryTrackPathLength(pathLength);
+    fastStep.ProposePrimaryTrackFinalTime(track->GetGlobalTime() + pathLength / c_light);
+    fastStep.ProposeTotalEnergyDeposited(energy - exitEnergy);
+}
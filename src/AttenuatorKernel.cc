@@ -0,0 +1,370 @@
+#include "AttenuatorKernel.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+AttenuatorKernel* AttenuatorKernel::fInstance = nullptr;
+
+const G4double AttenuatorKernel::kEnergyMin = 10.*keV;
+const G4double AttenuatorKernel::kEnergyMax = 2.*MeV;
+
+AttenuatorKernel::AttenuatorKernel()
+: fMaterialName("none"),
+  fThickness(0.),
+  fRadius(0.),
+  fEnabled(false),
+  fRecording(false),
+  fSampling(false),
+  fRetabulate(false),
+  fFileName("attenuator_kernel.dat"),
+  fMaxSamples(5000),
+  fMinSamples(100),
+  fMessenger(nullptr)
+{
+    fBins.resize(kNbEnergyBins * kNbCosBins);
+    DefineCommands();
+}
+
+AttenuatorKernel::~AttenuatorKernel()
+{
+    delete fMessenger;
+}
+
+AttenuatorKernel* AttenuatorKernel::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de DetectorConstruction)
+    if (fInstance == nullptr) {
+        fInstance = new AttenuatorKernel();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/attenuator/kernel/)
+// ═══════════════════════════════════════════════════════════════
+
+void AttenuatorKernel::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/attenuator/kernel/",
+                                        "Noyau de transmission/diffusion de la plaque attenuatrice");
+
+    auto& fileCmd = fMessenger->DeclareProperty("file", fFileName,
+        "Fichier cache du noyau (relu si materiau et epaisseur identiques)");
+    fileCmd.SetParameterName("fileName", false);
+    fileCmd.SetStates(G4State_PreInit, G4State_Idle);
+    fileCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& maxCmd = fMessenger->DeclareProperty("maxSamples", fMaxSamples,
+        "Etats de sortie conserves par case (echantillonnage par reservoir)");
+    maxCmd.SetParameterName("n", false);
+    maxCmd.SetRange("n>0");
+    maxCmd.SetStates(G4State_PreInit, G4State_Idle);
+    maxCmd.SetToBeBroadcasted(false);
+
+    auto& minCmd = fMessenger->DeclareProperty("minSamples", fMinSamples,
+        "Etats minimum pour utiliser une case (sinon transport complet)");
+    minCmd.SetParameterName("n", false);
+    minCmd.SetRange("n>0");
+    minCmd.SetStates(G4State_PreInit, G4State_Idle);
+    minCmd.SetToBeBroadcasted(false);
+
+    auto& retabCmd = fMessenger->DeclareMethod("retabulate", &AttenuatorKernel::Retabulate,
+        "Tabule a nouveau le noyau en transport complet pendant le prochain run");
+    retabCmd.SetParameterName("retabulate", true);
+    retabCmd.SetDefaultValue("true");
+    retabCmd.SetStates(G4State_PreInit, G4State_Idle);
+    retabCmd.SetToBeBroadcasted(false);
+}
+
+void AttenuatorKernel::SetSlab(const G4String& materialName, G4double thickness, G4double radius)
+{
+    // Une autre plaque invalide le noyau en mémoire
+    if (materialName != fMaterialName || thickness != fThickness) {
+        Clear();
+        fSampling = false;
+    }
+    fMaterialName = materialName;
+    fThickness = thickness;
+    fRadius = radius;
+}
+
+void AttenuatorKernel::Clear()
+{
+    for (auto& bin : fBins) {
+        bin.seen = 0;
+        bin.records.clear();
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CYCLE DE VIE (THREAD MAÎTRE)
+// ═══════════════════════════════════════════════════════════════
+
+void AttenuatorKernel::PrepareForRun()
+{
+    fRecording = false;
+    if (!fEnabled) return;
+
+    if (!fRetabulate && (fSampling || Load(fFileName))) {
+        fSampling = true;
+        return;
+    }
+
+    // Pas de cache valide : transport complet dans la plaque pendant ce run
+    Clear();
+    fSampling = false;
+    fRecording = true;
+    G4cout << ">>> Attenuateur : tabulation du noyau en transport complet pendant ce run ("
+           << fMaterialName << ", " << fThickness/mm << " mm) -> " << fFileName << G4endl;
+}
+
+void AttenuatorKernel::FinishRun()
+{
+    if (!fRecording) return;
+
+    fRecording = false;
+    fRetabulate = false;
+    fSampling = true;
+    Save(fFileName);
+    Print();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GRILLE ET REPÈRE LOCAL
+// ═══════════════════════════════════════════════════════════════
+
+G4bool AttenuatorKernel::IsFaceEntry(const G4ThreeVector& localPosition,
+                                     const G4ThreeVector& direction) const
+{
+    const G4double halfThickness = 0.5 * fThickness;
+    if (std::abs(std::abs(localPosition.z()) - halfThickness) > 1.*um) return false;
+    // Face amont (z = -e/2) : direction +z ; face aval (z = +e/2) : direction -z
+    return localPosition.z() * direction.z() < 0.;
+}
+
+G4int AttenuatorKernel::GetBinIndex(G4double energy, const G4ThreeVector& direction) const
+{
+    if (energy < kEnergyMin || energy >= kEnergyMax) return -1;
+
+    G4int iEnergy = static_cast<G4int>(kNbEnergyBins * std::log(energy / kEnergyMin)
+                                       / std::log(kEnergyMax / kEnergyMin));
+    G4int iCos = static_cast<G4int>(kNbCosBins * std::abs(direction.z()));
+    iEnergy = std::min(iEnergy, kNbEnergyBins - 1);
+    iCos = std::min(iCos, kNbCosBins - 1);
+    return iEnergy * kNbCosBins + iCos;
+}
+
+void AttenuatorKernel::BuildFrame(const G4ThreeVector& direction,
+                                  G4ThreeVector& u, G4ThreeVector& v, G4ThreeVector& n)
+{
+    n = G4ThreeVector(0., 0., direction.z() >= 0. ? 1. : -1.);
+
+    G4ThreeVector transverse(direction.x(), direction.y(), 0.);
+    if (transverse.mag2() > 1.e-12) {
+        u = transverse.unit();
+    } else {
+        // Incidence normale : azimut arbitraire (symétrie de la plaque)
+        G4double phi = twopi * G4UniformRand();
+        u = G4ThreeVector(std::cos(phi), std::sin(phi), 0.);
+    }
+    v = n.cross(u);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// TABULATION (RUN EN TRANSPORT COMPLET)
+// ═══════════════════════════════════════════════════════════════
+
+void AttenuatorKernel::Record(G4double energy, const G4ThreeVector& entryDirection,
+                              const G4ThreeVector& offset, const G4ThreeVector& exitDirection,
+                              G4double exitEnergy)
+{
+    G4int index = GetBinIndex(energy, entryDirection);
+    if (index < 0) return;
+
+    G4ThreeVector u, v, n;
+    BuildFrame(entryDirection, u, v, n);
+
+    ExitRecord record;
+    record.energyRatio = static_cast<float>(exitEnergy / energy);
+    record.offsetU = static_cast<float>(offset.dot(u) / mm);
+    record.offsetV = static_cast<float>(offset.dot(v) / mm);
+    record.offsetN = static_cast<float>(offset.dot(n) / mm);
+    record.dirU = static_cast<float>(exitDirection.dot(u));
+    record.dirV = static_cast<float>(exitDirection.dot(v));
+    record.dirN = static_cast<float>(exitDirection.dot(n));
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    KernelBin& bin = fBins[index];
+    bin.seen++;
+    if (static_cast<G4int>(bin.records.size()) < fMaxSamples) {
+        bin.records.push_back(record);
+    } else {
+        // Réservoir : chaque photon vu a la même probabilité d'être conservé
+        G4long slot = static_cast<G4long>(G4UniformRand() * bin.seen);
+        if (slot < fMaxSamples) bin.records[slot] = record;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// RÉÉCHANTILLONNAGE (MODE RAPIDE)
+// ═══════════════════════════════════════════════════════════════
+
+G4bool AttenuatorKernel::HasSamples(G4double energy, const G4ThreeVector& entryDirection) const
+{
+    G4int index = GetBinIndex(energy, entryDirection);
+    return index >= 0 && static_cast<G4int>(fBins[index].records.size()) >= fMinSamples;
+}
+
+void AttenuatorKernel::Sample(G4double energy, const G4ThreeVector& entryDirection,
+                              G4ThreeVector& offset, G4ThreeVector& exitDirection,
+                              G4double& exitEnergy) const
+{
+    const auto& records = fBins[GetBinIndex(energy, entryDirection)].records;
+    const ExitRecord& record = records[std::min(static_cast<size_t>(G4UniformRand() * records.size()),
+                                                records.size() - 1)];
+
+    exitEnergy = record.energyRatio * energy;
+    if (exitEnergy <= 0.) return;
+
+    G4ThreeVector u, v, n;
+    BuildFrame(entryDirection, u, v, n);
+
+    // Symétrie miroir par rapport au plan d'incidence (u, n)
+    G4double mirror = (G4UniformRand() < 0.5) ? 1. : -1.;
+
+    offset = (record.offsetU * u + mirror * record.offsetV * v + record.offsetN * n) * mm;
+    exitDirection = (record.dirU * u + mirror * record.dirV * v + record.dirN * n).unit();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CACHE FICHIER
+// ═══════════════════════════════════════════════════════════════
+
+void AttenuatorKernel::Save(const G4String& fileName) const
+{
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        G4cerr << "AttenuatorKernel: ERROR - Could not open " << fileName << G4endl;
+        return;
+    }
+
+    file << "# Noyau de transmission/diffusion de la plaque attenuatrice\n";
+    file << "# ratio offsetU offsetV offsetN (mm) dirU dirV dirN\n";
+    file << "material " << fMaterialName << "\n";
+    file << "thickness_mm " << std::setprecision(10) << fThickness / mm << "\n";
+    file << "grid " << kNbEnergyBins << " " << kNbCosBins << " "
+         << kEnergyMin / MeV << " " << kEnergyMax / MeV << "\n";
+
+    file << std::setprecision(7);
+    for (size_t i = 0; i < fBins.size(); ++i) {
+        const KernelBin& bin = fBins[i];
+        if (bin.records.empty()) continue;
+        file << "bin " << i << " " << bin.seen << " " << bin.records.size() << "\n";
+        for (const auto& r : bin.records) {
+            file << r.energyRatio << " " << r.offsetU << " " << r.offsetV << " " << r.offsetN << " "
+                 << r.dirU << " " << r.dirV << " " << r.dirN << "\n";
+        }
+    }
+
+    G4cout << ">>> Attenuateur : noyau ecrit dans " << fileName << G4endl;
+}
+
+G4bool AttenuatorKernel::Load(const G4String& fileName)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open()) return false;
+
+    G4String material;
+    G4double thickness_mm = 0.;
+    G4int nEnergy = 0, nCos = 0;
+    G4double eMin = 0., eMax = 0.;
+
+    Clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        std::string key;
+        iss >> key;
+
+        if (key == "material") {
+            iss >> material;
+        } else if (key == "thickness_mm") {
+            iss >> thickness_mm;
+        } else if (key == "grid") {
+            iss >> nEnergy >> nCos >> eMin >> eMax;
+        } else if (key == "bin") {
+            // Le cache doit décrire la même plaque et la même grille
+            if (material != fMaterialName
+                || std::abs(thickness_mm * mm - fThickness) > 1.e-6 * mm
+                || nEnergy != kNbEnergyBins || nCos != kNbCosBins
+                || std::abs(eMin * MeV - kEnergyMin) > 1.e-9 * MeV
+                || std::abs(eMax * MeV - kEnergyMax) > 1.e-9 * MeV) {
+                G4cout << ">>> Attenuateur : cache " << fileName
+                       << " ignore (autre plaque ou autre grille)" << G4endl;
+                Clear();
+                return false;
+            }
+
+            size_t index = 0, nRecords = 0;
+            G4long seen = 0;
+            iss >> index >> seen >> nRecords;
+            if (index >= fBins.size()) { Clear(); return false; }
+
+            KernelBin& bin = fBins[index];
+            bin.seen = seen;
+            bin.records.resize(nRecords);
+            for (auto& r : bin.records) {
+                file >> r.energyRatio >> r.offsetU >> r.offsetV >> r.offsetN
+                     >> r.dirU >> r.dirV >> r.dirN;
+            }
+            if (!file) { Clear(); return false; }
+        }
+    }
+
+    G4cout << ">>> Attenuateur : noyau relu depuis " << fileName << G4endl;
+    Print();
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// AFFICHAGE
+// ═══════════════════════════════════════════════════════════════
+
+void AttenuatorKernel::Print() const
+{
+    G4int nUsable = 0;
+    G4long nSeen = 0, nTransmitted = 0, nStored = 0;
+    const float exitDepth = static_cast<float>(0.999 * fThickness / mm);
+    for (const auto& bin : fBins) {
+        if (static_cast<G4int>(bin.records.size()) >= fMinSamples) nUsable++;
+        nSeen += bin.seen;
+        nStored += bin.records.size();
+        for (const auto& r : bin.records) {
+            if (r.energyRatio > 0.f && r.offsetN > exitDepth) nTransmitted++;
+        }
+    }
+
+    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    G4cout << "║  NOYAU DE L'ATTÉNUATEUR                                       ║" << G4endl;
+    G4cout << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+    G4cout << "║  Plaque              : " << fMaterialName << ", " << fThickness/mm << " mm" << G4endl;
+    G4cout << "║  Photons tabulés     : " << nSeen << G4endl;
+    G4cout << "║  États conservés     : " << nStored << G4endl;
+    G4cout << "║  Cases utilisables   : " << nUsable << " / " << fBins.size()
+           << " (>= " << fMinSamples << " états)" << G4endl;
+    if (nStored > 0) {
+        G4cout << "║  Transmission (réservoir) : " << std::fixed << std::setprecision(4)
+               << static_cast<G4double>(nTransmitted) / nStored
+               << std::defaultfloat << std::setprecision(6) << G4endl;
+    }
+    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+}
@@ -0,0 +1,378 @@
+#include "CascadeLibrary.hh"
+#include "Logger.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4RadioactiveDecay.hh"
+#include "G4HadronicParameters.hh"
+#include "G4NuclearLevelData.hh"
+#include "G4DeexPrecoParameters.hh"
+#include "G4IonTable.hh"
+#include "G4Ions.hh"
+#include "G4GenericIon.hh"
+#include "G4Gamma.hh"
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4VParticleChange.hh"
+#include "G4Version.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+CascadeLibrary* CascadeLibrary::fInstance = nullptr;
+
+namespace
+{
+    const char kMagic[8] = {'P', 'U', 'I', 'T', 'S', 'C', 'A', 'S'};
+    const std::uint32_t kVersion = 1;
+    const G4int kMaxParticlesPerDecay = 255;   // multiplicité stockée sur un octet
+
+    template <typename T>
+    void WriteValue(std::ostream& os, const T& value)
+    {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void ReadValue(std::istream& is, T& value)
+    {
+        is.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+}
+
+CascadeLibrary::CascadeLibrary()
+: fEnabled(false),
+  fConeOnly(true),
+  fFileName("eu152_cascades.bin"),
+  fMessenger(nullptr)
+{
+    DefineCommands();
+}
+
+CascadeLibrary::~CascadeLibrary()
+{
+    delete fMessenger;
+}
+
+CascadeLibrary* CascadeLibrary::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de RunAction)
+    if (fInstance == nullptr) {
+        fInstance = new CascadeLibrary();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/cascade/)
+// ═══════════════════════════════════════════════════════════════
+
+void CascadeLibrary::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/cascade/",
+                                        "Source par cascades de desintegration Eu-152 precalculees");
+
+    auto& enableCmd = fMessenger->DeclareProperty("enable", fEnabled,
+        "Une desintegration complete par evenement, tiree dans la bibliotheque");
+    enableCmd.SetParameterName("enable", true);
+    enableCmd.SetDefaultValue("true");
+    enableCmd.SetStates(G4State_PreInit, G4State_Idle);
+    enableCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& fileCmd = fMessenger->DeclareProperty("file", fFileName,
+        "Fichier binaire de la bibliotheque (ecrit par build, lu au debut du run)");
+    fileCmd.SetParameterName("fileName", false);
+    fileCmd.SetStates(G4State_PreInit, G4State_Idle);
+    fileCmd.SetToBeBroadcasted(false);
+
+    auto& buildCmd = fMessenger->DeclareMethod("build", &CascadeLibrary::Build,
+        "Desintegre N noyaux d'Eu-152 (G4RadioactiveDecay) et ecrit la bibliotheque");
+    buildCmd.SetParameterName("nDecays", true);
+    buildCmd.SetDefaultValue("1000000");
+    buildCmd.SetRange("nDecays>0");
+    buildCmd.SetStates(G4State_Idle);      // tables d'ions et EM initialisées
+    buildCmd.SetToBeBroadcasted(false);
+
+    auto& coneCmd = fMessenger->DeclareProperty("coneOnly", fConeOnly,
+        "N'emet que les particules dans le cone d'emission (false : 4 pi)");
+    coneCmd.SetParameterName("coneOnly", true);
+    coneCmd.SetDefaultValue("true");
+    coneCmd.SetStates(G4State_PreInit, G4State_Idle);
+    coneCmd.SetToBeBroadcasted(false);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GÉNÉRATION DE LA BIBLIOTHÈQUE (THREAD MAÎTRE)
+// ═══════════════════════════════════════════════════════════════
+
+void CascadeLibrary::Build(G4int nDecays)
+{
+#if G4VERSION_NUMBER >= 1120
+    // Période de 13,5 ans : au-delà du seuil par défaut (1 an), la
+    // désintégration serait ignorée par G4RadioactiveDecay
+    G4HadronicParameters::Instance()->SetTimeThresholdForRadioactiveDecay(1.e+60*CLHEP::year);
+#endif
+    // Corrélations angulaires entre gammas successifs d'une cascade
+    G4NuclearLevelData::GetInstance()->GetParameters()->SetCorrelatedGamma(true);
+
+    G4ParticleDefinition* eu152 = G4IonTable::GetIonTable()->GetIon(63, 152, 0.);
+    if (eu152 == nullptr) {
+        G4Exception("CascadeLibrary::Build", "Casc001", JustWarning,
+                    "Ion Eu-152 introuvable (donnees G4ENSDFSTATE ?) : bibliotheque non generee");
+        return;
+    }
+
+    // Processus hors liste de physique : appelé directement sur des noyaux
+    // au repos, conversion interne et relaxation atomique (X, Auger) actives
+    auto decay = new G4RadioactiveDecay();
+    decay->SetICM(true);
+    decay->SetARM(true);
+    decay->SelectAllVolumes();
+    decay->BuildPhysicsTable(*G4GenericIon::GenericIon());
+
+    G4cout << ">>> Cascades : desintegration de " << nDecays << " noyaux d'Eu-152 -> "
+           << fFileName << G4endl;
+
+    fParticles.clear();
+    fParticles.reserve(static_cast<std::size_t>(nDecays) * 8);
+    fFirst.assign(1, 0);
+    fFirst.reserve(static_cast<std::size_t>(nDecays) + 1);
+
+    std::vector<G4DynamicParticle*> pending;
+    G4Step step;
+    G4int truncated = 0;
+
+    for (G4int i = 0; i < nDecays; ++i) {
+        pending.push_back(new G4DynamicParticle(eu152, G4ThreeVector(0., 0., 1.), 0.));
+
+        // Désintégration puis désexcitation des niveaux du noyau fils,
+        // une transition par appel, jusqu'à l'état fondamental
+        while (!pending.empty()) {
+            G4DynamicParticle* nucleus = pending.back();
+            pending.pop_back();
+
+            // Noyau au repos à t = 0 (la trace libère la particule dynamique)
+            G4Track track(nucleus, 0., G4ThreeVector());
+            track.SetTrackStatus(fStopButAlive);
+
+            G4VParticleChange* change = decay->AtRestDoIt(track, step);
+            for (G4int s = 0; s < change->GetNumberOfSecondaries(); ++s) {
+                G4Track* secondary = change->GetSecondary(s);
+                const G4ParticleDefinition* definition = secondary->GetDefinition();
+                const G4ThreeVector& direction = secondary->GetMomentumDirection();
+
+                G4int species = (definition == G4Gamma::Definition()) ? kGamma
+                              : (definition == G4Electron::Definition()) ? kElectron
+                              : (definition == G4Positron::Definition()) ? kPositron : -1;
+
+                if (species >= 0) {
+                    fParticles.push_back({static_cast<float>(secondary->GetKineticEnergy() / keV),
+                                          static_cast<float>(direction.x()),
+                                          static_cast<float>(direction.y()),
+                                          static_cast<float>(direction.z()),
+                                          static_cast<std::uint8_t>(species)});
+                } else {
+                    // Niveau excité du noyau fils (recul négligé) ; neutrinos
+                    // et noyaux à l'état fondamental écartés
+                    auto ion = dynamic_cast<const G4Ions*>(definition);
+                    if (ion && ion->GetExcitationEnergy() > 0.) {
+                        pending.push_back(new G4DynamicParticle(definition, direction, 0.));
+                    }
+                }
+                delete secondary;
+            }
+            change->Clear();
+        }
+
+        if (fParticles.size() - fFirst.back() > static_cast<std::size_t>(kMaxParticlesPerDecay)) {
+            fParticles.resize(fFirst.back() + kMaxParticlesPerDecay);
+            ++truncated;
+        }
+        fFirst.push_back(static_cast<std::uint32_t>(fParticles.size()));
+    }
+
+    delete decay;
+
+    if (truncated > 0) {
+        G4ExceptionDescription ed;
+        ed << truncated << " desintegration(s) tronquee(s) a " << kMaxParticlesPerDecay << " particules";
+        G4Exception("CascadeLibrary::Build", "Casc001", JustWarning, ed);
+    }
+
+    fLoadedFile = Save(fFileName) ? fFileName : G4String("");
+    Print(G4cout);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CYCLE DE VIE ET TIRAGE
+// ═══════════════════════════════════════════════════════════════
+
+void CascadeLibrary::PrepareForRun()
+{
+    if (!fEnabled) return;
+    if (!fLoadedFile.empty() && fLoadedFile == fFileName) return;
+
+    if (!Load(fFileName)) {
+        G4ExceptionDescription ed;
+        ed << "Bibliotheque de cascades " << fFileName << " illisible ou absente"
+           << " (/puits/cascade/build N apres /run/initialize)";
+        G4Exception("CascadeLibrary::PrepareForRun", "Casc002", FatalException, ed);
+        return;
+    }
+    fLoadedFile = fFileName;
+    Print(Logger::GetInstance()->Banner());
+}
+
+const CascadeLibrary::Particle* CascadeLibrary::SampleDecay(G4int& count) const
+{
+    const std::size_t nDecays = GetNbDecays();
+    const std::size_t i = std::min(nDecays - 1, static_cast<std::size_t>(G4UniformRand() * nDecays));
+    count = static_cast<G4int>(fFirst[i + 1] - fFirst[i]);
+    return fParticles.data() + fFirst[i];
+}
+
+void CascadeLibrary::SampleRotation(G4ThreeVector& e1, G4ThreeVector& e2, G4ThreeVector& e3)
+{
+    // e3 isotrope, e1 uniforme dans le plan orthogonal : rotation uniforme
+    G4double cosTheta = 2. * G4UniformRand() - 1.;
+    G4double sinTheta = std::sqrt(std::max(0., 1. - cosTheta * cosTheta));
+    G4double phi = CLHEP::twopi * G4UniformRand();
+    e3 = G4ThreeVector(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+
+    G4ThreeVector a = e3.orthogonal().unit();
+    G4ThreeVector b = e3.cross(a);
+    G4double psi = CLHEP::twopi * G4UniformRand();
+    e1 = std::cos(psi) * a + std::sin(psi) * b;
+    e2 = e3.cross(e1);
+}
+
+const G4ParticleDefinition* CascadeLibrary::GetDefinition(G4int species)
+{
+    switch (species) {
+        case kElectron: return G4Electron::Definition();
+        case kPositron: return G4Positron::Definition();
+        default:        return G4Gamma::Definition();
+    }
+}
+
+const char* CascadeLibrary::GetSpeciesName(G4int species)
+{
+    static const char* const kNames[kNbSpecies] = {"gamma", "e-", "e+"};
+    return (species >= 0 && species < kNbSpecies) ? kNames[species] : "?";
+}
+
+void CascadeLibrary::Print(std::ostream& os) const
+{
+    const std::size_t nDecays = GetNbDecays();
+    std::array<G4double, kNbSpecies> count {};
+    std::array<G4double, kNbSpecies> energy {};
+    for (const auto& p : fParticles) {
+        count[p.species] += 1.;
+        energy[p.species] += p.energy_keV;
+    }
+
+    os << "\n╔═══════════════════════════════════════════════════════════════╗\n";
+    os << "║  CASCADES Eu-152 : " << std::setw(10) << nDecays << " desintegrations                  ║\n";
+    os << "╠═══════════════════════════════════════════════════════════════╣\n";
+    os << "║  Espece | Particules/desint. | Energie moyenne (keV)          ║\n";
+    for (G4int s = 0; s < kNbSpecies; ++s) {
+        os << "║  " << std::setw(6) << GetSpeciesName(s) << " | "
+           << std::setw(18) << std::fixed << std::setprecision(4)
+           << (nDecays > 0 ? count[s] / nDecays : 0.) << " | "
+           << std::setw(21) << std::setprecision(2)
+           << (count[s] > 0. ? energy[s] / count[s] : 0.) << "          ║\n";
+    }
+    os << "╚═══════════════════════════════════════════════════════════════╝\n" << std::flush;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// FICHIER BINAIRE
+// ═══════════════════════════════════════════════════════════════
+
+G4bool CascadeLibrary::Save(const G4String& fileName) const
+{
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        G4cerr << "CascadeLibrary: ERROR - Could not open " << fileName << G4endl;
+        return false;
+    }
+
+    const std::uint32_t nDecays = static_cast<std::uint32_t>(GetNbDecays());
+    const std::uint64_t nParticles = fParticles.size();
+    file.write(kMagic, sizeof(kMagic));
+    WriteValue(file, kVersion);
+    WriteValue(file, nDecays);
+    WriteValue(file, nParticles);
+
+    for (std::uint32_t i = 0; i < nDecays; ++i) {
+        WriteValue(file, static_cast<std::uint8_t>(fFirst[i + 1] - fFirst[i]));
+    }
+    for (const auto& p : fParticles) {
+        WriteValue(file, p.species);
+        WriteValue(file, p.energy_keV);
+        WriteValue(file, p.dirX);
+        WriteValue(file, p.dirY);
+        WriteValue(file, p.dirZ);
+    }
+
+    if (!file) {
+        G4cerr << "CascadeLibrary: ERROR - Write failed for " << fileName << G4endl;
+        return false;
+    }
+    G4cout << ">>> Cascades : " << nDecays << " desintegrations, " << nParticles
+           << " particules ecrites dans " << fileName << G4endl;
+    return true;
+}
+
+G4bool CascadeLibrary::Load(const G4String& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[sizeof(kMagic)];
+    std::uint32_t version = 0, nDecays = 0;
+    std::uint64_t nParticles = 0;
+    file.read(magic, sizeof(magic));
+    ReadValue(file, version);
+    ReadValue(file, nDecays);
+    ReadValue(file, nParticles);
+    if (!file || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0
+        || version != kVersion || nDecays == 0) {
+        G4cout << ">>> Cascades : " << fileName << " n'est pas une bibliotheque (version "
+               << kVersion << ")" << G4endl;
+        return false;
+    }
+
+    std::vector<std::uint32_t> first(nDecays + 1, 0);
+    for (std::uint32_t i = 0; i < nDecays; ++i) {
+        std::uint8_t count = 0;
+        ReadValue(file, count);
+        first[i + 1] = first[i] + count;
+    }
+    if (!file || first.back() != nParticles) return false;
+
+    std::vector<Particle> particles(nParticles);
+    for (auto& p : particles) {
+        ReadValue(file, p.species);
+        ReadValue(file, p.energy_keV);
+        ReadValue(file, p.dirX);
+        ReadValue(file, p.dirY);
+        ReadValue(file, p.dirZ);
+        if (p.species >= kNbSpecies) return false;
+    }
+    if (!file) return false;
+
+    fFirst.swap(first);
+    fParticles.swap(particles);
+    G4cout << ">>> Cascades : " << nDecays << " desintegrations lues dans " << fileName << G4endl;
+    return true;
+}
@@ -0,0 +1,83 @@
+#include "CorrelatedSampling.hh"
+
+#include "G4GenericMessenger.hh"
+#include "Randomize.hh"
+
+#include <cstdint>
+
+CorrelatedSampling* CorrelatedSampling::fInstance = nullptr;
+
+namespace
+{
+    // Mélangeur SplitMix64 : graines décorrélées pour des numéros voisins
+    uint64_t SplitMix64(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+}
+
+CorrelatedSampling::CorrelatedSampling()
+: fEnabled(false),
+  fBaseSeed(12345),
+  fMessenger(nullptr)
+{
+    DefineCommands();
+}
+
+CorrelatedSampling::~CorrelatedSampling()
+{
+    delete fMessenger;
+}
+
+CorrelatedSampling* CorrelatedSampling::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de RunAction)
+    if (fInstance == nullptr) {
+        fInstance = new CorrelatedSampling();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/corr/)
+// ═══════════════════════════════════════════════════════════════
+
+void CorrelatedSampling::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/corr/",
+                                        "Echantillonnage correle entre variantes de geometrie");
+
+    auto& enableCmd = fMessenger->DeclareProperty("enable", fEnabled,
+        "Graine de chaque evenement derivee de la graine de base et du numero d'evenement");
+    enableCmd.SetParameterName("enable", true);
+    enableCmd.SetDefaultValue("true");
+    enableCmd.SetStates(G4State_PreInit, G4State_Idle);
+    enableCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& seedCmd = fMessenger->DeclareProperty("seed", fBaseSeed,
+        "Graine de base, identique pour toutes les variantes comparees");
+    seedCmd.SetParameterName("seed", false);
+    seedCmd.SetStates(G4State_PreInit, G4State_Idle);
+    seedCmd.SetToBeBroadcasted(false);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GRAINE PAR ÉVÉNEMENT
+// ═══════════════════════════════════════════════════════════════
+
+void CorrelatedSampling::SeedEvent(G4int eventID) const
+{
+    uint64_t h = SplitMix64(SplitMix64(static_cast<uint64_t>(fBaseSeed))
+                            ^ static_cast<uint64_t>(static_cast<uint32_t>(eventID)));
+
+    // Deux graines dans les intervalles valides de RanecuEngine, terminées par 0
+    long seeds[3] = {
+        1 + static_cast<long>((h & 0xFFFFFFFFULL) % 2147483562ULL),
+        1 + static_cast<long>((h >> 32) % 2147483398ULL),
+        0
+    };
+    G4Random::setTheSeeds(seeds, -1);
+}
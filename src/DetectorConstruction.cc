@@ -1,4 +1,12 @@
 #include "DetectorConstruction.hh"
+#include "EmissionCone.hh"
+#include "SourceScan.hh"
+#include "PhysicsList.hh"
+#include "AttenuatorKernel.hh"
+#include "AttenuatorFastModel.hh"
+#include "PlaneSD.hh"
+#include "RingParameterisation.hh"
+#include "Logger.hh"
 
 #include "G4RunManager.hh"
 #include "G4NistManager.hh"
@@ -6,12 +14,28 @@
 #include "G4Tubs.hh"
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
+#include "G4PVReplica.hh"
+#include "G4PVParameterised.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4VisAttributes.hh"
 #include "G4Colour.hh"
 #include "G4UserLimits.hh"
 #include "G4UnitsTable.hh"
+#include "G4GenericMessenger.hh"
+#include "G4RunManagerKernel.hh"
+#include "G4BOptrForceCollision.hh"
+#include "G4Region.hh"
+#include "G4SDManager.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4UIcommand.hh"
+#ifdef G4LIB_USE_GDML
+#include "G4GDMLParser.hh"
+#endif
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
 
 DetectorConstruction::DetectorConstruction()
 : G4VUserDetectorConstruction(),
@@ -22,38 +46,455 @@ DetectorConstruction::DetectorConstruction()
   fPolystyreneThickness(1.0*mm),          // Épaisseur paroi PS : 1 mm
   fWaterThickness1(2.0*mm),               // Première tranche d'eau : 2 mm
   fWaterThickness2(1.0*mm),               // Deuxième tranche d'eau : 1 mm (anneaux)
+  fNbWaterRings(5),                       // 5 anneaux (disque central inclus)
   fRingWidth(5.0*mm),                     // Largeur des anneaux : 5 mm
+  fRingWidthRequest(0.),                  // 0 : rayon du container / nombre d'anneaux
+  fRingLayout(kPlacement),
   fPreContainerPlaneThickness(1.0*mm),    // PreContainerPlane : 1 mm (AIR)
   fPreContainerPlaneRadius(25.0*mm),      // Rayon PreContainer : 25 mm = 2.5 cm
   fTungstenFoilThickness(50.0*um),        // Feuille W : 50 µm
   fTungstenFoilRadius(25.0*mm),           // Rayon feuille W : 25 mm
-  fSourceToWaterDistance(25.0*mm)         // Distance source-eau : 25 mm
+  fTungstenFoil(true),
+  fSourceToWaterDistance(25.0*mm),        // Distance source-eau : 25 mm
+  fTightWorld(false),
+  fWorldMargin(10.0*mm),                  // Marge autour de l'empilement : 1 cm
+  fWorldHalfXY(25.0*cm),                  // Monde : 50 cm
+  fWorldHalfZ(25.0*cm),
+  fEnvelopeHalfXY(20.0*cm),               // Enveloppe : 40 cm
+  fEnvelopeHalfZ(20.0*cm),
+  fEnvelopeCenterZ(0.),
+  fForceCollision(false),
+  fAttenuatorMaterialName("none"),        // Pas de plaque par défaut
+  fAttenuatorThickness(10.0*mm),          // Plaque : 10 mm
+  fAttenuatorFastSim(false),
+  fAttenuatorRegion(nullptr),
+  fAttenuatorLogical(nullptr),
+  fPreContainerPlaneLogical(nullptr),
+  fPostContainerPlaneLogical(nullptr),
+  fWaterMaxStep(0.1*mm),                  // Steps courts dans l'eau (dose, kerma)
+  fGdmlExportFile(""),
+  fGdmlImportFile(""),
+  fMessenger(nullptr),
+  fAttenuatorMessenger(nullptr),
+  fGeometryMessenger(nullptr)
 {
-    fRingMasses.resize(kNbWaterRings, 0.);
+    fRingMasses.resize(fNbWaterRings, 0.);
+    
+    // Crée le cône d'émission (et ses commandes /puits/source/) sur le thread maître
+    EmissionCone::GetInstance();
+    SourceScan::GetInstance();
+    
+    // Noyau de la plaque atténuatrice (et ses commandes /puits/attenuator/kernel/)
+    AttenuatorKernel::GetInstance();
+    
+    DefineCommands();
 }
 
 DetectorConstruction::~DetectorConstruction()
-{}
+{
+    delete fMessenger;
+    delete fAttenuatorMessenger;
+    delete fGeometryMessenger;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/vr/, /puits/attenuator/, /puits/geometry/)
+// ═══════════════════════════════════════════════════════════════
+
+void DetectorConstruction::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/vr/", "Reduction de variance");
+    
+    auto& forceCmd = fMessenger->DeclareMethod("forceCollision",
+        &DetectorConstruction::SetForceCollision,
+        "Collision forcee des gammas dans les anneaux d'eau (poids statistiques)");
+    forceCmd.SetParameterName("enable", true);
+    forceCmd.SetDefaultValue("true");
+    forceCmd.SetStates(G4State_PreInit);
+    forceCmd.SetToBeBroadcasted(false);
+    
+    fAttenuatorMessenger = new G4GenericMessenger(this, "/puits/attenuator/",
+                                                  "Plaque attenuatrice avant le PreContainer");
+    
+    auto& materialCmd = fAttenuatorMessenger->DeclareProperty("material", fAttenuatorMaterialName,
+        "Materiau NIST de la plaque (ex. G4_PLEXIGLASS, G4_W) ou none");
+    materialCmd.SetParameterName("material", false);
+    materialCmd.SetStates(G4State_PreInit);
+    materialCmd.SetToBeBroadcasted(false);
+    
+    auto& thicknessCmd = fAttenuatorMessenger->DeclarePropertyWithUnit("thickness", "mm",
+        fAttenuatorThickness, "Epaisseur de la plaque (face aval contre le PreContainer)");
+    thicknessCmd.SetParameterName("thickness", false);
+    thicknessCmd.SetRange("thickness>0.");
+    thicknessCmd.SetStates(G4State_PreInit);
+    thicknessCmd.SetToBeBroadcasted(false);
+    
+    auto& fastCmd = fAttenuatorMessenger->DeclareMethod("fastSim",
+        &DetectorConstruction::SetAttenuatorFastSim,
+        "Simulation rapide de la plaque par noyau tabule (tabulation au premier run)");
+    fastCmd.SetParameterName("enable", true);
+    fastCmd.SetDefaultValue("true");
+    fastCmd.SetStates(G4State_PreInit);
+    fastCmd.SetToBeBroadcasted(false);
+    
+    // Variantes de géométrie (comparaisons par échantillonnage corrélé)
+    fGeometryMessenger = new G4GenericMessenger(this, "/puits/geometry/", "Variantes de geometrie");
+    
+    auto& foilCmd = fGeometryMessenger->DeclareProperty("tungstenFoil", fTungstenFoil,
+        "Feuille de tungstene sous le polystyrene (true par defaut)");
+    foilCmd.SetParameterName("enable", true);
+    foilCmd.SetDefaultValue("true");
+    foilCmd.SetStates(G4State_PreInit);
+    foilCmd.SetToBeBroadcasted(false);
+    
+    auto& ringsCmd = fGeometryMessenger->DeclareProperty("rings", fNbWaterRings,
+        "Nombre d'anneaux d'eau (5 par defaut)");
+    ringsCmd.SetParameterName("n", false);
+    ringsCmd.SetRange("n>=1 && n<=" + std::to_string(kMaxWaterRings));
+    ringsCmd.SetStates(G4State_PreInit);
+    ringsCmd.SetToBeBroadcasted(false);
+    
+    auto& widthCmd = fGeometryMessenger->DeclarePropertyWithUnit("ringWidth", "mm", fRingWidthRequest,
+        "Largeur des anneaux (0 : rayon du container / nombre d'anneaux)");
+    widthCmd.SetParameterName("width", false);
+    widthCmd.SetRange("width>=0.");
+    widthCmd.SetStates(G4State_PreInit);
+    widthCmd.SetToBeBroadcasted(false);
+    
+    auto& layoutCmd = fGeometryMessenger->DeclareMethod("ringLayout", &DetectorConstruction::SetRingLayout,
+        "Construction des anneaux : placement (defaut), replica ou parameterised");
+    layoutCmd.SetParameterName("layout", false);
+    layoutCmd.SetCandidates("placement replica parameterised");
+    layoutCmd.SetStates(G4State_PreInit);
+    layoutCmd.SetToBeBroadcasted(false);
+    
+    auto& exportCmd = fGeometryMessenger->DeclareProperty("gdmlExport", fGdmlExportFile,
+        "Ecrit la geometrie construite (et ses etiquettes) dans ce fichier GDML");
+    exportCmd.SetParameterName("file", false);
+    exportCmd.SetStates(G4State_PreInit);
+    exportCmd.SetToBeBroadcasted(false);
+    
+    auto& importCmd = fGeometryMessenger->DeclareProperty("gdmlImport", fGdmlImportFile,
+        "Construit la geometrie a partir de ce fichier GDML (ecrit par gdmlExport)");
+    importCmd.SetParameterName("file", false);
+    importCmd.SetStates(G4State_PreInit);
+    importCmd.SetToBeBroadcasted(false);
+    
+    auto& tightCmd = fGeometryMessenger->DeclareProperty("tightWorld", fTightWorld,
+        "Monde et enveloppe ajustes a l'empilement et a la source (+ worldMargin)");
+    tightCmd.SetParameterName("enable", true);
+    tightCmd.SetDefaultValue("true");
+    tightCmd.SetStates(G4State_PreInit);
+    tightCmd.SetToBeBroadcasted(false);
+    
+    auto& marginCmd = fGeometryMessenger->DeclarePropertyWithUnit("worldMargin", "mm", fWorldMargin,
+        "Marge d'air autour de l'empilement et de la source (tightWorld)");
+    marginCmd.SetParameterName("margin", false);
+    marginCmd.SetRange("margin>0.");
+    marginCmd.SetStates(G4State_PreInit);
+    marginCmd.SetToBeBroadcasted(false);
+}
+
+void DetectorConstruction::SetForceCollision(G4bool enable)
+{
+    fForceCollision = enable;
+    if (!enable) return;
+    
+    // Le biaisage doit envelopper les processus gamma avant /run/initialize
+    auto physicsList = dynamic_cast<PhysicsList*>(
+        G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+    if (physicsList) {
+        physicsList->EnableForcedCollision();
+    } else {
+        G4cerr << "DetectorConstruction: ERREUR - liste de physique incompatible, "
+               << "collision forcee ignoree" << G4endl;
+        fForceCollision = false;
+    }
+}
+
+void DetectorConstruction::SetAttenuatorFastSim(G4bool enable)
+{
+    fAttenuatorFastSim = enable;
+    if (!enable) return;
+    
+    // Le processus de simulation rapide doit être enregistré avant /run/initialize
+    auto physicsList = dynamic_cast<PhysicsList*>(
+        G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+    if (physicsList) {
+        physicsList->EnableFastSimulation();
+    } else {
+        G4cerr << "DetectorConstruction: ERREUR - liste de physique incompatible, "
+               << "simulation rapide ignoree" << G4endl;
+        fAttenuatorFastSim = false;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// OPÉRATEURS DE BIAISAGE ET MODÈLE RAPIDE (appelé sur chaque thread)
+// ═══════════════════════════════════════════════════════════════
+
+void DetectorConstruction::ConstructSDandField()
+{
+    // Courant de surface aux plans container (photons et électrons, par sens)
+    auto preContainerSD = new PlaneSD("PreContainerPlaneSD", PlaneSD::kPreContainer);
+    auto postContainerSD = new PlaneSD("PostContainerPlaneSD", PlaneSD::kPostContainer);
+    G4SDManager::GetSDMpointer()->AddNewDetector(preContainerSD);
+    G4SDManager::GetSDMpointer()->AddNewDetector(postContainerSD);
+    SetSensitiveDetector(fPreContainerPlaneLogical, preContainerSD);
+    SetSensitiveDetector(fPostContainerPlaneLogical, postContainerSD);
+    
+    // Modèle rapide de la plaque : inactif tant que le noyau n'est pas tabulé
+    if (fAttenuatorFastSim && fAttenuatorRegion) {
+        new AttenuatorFastModel("AttenuatorKernelModel", fAttenuatorRegion);
+        G4cout << ">>> Modele rapide attache a la plaque attenuatrice" << G4endl;
+    }
+    
+    if (!fForceCollision) return;
+    
+    // Un opérateur par volume logique d'anneau (un seul en replica /
+    // paramétré) : à l'entrée, le gamma est cloné en une copie non
+    // collisionnée (poids w·exp(-µL)) et une copie forcée à interagir dans
+    // l'anneau (poids w·(1 - exp(-µL)))
+    for (auto logicRing : fWaterRingLogicals) {
+        auto forceCollision = new G4BOptrForceCollision("gamma", "ForceCollision_" + logicRing->GetName());
+        forceCollision->AttachTo(logicRing);
+    }
+    
+    G4cout << ">>> Collision forcee des gammas attachee aux " << fNbWaterRings
+           << " anneaux d'eau" << G4endl;
+}
 
 G4String DetectorConstruction::GetWaterRingName(G4int ringIndex)
 {
     return "WaterRing_" + std::to_string(ringIndex);
 }
 
-G4double DetectorConstruction::GetRingInnerRadius(G4int ringIndex)
+G4String DetectorConstruction::GetRingLayoutName() const
 {
-    return ringIndex * 5.0 * mm;
+    switch (fRingLayout) {
+        case kReplica:       return "replica";
+        case kParameterised: return "parameterised";
+        default:             return "placement";
+    }
+}
+
+void DetectorConstruction::SetRingLayout(const G4String& name)
+{
+    if (name == "replica") {
+        fRingLayout = kReplica;
+    } else if (name == "parameterised") {
+        fRingLayout = kParameterised;
+    } else {
+        fRingLayout = kPlacement;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// ANNEAUX D'EAU (placements, replica radial ou paramétrisation)
+// ═══════════════════════════════════════════════════════════════
+
+void DetectorConstruction::ConstructWaterRings(G4LogicalVolume* logicEnveloppe,
+                                               G4double centerZ,
+                                               G4UserLimits* waterLimits)
+{
+    std::ostream& banner = Logger::GetInstance()->Banner();
+    
+    // Largeur : demandée, sinon le rayon du container partagé en fNbWaterRings
+    fRingWidth = (fRingWidthRequest > 0.) ? fRingWidthRequest : fContainerRadius / fNbWaterRings;
+    const G4double layerRadius = fNbWaterRings * fRingWidth;
+    if (layerRadius > fContainerRadius * (1. + 1e-9)) {
+        G4ExceptionDescription ed;
+        ed << fNbWaterRings << " anneaux de " << fRingWidth/mm << " mm depassent le rayon du container ("
+           << fContainerRadius/mm << " mm)";
+        G4Exception("DetectorConstruction::ConstructWaterRings", "Geom001", FatalException, ed);
+    }
+    
+    std::vector<G4Colour> ringColors = {
+        G4Colour(0.0, 0.3, 1.0, 0.6),
+        G4Colour(0.0, 0.4, 1.0, 0.6),
+        G4Colour(0.0, 0.5, 1.0, 0.6),
+        G4Colour(0.0, 0.6, 1.0, 0.6),
+        G4Colour(0.0, 0.7, 1.0, 0.6)
+    };
+    
+    fWaterRingLogicals.clear();
+    fRingMasses.assign(fNbWaterRings, 0.);
+    G4double waterDensity = fWater->GetDensity();
+    
+    if (fRingLayout == kPlacement) {
+        // Un volume par anneau, placés côte à côte dans l'enveloppe
+        for (G4int i = 0; i < fNbWaterRings; ++i) {
+            G4String ringName = GetWaterRingName(i);
+            
+            G4Tubs* solidRing = new G4Tubs(ringName,
+                                            GetRingInnerRadius(i),
+                                            GetRingOuterRadius(i),
+                                            fWaterThickness2/2,
+                                            0.*deg, 360.*deg);
+
+            G4LogicalVolume* logicRing = new G4LogicalVolume(solidRing, fWater, ringName + "Log");
+            logicRing->SetUserLimits(waterLimits);
+            
+            G4VisAttributes* ringVis = new G4VisAttributes(ringColors[i % ringColors.size()]);
+            ringVis->SetForceSolid(true);
+            logicRing->SetVisAttributes(ringVis);
+
+            new G4PVPlacement(nullptr,
+                              G4ThreeVector(0, 0, centerZ),
+                              logicRing,
+                              ringName,
+                              logicEnveloppe,
+                              false,
+                              i,
+                              true);
+
+            fWaterRingLogicals.push_back(logicRing);
+        }
+    } else {
+        // Tube conteneur rempli par les anneaux : la navigation ne voit qu'un
+        // volume fille (replica : voxels radiaux, recherche en O(1))
+        G4Tubs* solidLayer = new G4Tubs("WaterRingLayer", 0., layerRadius,
+                                        fWaterThickness2/2, 0.*deg, 360.*deg);
+        G4LogicalVolume* logicLayer = new G4LogicalVolume(solidLayer, fWater, "WaterRingLayerLog");
+        logicLayer->SetUserLimits(waterLimits);
+        logicLayer->SetVisAttributes(G4VisAttributes::GetInvisible());
+        
+        new G4PVPlacement(nullptr,
+                          G4ThreeVector(0, 0, centerZ),
+                          logicLayer,
+                          "WaterRingLayer",
+                          logicEnveloppe,
+                          false,
+                          0,
+                          true);
+        
+        // Dimensions du premier anneau (replica) ; la paramétrisation les remplace
+        G4Tubs* solidRing = new G4Tubs("WaterRing", 0., fRingWidth,
+                                       fWaterThickness2/2, 0.*deg, 360.*deg);
+        G4LogicalVolume* logicRing = new G4LogicalVolume(solidRing, fWater, "WaterRingLog");
+        logicRing->SetUserLimits(waterLimits);
+        
+        G4VisAttributes* ringVis = new G4VisAttributes(ringColors[2]);
+        ringVis->SetForceSolid(true);
+        logicRing->SetVisAttributes(ringVis);
+        
+        if (fRingLayout == kReplica) {
+            new G4PVReplica("WaterRing", logicRing, logicLayer, kRho,
+                            fNbWaterRings, fRingWidth, 0.);
+        } else {
+            new G4PVParameterised("WaterRing", logicRing, logicLayer, kUndefined,
+                                  fNbWaterRings,
+                                  new RingParameterisation(fRingWidth, fWaterThickness2/2),
+                                  true);
+        }
+        
+        fWaterRingLogicals.push_back(logicRing);
+    }
+    
+    // Eau au-delà du dernier anneau (largeur imposée) : hors mesure
+    if (layerRadius < fContainerRadius * (1. - 1e-9)) {
+        G4Tubs* solidOuter = new G4Tubs("WaterRingOuter", layerRadius, fContainerRadius,
+                                        fWaterThickness2/2, 0.*deg, 360.*deg);
+        G4LogicalVolume* logicOuter = new G4LogicalVolume(solidOuter, fWater, "WaterRingOuterLog");
+        logicOuter->SetUserLimits(waterLimits);
+        logicOuter->SetVisAttributes(G4VisAttributes::GetInvisible());
+        new G4PVPlacement(nullptr,
+                          G4ThreeVector(0, 0, centerZ),
+                          logicOuter,
+                          "WaterRingOuter",
+                          logicEnveloppe,
+                          false,
+                          0,
+                          true);
+    }
+    
+    for (G4int i = 0; i < fNbWaterRings; ++i) {
+        G4double rIn = GetRingInnerRadius(i);
+        G4double rOut = GetRingOuterRadius(i);
+        G4double ringVolume = M_PI * (rOut*rOut - rIn*rIn) * fWaterThickness2;
+        G4double ringMass = ringVolume * waterDensity;
+
+        fRingMasses[i] = ringMass;
+
+        char buffer[100];
+        sprintf(buffer, "║  %4d  |   %5.2f   |    %5.2f   |   %8.2f   |   %7.4f   ║",
+                i, rIn/mm, rOut/mm, ringVolume/mm3, ringMass/g);
+        banner << buffer << G4endl;
+    }
 }
 
-G4double DetectorConstruction::GetRingOuterRadius(G4int ringIndex)
+// ═══════════════════════════════════════════════════════════════
+// MONDE AJUSTÉ À L'EMPILEMENT (/puits/geometry/tightWorld)
+// ═══════════════════════════════════════════════════════════════
+
+void DetectorConstruction::FitWorldToStack(G4LogicalVolume* logicEnveloppe,
+                                           G4VPhysicalVolume* physEnveloppe,
+                                           G4double sourceZ)
 {
-    return (ringIndex + 1) * 5.0 * mm;
+    // Boîte englobante des filles de l'enveloppe (non tournées) et de la source,
+    // positions du balayage comprises (/puits/scan/ avant /run/initialize)
+    const SourceScan* scan = SourceScan::GetInstance();
+    G4double rMax = scan->GetMaxLateralOffset();
+    G4double zMin = scan->IsEnabled() ? std::min(sourceZ, scan->GetMinSourceZ()) : sourceZ;
+    G4double zMax = sourceZ;
+    
+    for (std::size_t i = 0; i < logicEnveloppe->GetNoDaughters(); ++i) {
+        const G4VPhysicalVolume* daughter = logicEnveloppe->GetDaughter(i);
+        G4ThreeVector pMin, pMax;
+        daughter->GetLogicalVolume()->GetSolid()->BoundingLimits(pMin, pMax);
+        
+        const G4ThreeVector translation = daughter->GetTranslation();
+        pMin += translation;
+        pMax += translation;
+        
+        rMax = std::max({rMax, std::abs(pMin.x()), std::abs(pMax.x()),
+                               std::abs(pMin.y()), std::abs(pMax.y())});
+        zMin = std::min(zMin, pMin.z());
+        zMax = std::max(zMax, pMax.z());
+    }
+    
+    // Enveloppe centrée sur l'empilement ; les filles sont décalées d'autant
+    // pour garder leurs positions globales (source, histogrammes en z)
+    fEnvelopeHalfXY = rMax + fWorldMargin;
+    fEnvelopeHalfZ = 0.5*(zMax - zMin) + fWorldMargin;
+    fEnvelopeCenterZ = 0.5*(zMin + zMax);
+    
+    for (std::size_t i = 0; i < logicEnveloppe->GetNoDaughters(); ++i) {
+        G4VPhysicalVolume* daughter = logicEnveloppe->GetDaughter(i);
+        daughter->SetTranslation(daughter->GetTranslation() - G4ThreeVector(0., 0., fEnvelopeCenterZ));
+    }
+    
+    auto solidEnveloppe = static_cast<G4Box*>(logicEnveloppe->GetSolid());
+    solidEnveloppe->SetXHalfLength(fEnvelopeHalfXY);
+    solidEnveloppe->SetYHalfLength(fEnvelopeHalfXY);
+    solidEnveloppe->SetZHalfLength(fEnvelopeHalfZ);
+    physEnveloppe->SetTranslation(G4ThreeVector(0., 0., fEnvelopeCenterZ));
+    
+    // Le monde reste centré à l'origine (repère global) : en z, il couvre
+    // l'enveloppe de part et d'autre de z = 0
+    fWorldHalfXY = fEnvelopeHalfXY + 1.*mm;
+    fWorldHalfZ = std::abs(fEnvelopeCenterZ) + fEnvelopeHalfZ + 1.*mm;
+    
+    auto solidWorld = static_cast<G4Box*>(physEnveloppe->GetMotherLogical()->GetSolid());
+    solidWorld->SetXHalfLength(fWorldHalfXY);
+    solidWorld->SetYHalfLength(fWorldHalfXY);
+    solidWorld->SetZHalfLength(fWorldHalfZ);
+    
+    G4cout << "DetectorConstruction : monde ajuste a l'empilement (marge "
+           << fWorldMargin/mm << " mm) : enveloppe z = " << (zMin - fWorldMargin)/mm
+           << " a " << (zMax + fWorldMargin)/mm << " mm, r < " << fEnvelopeHalfXY/mm << " mm" << G4endl;
 }
 
 G4VPhysicalVolume* DetectorConstruction::Construct()
 {
+    // Configuration enregistrée : pas de construction explicite
+    if (!fGdmlImportFile.empty()) return ConstructFromGdml();
+    
     G4NistManager* nist = G4NistManager::Instance();
     
+    // Bannières de géométrie (muettes en mode silencieux)
+    std::ostream& banner = Logger::GetInstance()->Banner();
+    
     // =============================================================================
     // MATÉRIAUX
     // =============================================================================
@@ -63,20 +504,20 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     fTungsten = nist->FindOrBuildMaterial("G4_W");
     fPolystyrene = nist->FindOrBuildMaterial("G4_POLYSTYRENE");
 
-    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║              MATÉRIAUX - CONFIGURATION OPTIMISÉE              ║" << G4endl;
-    G4cout << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
-    G4cout << "║  Eau (G4_WATER)         : rho = " << G4BestUnit(fWater->GetDensity(), "Volumic Mass") << "               ║" << G4endl;
-    G4cout << "║  Polystyrene (G4_PS)    : rho = " << G4BestUnit(fPolystyrene->GetDensity(), "Volumic Mass") << "               ║" << G4endl;
-    G4cout << "║  Tungstene (G4_W)       : rho = " << G4BestUnit(fTungsten->GetDensity(), "Volumic Mass") << "               ║" << G4endl;
-    G4cout << "║  Air (G4_AIR)           : rho = " << G4BestUnit(air->GetDensity(), "Volumic Mass") << "            ║" << G4endl;
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║              MATÉRIAUX - CONFIGURATION OPTIMISÉE              ║" << G4endl;
+    banner << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+    banner << "║  Eau (G4_WATER)         : rho = " << G4BestUnit(fWater->GetDensity(), "Volumic Mass") << "               ║" << G4endl;
+    banner << "║  Polystyrene (G4_PS)    : rho = " << G4BestUnit(fPolystyrene->GetDensity(), "Volumic Mass") << "               ║" << G4endl;
+    banner << "║  Tungstene (G4_W)       : rho = " << G4BestUnit(fTungsten->GetDensity(), "Volumic Mass") << "               ║" << G4endl;
+    banner << "║  Air (G4_AIR)           : rho = " << G4BestUnit(air->GetDensity(), "Volumic Mass") << "            ║" << G4endl;
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
 
     // =============================================================================
     // WORLD
     // =============================================================================
-    G4double world_size = 50*cm;
-    G4Box* solidWorld = new G4Box("World", world_size/2, world_size/2, world_size/2);
+    fWorldHalfXY = fWorldHalfZ = 25*cm;
+    G4Box* solidWorld = new G4Box("World", fWorldHalfXY, fWorldHalfXY, fWorldHalfZ);
     G4LogicalVolume* logicWorld = new G4LogicalVolume(solidWorld, air, "World");
     
     G4VPhysicalVolume* physWorld = new G4PVPlacement(0,
@@ -92,10 +533,13 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     // =============================================================================
     // ENVELOPPE
     // =============================================================================
-    G4Box* solidEnveloppe = new G4Box("Enveloppe", 20*cm, 20*cm, 20*cm);
+    // Dimensions ajustées à la fin de Construct() si /puits/geometry/tightWorld
+    fEnvelopeHalfXY = fEnvelopeHalfZ = 20*cm;
+    fEnvelopeCenterZ = 0.;
+    G4Box* solidEnveloppe = new G4Box("Enveloppe", fEnvelopeHalfXY, fEnvelopeHalfXY, fEnvelopeHalfZ);
     G4LogicalVolume* logicEnveloppe = new G4LogicalVolume(solidEnveloppe, air, "Enveloppe");
 
-    new G4PVPlacement(nullptr,
+    G4VPhysicalVolume* physEnveloppe = new G4PVPlacement(nullptr,
                       G4ThreeVector(),
                       logicEnveloppe,
                       "Enveloppe",
@@ -146,6 +590,80 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     G4double tungstenTopZ = tungstenBottomZ + fTungstenFoilThickness;               // 104.05 mm
     G4double tungstenCenterZ = (tungstenBottomZ + tungstenTopZ) / 2;                // 104.025 mm
 
+    // Plaque atténuatrice (optionnelle) : face aval contre le PreContainer
+    G4double attenuatorTopZ = preContainerBottomZ;                                  // 99 mm
+    G4double attenuatorBottomZ = attenuatorTopZ - fAttenuatorThickness;
+    G4double attenuatorCenterZ = (attenuatorBottomZ + attenuatorTopZ) / 2;
+    G4Material* attenuatorMaterial = nullptr;
+    if (fAttenuatorMaterialName != "none") {
+        attenuatorMaterial = nist->FindOrBuildMaterial(fAttenuatorMaterialName);
+        if (!attenuatorMaterial) {
+            G4cerr << "DetectorConstruction: ERREUR - materiau " << fAttenuatorMaterialName
+                   << " inconnu, plaque attenuatrice ignoree" << G4endl;
+        } else if (attenuatorBottomZ <= sourceZ + 1.*mm) {
+            G4cerr << "DetectorConstruction: ERREUR - plaque de " << fAttenuatorThickness/mm
+                   << " mm trop epaisse pour la distance source-eau, plaque ignoree" << G4endl;
+            attenuatorMaterial = nullptr;
+        }
+    }
+
+    // Source et face avant de l'empilement (plaque ou PreContainer) pour le cône d'émission
+    const G4double stackFrontZ = attenuatorMaterial ? attenuatorBottomZ : preContainerBottomZ;
+    const G4double stackRadius = std::max(fContainerRadius, fPreContainerPlaneRadius);
+    EmissionCone::GetInstance()->SetGeometry(sourceZ, stackFrontZ, stackRadius);
+    SourceScan::GetInstance()->SetWaterSurfaceZ(waterSurfaceZ);
+
+    // =============================================================================
+    // PLAQUE ATTÉNUATRICE (optionnelle) - AVANT le PreContainer
+    // Région dédiée : enveloppe du modèle de simulation rapide
+    // =============================================================================
+
+    fAttenuatorRegion = nullptr;
+    fAttenuatorLogical = nullptr;
+    if (attenuatorMaterial) {
+        G4Tubs* solidAttenuator = new G4Tubs("Attenuator",
+                                             0.,
+                                             fContainerRadius,
+                                             fAttenuatorThickness/2,
+                                             0.*deg, 360.*deg);
+
+        G4LogicalVolume* logicAttenuator = new G4LogicalVolume(solidAttenuator,
+                                                               attenuatorMaterial,
+                                                               "AttenuatorLog");
+
+        G4VisAttributes* attenuatorVis = new G4VisAttributes(G4Colour(0.9, 0.5, 0.1, 0.5));  // Orange
+        attenuatorVis->SetForceSolid(true);
+        logicAttenuator->SetVisAttributes(attenuatorVis);
+
+        new G4PVPlacement(nullptr,
+                          G4ThreeVector(0, 0, attenuatorCenterZ),
+                          logicAttenuator,
+                          "Attenuator",
+                          logicEnveloppe,
+                          false, 0, true);
+
+        fAttenuatorRegion = new G4Region("AttenuatorRegion");
+        fAttenuatorRegion->AddRootLogicalVolume(logicAttenuator);
+        fAttenuatorLogical = logicAttenuator;
+
+        banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+        banner << "║     PLAQUE ATTENUATRICE - AVANT le PreContainer               ║" << G4endl;
+        banner << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+        banner << "║  Materiau   : " << fAttenuatorMaterialName << G4endl;
+        banner << "║  Epaisseur  : " << fAttenuatorThickness/mm << " mm" << G4endl;
+        banner << "║  Rayon      : " << fContainerRadius/mm << " mm" << G4endl;
+        banner << "║  Z bas      : " << attenuatorBottomZ/mm << " mm" << G4endl;
+        banner << "║  Z haut     : " << attenuatorTopZ/mm << " mm" << G4endl;
+        banner << "║  Simulation rapide : " << (fAttenuatorFastSim ? "OUI (noyau tabule)" : "non") << G4endl;
+        banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    }
+
+    // Le noyau est propre à la plaque (matériau, épaisseur)
+    AttenuatorKernel* kernel = AttenuatorKernel::GetInstance();
+    kernel->SetSlab(attenuatorMaterial ? fAttenuatorMaterialName : G4String("none"),
+                    fAttenuatorThickness, fContainerRadius);
+    kernel->SetEnabled(fAttenuatorFastSim && attenuatorMaterial != nullptr);
+
     // =============================================================================
     // PRECONTAINER PLANE (1 mm) - AIR - AVANT la surface de l'eau
     // Matériau : AIR
@@ -166,6 +684,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     G4VisAttributes* preContainerVis = new G4VisAttributes(G4Colour(1.0, 1.0, 0.0, 0.3));  // Jaune transparent
     preContainerVis->SetForceSolid(true);
     logicPreContainerPlane->SetVisAttributes(preContainerVis);
+    fPreContainerPlaneLogical = logicPreContainerPlane;
     
     new G4PVPlacement(nullptr,
                       G4ThreeVector(0, 0, preContainerCenterZ),
@@ -174,23 +693,23 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
                       logicEnveloppe,
                       false, 0, true);
 
-    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║     PRECONTAINER PLANE - AVANT la surface de l'eau            ║" << G4endl;
-    G4cout << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
-    G4cout << "║  Materiau   : AIR                                             ║" << G4endl;
-    G4cout << "║  Epaisseur  : " << fPreContainerPlaneThickness/mm << " mm                                            ║" << G4endl;
-    G4cout << "║  Rayon      : " << fPreContainerPlaneRadius/mm << " mm (2.5 cm)                                ║" << G4endl;
-    G4cout << "║  Z bas      : " << preContainerBottomZ/mm << " mm                                            ║" << G4endl;
-    G4cout << "║  Z haut     : " << preContainerTopZ/mm << " mm (= surface eau)                         ║" << G4endl;
-    G4cout << "║  Z centre   : " << preContainerCenterZ/mm << " mm                                          ║" << G4endl;
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║     PRECONTAINER PLANE - AVANT la surface de l'eau            ║" << G4endl;
+    banner << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+    banner << "║  Materiau   : AIR                                             ║" << G4endl;
+    banner << "║  Epaisseur  : " << fPreContainerPlaneThickness/mm << " mm                                            ║" << G4endl;
+    banner << "║  Rayon      : " << fPreContainerPlaneRadius/mm << " mm (2.5 cm)                                ║" << G4endl;
+    banner << "║  Z bas      : " << preContainerBottomZ/mm << " mm                                            ║" << G4endl;
+    banner << "║  Z haut     : " << preContainerTopZ/mm << " mm (= surface eau)                         ║" << G4endl;
+    banner << "║  Z centre   : " << preContainerCenterZ/mm << " mm                                          ║" << G4endl;
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
 
     // =============================================================================
     // PREMIÈRE TRANCHE D'EAU (2 mm) - VOLUME UNIFORME
     // Position : z = 100 à 102 mm
     // =============================================================================
 
-    G4UserLimits* waterLimits = new G4UserLimits(0.1*mm);
+    G4UserLimits* waterLimits = new G4UserLimits(fWaterMaxStep);
 
     G4Tubs* solidWater1 = new G4Tubs("Water1",
                                       0.,
@@ -217,94 +736,45 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     G4double water1Volume = M_PI * fContainerRadius * fContainerRadius * fWaterThickness1;
     G4double water1Mass = water1Volume * fWater->GetDensity();
 
-    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║     PREMIERE TRANCHE D'EAU (2 mm) - VOLUME UNIFORME           ║" << G4endl;
-    G4cout << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
-    G4cout << "║  Epaisseur  : " << fWaterThickness1/mm << " mm                                            ║" << G4endl;
-    G4cout << "║  Rayon      : " << fContainerRadius/mm << " mm                                            ║" << G4endl;
-    G4cout << "║  Z bas      : " << water1BottomZ/mm << " mm (= surface eau)                         ║" << G4endl;
-    G4cout << "║  Z haut     : " << water1TopZ/mm << " mm                                           ║" << G4endl;
-    G4cout << "║  Z centre   : " << water1CenterZ/mm << " mm                                           ║" << G4endl;
-    G4cout << "║  Masse      : " << water1Mass/g << " g                                        ║" << G4endl;
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║     PREMIERE TRANCHE D'EAU (2 mm) - VOLUME UNIFORME           ║" << G4endl;
+    banner << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+    banner << "║  Epaisseur  : " << fWaterThickness1/mm << " mm                                            ║" << G4endl;
+    banner << "║  Rayon      : " << fContainerRadius/mm << " mm                                            ║" << G4endl;
+    banner << "║  Z bas      : " << water1BottomZ/mm << " mm (= surface eau)                         ║" << G4endl;
+    banner << "║  Z haut     : " << water1TopZ/mm << " mm                                           ║" << G4endl;
+    banner << "║  Z centre   : " << water1CenterZ/mm << " mm                                           ║" << G4endl;
+    banner << "║  Masse      : " << water1Mass/g << " g                                        ║" << G4endl;
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
 
     // =============================================================================
     // DEUXIÈME TRANCHE D'EAU (1 mm) - ANNEAUX CONCENTRIQUES (mesure de dose)
     // Position : z = 102 à 103 mm
     // =============================================================================
     
-    std::vector<G4Colour> ringColors = {
-        G4Colour(0.0, 0.3, 1.0, 0.6),
-        G4Colour(0.0, 0.4, 1.0, 0.6),
-        G4Colour(0.0, 0.5, 1.0, 0.6),
-        G4Colour(0.0, 0.6, 1.0, 0.6),
-        G4Colour(0.0, 0.7, 1.0, 0.6)
-    };
-
-    fWaterRingLogicals.clear();
-    G4double waterDensity = fWater->GetDensity();
-
-    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║  DEUXIEME TRANCHE D'EAU (1 mm) - ANNEAUX CONCENTRIQUES        ║" << G4endl;
-    G4cout << "║  >>> VOLUME DE MESURE DE DOSE <<<                             ║" << G4endl;
-    G4cout << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
-    G4cout << "║  Epaisseur  : " << fWaterThickness2/mm << " mm                                            ║" << G4endl;
-    G4cout << "║  Z bas      : " << water2BottomZ/mm << " mm                                           ║" << G4endl;
-    G4cout << "║  Z haut     : " << water2TopZ/mm << " mm                                           ║" << G4endl;
-    G4cout << "║  Z centre   : " << water2CenterZ/mm << " mm                                         ║" << G4endl;
-    G4cout << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
-    G4cout << "║  Index | R_in (mm) | R_out (mm) | Volume (mm3) | Masse (g)   ║" << G4endl;
-    G4cout << "╠════════╪═══════════╪════════════╪══════════════╪═════════════╣" << G4endl;
-
-    for (G4int i = 0; i < kNbWaterRings; ++i) {
-        G4double rIn = GetRingInnerRadius(i);
-        G4double rOut = GetRingOuterRadius(i);
-        
-        G4String ringName = GetWaterRingName(i);
-        
-        G4Tubs* solidRing = new G4Tubs(ringName,
-                                        rIn,
-                                        rOut,
-                                        fWaterThickness2/2,
-                                        0.*deg, 360.*deg);
+    banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║  DEUXIEME TRANCHE D'EAU (1 mm) - ANNEAUX CONCENTRIQUES        ║" << G4endl;
+    banner << "║  >>> VOLUME DE MESURE DE DOSE <<<                             ║" << G4endl;
+    banner << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+    banner << "║  Epaisseur  : " << fWaterThickness2/mm << " mm                                            ║" << G4endl;
+    banner << "║  Z bas      : " << water2BottomZ/mm << " mm                                           ║" << G4endl;
+    banner << "║  Z haut     : " << water2TopZ/mm << " mm                                           ║" << G4endl;
+    banner << "║  Z centre   : " << water2CenterZ/mm << " mm                                         ║" << G4endl;
+    banner << "║  Construction : " << GetRingLayoutName() << G4endl;
+    banner << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+    banner << "║  Index | R_in (mm) | R_out (mm) | Volume (mm3) | Masse (g)   ║" << G4endl;
+    banner << "╠════════╪═══════════╪════════════╪══════════════╪═════════════╣" << G4endl;
 
-        G4LogicalVolume* logicRing = new G4LogicalVolume(solidRing, fWater, ringName + "Log");
-        logicRing->SetUserLimits(waterLimits);
-        
-        G4VisAttributes* ringVis = new G4VisAttributes(ringColors[i]);
-        ringVis->SetForceSolid(true);
-        logicRing->SetVisAttributes(ringVis);
-
-        new G4PVPlacement(nullptr,
-                          G4ThreeVector(0, 0, water2CenterZ),
-                          logicRing,
-                          ringName,
-                          logicEnveloppe,
-                          false,
-                          i,
-                          true);
-
-        fWaterRingLogicals.push_back(logicRing);
-
-        G4double ringVolume = M_PI * (rOut*rOut - rIn*rIn) * fWaterThickness2;
-        G4double ringMass = ringVolume * waterDensity;
-
-        fRingMasses[i] = ringMass;
-
-        char buffer[100];
-        sprintf(buffer, "║    %d   |   %5.1f   |    %5.1f   |   %8.2f   |   %7.4f   ║",
-                i, rIn/mm, rOut/mm, ringVolume/mm3, ringMass/g);
-        G4cout << buffer << G4endl;
-    }
+    ConstructWaterRings(logicEnveloppe, water2CenterZ, waterLimits);
 
     G4double totalWaterMass = 0.;
-    for (G4int i = 0; i < kNbWaterRings; ++i) {
+    for (G4int i = 0; i < fNbWaterRings; ++i) {
         totalWaterMass += fRingMasses[i];
     }
 
-    G4cout << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
-    G4cout << "║  Masse totale eau (anneaux) : " << totalWaterMass/g << " g                     ║" << G4endl;
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    banner << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+    banner << "║  Masse totale eau (anneaux) : " << totalWaterMass/g << " g                     ║" << G4endl;
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
 
     // =============================================================================
     // POSTCONTAINER PLANE = POLYSTYRÈNE (1 mm) - Fond de la boîte de Petri
@@ -327,6 +797,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     G4VisAttributes* psVis = new G4VisAttributes(G4Colour(0.8, 0.8, 0.8, 0.6));  // Gris clair
     psVis->SetForceSolid(true);
     logicPostContainer->SetVisAttributes(psVis);
+    fPostContainerPlaneLogical = logicPostContainer;
 
     new G4PVPlacement(nullptr,
                       G4ThreeVector(0, 0, psCenterZ),
@@ -340,18 +811,18 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     G4double psVolume = M_PI * fContainerRadius * fContainerRadius * fPolystyreneThickness;
     G4double psMass = psVolume * fPolystyrene->GetDensity();
 
-    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║     POSTCONTAINER PLANE = POLYSTYRENE (1 mm)                  ║" << G4endl;
-    G4cout << "║     (Fond boite de Petri)                                     ║" << G4endl;
-    G4cout << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
-    G4cout << "║  Materiau   : POLYSTYRENE                                     ║" << G4endl;
-    G4cout << "║  Epaisseur  : " << fPolystyreneThickness/mm << " mm                                            ║" << G4endl;
-    G4cout << "║  Rayon      : " << fContainerRadius/mm << " mm                                            ║" << G4endl;
-    G4cout << "║  Z bas      : " << psBottomZ/mm << " mm                                           ║" << G4endl;
-    G4cout << "║  Z haut     : " << psTopZ/mm << " mm                                           ║" << G4endl;
-    G4cout << "║  Z centre   : " << psCenterZ/mm << " mm                                         ║" << G4endl;
-    G4cout << "║  Masse      : " << psMass/g << " g                                        ║" << G4endl;
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║     POSTCONTAINER PLANE = POLYSTYRENE (1 mm)                  ║" << G4endl;
+    banner << "║     (Fond boite de Petri)                                     ║" << G4endl;
+    banner << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+    banner << "║  Materiau   : POLYSTYRENE                                     ║" << G4endl;
+    banner << "║  Epaisseur  : " << fPolystyreneThickness/mm << " mm                                            ║" << G4endl;
+    banner << "║  Rayon      : " << fContainerRadius/mm << " mm                                            ║" << G4endl;
+    banner << "║  Z bas      : " << psBottomZ/mm << " mm                                           ║" << G4endl;
+    banner << "║  Z haut     : " << psTopZ/mm << " mm                                           ║" << G4endl;
+    banner << "║  Z centre   : " << psCenterZ/mm << " mm                                         ║" << G4endl;
+    banner << "║  Masse      : " << psMass/g << " g                                        ║" << G4endl;
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
 
     // =============================================================================
     // FEUILLE DE TUNGSTÈNE (50 µm) - Sous le polystyrène
@@ -370,63 +841,267 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     tungstenFoilVis->SetForceSolid(true);
     logicTungstenFoil->SetVisAttributes(tungstenFoilVis);
 
-    new G4PVPlacement(nullptr,
-                      G4ThreeVector(0, 0, tungstenCenterZ),
-                      logicTungstenFoil,
-                      "TungstenFoil",
-                      logicEnveloppe,
-                      false,
-                      0,
-                      true);
+    if (fTungstenFoil) {
+        new G4PVPlacement(nullptr,
+                          G4ThreeVector(0, 0, tungstenCenterZ),
+                          logicTungstenFoil,
+                          "TungstenFoil",
+                          logicEnveloppe,
+                          false,
+                          0,
+                          true);
+    }
 
     G4double tungstenVolume = M_PI * fTungstenFoilRadius * fTungstenFoilRadius * fTungstenFoilThickness;
     G4double tungstenMass = tungstenVolume * fTungsten->GetDensity();
 
-    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║     FEUILLE DE TUNGSTENE (50 um)                              ║" << G4endl;
-    G4cout << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
-    G4cout << "║  Epaisseur  : " << fTungstenFoilThickness/um << " um                                          ║" << G4endl;
-    G4cout << "║  Rayon      : " << fTungstenFoilRadius/mm << " mm                                            ║" << G4endl;
-    G4cout << "║  Z bas      : " << tungstenBottomZ/mm << " mm                                           ║" << G4endl;
-    G4cout << "║  Z haut     : " << tungstenTopZ/mm << " mm                                       ║" << G4endl;
-    G4cout << "║  Z centre   : " << tungstenCenterZ/mm << " mm                                      ║" << G4endl;
-    G4cout << "║  Masse      : " << tungstenMass/g << " g                                        ║" << G4endl;
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║     FEUILLE DE TUNGSTENE (50 um)                              ║" << G4endl;
+    banner << "╠═══════════════════════════════════════════════════════════════╣" << G4endl;
+    banner << "║  Epaisseur  : " << fTungstenFoilThickness/um << " um                                          ║" << G4endl;
+    banner << "║  Rayon      : " << fTungstenFoilRadius/mm << " mm                                            ║" << G4endl;
+    banner << "║  Z bas      : " << tungstenBottomZ/mm << " mm                                           ║" << G4endl;
+    banner << "║  Z haut     : " << tungstenTopZ/mm << " mm                                       ║" << G4endl;
+    banner << "║  Z centre   : " << tungstenCenterZ/mm << " mm                                      ║" << G4endl;
+    banner << "║  Masse      : " << tungstenMass/g << " g                                        ║" << G4endl;
+    if (!fTungstenFoil) {
+        banner << "║  >>> RETIREE (/puits/geometry/tungstenFoil false) <<<         ║" << G4endl;
+    }
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+
+    // =============================================================================
+    // MONDE AJUSTÉ (option)
+    // =============================================================================
+
+    if (fTightWorld) {
+        FitWorldToStack(logicEnveloppe, physEnveloppe, sourceZ);
+    }
 
     // =============================================================================
     // AFFICHAGE RÉCAPITULATIF DE LA GÉOMÉTRIE
     // =============================================================================
 
-    G4cout << "\n╔══════════════════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║      GEOMETRIE OPTIMISEE - CONFIGURATION FINALE                          ║" << G4endl;
-    G4cout << "╠══════════════════════════════════════════════════════════════════════════╣" << G4endl;
-    G4cout << "║                                                                          ║" << G4endl;
-    G4cout << "║  SOURCE Eu-152 : z = " << sourceZ/mm << " mm                                            ║" << G4endl;
-    G4cout << "║  Distance source-eau : " << fSourceToWaterDistance/mm << " mm                                     ║" << G4endl;
-    G4cout << "║                                                                          ║" << G4endl;
-    G4cout << "╟──────────────────────────────────────────────────────────────────────────╢" << G4endl;
-    G4cout << "║  EMPILEMENT (direction +z) :                                             ║" << G4endl;
-    G4cout << "║                                                                          ║" << G4endl;
-    G4cout << "║    1. PreContainer (AIR)    : z = " << preContainerBottomZ/mm << " - " << preContainerTopZ/mm << " mm  (1 mm)           ║" << G4endl;
-    G4cout << "║       Materiau: AIR | Rayon: 25 mm | AVANT surface eau                   ║" << G4endl;
-    G4cout << "║                                                                          ║" << G4endl;
-    G4cout << "║    2. Eau 1 (uniforme)      : z = " << water1BottomZ/mm << " - " << water1TopZ/mm << " mm  (2 mm)          ║" << G4endl;
-    G4cout << "║                                                                          ║" << G4endl;
-    G4cout << "║    3. Eau 2 (anneaux)       : z = " << water2BottomZ/mm << " - " << water2TopZ/mm << " mm  (1 mm)          ║" << G4endl;
-    G4cout << "║       >>> VOLUME DE MESURE DE DOSE <<<                                   ║" << G4endl;
-    G4cout << "║                                                                          ║" << G4endl;
-    G4cout << "║    4. PostContainer (PS)    : z = " << psBottomZ/mm << " - " << psTopZ/mm << " mm  (1 mm)          ║" << G4endl;
-    G4cout << "║       Materiau: POLYSTYRENE | Rayon: 25 mm                               ║" << G4endl;
-    G4cout << "║                                                                          ║" << G4endl;
-    G4cout << "║    5. Tungstene             : z = " << tungstenBottomZ/mm << " - " << tungstenTopZ/mm << " mm  (50 um)       ║" << G4endl;
-    G4cout << "║       Retrodiffusion electronique                                        ║" << G4endl;
-    G4cout << "║                                                                          ║" << G4endl;
-    G4cout << "╟──────────────────────────────────────────────────────────────────────────╢" << G4endl;
-    G4cout << "║  Rayon externe : " << fContainerRadius/mm << " mm (2.5 cm)                                    ║" << G4endl;
-    G4cout << "║  Nombre d'anneaux : " << kNbWaterRings << "                                                   ║" << G4endl;
-    G4cout << "║  Largeur anneaux : " << fRingWidth/mm << " mm                                               ║" << G4endl;
-    G4cout << "║                                                                          ║" << G4endl;
-    G4cout << "╚══════════════════════════════════════════════════════════════════════════╝\n" << G4endl;
+    banner << "\n╔══════════════════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║      GEOMETRIE OPTIMISEE - CONFIGURATION FINALE                          ║" << G4endl;
+    banner << "╠══════════════════════════════════════════════════════════════════════════╣" << G4endl;
+    banner << "║                                                                          ║" << G4endl;
+    banner << "║  SOURCE Eu-152 : z = " << sourceZ/mm << " mm                                            ║" << G4endl;
+    banner << "║  Distance source-eau : " << fSourceToWaterDistance/mm << " mm                                     ║" << G4endl;
+    banner << "║                                                                          ║" << G4endl;
+    banner << "╟──────────────────────────────────────────────────────────────────────────╢" << G4endl;
+    banner << "║  EMPILEMENT (direction +z) :                                             ║" << G4endl;
+    banner << "║                                                                          ║" << G4endl;
+    if (fAttenuatorRegion) {
+        banner << "║    0. Attenuateur           : z = " << attenuatorBottomZ/mm << " - " << attenuatorTopZ/mm
+               << " mm  (" << fAttenuatorMaterialName << ", " << fAttenuatorThickness/mm << " mm)" << G4endl;
+        banner << "║                                                                          ║" << G4endl;
+    }
+    banner << "║    1. PreContainer (AIR)    : z = " << preContainerBottomZ/mm << " - " << preContainerTopZ/mm << " mm  (1 mm)           ║" << G4endl;
+    banner << "║       Materiau: AIR | Rayon: 25 mm | AVANT surface eau                   ║" << G4endl;
+    banner << "║                                                                          ║" << G4endl;
+    banner << "║    2. Eau 1 (uniforme)      : z = " << water1BottomZ/mm << " - " << water1TopZ/mm << " mm  (2 mm)          ║" << G4endl;
+    banner << "║                                                                          ║" << G4endl;
+    banner << "║    3. Eau 2 (anneaux)       : z = " << water2BottomZ/mm << " - " << water2TopZ/mm << " mm  (1 mm)          ║" << G4endl;
+    banner << "║       >>> VOLUME DE MESURE DE DOSE <<<                                   ║" << G4endl;
+    banner << "║                                                                          ║" << G4endl;
+    banner << "║    4. PostContainer (PS)    : z = " << psBottomZ/mm << " - " << psTopZ/mm << " mm  (1 mm)          ║" << G4endl;
+    banner << "║       Materiau: POLYSTYRENE | Rayon: 25 mm                               ║" << G4endl;
+    banner << "║                                                                          ║" << G4endl;
+    banner << "║    5. Tungstene             : z = " << tungstenBottomZ/mm << " - " << tungstenTopZ/mm << " mm  (50 um)       ║" << G4endl;
+    banner << "║       Retrodiffusion electronique                                        ║" << G4endl;
+    banner << "║                                                                          ║" << G4endl;
+    banner << "╟──────────────────────────────────────────────────────────────────────────╢" << G4endl;
+    banner << "║  Rayon externe : " << fContainerRadius/mm << " mm (2.5 cm)                                    ║" << G4endl;
+    banner << "║  Nombre d'anneaux : " << fNbWaterRings << " (" << GetRingLayoutName() << ")" << G4endl;
+    banner << "║  Largeur anneaux : " << fRingWidth/mm << " mm                                               ║" << G4endl;
+    banner << "║  Enveloppe : " << 2*fEnvelopeHalfXY/mm << " x " << 2*fEnvelopeHalfXY/mm << " x "
+           << 2*fEnvelopeHalfZ/mm << " mm (centre z = " << fEnvelopeCenterZ/mm << " mm)" << G4endl;
+    banner << "║  Monde     : " << 2*fWorldHalfXY/mm << " x " << 2*fWorldHalfXY/mm << " x "
+           << 2*fWorldHalfZ/mm << " mm" << (fTightWorld ? " (ajuste)" : "") << G4endl;
+    banner << "║                                                                          ║" << G4endl;
+    banner << "╚══════════════════════════════════════════════════════════════════════════╝\n" << G4endl;
+
+    if (!fGdmlExportFile.empty()) {
+        ExportGdml(logicWorld, sourceZ, stackFrontZ, stackRadius);
+    }
 
     return physWorld;
 }
+
+// ═══════════════════════════════════════════════════════════════
+// GDML : EXPORT ET IMPORT DES CONFIGURATIONS
+// ═══════════════════════════════════════════════════════════════
+
+#ifdef G4LIB_USE_GDML
+
+// Nombre écrit sans perte (étiquettes auxiliaires)
+static G4String GdmlNumber(G4double value)
+{
+    std::ostringstream oss;
+    oss << std::setprecision(15) << value;
+    return oss.str();
+}
+
+// Valeur d'une étiquette, convertie dans son unité
+static G4double GdmlValue(const G4GDMLAuxStructType& aux)
+{
+    G4double value = G4UIcommand::ConvertToDouble(aux.value.c_str());
+    return aux.unit.empty() ? value : value * G4UnitDefinition::GetValueOf(aux.unit);
+}
+
+static G4GDMLAuxStructType GdmlAux(const G4String& type, const G4String& value,
+                                   const G4String& unit = "")
+{
+    G4GDMLAuxStructType aux;
+    aux.type = type;
+    aux.value = value;
+    aux.unit = unit;
+    aux.auxList = nullptr;
+    return aux;
+}
+
+#endif
+
+void DetectorConstruction::ExportGdml(const G4LogicalVolume* logicWorld, G4double sourceZ,
+                                      G4double stackFrontZ, G4double stackRadius) const
+{
+#ifdef G4LIB_USE_GDML
+    G4GDMLParser parser;
+    
+    // Paramètres lus par RunAction, EmissionCone et AttenuatorKernel
+    parser.AddAuxiliary(GdmlAux("SourceZ", GdmlNumber(sourceZ/mm), "mm"));
+    parser.AddAuxiliary(GdmlAux("StackFrontZ", GdmlNumber(stackFrontZ/mm), "mm"));
+    parser.AddAuxiliary(GdmlAux("StackRadius", GdmlNumber(stackRadius/mm), "mm"));
+    parser.AddAuxiliary(GdmlAux("ContainerRadius", GdmlNumber(fContainerRadius/mm), "mm"));
+    parser.AddAuxiliary(GdmlAux("SourceToWaterDistance", GdmlNumber(fSourceToWaterDistance/mm), "mm"));
+    parser.AddAuxiliary(GdmlAux("RingCount", std::to_string(fNbWaterRings)));
+    parser.AddAuxiliary(GdmlAux("RingWidth", GdmlNumber(fRingWidth/mm), "mm"));
+    parser.AddAuxiliary(GdmlAux("RingThickness", GdmlNumber(fWaterThickness2/mm), "mm"));
+    parser.AddAuxiliary(GdmlAux("RingLayout", GetRingLayoutName()));
+    parser.AddAuxiliary(GdmlAux("TungstenFoil", fTungstenFoil ? "1" : "0"));
+    parser.AddAuxiliary(GdmlAux("AttenuatorMaterial", fAttenuatorLogical ? fAttenuatorMaterialName : G4String("none")));
+    parser.AddAuxiliary(GdmlAux("AttenuatorThickness", GdmlNumber(fAttenuatorThickness/mm), "mm"));
+    
+    // Rôles des volumes pour le comptage
+    for (const G4LogicalVolume* logicRing : fWaterRingLogicals) {
+        parser.AddVolumeAuxiliary(GdmlAux("Role", "WaterRing"), logicRing);
+    }
+    parser.AddVolumeAuxiliary(GdmlAux("Role", "PreContainerPlane"), fPreContainerPlaneLogical);
+    parser.AddVolumeAuxiliary(GdmlAux("Role", "PostContainerPlane"), fPostContainerPlaneLogical);
+    if (fAttenuatorLogical) {
+        parser.AddVolumeAuxiliary(GdmlAux("Role", "Attenuator"), fAttenuatorLogical);
+    }
+    
+    // Limites de pas (non décrites par GDML) : seule l'eau en porte
+    for (const G4LogicalVolume* volume : *G4LogicalVolumeStore::GetInstance()) {
+        if (volume->GetUserLimits()) {
+            parser.AddVolumeAuxiliary(GdmlAux("StepLimit", GdmlNumber(fWaterMaxStep/mm), "mm"), volume);
+        }
+    }
+    
+    // G4GDMLParser refuse d'écraser un fichier existant
+    std::remove(fGdmlExportFile.c_str());
+    parser.Write(fGdmlExportFile, logicWorld);
+    
+    G4cout << ">>> Geometrie exportee en GDML : " << fGdmlExportFile << G4endl;
+#else
+    (void)logicWorld; (void)sourceZ; (void)stackFrontZ; (void)stackRadius;
+    G4Exception("DetectorConstruction::ExportGdml", "Geom002", JustWarning,
+                "Geant4 construit sans GDML : /puits/geometry/gdmlExport ignore");
+#endif
+}
+
+G4VPhysicalVolume* DetectorConstruction::ConstructFromGdml()
+{
+#ifdef G4LIB_USE_GDML
+    G4GDMLParser parser;
+    parser.Read(fGdmlImportFile, false);   // pas de validation du schéma (accès réseau)
+    
+    // ─────────────────────────────────────────────────────────────
+    // Paramètres de configuration (<userinfo>)
+    // ─────────────────────────────────────────────────────────────
+    G4double sourceZ = 100.0*mm - fSourceToWaterDistance;
+    G4double stackFrontZ = 100.0*mm - fPreContainerPlaneThickness;
+    G4double stackRadius = std::max(fContainerRadius, fPreContainerPlaneRadius);
+    
+    for (const G4GDMLAuxStructType& aux : *parser.GetAuxList()) {
+        if (aux.type == "SourceZ") sourceZ = GdmlValue(aux);
+        else if (aux.type == "StackFrontZ") stackFrontZ = GdmlValue(aux);
+        else if (aux.type == "StackRadius") stackRadius = GdmlValue(aux);
+        else if (aux.type == "ContainerRadius") fContainerRadius = GdmlValue(aux);
+        else if (aux.type == "SourceToWaterDistance") fSourceToWaterDistance = GdmlValue(aux);
+        else if (aux.type == "RingCount") fNbWaterRings = G4UIcommand::ConvertToInt(aux.value.c_str());
+        else if (aux.type == "RingWidth") fRingWidth = GdmlValue(aux);
+        else if (aux.type == "RingThickness") fWaterThickness2 = GdmlValue(aux);
+        else if (aux.type == "RingLayout") SetRingLayout(aux.value);
+        else if (aux.type == "TungstenFoil") fTungstenFoil = (aux.value == "1");
+        else if (aux.type == "AttenuatorMaterial") fAttenuatorMaterialName = aux.value;
+        else if (aux.type == "AttenuatorThickness") fAttenuatorThickness = GdmlValue(aux);
+    }
+    
+    // ─────────────────────────────────────────────────────────────
+    // Rôles et limites de pas des volumes logiques
+    // ─────────────────────────────────────────────────────────────
+    fWaterRingLogicals.clear();
+    fPreContainerPlaneLogical = nullptr;
+    fPostContainerPlaneLogical = nullptr;
+    fAttenuatorLogical = nullptr;
+    
+    for (const auto& entry : *parser.GetAuxMap()) {
+        G4LogicalVolume* volume = entry.first;
+        for (const G4GDMLAuxStructType& aux : entry.second) {
+            if (aux.type == "StepLimit") {
+                volume->SetUserLimits(new G4UserLimits(GdmlValue(aux)));
+            } else if (aux.type == "Role") {
+                if (aux.value == "WaterRing") fWaterRingLogicals.push_back(volume);
+                else if (aux.value == "PreContainerPlane") fPreContainerPlaneLogical = volume;
+                else if (aux.value == "PostContainerPlane") fPostContainerPlaneLogical = volume;
+                else if (aux.value == "Attenuator") fAttenuatorLogical = volume;
+            }
+        }
+    }
+    
+    if (fWaterRingLogicals.empty() || !fPreContainerPlaneLogical || !fPostContainerPlaneLogical
+        || fNbWaterRings < 1 || fNbWaterRings > kMaxWaterRings || fRingWidth <= 0.) {
+        G4ExceptionDescription ed;
+        ed << fGdmlImportFile << " : etiquettes manquantes (Role WaterRing / PreContainerPlane / "
+           << "PostContainerPlane, RingCount, RingWidth) - fichier non ecrit par /puits/geometry/gdmlExport ?";
+        G4Exception("DetectorConstruction::ConstructFromGdml", "Geom003", FatalException, ed);
+    }
+    
+    // Masses des anneaux : tubes concentriques de largeur fRingWidth
+    fWater = fWaterRingLogicals.front()->GetMaterial();
+    fRingMasses.assign(fNbWaterRings, 0.);
+    for (G4int i = 0; i < fNbWaterRings; ++i) {
+        G4double rIn = GetRingInnerRadius(i);
+        G4double rOut = GetRingOuterRadius(i);
+        fRingMasses[i] = M_PI * (rOut*rOut - rIn*rIn) * fWaterThickness2 * fWater->GetDensity();
+    }
+    
+    // Plaque atténuatrice : région du modèle rapide et noyau
+    fAttenuatorRegion = nullptr;
+    if (fAttenuatorLogical) {
+        fAttenuatorRegion = new G4Region("AttenuatorRegion");
+        fAttenuatorRegion->AddRootLogicalVolume(fAttenuatorLogical);
+    } else {
+        fAttenuatorMaterialName = "none";
+    }
+    AttenuatorKernel* kernel = AttenuatorKernel::GetInstance();
+    kernel->SetSlab(fAttenuatorMaterialName, fAttenuatorThickness, fContainerRadius);
+    kernel->SetEnabled(fAttenuatorFastSim && fAttenuatorLogical != nullptr);
+    
+    EmissionCone::GetInstance()->SetGeometry(sourceZ, stackFrontZ, stackRadius);
+    SourceScan::GetInstance()->SetWaterSurfaceZ(sourceZ + fSourceToWaterDistance);
+    
+    Logger::GetInstance()->Banner()
+        << "\n>>> Geometrie importee de " << fGdmlImportFile << " : "
+        << fNbWaterRings << " anneaux de " << fRingWidth/mm << " mm (" << GetRingLayoutName() << ")"
+        << ", plaque " << fAttenuatorMaterialName << ", source a z = " << sourceZ/mm << " mm\n" << G4endl;
+    
+    return parser.GetWorldVolume();
+#else
+    G4Exception("DetectorConstruction::ConstructFromGdml", "Geom002", FatalException,
+                "Geant4 construit sans GDML : /puits/geometry/gdmlImport indisponible");
+    return nullptr;
+#endif
+}
@@ -0,0 +1,166 @@
+#include "EmissionCone.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+EmissionCone* EmissionCone::fInstance = nullptr;
+
+EmissionCone::EmissionCone()
+: fMode(kFixed),
+  fFixedAngle(45.*deg),
+  fMargin(1.0*mm),
+  fTargetRadius(0.),
+  fSourceZ(75.0*mm),            // Valeurs par défaut avant Construct()
+  fStackFrontZ(99.0*mm),
+  fStackRadius(25.0*mm),
+  fMessenger(nullptr)
+{
+    DefineCommands();
+}
+
+EmissionCone::~EmissionCone()
+{
+    delete fMessenger;
+}
+
+EmissionCone* EmissionCone::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de DetectorConstruction)
+    if (fInstance == nullptr) {
+        fInstance = new EmissionCone();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/source/)
+// ═══════════════════════════════════════════════════════════════
+
+void EmissionCone::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/source/",
+                                        "Cone d'emission de la source Eu-152");
+
+    auto& modeCmd = fMessenger->DeclareMethod("coneMode", &EmissionCone::SetModeByName,
+        "fixed : demi-angle coneAngle ; geometry : cone sous-tendu par l'empilement");
+    modeCmd.SetParameterName("mode", false);
+    modeCmd.SetCandidates("fixed geometry");
+    modeCmd.SetStates(G4State_PreInit, G4State_Idle);
+    modeCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& angleCmd = fMessenger->DeclarePropertyWithUnit("coneAngle", "deg", fFixedAngle,
+        "Demi-angle du cone en mode fixed");
+    angleCmd.SetParameterName("angle", false);
+    angleCmd.SetRange("angle>0. && angle<=180.");
+    angleCmd.SetStates(G4State_PreInit, G4State_Idle);
+    angleCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& marginCmd = fMessenger->DeclarePropertyWithUnit("coneMargin", "mm", fMargin,
+        "Marge radiale ajoutee au rayon cible sur la face avant (mode geometry)");
+    marginCmd.SetParameterName("margin", false);
+    marginCmd.SetRange("margin>=0.");
+    marginCmd.SetStates(G4State_PreInit, G4State_Idle);
+    marginCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& radiusCmd = fMessenger->DeclarePropertyWithUnit("targetRadius", "mm", fTargetRadius,
+        "Rayon vise sur l'empilement en mode geometry (0 = rayon complet) ;"
+        " inferieur au rayon de l'empilement, les doses sont une borne inferieure");
+    radiusCmd.SetParameterName("radius", false);
+    radiusCmd.SetRange("radius>=0.");
+    radiusCmd.SetStates(G4State_PreInit, G4State_Idle);
+    radiusCmd.SetToBeBroadcasted(false);   // singleton du processus
+}
+
+void EmissionCone::SetModeByName(const G4String& name)
+{
+    fMode = (name == "geometry") ? kGeometry : kFixed;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GÉOMÉTRIE ET DEMI-ANGLE
+// ═══════════════════════════════════════════════════════════════
+
+void EmissionCone::PrepareForRun() const
+{
+    if (fMode != kGeometry || fTargetRadius <= 0. || fTargetRadius >= fStackRadius) return;
+
+    std::ostringstream msg;
+    msg << "targetRadius = " << fTargetRadius/mm << " mm < rayon de l'empilement ("
+        << fStackRadius/mm << " mm) : cone tronque, la diffusion depuis l'exterieur"
+        << " du rayon vise est perdue. Les doses par anneau sont une borne inferieure.";
+    G4Exception("EmissionCone::PrepareForRun", "Cone001", JustWarning, msg.str().c_str());
+}
+
+void EmissionCone::SetGeometry(G4double sourceZ, G4double stackFrontZ, G4double stackRadius)
+{
+    fSourceZ = sourceZ;
+    fStackFrontZ = stackFrontZ;
+    fStackRadius = stackRadius;
+}
+
+G4double EmissionCone::GetHalfAngle() const
+{
+    return GetHalfAngle(GetSourcePosition());
+}
+
+G4double EmissionCone::GetHalfAngle(const G4ThreeVector& source) const
+{
+    if (fMode == kFixed) return fFixedAngle;
+
+    // Cône passant par le bord de la face avant de l'empilement : toute
+    // direction qui touche l'empilement est dans le cône. Source décalée de
+    // rho de l'axe : le bord opposé est à radius + rho de l'axe du cône.
+    // Avec targetRadius < rayon de l'empilement, le cône est tronqué : les
+    // photons qui auraient atteint l'empilement hors du rayon visé (et
+    // diffusé vers les anneaux) ne sont pas tirés, les doses sont alors une
+    // borne inférieure (avertissement en début de run)
+    G4double radius = (fTargetRadius > 0.) ? std::min(fTargetRadius, fStackRadius) : fStackRadius;
+    G4double distance = fStackFrontZ - source.z();
+    if (distance <= 0.) return CLHEP::pi;
+    return std::atan2(radius + source.perp() + fMargin, distance);
+}
+
+G4double EmissionCone::GetSolidAngleFraction() const
+{
+    return (1.0 - std::cos(GetHalfAngle())) / 2.0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// TIRAGE D'UNE DIRECTION
+// ═══════════════════════════════════════════════════════════════
+
+G4ThreeVector EmissionCone::SampleDirection(G4double& theta, G4double& phi) const
+{
+    return SampleDirection(GetHalfAngle(), theta, phi);
+}
+
+G4ThreeVector EmissionCone::SampleDirection(G4double uCosTheta, G4double uPhi,
+                                            G4double& theta, G4double& phi) const
+{
+    return SampleDirection(GetHalfAngle(), uCosTheta, uPhi, theta, phi);
+}
+
+G4ThreeVector EmissionCone::SampleDirection(G4double halfAngle, G4double& theta, G4double& phi) const
+{
+    G4double uCosTheta = G4UniformRand();
+    G4double uPhi = G4UniformRand();
+    return SampleDirection(halfAngle, uCosTheta, uPhi, theta, phi);
+}
+
+G4ThreeVector EmissionCone::SampleDirection(G4double halfAngle, G4double uCosTheta, G4double uPhi,
+                                            G4double& theta, G4double& phi) const
+{
+    // Distribution uniforme sur la calotte sphérique :
+    // cos(theta) uniforme entre cos(halfAngle) et 1, phi uniforme
+    G4double cosTheta = 1. - uCosTheta * (1. - std::cos(halfAngle));
+    theta = std::acos(cosTheta);
+    phi = uPhi * CLHEP::twopi;
+
+    G4double sinTheta = std::sqrt(std::max(0., 1. - cosTheta * cosTheta));
+    return G4ThreeVector(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+}
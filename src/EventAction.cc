@@ -1,45 +1,41 @@
 #include "EventAction.hh"
 #include "RunAction.hh"
+#include "PrimaryGeneratorAction.hh"
+#include "StratifiedSampler.hh"
+#include "KermaScoring.hh"
 #include "Logger.hh"
+#include "Eu152Data.hh"
+#include "AllocationCounter.hh"
+#include "ProfilingTimers.hh"
 
 #include "G4Event.hh"
 #include "G4SystemOfUnits.hh"
+#include <algorithm>
 #include <sstream>
 #include <cmath>
+#include <ctime>
 
 // ═══════════════════════════════════════════════════════════════
 // DÉFINITION DES RAIES GAMMA Eu-152 (énergies en keV)
+// Table de référence unique : Eu152Data.hh
 // ═══════════════════════════════════════════════════════════════
+static_assert(EventAction::kNbGammaLines == Eu152::kNbLines,
+              "EventAction et Eu152Data doivent avoir le meme nombre de raies");
+
 const std::array<G4double, EventAction::kNbGammaLines> EventAction::kGammaLineEnergies = {
-    39.52,    // 0: 20.8% (raie X)
-    40.12,    // 1: 37.7% (raie X)
-    121.78,   // 2: 28.41%
-    244.70,   // 3: 7.53%
-    344.28,   // 4: 26.59%
-    411.12,   // 5: 2.24%
-    443.97,   // 6: 2.83%
-    778.90,   // 7: 12.97%
-    867.38,   // 8: 4.24%
-    964.08,   // 9: 14.63%
-    1085.87,  // 10: 10.21%
-    1112.07,  // 11: 13.64%
-    1408.01   // 12: 21.01%
+    Eu152::kLineEnergies_keV[0],  Eu152::kLineEnergies_keV[1],  Eu152::kLineEnergies_keV[2],
+    Eu152::kLineEnergies_keV[3],  Eu152::kLineEnergies_keV[4],  Eu152::kLineEnergies_keV[5],
+    Eu152::kLineEnergies_keV[6],  Eu152::kLineEnergies_keV[7],  Eu152::kLineEnergies_keV[8],
+    Eu152::kLineEnergies_keV[9],  Eu152::kLineEnergies_keV[10], Eu152::kLineEnergies_keV[11],
+    Eu152::kLineEnergies_keV[12]
 };
 
 const std::array<G4String, EventAction::kNbGammaLines> EventAction::kGammaLineNames = {
-    "40 keV (X)",
-    "40 keV (X)",
-    "122 keV",
-    "245 keV",
-    "344 keV",
-    "411 keV",
-    "444 keV",
-    "779 keV",
-    "867 keV",
-    "964 keV",
-    "1086 keV",
-    "1112 keV",
-    "1408 keV"
+    Eu152::kLineNames[0],  Eu152::kLineNames[1],  Eu152::kLineNames[2],
+    Eu152::kLineNames[3],  Eu152::kLineNames[4],  Eu152::kLineNames[5],
+    Eu152::kLineNames[6],  Eu152::kLineNames[7],  Eu152::kLineNames[8],
+    Eu152::kLineNames[9],  Eu152::kLineNames[10], Eu152::kLineNames[11],
+    Eu152::kLineNames[12]
 };
 
 // ═══════════════════════════════════════════════════════════════
@@ -52,6 +48,12 @@ const std::array<G4String, EventAction::kNbProcesses> kProcessNames = {
     "Other"
 };
 
+// Noms rendus par référence (pas de G4String construit par appel)
+static const G4String kUnknownName = "Unknown";
+
+// Capacité initiale des conteneurs par événement (~2 gammas par désintégration)
+static const size_t kInitialTrackCapacity = 16;
+
 G4int EventAction::GetProcessIndex(const G4String& processName)
 {
     if (processName == "phot") return kPhotoelectric;
@@ -60,36 +62,42 @@ G4int EventAction::GetProcessIndex(const G4String& processName)
     return kOther;
 }
 
-G4String EventAction::GetProcessName(G4int processIndex)
+const G4String& EventAction::GetProcessName(G4int processIndex)
 {
     if (processIndex >= 0 && processIndex < kNbProcesses) {
         return kProcessNames[processIndex];
     }
-    return "Unknown";
+    return kUnknownName;
+}
+
+// Temps CPU consommé par le thread appelant (s) : le coût par raie de
+// l'allocation stratifiée ne doit pas compter le temps où le thread attend
+static G4double ThreadCpuTime()
+{
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + 1e-9 * now.tv_nsec;
 }
 
-EventAction::EventAction(RunAction* runAction)
+EventAction::EventAction(RunAction* runAction, PrimaryGeneratorAction* generator)
 : G4UserEventAction(),
   fRunAction(runAction),
-  fPreContainerNPhotons(0),
-  fPreContainerSumEPhotons(0.),
-  fPreContainerNElectrons(0),
-  fPreContainerSumEElectrons(0.),
-  fPostContainerNPhotonsBack(0),
-  fPostContainerSumEPhotonsBack(0.),
-  fPostContainerNElectronsBack(0),
-  fPostContainerSumEElectronsBack(0.),
-  fPostContainerNPhotonsFwd(0),
-  fPostContainerSumEPhotonsFwd(0.),
-  fPostContainerNElectronsFwd(0),
-  fPostContainerSumEElectronsFwd(0.),
+  fGenerator(generator),
+  fEventStartCPU_s(0.),
   fVerboseLevel(1)
 {
     // Initialisation des tableaux de dépôt d'énergie
     fRingEnergyDeposit.fill(0.);
+    fRingKermaEnergy.fill(0.);
     for (auto& arr : fRingEnergyByLine) {
         arr.fill(0.);
     }
+    
+    // Capacité réservée une fois : clear() la conserve d'un événement à l'autre
+    fPrimaryGammas.reserve(kInitialTrackCapacity);
+    fTrackIndex.reserve(kInitialTrackCapacity);
+    fGammasEnteredWater.reserve(kInitialTrackCapacity);
+    fGammasEnteredContainer.reserve(kInitialTrackCapacity);
 }
 
 EventAction::~EventAction()
@@ -120,12 +128,20 @@ G4double EventAction::GetGammaLineEnergy(G4int lineIndex)
     return 0.;
 }
 
-G4String EventAction::GetGammaLineName(G4int lineIndex)
+const G4String& EventAction::GetGammaLineName(G4int lineIndex)
 {
     if (lineIndex >= 0 && lineIndex < kNbGammaLines) {
         return kGammaLineNames[lineIndex];
     }
-    return "Unknown";
+    return kUnknownName;
+}
+
+G4int EventAction::FindPrimary(G4int trackID) const
+{
+    for (const auto& entry : fTrackIndex) {
+        if (entry.first == trackID) return entry.second;
+    }
+    return -1;
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -134,33 +150,30 @@ G4String EventAction::GetGammaLineName(G4int lineIndex)
 
 void EventAction::BeginOfEventAction(const G4Event* /*event*/)
 {
-    // Réinitialiser les structures pour le nouvel événement
+    PUITS_ALLOCATION_SCOPE(kEvent);
+    PUITS_PROFILE_SCOPE(kBeginOfEvent);
+    
+    // Réinitialiser les structures pour le nouvel événement (capacité conservée)
     fPrimaryGammas.clear();
-    fTrackIDtoIndex.clear();
-    fGammasEnteredWater.clear();      // Réinitialiser le set anti-double-comptage eau
-    fGammasEnteredContainer.clear();  // Réinitialiser le set anti-double-comptage container
+    fTrackIndex.clear();
+    fGammasEnteredWater.clear();      // anti-double-comptage eau
+    fGammasEnteredContainer.clear();  // anti-double-comptage container
     
-    // Réinitialiser les dépôts d'énergie
-    fRingEnergyDeposit.fill(0.);
-    for (auto& arr : fRingEnergyByLine) {
-        arr.fill(0.);
+    // Réinitialiser les dépôts d'énergie (seuls les anneaux construits sont remplis)
+    const G4int nRings = fRunAction->GetNbRings();
+    for (G4int i = 0; i < nRings; ++i) {
+        fRingEnergyDeposit[i] = 0.;
+        fRingKermaEnergy[i] = 0.;
+        fRingEnergyByLine[i].fill(0.);
     }
     
     // Réinitialiser les comptages aux plans container
-    fPreContainerNPhotons = 0;
-    fPreContainerSumEPhotons = 0.;
-    fPreContainerNElectrons = 0;
-    fPreContainerSumEElectrons = 0.;
+    fPlaneTallies.fill(PlaneTally());
     
-    fPostContainerNPhotonsBack = 0;
-    fPostContainerSumEPhotonsBack = 0.;
-    fPostContainerNElectronsBack = 0;
-    fPostContainerSumEElectronsBack = 0.;
-    
-    fPostContainerNPhotonsFwd = 0;
-    fPostContainerSumEPhotonsFwd = 0.;
-    fPostContainerNElectronsFwd = 0;
-    fPostContainerSumEElectronsFwd = 0.;
+    // Coût CPU par raie pour l'allocation stratifiée
+    if (fGenerator->GetStratifiedSampler()->IsEnabled()) {
+        fEventStartCPU_s = ThreadCpuTime();
+    }
     
     // ═══════════════════════════════════════════════════════════════
     // CORRECTION BUG : Ne PAS enregistrer les primaires ici !
@@ -178,7 +191,7 @@ void EventAction::RegisterPrimaryGamma(G4int trackID, G4double energy,
                                         G4double theta, G4double phi)
 {
     // Vérifier si ce trackID n'est pas déjà enregistré
-    if (fTrackIDtoIndex.find(trackID) != fTrackIDtoIndex.end()) {
+    if (FindPrimary(trackID) >= 0) {
         return;  // Déjà enregistré
     }
     
@@ -189,36 +202,58 @@ void EventAction::RegisterPrimaryGamma(G4int trackID, G4double energy,
     info.theta = theta;
     info.phi = phi;
     info.absorbedInWater = false;
+    info.absorbedWeight = 0.;
     info.enteredWater = false;
     info.absorptionProcess = -1;
     
-    fTrackIDtoIndex[trackID] = fPrimaryGammas.size();
+    fTrackIndex.emplace_back(trackID, static_cast<G4int>(fPrimaryGammas.size()));
     fPrimaryGammas.push_back(info);
 }
 
+void EventAction::RegisterPrimaryClone(G4int cloneTrackID, G4int parentTrackID)
+{
+    G4int index = FindPrimary(parentTrackID);
+    if (index >= 0 && FindPrimary(cloneTrackID) < 0) {
+        fTrackIndex.emplace_back(cloneTrackID, index);
+    }
+}
+
 void EventAction::EndOfEventAction(const G4Event* event)
 {
+    PUITS_ALLOCATION_SCOPE(kEvent);
+    PUITS_PROFILE_SCOPE(kEndOfEvent);
+    
     G4int eventID = event->GetEventID();
     
+    // Poids source (p/q en mode stratifié) : retiré des statistiques par raie,
+    // qui restent des taux par photon émis de la raie
+    G4double sourceWeight = fGenerator->GetLastEventWeight();
+    
+    // Position de source de l'événement en balayage (-1 sinon)
+    const G4int scanPosition = fGenerator->GetLastEventPosition();
+    
     // Collecter les statistiques pour chaque raie
-    std::vector<G4double> primaryEnergies;
     for (const auto& gamma : fPrimaryGammas) {
-        primaryEnergies.push_back(gamma.energyInitial);
-        
         // Enregistrer les statistiques par raie (SANS FILTRE)
         if (gamma.gammaLineIndex >= 0) {
             fRunAction->RecordGammaLineStatistics(
                 gamma.gammaLineIndex,
                 gamma.enteredWater,
                 gamma.absorbedInWater,
-                gamma.absorptionProcess  // processus d'absorption
+                gamma.absorptionProcess,  // processus d'absorption
+                gamma.absorbedWeight / sourceWeight
             );
+            if (scanPosition >= 0) {
+                fRunAction->RecordScanLine(scanPosition, gamma.gammaLineIndex, gamma.enteredWater,
+                                           gamma.absorbedInWater, gamma.absorbedWeight / sourceWeight);
+            }
         }
     }
     
     // Transférer les dépôts d'énergie vers RunAction
+    const G4int nRings = fRunAction->GetNbRings();
     G4double totalDeposit = 0.;
-    for (G4int i = 0; i < DetectorConstruction::kNbWaterRings; ++i) {
+    for (G4int i = 0; i < nRings; ++i) {
         if (fRingEnergyDeposit[i] > 0.) {
             fRunAction->AddRingEnergy(i, fRingEnergyDeposit[i]);
             totalDeposit += fRingEnergyDeposit[i];
@@ -231,11 +266,39 @@ void EventAction::EndOfEventAction(const G4Event* event)
             }
         }
     }
+
+    // Dose par anneau de l'événement pour les incertitudes :
+    // TOUS les événements comptent, y compris ceux sans dépôt
+    fRunAction->RecordRingDoses(fRingEnergyDeposit);
+    if (scanPosition >= 0) {
+        fRunAction->RecordScanEvent(scanPosition, fRingEnergyDeposit, fGenerator->GetLastEventDecays());
+    }
+    
+    // Kerma par longueur de trace : même traitement (tous les événements)
+    if (KermaScoring::GetInstance()->IsEnabled()) {
+        fRunAction->RecordRingKerma(fRingKermaEnergy);
+    }
     
+    // Score de la raie tirée pour les lots pilotes de l'allocation stratifiée
+    StratifiedSampler* sampler = fGenerator->GetStratifiedSampler();
+    if (sampler->IsEnabled() && fGenerator->GetLastEventLine() >= 0) {
+        G4double sumDoseSquared = 0.;
+        for (G4int i = 0; i < nRings; ++i) {
+            G4double mass_g = fRunAction->GetRingMass(i);
+            if (fRingEnergyDeposit[i] > 0. && mass_g > 0.) {
+                G4double dose = RunAction::EnergyToNanoGray(fRingEnergyDeposit[i] / MeV, mass_g) / sourceWeight;
+                sumDoseSquared += dose * dose;
+            }
+        }
+        G4double cpuTime_s = ThreadCpuTime() - fEventStartCPU_s;
+        sampler->RecordEvent(fGenerator->GetLastEventLine(), sumDoseSquared, cpuTime_s);
+        fRunAction->RecordStratifiedLine(fGenerator->GetLastEventLine(), sourceWeight);
+    }
+
     // Enregistrer les statistiques globales de l'événement
+    fRunAction->AddDecays(fGenerator->GetLastEventDecays());
     fRunAction->RecordEventStatistics(
         fPrimaryGammas.size(),
-        primaryEnergies,
         GetNumberTransmitted(),
         GetNumberAbsorbed(),
         totalDeposit,
@@ -243,36 +306,43 @@ void EventAction::EndOfEventAction(const G4Event* event)
     );
     
     // Enregistrer les comptages aux plans container
-    fRunAction->RecordContainerPlaneStatistics(
-        fPreContainerNPhotons, fPreContainerSumEPhotons,
-        fPreContainerNElectrons, fPreContainerSumEElectrons,
-        fPostContainerNPhotonsBack, fPostContainerSumEPhotonsBack,
-        fPostContainerNElectronsBack, fPostContainerSumEElectronsBack,
-        fPostContainerNPhotonsFwd, fPostContainerSumEPhotonsFwd,
-        fPostContainerNElectronsFwd, fPostContainerSumEElectronsFwd
-    );
+    const PlaneTally& prePhotonFwd = GetPlaneTally(PlaneSD::kPreContainer, PlaneSD::kPhoton, PlaneSD::kForward);
+    const PlaneTally& preElectronFwd = GetPlaneTally(PlaneSD::kPreContainer, PlaneSD::kElectron, PlaneSD::kForward);
+    const PlaneTally& postPhotonFwd = GetPlaneTally(PlaneSD::kPostContainer, PlaneSD::kPhoton, PlaneSD::kForward);
+    const PlaneTally& postPhotonBack = GetPlaneTally(PlaneSD::kPostContainer, PlaneSD::kPhoton, PlaneSD::kBackward);
+    const PlaneTally& postElectronFwd = GetPlaneTally(PlaneSD::kPostContainer, PlaneSD::kElectron, PlaneSD::kForward);
+    const PlaneTally& postElectronBack = GetPlaneTally(PlaneSD::kPostContainer, PlaneSD::kElectron, PlaneSD::kBackward);
+    
+    for (G4int i = 0; i < PlaneSD::kNbTallies; ++i) {
+        const PlaneTally& tally = fPlaneTallies[i];
+        fRunAction->AddPlaneTally(i, tally.count, tally.sumEnergy, tally.weightedCount, tally.weightedEnergy);
+        if (scanPosition >= 0) {
+            fRunAction->AddScanPlaneTally(scanPosition, i, tally.count, tally.sumEnergy,
+                                          tally.weightedCount, tally.weightedEnergy);
+        }
+    }
     
     // ─────────────────────────────────────────────────────────────
     // REMPLISSAGE DES NTUPLES PRECONTAINER ET POSTCONTAINER
     // ─────────────────────────────────────────────────────────────
     fRunAction->FillPreContainerNtuple(
         eventID,
-        fPreContainerNPhotons,
-        fPreContainerSumEPhotons / keV,
-        fPreContainerNElectrons,
-        fPreContainerSumEElectrons / keV
+        prePhotonFwd.count,
+        prePhotonFwd.sumEnergy / keV,
+        preElectronFwd.count,
+        preElectronFwd.sumEnergy / keV
     );
     
     fRunAction->FillPostContainerNtuple(
         eventID,
-        fPostContainerNPhotonsFwd,
-        fPostContainerSumEPhotonsFwd / keV,
-        fPostContainerNPhotonsBack,
-        fPostContainerSumEPhotonsBack / keV,
-        fPostContainerNElectronsFwd,
-        fPostContainerSumEElectronsFwd / keV,
-        fPostContainerNElectronsBack,
-        fPostContainerSumEElectronsBack / keV
+        postPhotonFwd.count,
+        postPhotonFwd.sumEnergy / keV,
+        postPhotonBack.count,
+        postPhotonBack.sumEnergy / keV,
+        postElectronFwd.count,
+        postElectronFwd.sumEnergy / keV,
+        postElectronBack.count,
+        postElectronBack.sumEnergy / keV
     );
     
     // ─────────────────────────────────────────────────────────────
@@ -300,19 +370,22 @@ void EventAction::EndOfEventAction(const G4Event* event)
         
         // Résumé des plans container
         std::stringstream cs;
-        cs << "  PreContainer: nPhotons=" << fPreContainerNPhotons 
-           << " sumE=" << fPreContainerSumEPhotons/keV << " keV"
-           << " | nElec=" << fPreContainerNElectrons 
-           << " sumE=" << fPreContainerSumEElectrons/keV << " keV";
+        cs << "  PreContainer: nPhotons=" << prePhotonFwd.count
+           << " sumE=" << prePhotonFwd.sumEnergy/keV << " keV"
+           << " | nElec=" << preElectronFwd.count
+           << " sumE=" << preElectronFwd.sumEnergy/keV << " keV";
         Logger::GetInstance()->LogLine(cs.str());
         
         std::stringstream ps;
-        ps << "  PostContainer: nPhotons_back=" << fPostContainerNPhotonsBack 
-           << " sumE_back=" << fPostContainerSumEPhotonsBack/keV << " keV"
-           << " | nPhotons_fwd=" << fPostContainerNPhotonsFwd 
-           << " sumE_fwd=" << fPostContainerSumEPhotonsFwd/keV << " keV";
+        ps << "  PostContainer: nPhotons_back=" << postPhotonBack.count
+           << " sumE_back=" << postPhotonBack.sumEnergy/keV << " keV"
+           << " | nPhotons_fwd=" << postPhotonFwd.count
+           << " sumE_fwd=" << postPhotonFwd.sumEnergy/keV << " keV";
         Logger::GetInstance()->LogLine(ps.str());
     }
+    
+    PUITS_ALLOCATION_END_OF_EVENT();
+    PUITS_PROFILE_END_OF_EVENT();
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -321,41 +394,49 @@ void EventAction::EndOfEventAction(const G4Event* event)
 
 void EventAction::RecordWaterEntry(G4int trackID, G4double energy)
 {
-    // Ajouter au set pour éviter le double-comptage
-    fGammasEnteredWater.insert(trackID);
+    // Mémoriser le trackID pour éviter le double-comptage
+    if (!HasEnteredWater(trackID)) {
+        fGammasEnteredWater.push_back(trackID);
+    }
     
-    auto it = fTrackIDtoIndex.find(trackID);
-    if (it != fTrackIDtoIndex.end()) {
-        fPrimaryGammas[it->second].enteredWater = true;
+    G4int index = FindPrimary(trackID);
+    if (index >= 0) {
+        fPrimaryGammas[index].enteredWater = true;
     }
 }
 
 G4bool EventAction::HasEnteredWater(G4int trackID) const
 {
-    return fGammasEnteredWater.find(trackID) != fGammasEnteredWater.end();
+    return std::find(fGammasEnteredWater.begin(), fGammasEnteredWater.end(), trackID)
+           != fGammasEnteredWater.end();
 }
 
 void EventAction::RecordContainerEntry(G4int trackID)
 {
-    // Ajouter au set pour éviter le double-comptage
-    fGammasEnteredContainer.insert(trackID);
+    // Mémoriser le trackID pour éviter le double-comptage
+    if (!HasEnteredContainer(trackID)) {
+        fGammasEnteredContainer.push_back(trackID);
+    }
 }
 
 G4bool EventAction::HasEnteredContainer(G4int trackID) const
 {
-    return fGammasEnteredContainer.find(trackID) != fGammasEnteredContainer.end();
+    return std::find(fGammasEnteredContainer.begin(), fGammasEnteredContainer.end(), trackID)
+           != fGammasEnteredContainer.end();
 }
 
-void EventAction::RecordGammaAbsorbed(G4int trackID, const G4String& volumeName, const G4String& processName)
+void EventAction::RecordGammaAbsorbed(G4int trackID, const G4String& volumeName, const G4String& processName,
+                                      G4double weight)
 {
-    auto it = fTrackIDtoIndex.find(trackID);
-    if (it != fTrackIDtoIndex.end()) {
+    G4int index = FindPrimary(trackID);
+    if (index >= 0) {
         // Enregistrer le processus d'absorption
         G4int processIndex = GetProcessIndex(processName);
-        fPrimaryGammas[it->second].absorptionProcess = processIndex;
+        fPrimaryGammas[index].absorptionProcess = processIndex;
         
         if (volumeName.find("Water") != std::string::npos) {
-            fPrimaryGammas[it->second].absorbedInWater = true;
+            fPrimaryGammas[index].absorbedInWater = true;
+            fPrimaryGammas[index].absorbedWeight += weight;
         }
     }
 }
@@ -366,22 +447,29 @@ void EventAction::RecordGammaAbsorbed(G4int trackID, const G4String& volumeName,
 
 void EventAction::AddRingEnergy(G4int ringIndex, G4double edep)
 {
-    if (ringIndex >= 0 && ringIndex < DetectorConstruction::kNbWaterRings) {
+    if (ringIndex >= 0 && ringIndex < DetectorConstruction::kMaxWaterRings) {
         fRingEnergyDeposit[ringIndex] += edep;
     }
 }
 
 void EventAction::AddRingEnergyByLine(G4int ringIndex, G4int lineIndex, G4double edep)
 {
-    if (ringIndex >= 0 && ringIndex < DetectorConstruction::kNbWaterRings &&
+    if (ringIndex >= 0 && ringIndex < DetectorConstruction::kMaxWaterRings &&
         lineIndex >= 0 && lineIndex < kNbGammaLines) {
         fRingEnergyByLine[ringIndex][lineIndex] += edep;
     }
 }
 
+void EventAction::AddRingKerma(G4int ringIndex, G4double kermaEnergy)
+{
+    if (ringIndex >= 0 && ringIndex < DetectorConstruction::kMaxWaterRings) {
+        fRingKermaEnergy[ringIndex] += kermaEnergy;
+    }
+}
+
 G4double EventAction::GetRingEnergy(G4int ringIndex) const
 {
-    if (ringIndex >= 0 && ringIndex < DetectorConstruction::kNbWaterRings) {
+    if (ringIndex >= 0 && ringIndex < DetectorConstruction::kMaxWaterRings) {
         return fRingEnergyDeposit[ringIndex];
     }
     return 0.;
@@ -400,40 +488,14 @@ G4double EventAction::GetTotalWaterEnergy() const
 // COMPTAGES AUX PLANS CONTAINER
 // ═══════════════════════════════════════════════════════════════
 
-void EventAction::AddPreContainerPhoton(G4double energy)
-{
-    fPreContainerNPhotons++;
-    fPreContainerSumEPhotons += energy;
-}
-
-void EventAction::AddPreContainerElectron(G4double energy)
-{
-    fPreContainerNElectrons++;
-    fPreContainerSumEElectrons += energy;
-}
-
-void EventAction::AddPostContainerPhotonBack(G4double energy)
-{
-    fPostContainerNPhotonsBack++;
-    fPostContainerSumEPhotonsBack += energy;
-}
-
-void EventAction::AddPostContainerElectronBack(G4double energy)
-{
-    fPostContainerNElectronsBack++;
-    fPostContainerSumEElectronsBack += energy;
-}
-
-void EventAction::AddPostContainerPhotonFwd(G4double energy)
-{
-    fPostContainerNPhotonsFwd++;
-    fPostContainerSumEPhotonsFwd += energy;
-}
-
-void EventAction::AddPostContainerElectronFwd(G4double energy)
+void EventAction::AddPlaneCrossing(G4int tallyIndex, G4double energy, G4double weight)
 {
-    fPostContainerNElectronsFwd++;
-    fPostContainerSumEElectronsFwd += energy;
+    PlaneTally& tally = fPlaneTallies[tallyIndex];
+    tally.count++;
+    tally.sumEnergy += energy;
+    tally.weightedCount += weight;
+    tally.weightedEnergy += weight * energy;
+    fRunAction->FillPlaneSpectrum(tallyIndex, energy / keV, weight);
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -461,14 +523,14 @@ G4int EventAction::GetNumberAbsorbed() const
 
 G4bool EventAction::IsPrimaryTrack(G4int trackID) const
 {
-    return fTrackIDtoIndex.find(trackID) != fTrackIDtoIndex.end();
+    return FindPrimary(trackID) >= 0;
 }
 
 G4int EventAction::GetGammaLineForTrack(G4int trackID) const
 {
-    auto it = fTrackIDtoIndex.find(trackID);
-    if (it != fTrackIDtoIndex.end()) {
-        return fPrimaryGammas[it->second].gammaLineIndex;
+    G4int index = FindPrimary(trackID);
+    if (index >= 0) {
+        return fPrimaryGammas[index].gammaLineIndex;
     }
     return -1;
 }
@@ -0,0 +1,308 @@
+#include "JobServer.hh"
+#include "Logger.hh"
+
+#include "G4UImanager.hh"
+#include "G4UIcommandTree.hh"
+#include "G4UIcommand.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+namespace
+{
+    std::atomic<bool> gStopSignal(false);
+
+    // Réglages communs aux jobs du serveur, rejoués après la remise à zéro
+    // (pas un job : ignoré par la file)
+    const G4String kDefaultsMacro = "defaults.mac";
+
+    // État remis avant chaque job : valeurs par défaut des constructeurs pour
+    // tout ce qu'un job peut régler (un job ne doit pas hériter du précédent).
+    // Les graines ne sont pas remises : chaque job donne les siennes
+    const std::vector<G4String> kJobDefaults = {
+        "/puits/scan/clear",
+        "/puits/source/coneMode fixed",
+        "/puits/source/coneAngle 45 deg",
+        "/puits/source/coneMargin 1 mm",
+        "/puits/source/targetRadius 0 mm",
+        "/puits/strat/enable false",
+        "/puits/strat/batchSize 10000",
+        "/puits/strat/defensiveFraction 0.1",
+        "/puits/qmc/enable false",
+        "/puits/qmc/study false",
+        "/puits/corr/enable false",
+        "/puits/corr/seed 12345",
+        "/puits/kerma/enable false",
+        "/puits/kerma/electronTransport true",
+        "/puits/cascade/enable false",
+        "/puits/cascade/coneOnly true",
+        "/puits/response/off",
+        "/puits/stats/batchSize 10000",
+        "/puits/stats/reportEvery 0",
+        "/puits/output/results true",
+        "/puits/output/merge none",
+        "/puits/progress/interval 0 s",
+        "/puits/progress/heartbeatFile",
+        "/puits/attenuator/kernel/file attenuator_kernel.dat",
+        "/puits/attenuator/kernel/maxSamples 5000",
+        "/puits/attenuator/kernel/minSamples 100",
+        "/puits/attenuator/kernel/retabulate false"
+    };
+
+    // Profondeur maximale des macros imbriquées (/control/execute) d'un job
+    const G4int kMaxMacroDepth = 8;
+
+    void OnStopSignal(int)
+    {
+        gStopSignal = true;
+    }
+
+    G4String Trim(const std::string& line)
+    {
+        const char* blanks = " \t\r\n";
+        size_t first = line.find_first_not_of(blanks);
+        if (first == std::string::npos) return "";
+        size_t last = line.find_last_not_of(blanks);
+        return line.substr(first, last - first + 1);
+    }
+
+    // Commande connue mais refusée dans l'état courant (Idle) : géométrie,
+    // physique, atténuateur... Les commandes inconnues sont laissées à
+    // ApplyCommand, qui les signale lui-même
+    G4bool IsPreInitOnly(const G4String& command)
+    {
+        G4String path = command.substr(0, command.find(' '));
+        G4UIcommand* uiCommand = G4UImanager::GetUIpointer()->GetTree()->FindPath(path);
+        return uiCommand != nullptr && !uiCommand->IsAvailable();
+    }
+
+    // Commandes d'une macro, sans commentaires ni lignes vides
+    G4bool ReadMacro(const std::filesystem::path& macro, std::vector<G4String>& commands, G4String& error)
+    {
+        std::ifstream file(macro);
+        if (!file.is_open()) {
+            error = "impossible de lire " + macro.string();
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            G4String command = Trim(line);
+            if (command.empty() || command[0] == '#') continue;
+            commands.push_back(command);
+        }
+        return true;
+    }
+
+    // Commandes d'une macro et de celles qu'elle appelle par /control/execute,
+    // pour vérifier tout ce que le job exécutera. Les macros paramétrées
+    // (/control/loop, /control/foreach) ne peuvent pas être lues à l'avance
+    G4bool ExpandMacro(const std::filesystem::path& macro, std::vector<G4String>& expanded,
+                       G4String& error, G4int depth)
+    {
+        if (depth > kMaxMacroDepth) {
+            error = macro.string() + " : plus de " + std::to_string(kMaxMacroDepth) + " macros imbriquees";
+            return false;
+        }
+        std::vector<G4String> commands;
+        if (!ReadMacro(macro, commands, error)) return false;
+        for (const G4String& command : commands) {
+            G4String path = command.substr(0, command.find(' '));
+            if (path == "/control/loop" || path == "/control/foreach") {
+                error = command + " : macro parametree, interdite dans un job";
+                return false;
+            }
+            expanded.push_back(command);
+            if (path == "/control/execute") {
+                if (!ExpandMacro(std::string(Trim(command.substr(path.size()))), expanded, error, depth + 1)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+JobServer::JobServer(const G4String& jobDirectory, G4double initTime_s)
+: fJobDirectory(jobDirectory),
+  fPollInterval_s(1.),
+  fInitTime_s(initTime_s),
+  fQuiet(Logger::GetInstance()->IsQuiet())
+{
+    for (const char* sub : {"running", "done", "failed", "results"}) {
+        std::filesystem::create_directories(fJobDirectory / sub);
+    }
+
+    std::signal(SIGINT, OnStopSignal);
+    std::signal(SIGTERM, OnStopSignal);
+}
+
+JobServer::~JobServer()
+{
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+}
+
+G4bool JobServer::StopRequested() const
+{
+    return gStopSignal || std::filesystem::exists(fJobDirectory / "STOP");
+}
+
+// ═══════════════════════════════════════════════════════════════
+// BOUCLE DE SURVEILLANCE
+// ═══════════════════════════════════════════════════════════════
+
+void JobServer::Run()
+{
+    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    G4cout << "║  MODE SERVEUR - géométrie et physique initialisées            ║" << G4endl;
+    G4cout << "║  Dossier de jobs : " << fJobDirectory.string() << G4endl;
+    G4cout << "║  Arrêt : fichier STOP dans le dossier, ou Ctrl-C              ║" << G4endl;
+    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+
+    std::ofstream serverLog(fJobDirectory / "server.log", std::ios::app);
+    serverLog << "# demarrage : initialisation " << std::fixed << std::setprecision(2)
+              << fInitTime_s << " s" << std::endl;
+    G4int nDone = 0, nFailed = 0;
+    G4double sumTurnaround_s = 0.;
+
+    while (!StopRequested()) {
+        std::vector<std::filesystem::path> jobs = PendingJobs();
+        if (jobs.empty()) {
+            std::this_thread::sleep_for(std::chrono::duration<G4double>(fPollInterval_s));
+            continue;
+        }
+
+        for (const auto& pending : jobs) {
+            if (StopRequested()) break;
+
+            // Attente dans la file : du dépôt (date du fichier) à la prise en charge
+            std::error_code error;
+            auto deposited = std::filesystem::last_write_time(pending, error);
+            G4double wait_s = error ? 0. : std::chrono::duration<G4double>(
+                std::filesystem::file_time_type::clock::now() - deposited).count();
+
+            // Réservation : un seul serveur exécute un job donné
+            std::filesystem::path running = fJobDirectory / "running" / pending.filename();
+            std::filesystem::rename(pending, running, error);
+            if (error) continue;
+
+            G4String stem = pending.stem().string();
+            G4cout << ">>> Job " << stem << G4endl;
+
+            auto start = std::chrono::steady_clock::now();
+            G4String failure;
+            G4bool ok = ResetState(failure);
+
+            // Sorties séparées par défaut ; le job peut les renommer
+            if (ok) {
+                G4UImanager::GetUIpointer()->ApplyCommand(
+                    "/puits/output/name " + (fJobDirectory / "results" / stem).string());
+                ok = RunJob(running, failure);
+            }
+            G4double elapsed = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count();
+            G4double turnaround = std::max(0., wait_s) + elapsed;
+
+            std::filesystem::rename(running, fJobDirectory / (ok ? "done" : "failed") / pending.filename(), error);
+            if (ok) nDone++; else nFailed++;
+            sumTurnaround_s += turnaround;
+
+            // Délai de rendu = attente + exécution, à comparer à l'initialisation
+            serverLog << stem << " " << (ok ? "OK" : "ECHEC") << " "
+                      << std::fixed << std::setprecision(2) << elapsed << " s"
+                      << " (attente " << std::max(0., wait_s) << " s, rendu " << turnaround << " s)";
+            if (!ok) serverLog << " | " << failure;
+            serverLog << std::endl;
+
+            G4cout << ">>> Job " << stem << (ok ? " termine" : " en echec : " + failure)
+                   << " (" << elapsed << " s, rendu " << turnaround << " s)" << G4endl;
+        }
+    }
+
+    std::filesystem::remove(fJobDirectory / "STOP");
+    G4int nJobs = nDone + nFailed;
+    G4cout << ">>> Serveur arrete : " << nDone << " job(s) termine(s), "
+           << nFailed << " en echec" << G4endl;
+    if (nJobs > 0) {
+        G4cout << ">>> Rendu moyen par job : " << sumTurnaround_s / nJobs
+               << " s (initialisation evitee : " << fInitTime_s << " s)" << G4endl;
+    }
+}
+
+std::vector<std::filesystem::path> JobServer::PendingJobs() const
+{
+    std::vector<std::filesystem::path> jobs;
+    for (const auto& entry : std::filesystem::directory_iterator(fJobDirectory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".mac"
+            && entry.path().filename() != kDefaultsMacro) {
+            jobs.push_back(entry.path());
+        }
+    }
+    std::sort(jobs.begin(), jobs.end());
+    return jobs;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// EXÉCUTION D'UN JOB
+// ═══════════════════════════════════════════════════════════════
+
+G4bool JobServer::ResetState(G4String& error)
+{
+    G4UImanager* UImanager = G4UImanager::GetUIpointer();
+    std::vector<G4String> commands = kJobDefaults;
+    // Sortie console : celle du démarrage du serveur (--quiet, macro d'initialisation)
+    commands.push_back(G4String("/puits/output/quiet ") + (fQuiet ? "true" : "false"));
+    for (const G4String& command : commands) {
+        G4int status = UImanager->ApplyCommand(command);
+        if (status != 0) {
+            error = "remise a zero : " + command + " (code " + std::to_string(status) + ")";
+            return false;
+        }
+    }
+
+    // Réglages communs à tous les jobs du serveur
+    std::filesystem::path defaults = fJobDirectory / kDefaultsMacro;
+    if (std::filesystem::exists(defaults)) {
+        if (!RunJob(defaults, error)) {
+            error = kDefaultsMacro + " : " + error;
+            return false;
+        }
+    }
+    return true;
+}
+
+G4bool JobServer::RunJob(const std::filesystem::path& jobFile, G4String& error)
+{
+    std::vector<G4String> commands, expanded;
+    if (!ReadMacro(jobFile, commands, error)) return false;
+    if (!ExpandMacro(jobFile, expanded, error, 0)) return false;
+
+    // Géométrie et physique sont construites une seule fois : un job qui les
+    // modifie, lui-même ou par une macro appelée, est refusé en entier,
+    // avant toute exécution
+    for (const G4String& command : expanded) {
+        if (!IsPreInitOnly(command)) continue;
+        if (command.rfind("/puits/geometry/", 0) == 0) {
+            error = command + " : geometrie fixee par la macro d'initialisation du serveur"
+                    " (un serveur par geometrie)";
+        } else {
+            error = command + " : commande PreInit, reservee a la macro d'initialisation du serveur";
+        }
+        return false;
+    }
+
+    // Commande par commande : le code de retour de chacune est vérifié
+    G4UImanager* UImanager = G4UImanager::GetUIpointer();
+    for (const G4String& command : commands) {
+        G4int status = UImanager->ApplyCommand(command);
+        if (status != 0) {
+            error = command + " (code " + std::to_string(status) + ")";
+            return false;
+        }
+    }
+    return true;
+}
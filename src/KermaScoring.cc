@@ -0,0 +1,102 @@
+#include "KermaScoring.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+
+KermaScoring* KermaScoring::fInstance = nullptr;
+
+namespace
+{
+    // ═══════════════════════════════════════════════════════════════
+    // µen/ρ DE L'EAU LIQUIDE (NIST, Hubbell & Seltzer)
+    // Énergie en MeV, µen/ρ en cm²/g
+    // ═══════════════════════════════════════════════════════════════
+    const G4int kNbNistPoints = 29;
+    const G4double kNistEnergy_MeV[kNbNistPoints] = {
+        1.0e-3, 1.5e-3, 2.0e-3, 3.0e-3, 4.0e-3, 5.0e-3, 6.0e-3, 8.0e-3,
+        1.0e-2, 1.5e-2, 2.0e-2, 3.0e-2, 4.0e-2, 5.0e-2, 6.0e-2, 8.0e-2,
+        1.0e-1, 1.5e-1, 2.0e-1, 3.0e-1, 4.0e-1, 5.0e-1, 6.0e-1, 8.0e-1,
+        1.0,    1.25,   1.5,    2.0,    3.0
+    };
+    const G4double kNistMuEn_cm2g[kNbNistPoints] = {
+        4.065e+3, 1.372e+3, 6.152e+2, 1.917e+2, 8.191e+1, 4.188e+1, 2.405e+1, 9.915,
+        4.944,    1.374,    5.503e-1, 1.557e-1, 6.947e-2, 4.223e-2, 3.190e-2, 2.597e-2,
+        2.546e-2, 2.764e-2, 2.967e-2, 3.192e-2, 3.279e-2, 3.299e-2, 3.284e-2, 3.206e-2,
+        3.103e-2, 2.965e-2, 2.833e-2, 2.608e-2, 2.281e-2
+    };
+}
+
+KermaScoring::KermaScoring()
+: fLogEMin(0.),
+  fLogEMax(0.),
+  fInvLogStep(0.),
+  fEnabled(false),
+  fElectronTransport(true),
+  fMessenger(nullptr)
+{
+    BuildTable();
+    DefineCommands();
+}
+
+KermaScoring::~KermaScoring()
+{
+    delete fMessenger;
+}
+
+KermaScoring* KermaScoring::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de RunAction)
+    if (fInstance == nullptr) {
+        fInstance = new KermaScoring();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/kerma/)
+// ═══════════════════════════════════════════════════════════════
+
+void KermaScoring::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/kerma/",
+                                        "Kerma de collision par longueur de trace dans les anneaux");
+
+    auto& enableCmd = fMessenger->DeclareProperty("enable", fEnabled,
+        "Score le kerma par longueur de trace a cote de la dose (depot)");
+    enableCmd.SetParameterName("enable", true);
+    enableCmd.SetDefaultValue("true");
+    enableCmd.SetStates(G4State_PreInit, G4State_Idle);
+    enableCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& electronCmd = fMessenger->DeclareProperty("electronTransport", fElectronTransport,
+        "false : electrons deposes sur place dans les anneaux (mode kerma seulement)");
+    electronCmd.SetParameterName("transport", true);
+    electronCmd.SetDefaultValue("true");
+    electronCmd.SetStates(G4State_PreInit, G4State_Idle);
+    electronCmd.SetToBeBroadcasted(false);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GRILLE RÉGULIÈRE EN LOG E
+// ═══════════════════════════════════════════════════════════════
+
+void KermaScoring::BuildTable()
+{
+    fLogEMin = std::log(kNistEnergy_MeV[0] * MeV);
+    fLogEMax = std::log(kNistEnergy_MeV[kNbNistPoints - 1] * MeV);
+    G4double step = (fLogEMax - fLogEMin) / (kGridSize - 1);
+    fInvLogStep = 1. / step;
+
+    // Interpolation log-log de la table NIST aux nœuds de la grille
+    G4int j = 0;
+    for (G4int i = 0; i < kGridSize; ++i) {
+        G4double logE = fLogEMin + i * step;
+        while (j < kNbNistPoints - 2 && logE > std::log(kNistEnergy_MeV[j + 1] * MeV)) j++;
+
+        G4double x0 = std::log(kNistEnergy_MeV[j] * MeV);
+        G4double x1 = std::log(kNistEnergy_MeV[j + 1] * MeV);
+        G4double y0 = std::log(kNistMuEn_cm2g[j] * cm2 / g);
+        G4double y1 = std::log(kNistMuEn_cm2g[j + 1] * cm2 / g);
+        fLogMuEn[i] = y0 + (logE - x0) * (y1 - y0) / (x1 - x0);
+    }
+}
@@ -4,13 +4,15 @@
 #include <iomanip>
 #include <sstream>
 
-// Initialisation du singleton
-Logger* Logger::fInstance = nullptr;
+// Initialisation du singleton (une instance par thread)
+G4ThreadLocal Logger* Logger::fInstance = nullptr;
+G4bool Logger::fQuiet = false;
 
 Logger::Logger()
 : fEnabled(true),
   fEchoToConsole(false),
-  fFilename("output.log")
+  fFilename("output.log"),
+  fNullStream(nullptr)
 {}
 
 Logger::~Logger()
@@ -36,7 +38,7 @@ void Logger::Open(const G4String& filename)
     fLogFile.open(filename, std::ios::out);
     
     if (fLogFile.is_open()) {
-        G4cout << "Logger: Output redirected to " << filename << G4endl;
+        Banner() << "Logger: Output redirected to " << filename << G4endl;
         
         // Écrire un header avec la date/heure
         std::time_t now = std::time(nullptr);
@@ -68,7 +70,7 @@ void Logger::Close()
         fLogFile << "╚═══════════════════════════════════════════════════════════════════╝\n";
         
         fLogFile.close();
-        G4cout << "Logger: Log file closed." << G4endl;
+        Banner() << "Logger: Log file closed." << G4endl;
     }
 }
 
@@ -1,26 +1,38 @@
 #include "PhysicsList.hh"
+#include "Logger.hh"
 
 #include "G4EmLivermorePhysics.hh"
+#include "G4EmPenelopePhysics.hh"
 #include "G4EmStandardPhysics_option4.hh"
+#include "G4EmExtraPhysics.hh"
 #include "G4DecayPhysics.hh"
+#include "G4HadronElasticPhysics.hh"
+#include "G4HadronPhysicsFTFP_BERT.hh"
+#include "G4StoppingPhysics.hh"
+#include "G4IonPhysics.hh"
+#include "G4NeutronTrackingCut.hh"
 #include "G4StepLimiterPhysics.hh"
+#include "G4GenericBiasingPhysics.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4GenericMessenger.hh"
 #include "G4SystemOfUnits.hh"
 
-PhysicsList::PhysicsList() : FTFP_BERT() {
-  
+PhysicsList::PhysicsList() : G4VModularPhysicsList() {
+
+  SetVerboseLevel(1);
 
   // Modèles basse énergie optimisés pour photons/électrons de keV à quelques MeV
-  ReplacePhysics(new G4EmLivermorePhysics());
+  // (remplaçable par /puits/physics/em avant /run/initialize)
+  RegisterPhysics(new G4EmLivermorePhysics());
 
-  // Physique de décroissance
-  RegisterPhysics(new G4DecayPhysics());
-  
   // Step Limiter : permet d'appliquer les G4UserLimits dans les volumes
   // Nécessaire pour forcer des steps courts dans le détecteur Kerma
   RegisterPhysics(new G4StepLimiterPhysics());
 
-  G4cout << "\n========== PHYSIQUE ==========\n"
-  << "Liste de physique : FTFP_BERT\n"
+  DefineCommands();
+
+  Logger::GetInstance()->Banner() << "\n========== PHYSIQUE ==========\n"
+  << "Liste de physique : EM seule (modulaire)\n"
   << "EM Physics : Livermore (optimisée basse énergie)\n"
   << "  - Photoélectrique avec couches atomiques\n"
   << "  - Compton avec fonction de diffusion\n"
@@ -29,17 +41,105 @@ PhysicsList::PhysicsList() : FTFP_BERT() {
   << "  - Bremsstrahlung\n"
   << "  - Ionisation\n"
   << "Step Limiter : activé (pour UserLimits)\n"
+  << "Choix EM : /puits/physics/em livermore|penelope|option4\n"
   << "==============================\n" << G4endl;
 }
 
+PhysicsList::~PhysicsList() {
+  delete fMessenger;
+}
+
+void PhysicsList::DefineCommands() {
+
+  fMessenger = new G4GenericMessenger(this, "/puits/physics/",
+                                      "Liste de physique (avant /run/initialize)");
+
+  auto& emCmd = fMessenger->DeclareMethod("em", &PhysicsList::SelectEmPhysics,
+    "Physique EM : livermore (defaut), penelope ou option4");
+  emCmd.SetParameterName("model", false);
+  emCmd.SetCandidates("livermore penelope option4");
+  emCmd.SetStates(G4State_PreInit);
+  emCmd.SetToBeBroadcasted(false);   // liste partagée, construite par le maître
+
+  auto& hadCmd = fMessenger->DeclareMethod("hadronic", &PhysicsList::EnableHadronicPhysics,
+    "Ajoute les constructeurs hadroniques et de decroissance de FTFP_BERT (reference)");
+  hadCmd.SetStates(G4State_PreInit);
+  hadCmd.SetToBeBroadcasted(false);
+}
+
+void PhysicsList::SelectEmPhysics(const G4String& name) {
+
+  if (name == fEmName) return;
+
+  if (name == "penelope") {
+    ReplacePhysics(new G4EmPenelopePhysics());
+  } else if (name == "option4") {
+    ReplacePhysics(new G4EmStandardPhysics_option4());
+  } else {
+    ReplacePhysics(new G4EmLivermorePhysics());
+  }
+  fEmName = name;
+
+  G4cout << "PhysicsList : physique EM -> " << fEmName << G4endl;
+}
+
+void PhysicsList::EnableHadronicPhysics() {
+
+  if (fHadronic) return;
+
+  // Mêmes constructeurs que FTFP_BERT (hors EM) : sert de référence pour
+  // vérifier que la liste réduite donne les mêmes doses
+  RegisterPhysics(new G4EmExtraPhysics());
+  RegisterPhysics(new G4DecayPhysics());
+  RegisterPhysics(new G4HadronElasticPhysics());
+  RegisterPhysics(new G4HadronPhysicsFTFP_BERT());
+  RegisterPhysics(new G4StoppingPhysics());
+  RegisterPhysics(new G4IonPhysics());
+  RegisterPhysics(new G4NeutronTrackingCut());
+  fHadronic = true;
+
+  G4cout << "PhysicsList : constructeurs hadroniques FTFP_BERT ajoutes (reference)" << G4endl;
+}
+
+void PhysicsList::EnableForcedCollision() {
+
+  if (fBiasingPhysics) return;
+
+  // Enveloppe les processus gamma par G4BiasingProcessInterface : les
+  // opérateurs G4BOptrForceCollision sont attachés aux anneaux dans
+  // DetectorConstruction::ConstructSDandField()
+  fBiasingPhysics = new G4GenericBiasingPhysics();
+  fBiasingPhysics->PhysicsBias("gamma");
+  RegisterPhysics(fBiasingPhysics);
+
+  G4cout << "\n========== BIAISAGE ==========\n"
+  << "G4GenericBiasingPhysics : gamma\n"
+  << "Collision forcee dans les anneaux d'eau\n"
+  << "==============================\n" << G4endl;
+}
+
+void PhysicsList::EnableFastSimulation() {
+
+  if (fFastSimulationPhysics) return;
+
+  // Processus G4FastSimulationManagerProcess pour les gammas : le modèle
+  // AttenuatorFastModel est attaché à la région de la plaque dans
+  // DetectorConstruction::ConstructSDandField()
+  fFastSimulationPhysics = new G4FastSimulationPhysics();
+  fFastSimulationPhysics->ActivateFastSimulation("gamma");
+  RegisterPhysics(fFastSimulationPhysics);
+
+  G4cout << "PhysicsList : simulation rapide activee pour les gammas (attenuateur)" << G4endl;
+}
+
 void PhysicsList::SetCuts() {
-  
+
   // Cuts de production (distances minimales)
   SetCutValue(0.1*mm, "gamma");
   SetCutValue(0.1*mm, "e-");
   SetCutValue(0.1*mm, "e+");
   SetCutValue(0.1*mm, "proton");
-  
+
   // ALTERNATIVE : Cuts encore plus fins pour précision maximale (mais plus lent)
   // Décommenter les lignes suivantes pour des cuts de 0.01 mm
   // SetCutValue(0.01*mm, "gamma");
@@ -48,7 +148,7 @@ void PhysicsList::SetCuts() {
   // SetCutValue(0.01*mm, "proton");
 
   if (verboseLevel > 0) {
-    G4cout << "\n========== CUTS DE PRODUCTION ==========\n"
+    Logger::GetInstance()->Banner() << "\n========== CUTS DE PRODUCTION ==========\n"
            << "Gamma : 0.1 mm\n"
            << "e-    : 0.1 mm\n"
            << "e+    : 0.1 mm\n"
@@ -0,0 +1,79 @@
+#include "PlaneSD.hh"
+#include "EventAction.hh"
+#include "Logger.hh"
+#include "AllocationCounter.hh"
+#include "ProfilingTimers.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4StepPoint.hh"
+#include "G4Gamma.hh"
+#include "G4Electron.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4SDParticleFilter.hh"
+#include "G4SystemOfUnits.hh"
+#include <sstream>
+
+PlaneSD::PlaneSD(const G4String& name, Plane plane)
+: G4VSensitiveDetector(name),
+  fPlane(plane),
+  fEventAction(nullptr),
+  fVerbose(true),
+  fVerboseMaxEvents(10)
+{
+    auto filter = new G4SDParticleFilter(name + "_filter");
+    filter->add("gamma");
+    filter->add("e-");
+    SetFilter(filter);
+}
+
+G4String PlaneSD::GetTallyName(G4int tallyIndex)
+{
+    G4int direction = tallyIndex % kNbDirections;
+    G4int particle = (tallyIndex / kNbDirections) % kNbParticles;
+    G4int plane = tallyIndex / (kNbDirections * kNbParticles);
+    
+    G4String name = (plane == kPreContainer) ? "pre" : "post";
+    name += (particle == kPhoton) ? "_photon" : "_electron";
+    name += (direction == kForward) ? "_fwd" : "_back";
+    return name;
+}
+
+void PlaneSD::Initialize(G4HCofThisEvent*)
+{
+    fEventAction = static_cast<EventAction*>(G4EventManager::GetEventManager()->GetUserEventAction());
+    fVerbose = !Logger::GetInstance()->IsQuiet();
+}
+
+G4bool PlaneSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+    PUITS_ALLOCATION_SCOPE(kHits);
+    PUITS_PROFILE_SCOPE(kSensitiveDetector);
+    
+    // Traversée de la face d'entrée uniquement (premier pas dans le plan)
+    G4StepPoint* preStepPoint = step->GetPreStepPoint();
+    if (preStepPoint->GetStepStatus() != fGeomBoundary) return false;
+    
+    G4Track* track = step->GetTrack();
+    G4int particle = (track->GetDefinition() == G4Gamma::Definition()) ? kPhoton : kElectron;
+    G4int direction = (preStepPoint->GetMomentumDirection().z() > 0.) ? kForward : kBackward;
+    G4double energy = preStepPoint->GetKineticEnergy();
+    G4int tallyIndex = GetTallyIndex(fPlane, particle, direction);
+    
+    fEventAction->AddPlaneCrossing(tallyIndex, energy, track->GetWeight());
+    
+    if (!fVerbose) return true;
+    G4int eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+    if (eventID < fVerboseMaxEvents) {
+        std::stringstream ss;
+        ss << "PLANE_CROSSING | Event " << eventID
+           << " | " << GetTallyName(tallyIndex)
+           << " | trackID=" << track->GetTrackID()
+           << " | E=" << energy/keV << " keV"
+           << " | z=" << preStepPoint->GetPosition().z()/mm << " mm";
+        Logger::GetInstance()->LogLine(ss.str());
+    }
+    
+    return true;
+}
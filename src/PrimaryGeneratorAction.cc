@@ -1,7 +1,22 @@
 #include "PrimaryGeneratorAction.hh"
+#include "Eu152Data.hh"
+#include "EmissionCone.hh"
+#include "ResponseMatrix.hh"
+#include "CascadeLibrary.hh"
+#include "SourceScan.hh"
+#include "StratifiedSampler.hh"
+#include "QmcSampling.hh"
+#include "CorrelatedSampling.hh"
+#include "SobolSequence.hh"
+#include "Logger.hh"
+#include "AllocationCounter.hh"
+#include "ProfilingTimers.hh"
 
 #include "G4ParticleGun.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4Run.hh"
+#include "G4RunManager.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4SystemOfUnits.hh"
@@ -11,9 +26,14 @@
 PrimaryGeneratorAction::PrimaryGeneratorAction()
 : G4VUserPrimaryGeneratorAction(),
   fParticleGun(nullptr),
+  fSampler(nullptr),
+  fSobol(nullptr),
+  fSobolRunID(-1),
   fLastEventGammaCount(0),
-  fConeAngle(45.*deg),
-  fSourcePosition(0., 0., 75.0*mm)  // Source à z = 75 mm (25 mm avant surface eau à z=100 mm)
+  fLastEventLine(-1),
+  fLastEventWeight(1.),
+  fLastEventDecays(1),
+  fLastEventPosition(-1)
 {
     // Créer le particle gun
     fParticleGun = new G4ParticleGun(1);
@@ -22,7 +42,6 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
     G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
     G4ParticleDefinition* particle = particleTable->FindParticle("gamma");
     fParticleGun->SetParticleDefinition(particle);
-    fParticleGun->SetParticlePosition(fSourcePosition);
     
     // ═══════════════════════════════════════════════════════════════
     // SPECTRE GAMMA EUROPIUM-152
@@ -30,38 +49,11 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
     // Source: NNDC/ENSDF - principales raies gamma
     // Énergies en keV, intensités en % par désintégration
     
-    // Raies principales (intensité > 2%) + raies X
-    fGammaEnergies = {
-        39.52,    // Intensité: 20.8% (raie X)
-        40.12,    // Intensité: 37.7% (raie X)
-        121.78,   // Intensité: 28.41%
-        244.70,   // Intensité: 7.53%
-        344.28,   // Intensité: 26.59%
-        411.12,   // Intensité: 2.24%
-        443.97,   // Intensité: 2.83%
-        778.90,   // Intensité: 12.97%
-        867.38,   // Intensité: 4.24%
-        964.08,   // Intensité: 14.63%
-        1085.87,  // Intensité: 10.21%
-        1112.07,  // Intensité: 13.64%
-        1408.01   // Intensité: 21.01%
-    };
-    
-    fGammaIntensities = {
-        20.8,
-        37.7,
-        28.41,
-        7.53,
-        26.59,
-        2.24,
-        2.83,
-        12.97,
-        4.24,
-        14.63,
-        10.21,
-        13.64,
-        21.01
-    };
+    // Raies principales (intensité > 2%) + raies X : table partagée Eu152Data.hh
+    fGammaEnergies.assign(Eu152::kLineEnergies_keV,
+                          Eu152::kLineEnergies_keV + Eu152::kNbLines);
+    fGammaIntensities.assign(Eu152::kLineIntensities_pct,
+                             Eu152::kLineIntensities_pct + Eu152::kNbLines);
     
     // Calculer les probabilités d'émission (normalisées pour le sampling)
     // Note: la somme des intensités est ~144.3%, donc en moyenne 1.443 gamma/désintégration
@@ -78,24 +70,135 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
         fGammaProbabilities[i] = fGammaIntensities[i] / 100.;
     }
     
-    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║  PrimaryGeneratorAction: Spectre Eu-152 initialisé            ║" << G4endl;
-    G4cout << "║  " << fGammaEnergies.size() << " raies gamma principales                                   ║" << G4endl;
-    G4cout << "║  Intensité totale: " << totalIntensity << "%                                   ║" << G4endl;
-    G4cout << "║  Gammas moyens/désintégration: ~" << totalIntensity/100. << "                         ║" << G4endl;
-    G4cout << "║  Angle du cône: " << fConeAngle/deg << " degrés                                    ║" << G4endl;
-    G4cout << "║  *** POSITION SOURCE: z = " << fSourcePosition.z()/mm << " mm (25 mm avant eau) ***  ║" << G4endl;
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    // Allocation stratifiée optionnelle (/puits/strat/enable)
+    fSampler = new StratifiedSampler(fGammaProbabilities);
+    
+    // Suite quasi-aléatoire optionnelle de la source (/puits/qmc/enable)
+    fSobol = new SobolSequence();
+    
+    std::ostream& banner = Logger::GetInstance()->Banner();
+    banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║  PrimaryGeneratorAction: Spectre Eu-152 initialisé            ║" << G4endl;
+    banner << "║  " << fGammaEnergies.size() << " raies gamma principales                                   ║" << G4endl;
+    banner << "║  Intensité totale: " << totalIntensity << "%                                   ║" << G4endl;
+    banner << "║  Gammas moyens/désintégration: ~" << totalIntensity/100. << "                         ║" << G4endl;
+    banner << "║  Cône d'émission : /puits/source/coneMode (defaut : fixed 45°) ║" << G4endl;
+    banner << "║  Position source : fournie par DetectorConstruction          ║" << G4endl;
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
 }
 
 PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
+    delete fSobol;
+    delete fSampler;
     delete fParticleGun;
 }
 
+G4double PrimaryGeneratorAction::GetConeAngle() const
+{
+    return EmissionCone::GetInstance()->GetHalfAngle();
+}
+
+G4bool PrimaryGeneratorAction::NextSourcePoint(std::array<G4double, SobolSequence::kNbDimensions>& u)
+{
+    if (!QmcSampling::GetInstance()->IsEnabled()) return false;
+    
+    // Nouveau brouillage à chaque run : chaque run est une réplique indépendante
+    G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+    if (runID != fSobolRunID) {
+        fSobol->Rescramble();
+        fSobolRunID = runID;
+    }
+    fSobol->Next(u);
+    return true;
+}
+
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
+    PUITS_PROFILE_BEGIN_EVENT();
+    PUITS_PROFILE_SCOPE(kGeneratePrimaries);
+    PUITS_ALLOCATION_SCOPE(kEvent);
+    
+    // Échantillonnage corrélé : flux aléatoire fixé par le seul numéro
+    // d'événement (mêmes primaires pour toutes les variantes de géométrie)
+    const CorrelatedSampling* correlated = CorrelatedSampling::GetInstance();
+    if (correlated->IsEnabled()) {
+        correlated->SeedEvent(anEvent->GetEventID());
+    }
+    
     fLastEventGammaCount = 0;
+    fLastEventLine = -1;
+    fLastEventWeight = 1.;
+    fLastEventDecays = 1;
+    fLastEventPosition = -1;
+    
+    // Cône et position source partagés (géométrie courante)
+    const EmissionCone* cone = EmissionCone::GetInstance();
+    G4ThreeVector sourcePosition = cone->GetSourcePosition();
+    G4double halfAngle = cone->GetHalfAngle();
+    
+    // Balayage : position de l'événement (cyclique) et son propre cône
+    const SourceScan* scan = SourceScan::GetInstance();
+    if (scan->IsEnabled()) {
+        fLastEventPosition = scan->GetPositionIndex(anEvent->GetEventID());
+        sourcePosition = scan->GetSourcePosition(fLastEventPosition);
+        halfAngle = scan->GetHalfAngle(fLastEventPosition);
+    }
+    
+    // Point de la suite de Sobol (option QMC) et angles tirés
+    std::array<G4double, SobolSequence::kNbDimensions> u;
+    G4double theta, phi;
+    
+    // ═══════════════════════════════════════════════════════════════
+    // MODE MATRICE DE RÉPONSE : un photon monoénergétique par événement
+    // ═══════════════════════════════════════════════════════════════
+    const ResponseMatrix* response = ResponseMatrix::GetInstance();
+    if (response->IsEnabled()) {
+        G4ThreeVector direction = NextSourcePoint(u)
+            ? cone->SampleDirection(halfAngle, u[SobolSequence::kCosTheta], u[SobolSequence::kPhi], theta, phi)
+            : cone->SampleDirection(halfAngle, theta, phi);
+        
+        fParticleGun->SetParticleEnergy(response->GetEnergy());
+        fParticleGun->SetParticleMomentumDirection(direction);
+        fParticleGun->SetParticlePosition(sourcePosition);
+        fParticleGun->GeneratePrimaryVertex(anEvent);
+        
+        fLastEventGammaCount = 1;
+        return;
+    }
+    
+    // ═══════════════════════════════════════════════════════════════
+    // MODE CASCADES : une désintégration de la bibliothèque précalculée
+    // ═══════════════════════════════════════════════════════════════
+    if (CascadeLibrary::GetInstance()->IsEnabled()) {
+        GenerateCascade(anEvent, sourcePosition, halfAngle);
+        return;
+    }
+    
+    // ═══════════════════════════════════════════════════════════════
+    // MODE STRATIFIÉ : une raie tirée selon l'allocation, poids p/q
+    // ═══════════════════════════════════════════════════════════════
+    if (fSampler->IsEnabled()) {
+        G4ThreeVector direction;
+        if (NextSourcePoint(u)) {
+            fLastEventLine = fSampler->SampleLine(u[SobolSequence::kLine], fLastEventWeight);
+            direction = cone->SampleDirection(halfAngle, u[SobolSequence::kCosTheta], u[SobolSequence::kPhi], theta, phi);
+        } else {
+            fLastEventLine = fSampler->SampleLine(fLastEventWeight);
+            direction = cone->SampleDirection(halfAngle, theta, phi);
+        }
+        
+        fParticleGun->SetParticleEnergy(fGammaEnergies[fLastEventLine] * keV);
+        fParticleGun->SetParticleMomentumDirection(direction);
+        fParticleGun->SetParticlePosition(sourcePosition);
+        fParticleGun->GeneratePrimaryVertex(anEvent);
+        
+        // Le poids du vertex est transmis à la trace primaire puis aux secondaires
+        anEvent->GetPrimaryVertex(anEvent->GetNumberOfPrimaryVertex() - 1)->SetWeight(fLastEventWeight);
+        
+        fLastEventGammaCount = 1;
+        return;
+    }
     
     // Pour chaque raie gamma, tirer si elle est émise
     for (size_t i = 0; i < fGammaEnergies.size(); ++i) {
@@ -107,15 +210,16 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
             // Énergie de la raie
             G4double energy = fGammaEnergies[i] * keV;
             
-            // Générer une direction dans le cône
-            G4double theta, phi;
-            G4ThreeVector direction;
-            GenerateDirectionInCone(fConeAngle, theta, phi, direction);
+            // Générer une direction dans le cône (un point de la suite par
+            // photon en QMC ; les émissions restent pseudo-aléatoires)
+            G4ThreeVector direction = NextSourcePoint(u)
+                ? cone->SampleDirection(halfAngle, u[SobolSequence::kCosTheta], u[SobolSequence::kPhi], theta, phi)
+                : cone->SampleDirection(halfAngle, theta, phi);
             
             // Configurer et tirer
             fParticleGun->SetParticleEnergy(energy);
             fParticleGun->SetParticleMomentumDirection(direction);
-            fParticleGun->SetParticlePosition(fSourcePosition);
+            fParticleGun->SetParticlePosition(sourcePosition);
             fParticleGun->GeneratePrimaryVertex(anEvent);
             
             fLastEventGammaCount++;
@@ -127,22 +231,44 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
     // émettre de gamma dans le cône d'émission
 }
 
-void PrimaryGeneratorAction::GenerateDirectionInCone(G4double coneAngle,
-                                                     G4double& theta,
-                                                     G4double& phi,
-                                                     G4ThreeVector& direction)
+void PrimaryGeneratorAction::GenerateCascade(G4Event* anEvent, const G4ThreeVector& sourcePosition,
+                                             G4double halfAngle)
 {
-    // Distribution uniforme sur la surface de la calotte sphérique
-    // cos(theta) est uniforme entre cos(coneAngle) et 1
-    G4double cosTheta = 1. - G4UniformRand() * (1. - std::cos(coneAngle));
-    theta = std::acos(cosTheta);
-    
-    // phi est uniforme entre 0 et 2π
-    phi = G4UniformRand() * 2. * CLHEP::pi;
-    
-    // Calculer la direction
-    G4double sinTheta = std::sin(theta);
-    direction.set(sinTheta * std::cos(phi),
-                  sinTheta * std::sin(phi),
-                  cosTheta);
+    const CascadeLibrary* cascades = CascadeLibrary::GetInstance();
+    const G4double cosCone = cascades->IsConeOnly() ? std::cos(halfAngle) : -1.;
+    
+    // Désintégrations tirées jusqu'à la première qui émet dans le cône : les
+    // autres ne déposent rien, elles ne comptent que dans la normalisation
+    const G4long kMaxDecays = 1000000;
+    fLastEventDecays = 0;
+    while (fLastEventDecays < kMaxDecays) {
+        ++fLastEventDecays;
+        
+        G4int count = 0;
+        const CascadeLibrary::Particle* decay = cascades->SampleDecay(count);
+        
+        // Cascade tournée en bloc : corrélations angulaires conservées
+        G4ThreeVector e1, e2, e3;
+        CascadeLibrary::SampleRotation(e1, e2, e3);
+        
+        G4int emitted = 0;
+        for (G4int i = 0; i < count; ++i) {
+            const CascadeLibrary::Particle& p = decay[i];
+            G4ThreeVector direction = p.dirX * e1 + p.dirY * e2 + p.dirZ * e3;
+            if (direction.z() < cosCone) continue;
+            
+            fParticleGun->SetParticleDefinition(CascadeLibrary::GetDefinition(p.species));
+            fParticleGun->SetParticleEnergy(p.energy_keV * keV);
+            fParticleGun->SetParticleMomentumDirection(direction);
+            fParticleGun->SetParticlePosition(sourcePosition);
+            fParticleGun->GeneratePrimaryVertex(anEvent);
+            
+            if (p.species == CascadeLibrary::kGamma) fLastEventGammaCount++;
+            ++emitted;
+        }
+        if (emitted > 0) break;
+    }
+    
+    // Les autres modes émettent des gammas
+    fParticleGun->SetParticleDefinition(CascadeLibrary::GetDefinition(CascadeLibrary::kGamma));
 }
@@ -0,0 +1,445 @@
+#include "ProfilingTimers.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4ios.hh"
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PUITS_PROFILING_TSC 1
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+ProfilingTimers* ProfilingTimers::fInstance = nullptr;
+G4double ProfilingTimers::fNsPerTick = 1.;
+
+namespace {
+
+const G4int kMaxDepth = 16;
+
+struct Frame
+{
+    G4int section;
+    std::uint64_t start;
+    std::uint64_t child;                // temps inclusif des portées filles
+    std::uint64_t hardwareStart[ProfilingTimers::kNbHardwareCounters];
+    std::uint64_t hardwareChild[ProfilingTimers::kNbHardwareCounters];
+};
+
+// Compteurs du thread courant : type trivial, initialisé statiquement
+struct ThreadProfile
+{
+    G4int depth;
+    G4bool closeEvent;                  // fermer la portée transport au retour à la profondeur 1
+    G4int hardwareFd;                   // leader du groupe perf (-1 : aucun)
+    G4bool hardwareOpened;
+    G4bool hardwareActive;              // lecture à chaque portée (/puits/profile/hardware)
+    Frame frames[kMaxDepth];
+    G4long calls[ProfilingTimers::kNbSections];
+    std::uint64_t inclusive[ProfilingTimers::kNbSections];
+    std::uint64_t self[ProfilingTimers::kNbSections];
+    G4long histogram[ProfilingTimers::kNbSections][ProfilingTimers::kNbHistogramBins];
+    std::uint64_t hardware[ProfilingTimers::kNbSections][ProfilingTimers::kNbHardwareCounters];
+};
+
+G4ThreadLocal ThreadProfile tProfile = {};
+
+const char* kSectionNames[ProfilingTimers::kNbSections] = {
+    "Transport Geant4 (hors actions)",
+    "GeneratePrimaries",
+    "BeginOfEventAction",
+    "EndOfEventAction",
+    "UserSteppingAction",
+    "PlaneSD::ProcessHits",
+    "Remplissage histogrammes",
+    "Remplissage ntuples",
+    "Statistiques de dose"
+};
+
+const char* kSectionKeys[ProfilingTimers::kNbSections] = {
+    "geant4_transport",
+    "generate_primaries",
+    "begin_of_event",
+    "end_of_event",
+    "stepping",
+    "plane_sd",
+    "histogram_fill",
+    "ntuple_fill",
+    "dose_statistics"
+};
+
+const char* kHardwareKeys[ProfilingTimers::kNbHardwareCounters] = {
+    "cycles", "instructions", "cache_misses"
+};
+
+#ifdef PUITS_PROFILING
+inline std::uint64_t ReadClock()
+{
+#ifdef PUITS_PROFILING_TSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline G4int HistogramBin(G4double ns)
+{
+    G4int bin = 0;
+    std::uint64_t n = static_cast<std::uint64_t>(ns);
+    while (n > 0 && bin < ProfilingTimers::kNbHistogramBins - 1) {
+        n >>= 1;
+        ++bin;
+    }
+    return bin;
+}
+
+// ─────────────────────────────────────────────────────────────
+// Compteurs matériels (perf_event_open, groupe lu d'un seul read)
+// ─────────────────────────────────────────────────────────────
+
+void OpenHardwareCounters(ThreadProfile& profile)
+{
+    profile.hardwareOpened = true;
+    profile.hardwareFd = -1;
+#if defined(__linux__)
+    const std::uint64_t configs[ProfilingTimers::kNbHardwareCounters] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES
+    };
+    G4int leader = -1;
+    for (G4int c = 0; c < ProfilingTimers::kNbHardwareCounters; ++c) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[c];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.disabled = (leader < 0) ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // pid 0, cpu -1 : le thread appelant, sur tous les CPU
+        G4int fd = static_cast<G4int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+        if (fd < 0) {
+            if (leader >= 0) close(leader);
+            G4ExceptionDescription description;
+            description << "perf_event_open indisponible (" << std::strerror(errno)
+                        << ") : compteurs materiels desactives sur ce thread"
+                        << " (voir /proc/sys/kernel/perf_event_paranoid)";
+            G4Exception("ProfilingTimers", "Prof001", JustWarning, description);
+            return;
+        }
+        if (leader < 0) leader = fd;
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    profile.hardwareFd = leader;
+#else
+    G4Exception("ProfilingTimers", "Prof001", JustWarning,
+                "Compteurs materiels disponibles sous Linux seulement");
+#endif
+}
+
+inline void ReadHardwareCounters(const ThreadProfile& profile, std::uint64_t* values)
+{
+#if defined(__linux__)
+    std::uint64_t buffer[1 + ProfilingTimers::kNbHardwareCounters];
+    if (read(profile.hardwareFd, buffer, sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer))) {
+        for (G4int c = 0; c < ProfilingTimers::kNbHardwareCounters; ++c) values[c] = buffer[1 + c];
+        return;
+    }
+#endif
+    (void)profile;
+    for (G4int c = 0; c < ProfilingTimers::kNbHardwareCounters; ++c) values[c] = 0;
+}
+#endif
+
+}
+
+// ═══════════════════════════════════════════════════════════════
+// SINGLETON ET COMMANDES (/puits/profile/)
+// ═══════════════════════════════════════════════════════════════
+
+ProfilingTimers::ProfilingTimers()
+: fHardware(false),
+  fMessenger(nullptr)
+{
+#if defined(PUITS_PROFILING) && defined(PUITS_PROFILING_TSC)
+    // Étalonnage du TSC sur ~20 ms (fréquence invariante sur les CPU récents)
+    auto wall0 = std::chrono::steady_clock::now();
+    std::uint64_t tick0 = ReadClock();
+    std::chrono::steady_clock::time_point wall1;
+    do {
+        wall1 = std::chrono::steady_clock::now();
+    } while (wall1 - wall0 < std::chrono::milliseconds(20));
+    std::uint64_t tick1 = ReadClock();
+    G4double ns = std::chrono::duration<G4double, std::nano>(wall1 - wall0).count();
+    if (tick1 > tick0) fNsPerTick = ns / static_cast<G4double>(tick1 - tick0);
+#endif
+    DefineCommands();
+}
+
+ProfilingTimers::~ProfilingTimers()
+{
+    delete fMessenger;
+}
+
+ProfilingTimers* ProfilingTimers::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de RunAction)
+    if (fInstance == nullptr) {
+        fInstance = new ProfilingTimers();
+    }
+    return fInstance;
+}
+
+void ProfilingTimers::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/profile/",
+        "Minuteries des actions utilisateur (option PUITS_PROFILING)");
+
+    auto& hardwareCmd = fMessenger->DeclareProperty("hardware", fHardware,
+        "Lit cycles, instructions et defauts de cache par section (perf_event_open)");
+    hardwareCmd.SetParameterName("enable", true);
+    hardwareCmd.SetDefaultValue("true");
+    hardwareCmd.SetStates(G4State_PreInit, G4State_Idle);
+    hardwareCmd.SetToBeBroadcasted(false);   // singleton du processus
+}
+
+G4bool ProfilingTimers::IsCompiled()
+{
+#ifdef PUITS_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════
+// PORTÉES (thread courant, sans verrou)
+// ═══════════════════════════════════════════════════════════════
+
+void ProfilingTimers::Enter(Section section)
+{
+#ifdef PUITS_PROFILING
+    ThreadProfile& profile = tProfile;
+    if (profile.depth >= kMaxDepth) {
+        profile.depth++;               // trop profond : compté seulement pour l'équilibre
+        return;
+    }
+    Frame& frame = profile.frames[profile.depth++];
+    frame.section = section;
+    frame.child = 0;
+    if (profile.hardwareActive) {
+        ReadHardwareCounters(profile, frame.hardwareStart);
+        for (G4int c = 0; c < kNbHardwareCounters; ++c) frame.hardwareChild[c] = 0;
+    }
+    frame.start = ReadClock();
+#else
+    (void)section;
+#endif
+}
+
+void ProfilingTimers::Leave()
+{
+#ifdef PUITS_PROFILING
+    const std::uint64_t now = ReadClock();
+    ThreadProfile& profile = tProfile;
+    if (profile.depth == 0) return;
+    if (profile.depth > kMaxDepth) {
+        profile.depth--;
+        return;
+    }
+
+    Frame& frame = profile.frames[--profile.depth];
+    const G4int s = frame.section;
+    const std::uint64_t elapsed = now - frame.start;
+    const std::uint64_t self = (elapsed > frame.child) ? elapsed - frame.child : 0;
+    profile.calls[s]++;
+    profile.inclusive[s] += elapsed;
+    profile.self[s] += self;
+    profile.histogram[s][HistogramBin(self * fNsPerTick)]++;
+    if (profile.depth > 0) profile.frames[profile.depth - 1].child += elapsed;
+
+    if (profile.hardwareActive) {
+        std::uint64_t values[kNbHardwareCounters];
+        ReadHardwareCounters(profile, values);
+        for (G4int c = 0; c < kNbHardwareCounters; ++c) {
+            std::uint64_t total = values[c] - frame.hardwareStart[c];
+            profile.hardware[s][c] += (total > frame.hardwareChild[c]) ? total - frame.hardwareChild[c] : 0;
+            if (profile.depth > 0) profile.frames[profile.depth - 1].hardwareChild[c] += total;
+        }
+    }
+
+    // Fin d'événement demandée : la portée transport se ferme avec la dernière action
+    if (profile.closeEvent && profile.depth == 1) {
+        profile.closeEvent = false;
+        Leave();
+    }
+#endif
+}
+
+void ProfilingTimers::BeginEvent()
+{
+#ifdef PUITS_PROFILING
+    ThreadProfile& profile = tProfile;
+    profile.depth = 0;                 // événement précédent interrompu : portées abandonnées
+    profile.closeEvent = false;
+
+    // Compteurs matériels ouverts au premier événement du thread
+    if (fInstance->fHardware && !profile.hardwareOpened) {
+        OpenHardwareCounters(profile);
+    }
+    // Désactivés entre deux runs : le groupe reste ouvert mais n'est plus lu
+    profile.hardwareActive = fInstance->fHardware && profile.hardwareFd > 0;
+    Enter(kTransport);
+#endif
+}
+
+void ProfilingTimers::EndOfEvent()
+{
+#ifdef PUITS_PROFILING
+    ThreadProfile& profile = tProfile;
+    if (profile.depth > 0 && profile.frames[0].section == kTransport) {
+        if (profile.depth == 1) Leave();
+        else profile.closeEvent = true;
+    }
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════
+// FUSION, RAPPORT ET JSON
+// ═══════════════════════════════════════════════════════════════
+
+void ProfilingTimers::FlushThread()
+{
+    ThreadProfile& profile = tProfile;
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        for (G4int s = 0; s < kNbSections; ++s) {
+            fTotals.calls[s] += profile.calls[s];
+            fTotals.inclusiveNs[s] += profile.inclusive[s] * fNsPerTick;
+            fTotals.selfNs[s] += profile.self[s] * fNsPerTick;
+            for (G4int b = 0; b < kNbHistogramBins; ++b) {
+                fTotals.histogram[s][b] += profile.histogram[s][b];
+            }
+            for (G4int c = 0; c < kNbHardwareCounters; ++c) {
+                fTotals.hardware[s][c] += static_cast<G4double>(profile.hardware[s][c]);
+            }
+        }
+        if (profile.hardwareActive) fTotals.hardwareValid = true;
+    }
+
+    // Les compteurs matériels restent ouverts pour les runs suivants
+    std::memset(profile.calls, 0, sizeof(profile.calls));
+    std::memset(profile.inclusive, 0, sizeof(profile.inclusive));
+    std::memset(profile.self, 0, sizeof(profile.self));
+    std::memset(profile.histogram, 0, sizeof(profile.histogram));
+    std::memset(profile.hardware, 0, sizeof(profile.hardware));
+}
+
+G4double ProfilingTimers::Quantile(const std::array<G4long, kNbHistogramBins>& histogram, G4double q)
+{
+    G4long total = 0;
+    for (G4long n : histogram) total += n;
+    if (total == 0) return 0.;
+
+    G4long cumulative = 0;
+    for (G4int b = 0; b < kNbHistogramBins; ++b) {
+        cumulative += histogram[b];
+        if (cumulative >= q * total) return (b == 0) ? 1. : static_cast<G4double>(1ull << b);
+    }
+    return static_cast<G4double>(1ull << (kNbHistogramBins - 1));
+}
+
+void ProfilingTimers::Report(std::ostream& os)
+{
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fLastRun = fTotals;
+        fTotals = Totals();
+    }
+
+    if (!IsCompiled()) return;
+
+    const Totals& totals = fLastRun;
+    const G4double eventNs = totals.inclusiveNs[kTransport];
+
+    os << "\n╔══════════════════════════════════════════════════════════════════════════════════════════════════════╗\n";
+    os << "║                    TEMPS DES ACTIONS UTILISATEUR (PUITS_PROFILING, somme des threads)                ║\n";
+    os << "╠══════════════════════════════════════════════════════════════════════════════════════════════════════╣\n";
+    os << "║  Événements : " << totals.calls[kTransport] << "   Temps total des événements : "
+       << std::fixed << std::setprecision(3) << eventNs * 1e-9 << " s\n";
+    os << "╠═════════════════════════════════╦═════════════╦═══════════╦═══════════╦════════╦═══════════╦═════════╣\n";
+    os << "║ Section                         ║   Appels    ║ Incl. (s) ║ Propre (s)║ % evt  ║ ns/appel  ║ p99 (ns)║\n";
+    os << "╠═════════════════════════════════╬═════════════╬═══════════╬═══════════╬════════╬═══════════╬═════════╣\n";
+    for (G4int s = 0; s < kNbSections; ++s) {
+        if (totals.calls[s] == 0) continue;
+        os << "║ " << std::left << std::setw(31) << kSectionNames[s] << std::right << " ║"
+           << std::setw(12) << totals.calls[s] << " ║"
+           << std::setw(10) << std::setprecision(3) << totals.inclusiveNs[s] * 1e-9 << " ║"
+           << std::setw(10) << totals.selfNs[s] * 1e-9 << " ║"
+           << std::setw(7) << std::setprecision(2)
+           << ((eventNs > 0.) ? 100. * totals.selfNs[s] / eventNs : 0.) << " ║"
+           << std::setw(10) << std::setprecision(1) << totals.selfNs[s] / totals.calls[s] << " ║"
+           << std::setw(8) << std::setprecision(0) << Quantile(totals.histogram[s], 0.99) << " ║\n";
+    }
+    os << "╚═════════════════════════════════╩═════════════╩═══════════╩═══════════╩════════╩═══════════╩═════════╝\n";
+
+    if (totals.hardwareValid) {
+        os << "  Compteurs matériels (temps propre, par appel) :\n";
+        for (G4int s = 0; s < kNbSections; ++s) {
+            if (totals.calls[s] == 0) continue;
+            const auto& hw = totals.hardware[s];
+            os << "    " << std::left << std::setw(31) << kSectionNames[s] << std::right
+               << std::setprecision(1)
+               << "  cycles " << std::setw(10) << hw[0] / totals.calls[s]
+               << "  IPC " << std::setw(5) << std::setprecision(2) << ((hw[0] > 0.) ? hw[1] / hw[0] : 0.)
+               << "  défauts de cache " << std::setw(8) << hw[2] / totals.calls[s] << "\n";
+        }
+    }
+    os << "  Temps propre : portées imbriquées déduites ; transport = événement moins actions\n";
+    os << std::defaultfloat << std::setprecision(6);
+}
+
+void ProfilingTimers::WriteJson(std::ostream& os) const
+{
+    const Totals& totals = fLastRun;
+    os << "  \"profiling\": {\"clock\": "
+#ifdef PUITS_PROFILING_TSC
+       << "\"tsc\""
+#else
+       << "\"steady_clock\""
+#endif
+       << ", \"ns_per_tick\": " << fNsPerTick
+       << ", \"hardware\": " << (totals.hardwareValid ? "true" : "false")
+       << ", \"sections\": {";
+    for (G4int s = 0; s < kNbSections; ++s) {
+        os << (s ? ",\n" : "\n") << "    \"" << kSectionKeys[s] << "\": {\"calls\": " << totals.calls[s]
+           << ", \"inclusive_s\": " << totals.inclusiveNs[s] * 1e-9
+           << ", \"self_s\": " << totals.selfNs[s] * 1e-9
+           << ", \"p50_ns\": " << Quantile(totals.histogram[s], 0.50)
+           << ", \"p99_ns\": " << Quantile(totals.histogram[s], 0.99)
+           << ", \"histogram_log2_ns\": [";
+        for (G4int b = 0; b < kNbHistogramBins; ++b) {
+            os << (b ? ", " : "") << totals.histogram[s][b];
+        }
+        os << "]";
+        if (totals.hardwareValid) {
+            for (G4int c = 0; c < kNbHardwareCounters; ++c) {
+                os << ", \"" << kHardwareKeys[c] << "\": " << totals.hardware[s][c];
+            }
+        }
+        os << "}";
+    }
+    os << "\n  }}";
+}
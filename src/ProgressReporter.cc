@@ -0,0 +1,264 @@
+#include "ProgressReporter.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+ProgressReporter* ProgressReporter::fInstance = nullptr;
+
+ProgressReporter::ProgressReporter()
+: fStopRequested(false),
+  fRunID(0),
+  fEventsToProcess(0),
+  fLastEvents(0),
+  fInterval(0.),
+  fHeartbeatFileName(""),
+  fMessenger(nullptr)
+{
+    DefineCommands();
+}
+
+ProgressReporter::~ProgressReporter()
+{
+    Stop();
+    delete fMessenger;
+}
+
+ProgressReporter* ProgressReporter::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de RunAction)
+    if (fInstance == nullptr) {
+        fInstance = new ProgressReporter();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/progress/)
+// ═══════════════════════════════════════════════════════════════
+
+void ProgressReporter::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/progress/",
+                                        "Rapport d'avancement periodique");
+
+    auto& intervalCmd = fMessenger->DeclarePropertyWithUnit("interval", "s", fInterval,
+        "Periode du rapport d'avancement (0 = desactive)");
+    intervalCmd.SetParameterName("period", false);
+    intervalCmd.SetRange("period>=0.");
+    intervalCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+    auto& fileCmd = fMessenger->DeclareProperty("heartbeatFile", fHeartbeatFileName,
+        "Fichier JSON-lines recevant chaque rapport (vide = aucun)");
+    fileCmd.SetParameterName("fileName", true);
+    fileCmd.SetDefaultValue("");
+    fileCmd.SetStates(G4State_PreInit, G4State_Idle);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// PUBLICATION DEPUIS LA BOUCLE D'ÉVÉNEMENTS
+// ═══════════════════════════════════════════════════════════════
+
+G4int ProgressReporter::RegisterSlot()
+{
+    std::lock_guard<std::mutex> lock(fSlotsMutex);
+    fSlots.push_back(std::make_unique<Slot>());
+    return static_cast<G4int>(fSlots.size()) - 1;
+}
+
+void ProgressReporter::Publish(G4int slotIndex, const RingDoseStatistics& stats)
+{
+    Slot* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(fSlotsMutex);
+        if (slotIndex < 0 || slotIndex >= static_cast<G4int>(fSlots.size())) return;
+        slot = fSlots[slotIndex].get();
+    }
+
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    if (slot->stats) {
+        *slot->stats = stats;
+    } else {
+        slot->stats = std::make_unique<RingDoseStatistics>(stats);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// THREAD DE RAPPORT
+// ═══════════════════════════════════════════════════════════════
+
+void ProgressReporter::Start(G4int runID, G4long eventsToProcess)
+{
+    Stop();
+
+    fRunID = runID;
+    fEventsToProcess = eventsToProcess;
+    fStartTime = std::chrono::steady_clock::now();
+    fLastTime = fStartTime;
+    fLastEvents = 0;
+
+    // Les statistiques du run précédent ne doivent pas être comptées
+    {
+        std::lock_guard<std::mutex> lock(fSlotsMutex);
+        for (auto& slot : fSlots) {
+            std::lock_guard<std::mutex> slotLock(slot->mutex);
+            if (slot->stats) slot->stats->Reset();
+        }
+    }
+
+    if (!IsEnabled()) return;
+
+    if (!fHeartbeatFileName.empty()) {
+        fHeartbeat.open(fHeartbeatFileName, std::ios::out | std::ios::app);
+        if (!fHeartbeat.is_open()) {
+            G4cerr << "ProgressReporter: ERROR - Could not open " << fHeartbeatFileName << G4endl;
+        }
+    }
+
+    fStopRequested = false;
+    fThread = std::thread(&ProgressReporter::Loop, this);
+}
+
+void ProgressReporter::Stop()
+{
+    if (!fThread.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(fWakeMutex);
+        fStopRequested = true;
+    }
+    fWake.notify_all();
+    fThread.join();
+
+    Report(true);
+
+    if (fHeartbeat.is_open()) fHeartbeat.close();
+}
+
+void ProgressReporter::Loop()
+{
+    const auto period = std::chrono::duration<G4double>(fInterval / s);
+
+    std::unique_lock<std::mutex> lock(fWakeMutex);
+    while (!fStopRequested) {
+        if (fWake.wait_for(lock, period, [this] { return fStopRequested; })) break;
+        lock.unlock();
+        Report(false);
+        lock.lock();
+    }
+}
+
+void ProgressReporter::Report(G4bool finalReport)
+{
+    // ─────────────────────────────────────────────────────────────
+    // Fusion des emplacements publiés
+    // ─────────────────────────────────────────────────────────────
+    std::unique_ptr<RingDoseStatistics> total;
+    {
+        std::lock_guard<std::mutex> lock(fSlotsMutex);
+        for (auto& slot : fSlots) {
+            std::lock_guard<std::mutex> slotLock(slot->mutex);
+            if (!slot->stats) continue;
+            if (!total) {
+                total = std::make_unique<RingDoseStatistics>(*slot->stats);
+            } else {
+                total->Merge(*slot->stats);
+            }
+        }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    G4double elapsed = std::chrono::duration<G4double>(now - fStartTime).count();
+    G4double dt = std::chrono::duration<G4double>(now - fLastTime).count();
+
+    G4long events = total ? total->GetNbEvents() : 0;
+    G4double rate = (dt > 0.) ? (events - fLastEvents) / dt : 0.;
+    if (finalReport && elapsed > 0.) rate = events / elapsed;
+    G4double eta = (rate > 0. && fEventsToProcess > events)
+                   ? (fEventsToProcess - events) / rate : 0.;
+    G4double rss = GetResidentMemoryMB();
+
+    fLastTime = now;
+    fLastEvents = events;
+
+    // ─────────────────────────────────────────────────────────────
+    // Console
+    // ─────────────────────────────────────────────────────────────
+    G4int etaSec = static_cast<G4int>(eta);
+    char etaBuffer[32];
+    std::snprintf(etaBuffer, sizeof(etaBuffer), "%02d:%02d:%02d",
+                  etaSec / 3600, (etaSec / 60) % 60, etaSec % 60);
+
+    std::ostringstream oss;
+    oss << (finalReport ? "[progress] FIN run " : "[progress] run ") << fRunID
+        << " | " << events << " / " << fEventsToProcess << " evt";
+    if (fEventsToProcess > 0) {
+        oss << " (" << std::fixed << std::setprecision(1)
+            << 100. * events / fEventsToProcess << " %)";
+    }
+    oss << " | " << std::fixed << std::setprecision(0) << rate << " evt/s"
+        << " | ETA " << etaBuffer
+        << " | RSS " << std::setprecision(1) << rss << " MB\n";
+
+    G4int nRings = total ? total->GetNbRings() : 0;
+    for (G4int i = 0; i < nRings; ++i) {
+        RingDoseStatistics::Summary sum = total->GetSummary(i, elapsed);
+        oss << "           anneau " << i << " : "
+            << std::scientific << std::setprecision(4) << sum.mean << " nGy/evt"
+            << "  +/- " << std::fixed << std::setprecision(2) << 100. * sum.relError << " %\n";
+    }
+    G4cout << oss.str() << std::flush;
+
+    // ─────────────────────────────────────────────────────────────
+    // Heartbeat JSON-lines
+    // ─────────────────────────────────────────────────────────────
+    if (fHeartbeat.is_open()) {
+        std::ostringstream js;
+        js << std::setprecision(10)
+           << "{\"run\":" << fRunID
+           << ",\"final\":" << (finalReport ? "true" : "false")
+           << ",\"elapsed_s\":" << elapsed
+           << ",\"events\":" << events
+           << ",\"events_total\":" << fEventsToProcess
+           << ",\"events_per_s\":" << rate
+           << ",\"eta_s\":" << eta
+           << ",\"rss_mb\":" << rss
+           << ",\"rings\":[";
+        for (G4int i = 0; i < nRings; ++i) {
+            RingDoseStatistics::Summary sum = total->GetSummary(i, elapsed);
+            js << (i ? "," : "")
+               << "{\"ring\":" << i
+               << ",\"dose_nGy_per_evt\":" << sum.mean
+               << ",\"rel_error\":" << sum.relError << "}";
+        }
+        js << "]}\n";
+        fHeartbeat << js.str();
+        fHeartbeat.flush();
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// MÉMOIRE RÉSIDENTE
+// ═══════════════════════════════════════════════════════════════
+
+G4double ProgressReporter::GetResidentMemoryMB()
+{
+#ifdef __linux__
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return 0.;
+    long pagesTotal = 0, pagesResident = 0;
+    G4int nRead = std::fscanf(statm, "%ld %ld", &pagesTotal, &pagesResident);
+    std::fclose(statm);
+    if (nRead != 2) return 0.;
+    return pagesResident * static_cast<G4double>(sysconf(_SC_PAGESIZE)) / (1024. * 1024.);
+#else
+    return 0.;
+#endif
+}
@@ -0,0 +1,136 @@
+#include "QmcSampling.hh"
+
+#include "G4GenericMessenger.hh"
+
+#include <cmath>
+#include <iomanip>
+
+QmcSampling* QmcSampling::fInstance = nullptr;
+
+QmcSampling::QmcSampling()
+: fEnabled(false),
+  fStudy(false),
+  fMessenger(nullptr)
+{
+    DefineCommands();
+}
+
+QmcSampling::~QmcSampling()
+{
+    delete fMessenger;
+}
+
+QmcSampling* QmcSampling::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de RunAction)
+    if (fInstance == nullptr) {
+        fInstance = new QmcSampling();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/qmc/)
+// ═══════════════════════════════════════════════════════════════
+
+void QmcSampling::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/qmc/",
+                                        "Suite de Sobol brouillee pour la source");
+
+    auto& enableCmd = fMessenger->DeclareProperty("enable", fEnabled,
+        "Raie, cos(theta) et phi tires dans une suite de Sobol brouillee");
+    enableCmd.SetParameterName("enable", true);
+    enableCmd.SetDefaultValue("true");
+    enableCmd.SetStates(G4State_PreInit, G4State_Idle);
+    enableCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& studyCmd = fMessenger->DeclareProperty("study", fStudy,
+        "Chaque run est une replique ; FOM par anneau QMC vs pseudo-aleatoire");
+    studyCmd.SetParameterName("study", true);
+    studyCmd.SetDefaultValue("true");
+    studyCmd.SetStates(G4State_PreInit, G4State_Idle);
+    studyCmd.SetToBeBroadcasted(false);
+
+    auto& resetCmd = fMessenger->DeclareMethod("resetStudy", &QmcSampling::ResetStudy,
+        "Oublie les repliques enregistrees");
+    resetCmd.SetStates(G4State_PreInit, G4State_Idle);
+    resetCmd.SetToBeBroadcasted(false);
+}
+
+void QmcSampling::ResetStudy()
+{
+    for (G4int mode = 0; mode < 2; ++mode) {
+        fReplicateMeans[mode].clear();
+        fReplicateTimes[mode].clear();
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// RÉPLIQUES ET FIGURE DE MÉRITE
+// ═══════════════════════════════════════════════════════════════
+
+void QmcSampling::RecordReplicate(const std::vector<G4double>& ringMeans, G4double cpuTime_s)
+{
+    G4int mode = fEnabled ? 1 : 0;
+    fReplicateMeans[mode].push_back(ringMeans);
+    fReplicateTimes[mode].push_back(cpuTime_s);
+}
+
+G4double QmcSampling::ComputeFOM(G4int mode, G4int ring, G4double& relError) const
+{
+    relError = 0.;
+    const auto& means = fReplicateMeans[mode];
+    const G4int n = static_cast<G4int>(means.size());
+    if (n < 2) return 0.;
+
+    G4double sum = 0., sumTime = 0.;
+    for (G4int r = 0; r < n; ++r) {
+        sum += means[r][ring];
+        sumTime += fReplicateTimes[mode][r];
+    }
+    G4double mean = sum / n;
+    G4double var = 0.;
+    for (G4int r = 0; r < n; ++r) {
+        G4double d = means[r][ring] - mean;
+        var += d * d;
+    }
+    var /= (n - 1);
+
+    // Erreur relative et temps d'UNE réplique : FOM indépendante du nombre de répliques
+    if (mean <= 0. || var <= 0.) return 0.;
+    relError = std::sqrt(var) / mean;
+    G4double time = sumTime / n;
+    return (time > 0.) ? 1. / (relError * relError * time) : 0.;
+}
+
+void QmcSampling::PrintStudy(std::ostream& os) const
+{
+    const size_t nPrng = fReplicateMeans[0].size();
+    const size_t nQmc = fReplicateMeans[1].size();
+    const size_t nRings = !fReplicateMeans[0].empty() ? fReplicateMeans[0].front().size()
+                        : !fReplicateMeans[1].empty() ? fReplicateMeans[1].front().size() : 0;
+
+    os << "\n╔═══════════════════════════════════════════════════════════════════════════════════════╗\n";
+    os << "║              ÉTUDE QMC - répliques pseudo-aléatoires : " << std::setw(4) << nPrng
+       << ", QMC : " << std::setw(4) << nQmc << "                  ║\n";
+    os << "╠═════════╦═══════════════╦═════════════════╦═══════════════╦═════════════════╦═════════╣\n";
+    os << "║ Anneau  ║ Err.rel. PRNG ║  FOM PRNG (1/s) ║ Err.rel. QMC  ║  FOM QMC (1/s)  ║  Gain   ║\n";
+    os << "╠═════════╬═══════════════╬═════════════════╬═══════════════╬═════════════════╬═════════╣\n";
+    for (size_t i = 0; i < nRings; ++i) {
+        G4double relPrng, relQmc;
+        G4double fomPrng = ComputeFOM(0, i, relPrng);
+        G4double fomQmc = ComputeFOM(1, i, relQmc);
+        os << "║    " << i << "    ║"
+           << std::setw(12) << std::fixed << std::setprecision(3) << 100. * relPrng << " % ║"
+           << std::setw(15) << std::scientific << std::setprecision(4) << fomPrng << "  ║"
+           << std::setw(12) << std::fixed << std::setprecision(3) << 100. * relQmc << " % ║"
+           << std::setw(15) << std::scientific << std::setprecision(4) << fomQmc << "  ║"
+           << std::setw(8) << std::fixed << std::setprecision(2)
+           << ((fomPrng > 0.) ? fomQmc / fomPrng : 0.) << " ║\n";
+    }
+    os << "╠═════════╩═══════════════╩═════════════════╩═══════════════╩═════════════════╩═════════╣\n";
+    os << "║  Err.rel. : dispersion des moyennes de runs (une réplique), >= 2 répliques par mode   ║\n";
+    os << "║  Gain = FOM QMC / FOM pseudo-aléatoire                                                ║\n";
+    os << "╚═══════════════════════════════════════════════════════════════════════════════════════╝\n";
+}
@@ -0,0 +1,190 @@
+#include "ResponseMatrix.hh"
+#include "Eu152Data.hh"
+#include "EmissionCone.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+ResponseMatrix* ResponseMatrix::fInstance = nullptr;
+
+ResponseMatrix::ResponseMatrix()
+: fEnergy(0.),
+  fFileName(""),
+  fMessenger(nullptr)
+{
+    DefineCommands();
+}
+
+ResponseMatrix::~ResponseMatrix()
+{
+    delete fMessenger;
+}
+
+ResponseMatrix* ResponseMatrix::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de RunAction)
+    if (fInstance == nullptr) {
+        fInstance = new ResponseMatrix();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/response/)
+// ═══════════════════════════════════════════════════════════════
+
+void ResponseMatrix::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/response/",
+                                        "Matrice de reponse par raie (sous-runs monoenergetiques)");
+
+    auto& energyCmd = fMessenger->DeclarePropertyWithUnit("energy", "keV", fEnergy,
+        "Energie du sous-run monoenergetique (active le mode reponse)");
+    energyCmd.SetParameterName("energy", false);
+    energyCmd.SetRange("energy>0.");
+    energyCmd.SetStates(G4State_PreInit, G4State_Idle);
+    energyCmd.SetToBeBroadcasted(false);
+
+    auto& lineCmd = fMessenger->DeclareMethod("line", &ResponseMatrix::SetLine,
+        "Sous-run a l'energie de la raie Eu-152 d'index donne (0-12)");
+    lineCmd.SetParameterName("lineIndex", false);
+    lineCmd.SetRange("lineIndex>=0 && lineIndex<13");
+    lineCmd.SetStates(G4State_PreInit, G4State_Idle);
+    lineCmd.SetToBeBroadcasted(false);
+
+    auto& offCmd = fMessenger->DeclareMethod("off", &ResponseMatrix::Disable,
+        "Retour au spectre Eu-152 complet");
+    offCmd.SetStates(G4State_PreInit, G4State_Idle);
+    offCmd.SetToBeBroadcasted(false);
+
+    auto& fileCmd = fMessenger->DeclareProperty("file", fFileName,
+        "Fichier de reponse (vide = response_<hash geometrie>.csv)");
+    fileCmd.SetParameterName("fileName", true);
+    fileCmd.SetDefaultValue("");
+    fileCmd.SetStates(G4State_PreInit, G4State_Idle);
+    fileCmd.SetToBeBroadcasted(false);
+}
+
+void ResponseMatrix::SetLine(G4int lineIndex)
+{
+    if (lineIndex >= 0 && lineIndex < Eu152::kNbLines) {
+        fEnergy = Eu152::kLineEnergies_keV[lineIndex] * keV;
+    }
+}
+
+void ResponseMatrix::Disable()
+{
+    fEnergy = 0.;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// HACHAGE DE LA GÉOMÉTRIE
+// ═══════════════════════════════════════════════════════════════
+
+G4String ResponseMatrix::ComputeGeometryHash()
+{
+    std::ostringstream desc;
+    desc << std::setprecision(9);
+    for (const G4VPhysicalVolume* pv : *G4PhysicalVolumeStore::GetInstance()) {
+        const G4LogicalVolume* lv = pv->GetLogicalVolume();
+        desc << pv->GetName() << '|' << pv->GetCopyNo() << '|'
+             << pv->GetTranslation() << '|'
+             << lv->GetMaterial()->GetName() << '|'
+             << lv->GetMaterial()->GetDensity() / (g/cm3) << '|';
+        if (pv->IsReplicated()) desc << pv->GetMultiplicity() << '|';   // replica / paramétré
+        lv->GetSolid()->StreamInfo(desc);
+    }
+    
+    // La réponse par photon dépend aussi de la position source et du cône tiré
+    const EmissionCone* cone = EmissionCone::GetInstance();
+    desc << "source|" << cone->GetSourcePosition() << "|cone|" << cone->GetHalfAngle() / deg;
+
+    // FNV-1a 64 bits
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : desc.str()) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return G4String(buffer);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// ÉCRITURE DU FICHIER DE RÉPONSE
+// ═══════════════════════════════════════════════════════════════
+
+void ResponseMatrix::Record(const Row& row)
+{
+    const G4String hash = ComputeGeometryHash();
+    const G4String fileName = fFileName.empty() ? "response_" + hash + ".csv" : fFileName;
+    const G4int nRings = static_cast<G4int>(row.dose_nGy.size());
+
+    // Lignes existantes de la même géométrie, indexées par énergie
+    std::map<G4String, G4String> rows;
+    {
+        std::ifstream in(fileName);
+        G4String line;
+        G4bool sameGeometry = false;
+        while (std::getline(in, line)) {
+            if (line.rfind("# geometry_hash=", 0) == 0) {
+                sameGeometry = (line.substr(16) == hash);
+                if (!sameGeometry) {
+                    G4cout << "ResponseMatrix: WARNING - " << fileName
+                           << " correspond a une autre geometrie, fichier reecrit" << G4endl;
+                    break;
+                }
+                continue;
+            }
+            if (line.empty() || line[0] == '#' || line.rfind("energy_keV", 0) == 0) continue;
+            if (sameGeometry) rows[line.substr(0, line.find(','))] = line;
+        }
+    }
+
+    std::ostringstream key;
+    key << std::fixed << std::setprecision(3) << row.energy_keV;
+
+    std::ostringstream out;
+    out << key.str() << "," << row.nPhotons << ","
+        << std::scientific << std::setprecision(9) << row.coneFraction;
+    for (G4int i = 0; i < nRings; ++i) {
+        out << "," << row.dose_nGy[i] << "," << row.doseSem_nGy[i];
+    }
+    out << "," << row.prePhotons << "," << row.postPhotonsFwd
+        << "," << row.enteredWater << "," << row.absorbedWater;
+    rows[key.str()] = out.str();
+
+    // Réécriture complète (quelques dizaines de lignes au plus)
+    std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        G4cerr << "ResponseMatrix: ERROR - Could not open " << fileName << G4endl;
+        return;
+    }
+    file << "# puits_couronne response matrix (grandeurs par photon emis dans le cone)\n";
+    file << "# geometry_hash=" << hash << "\n";
+    file << "energy_keV,n_photons,cone_fraction";
+    for (G4int i = 0; i < nRings; ++i) {
+        file << ",dose_nGy_ring" << i << ",sem_nGy_ring" << i;
+    }
+    file << ",pre_photons,post_photons_fwd,entered_water,absorbed_water\n";
+
+    // Tri numérique des énergies
+    std::map<G4double, G4String> sorted;
+    for (const auto& entry : rows) sorted[std::stod(entry.first)] = entry.second;
+    for (const auto& entry : sorted) file << entry.second << "\n";
+
+    G4cout << ">>> Matrice de reponse : " << key.str() << " keV -> " << fileName << G4endl;
+}
@@ -0,0 +1,131 @@
+#include "RingDoseStatistics.hh"
+
+#include <cmath>
+
+// ═══════════════════════════════════════════════════════════════
+// ACCUMULATEUR DE WELFORD
+// ═══════════════════════════════════════════════════════════════
+
+void RingDoseStatistics::Welford::Add(G4double x)
+{
+    n++;
+    G4double delta = x - mean;
+    mean += delta / n;
+    m2 += delta * (x - mean);
+}
+
+void RingDoseStatistics::Welford::Merge(const Welford& other)
+{
+    if (other.n == 0) return;
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+    // Formule parallèle de Chan et al.
+    G4long nTot = n + other.n;
+    G4double delta = other.mean - mean;
+    mean += delta * other.n / nTot;
+    m2 += other.m2 + delta * delta * (static_cast<G4double>(n) * other.n / nTot);
+    n = nTot;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// STATISTIQUES PAR ANNEAU
+// ═══════════════════════════════════════════════════════════════
+
+RingDoseStatistics::RingDoseStatistics(const G4String& name, G4int nRings, G4int batchSize)
+: G4VAccumulable(name),
+  fNbRings(nRings),
+  fBatchSize(batchSize > 0 ? batchSize : 1),
+  fNbEvents(0),
+  fEvent(nRings),
+  fBatch(nRings),
+  fBatchSum(nRings, 0.),
+  fEventsInBatch(0)
+{}
+
+void RingDoseStatistics::SetBatchSize(G4int batchSize)
+{
+    fBatchSize = (batchSize > 0) ? batchSize : 1;
+    Reset();
+}
+
+void RingDoseStatistics::SetNbRings(G4int nRings)
+{
+    if (nRings == fNbRings) return;
+    fNbRings = nRings;
+    fEvent.resize(nRings);
+    fBatch.resize(nRings);
+    fBatchSum.resize(nRings);
+    Reset();
+}
+
+void RingDoseStatistics::Fill(const G4double* values)
+{
+    fNbEvents++;
+    for (G4int i = 0; i < fNbRings; ++i) {
+        fEvent[i].Add(values[i]);
+        fBatchSum[i] += values[i];
+    }
+
+    if (++fEventsInBatch == fBatchSize) {
+        for (G4int i = 0; i < fNbRings; ++i) {
+            fBatch[i].Add(fBatchSum[i] / fBatchSize);
+            fBatchSum[i] = 0.;
+        }
+        fEventsInBatch = 0;
+    }
+}
+
+void RingDoseStatistics::Merge(const G4VAccumulable& other)
+{
+    const auto& stats = static_cast<const RingDoseStatistics&>(other);
+    if (stats.fNbRings != fNbRings) return;
+
+    // Les événements du lot incomplet de l'autre thread entrent dans
+    // l'estimation de Welford mais pas dans celle par lots
+    fNbEvents += stats.fNbEvents;
+    for (G4int i = 0; i < fNbRings; ++i) {
+        fEvent[i].Merge(stats.fEvent[i]);
+        fBatch[i].Merge(stats.fBatch[i]);
+    }
+}
+
+void RingDoseStatistics::Reset()
+{
+    fNbEvents = 0;
+    fEventsInBatch = 0;
+    for (G4int i = 0; i < fNbRings; ++i) {
+        fEvent[i] = Welford();
+        fBatch[i] = Welford();
+        fBatchSum[i] = 0.;
+    }
+}
+
+RingDoseStatistics::Summary RingDoseStatistics::GetSummary(G4int ring, G4double time_s) const
+{
+    Summary s{0., 0., 0., 0., 0., 0., 0};
+    if (ring < 0 || ring >= fNbRings || fEvent[ring].n == 0) return s;
+
+    const Welford& ev = fEvent[ring];
+    const Welford& bt = fBatch[ring];
+
+    s.mean = ev.mean;
+    s.sigmaWelford = std::sqrt(ev.Variance() / ev.n);
+    s.nBatches = static_cast<G4int>(bt.n);
+    if (bt.n > 1) {
+        s.sigmaBatch = std::sqrt(bt.Variance() / bt.n);
+    }
+
+    // L'erreur par lots n'est retenue qu'avec assez de lots pour
+    // que sa propre incertitude reste raisonnable
+    s.sigmaMean = (s.nBatches >= kMinBatches) ? s.sigmaBatch : s.sigmaWelford;
+
+    if (s.mean > 0.) {
+        s.relError = s.sigmaMean / s.mean;
+    }
+    if (s.relError > 0. && time_s > 0.) {
+        s.fom = 1. / (s.relError * s.relError * time_s);
+    }
+    return s;
+}
@@ -0,0 +1,29 @@
+#include "RingParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4Tubs.hh"
+#include "G4ThreeVector.hh"
+#include "G4SystemOfUnits.hh"
+
+RingParameterisation::RingParameterisation(G4double ringWidth, G4double halfThickness)
+: G4VPVParameterisation(),
+  fRingWidth(ringWidth),
+  fHalfThickness(halfThickness)
+{}
+
+void RingParameterisation::ComputeTransformation(const G4int, G4VPhysicalVolume* physVol) const
+{
+    // Anneaux concentriques : tous centrés dans le conteneur
+    physVol->SetTranslation(G4ThreeVector());
+    physVol->SetRotation(nullptr);
+}
+
+void RingParameterisation::ComputeDimensions(G4Tubs& ring, const G4int copyNo,
+                                             const G4VPhysicalVolume*) const
+{
+    ring.SetInnerRadius(copyNo * fRingWidth);
+    ring.SetOuterRadius((copyNo + 1) * fRingWidth);
+    ring.SetZHalfLength(fHalfThickness);
+    ring.SetStartPhiAngle(0.*deg);
+    ring.SetDeltaPhiAngle(360.*deg);
+}
@@ -1,14 +1,39 @@
 #include "RunAction.hh"
 #include "DetectorConstruction.hh"
+#include "EmissionCone.hh"
+#include "ResponseMatrix.hh"
+#include "CascadeLibrary.hh"
+#include "SourceScan.hh"
+#include "Eu152Data.hh"
+#include "QmcSampling.hh"
+#include "KermaScoring.hh"
+#include "CorrelatedSampling.hh"
+#include "StratifiedSampler.hh"
+#include "AttenuatorKernel.hh"
+#include "PhysicsList.hh"
 #include "Logger.hh"
+#include "ProgressReporter.hh"
+#include "ThreadingConfig.hh"
+#include "AllocationCounter.hh"
+#include "ProfilingTimers.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
+#include "G4RunManagerKernel.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4AnalysisManager.hh"
+#include "G4AccumulableManager.hh"
+#include "G4Threading.hh"
+#include "G4GenericMessenger.hh"
+#include "Randomize.hh"
 #include <iomanip>
+#include <fstream>
 #include <sstream>
+#include <cctype>
 #include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
 
 // ═══════════════════════════════════════════════════════════════
 // CONSTANTES POUR LA CONVERSION EN DOSE
@@ -17,49 +42,155 @@
 static const G4double kMeVtoJoule = 1.60218e-13;
 static const G4double kNanoGrayFactor = 0.160218;  // nGy per MeV per gram
 
+// Libellé "(a-b mm)" d'un anneau pour les titres d'histogrammes
+static G4String RingRangeLabel(const DetectorConstruction* detector, G4int ring)
+{
+    if (ring >= detector->GetNbWaterRings()) return "(absent)";
+    std::ostringstream oss;
+    oss << "(" << detector->GetRingInnerRadius(ring)/mm << "-"
+        << detector->GetRingOuterRadius(ring)/mm << "mm)";
+    return oss.str();
+}
+
 RunAction::RunAction()
 : G4UserRunAction(),
   fActivity4pi(4.2e4),          // 42 kBq (source réelle)
-  fConeAngle(45.*deg),
-  fSourcePosZ(75.0*mm),           // Source à z = 75 mm (25 mm avant surface eau à z=100 mm)
   fMeanGammasPerDecay(2.03),    // Mis à jour avec 13 raies
   fWaterRadius(25.0*mm),        // Rayon de l'eau
   fWaterBottomZ(98.5*mm),       // Position Z du bas de l'eau
-  fTotalPrimariesGenerated(0),
-  fTotalEventsWithZeroGamma(0),
-  fTotalTransmitted(0),
-  fTotalAbsorbed(0),
-  fTotalEvents(0),
-  fTotalWaterEnergy(0.),
-  fTotalWaterEventCount(0),
-  fGammasEnteringContainer(0),
-  fGammasEnteringWater(0),
-  fElectronsInWater(0),
-  fGammasPreContainerPlane(0),
-  fGammasPostContainerPlane(0),
-  fOutputFileName("output.root")
-{
-    fRingTotalEnergy.fill(0.);
-    fRingTotalEnergy2.fill(0.);
-    fRingEventCount.fill(0);
+  fCounters("RunCounters"),
+  fTotalRingMass(0.),
+  fNbRings(5),
+  fEdepRingFirstH1(-1),
+  fElectronSpectrumH1(-1),
+  fDoseRingFirstH1(-1),
+  fDoseTotalH1(-1),
+  fPlaneSpectrumFirstH1(-1),
+  fDoseStats("RingDose", DetectorConstruction::kMaxWaterRings),
+  fKermaStats("RingKerma", DetectorConstruction::kMaxWaterRings),
+  fScanTallies("ScanTallies"),
+  fStatsBatchSize(10000),
+  fStatsReportEvery(0),
+  fRunStartCPU(0),
+  fStartupCPU_s(0.),
+  fStartupMemory_MB(0.),
+  fProgressSlot(-1),
+  fEventsSincePublish(0),
+  fHistogramsBooked(false),
+  fOutputFileName("output.root"),
+  fLogFileName("output.log"),
+  fOutputPrefix("output"),
+  fWriteResults(true),
+  fPerThreadOutput(false),
+  fMergeMode("none"),
+  fMessenger(nullptr),
+  fOutputMessenger(nullptr)
+{
     fRingMasses.fill(0.);
+    fRunSeeds.fill(0);
     
-    for (auto& arr : fRingEnergyByLine) {
-        arr.fill(0.);
-    }
+    // Compteurs et statistiques de dose fusionnés entre threads en mode MT
+    G4AccumulableManager::Instance()->Register(&fCounters);
+    G4AccumulableManager::Instance()->Register(&fDoseStats);
     
-    fLineEmitted.fill(0);
-    fLineEnteredWater.fill(0);
-    fLineAbsorbedWater.fill(0);
+    // Commandes /puits/alloc/ et /puits/profile/ créées sur le maître (avant les threads)
+    AllocationCounter::GetInstance();
+    ProfilingTimers::GetInstance();
+    G4AccumulableManager::Instance()->Register(&fKermaStats);
+    G4AccumulableManager::Instance()->Register(&fScanTallies);
     
-    // Initialiser les compteurs par processus
-    for (auto& arr : fLineAbsorbedByProcess) {
-        arr.fill(0);
-    }
+    // Emplacement de publication pour le rapport d'avancement
+    fProgressSlot = ProgressReporter::GetInstance()->RegisterSlot();
+    
+    // Crée les commandes /puits/response/, /puits/cascade/, /puits/qmc/, /puits/kerma/,
+    // /puits/corr/ et /puits/strat/ sur le thread maître
+    ResponseMatrix::GetInstance();
+    CascadeLibrary::GetInstance();
+    QmcSampling::GetInstance();
+    KermaScoring::GetInstance();
+    CorrelatedSampling::GetInstance();
+    StratifiedSampler::DefineCommands();
+    
+    DefineCommands();
 }
 
 RunAction::~RunAction()
-{}
+{
+    delete fMessenger;
+    delete fOutputMessenger;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/stats/)
+// ═══════════════════════════════════════════════════════════════
+
+void RunAction::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/stats/",
+                                        "Incertitudes sur la dose par anneau");
+    
+    auto& batchCmd = fMessenger->DeclareProperty("batchSize", fStatsBatchSize,
+        "Nombre d'evenements par lot pour l'erreur par moyennes de lots");
+    batchCmd.SetParameterName("nEvents", false);
+    batchCmd.SetRange("nEvents>0");
+    batchCmd.SetStates(G4State_PreInit, G4State_Idle);
+    
+    auto& reportCmd = fMessenger->DeclareProperty("reportEvery", fStatsReportEvery,
+        "Rapport intermediaire dose/erreur/FOM tous les N evenements (0 = fin de run seulement)");
+    reportCmd.SetParameterName("nEvents", false);
+    reportCmd.SetRange("nEvents>=0");
+    reportCmd.SetStates(G4State_PreInit, G4State_Idle);
+    
+    // Nom des sorties, modifiable entre deux runs (un job = un préfixe en mode serveur)
+    fOutputMessenger = new G4GenericMessenger(this, "/puits/output/", "Fichiers de sortie du run");
+    
+    auto& nameCmd = fOutputMessenger->DeclareMethod("name", &RunAction::SetOutputName,
+        "Prefixe des sorties : <nom>.root et <nom>.log (dossiers crees si besoin)");
+    nameCmd.SetParameterName("name", false);
+    nameCmd.SetStates(G4State_PreInit, G4State_Idle);
+    
+    auto& resultsCmd = fOutputMessenger->DeclareProperty("results", fWriteResults,
+        "Ecrit <nom>_results.json, <nom>_rings.csv et <nom>_lines.csv en fin de run");
+    resultsCmd.SetParameterName("enable", true);
+    resultsCmd.SetDefaultValue("true");
+    resultsCmd.SetStates(G4State_PreInit, G4State_Idle);
+    
+    auto& perThreadCmd = fOutputMessenger->DeclareProperty("perThread", fPerThreadOutput,
+        "MT : ntuples ecrits dans <nom>_t<N>.root par thread, sans fusion par le maitre");
+    perThreadCmd.SetParameterName("enable", true);
+    perThreadCmd.SetDefaultValue("true");
+    perThreadCmd.SetStates(G4State_PreInit);   // fixé avant l'ouverture du premier fichier
+    
+    auto& mergeCmd = fOutputMessenger->DeclareProperty("merge", fMergeMode,
+        "Fusion hadd des fichiers par thread : none (index seul), end (fin de run) ou background");
+    mergeCmd.SetParameterName("mode", false);
+    mergeCmd.SetCandidates("none end background");
+    mergeCmd.SetStates(G4State_PreInit, G4State_Idle);
+    
+    auto& quietCmd = fOutputMessenger->DeclareMethod("quiet", &RunAction::SetQuiet,
+        "Supprime les bannieres console (les fichiers de sortie sont inchanges)");
+    quietCmd.SetParameterName("quiet", true);
+    quietCmd.SetDefaultValue("true");
+    quietCmd.SetStates(G4State_PreInit, G4State_Idle);
+}
+
+void RunAction::SetQuiet(G4bool quiet)
+{
+    Logger::GetInstance()->SetQuiet(quiet);
+}
+
+void RunAction::SetOutputName(const G4String& name)
+{
+    fOutputPrefix = name;
+    fOutputFileName = name + ".root";
+    fLogFileName = name + ".log";
+    
+    std::filesystem::path parent = std::filesystem::path(fOutputFileName).parent_path();
+    if (!parent.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(parent, error);
+    }
+}
 
 // ═══════════════════════════════════════════════════════════════
 // CONVERSION D'UNITÉS
@@ -84,43 +215,34 @@ G4double RunAction::ConvertToNanoGray(G4double energy, G4double mass)
 
 G4double RunAction::GetSolidAngleFraction() const
 {
-    // Fraction de l'angle solide 4π couverte par le cône
-    return (1.0 - std::cos(fConeAngle)) / 2.0;
+    // Mode cascades : désintégrations tirées sur 4π, seules celles qui
+    // émettent dans le cône deviennent des événements
+    if (CascadeLibrary::GetInstance()->IsEnabled() && !ResponseMatrix::GetInstance()->IsEnabled()) {
+        return (fCounters.decays > 0) ? static_cast<G4double>(fCounters.events) / fCounters.decays : 1.;
+    }
+    
+    // Fraction de l'angle solide 4π couverte par le cône (source unique)
+    return EmissionCone::GetInstance()->GetSolidAngleFraction();
+}
+
+G4double RunAction::GetConeAngle() const
+{
+    return EmissionCone::GetInstance()->GetHalfAngle();
+}
+
+G4double RunAction::GetSourcePosZ() const
+{
+    return EmissionCone::GetInstance()->GetSourcePosition().z();
 }
 
 // ═══════════════════════════════════════════════════════════════
-// DÉBUT DE RUN - AVEC CRÉATION DU FICHIER ROOT
+// RÉSERVATION DES HISTOGRAMMES ET NTUPLES (premier run uniquement)
 // ═══════════════════════════════════════════════════════════════
 
-void RunAction::BeginOfRunAction(const G4Run* run)
+void RunAction::BookHistograms()
 {
-    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║  DÉBUT DU RUN " << run->GetRunID() << " - CONFIGURATION SANS FILTRE              ║" << G4endl;
-    G4cout << "║  Source à z = " << fSourcePosZ/mm << " mm                                        ║" << G4endl;
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
-    
-    Logger::GetInstance()->Open("output.log");
-    Logger::GetInstance()->LogHeader("Démarrage du Run " + std::to_string(run->GetRunID()) + " - SANS FILTRE");
-    
-    // ═══════════════════════════════════════════════════════════════
-    // CRÉATION DU FICHIER ROOT ET DES HISTOGRAMMES
-    // ═══════════════════════════════════════════════════════════════
-    
     auto analysisManager = G4AnalysisManager::Instance();
     
-    // Configuration du manager
-    analysisManager->SetDefaultFileType("root");
-    analysisManager->SetVerboseLevel(1);
-    analysisManager->SetNtupleMerging(true);  // Pour le multithreading
-    
-    // Ouvrir le fichier ROOT
-    G4bool fileOpen = analysisManager->OpenFile(fOutputFileName);
-    if (!fileOpen) {
-        G4cerr << "*** ERREUR: Impossible d'ouvrir le fichier " << fOutputFileName << G4endl;
-        return;
-    }
-    G4cout << ">>> Fichier ROOT ouvert: " << fOutputFileName << G4endl;
-    
     // ─────────────────────────────────────────────────────────────
     // CRÉATION DES HISTOGRAMMES 1D
     // ─────────────────────────────────────────────────────────────
@@ -137,32 +259,54 @@ void RunAction::BeginOfRunAction(const G4Run* run)
     analysisManager->CreateH1("hEdepWater", "Energie deposee dans eau;Energie (keV);Counts", 
                               500, 0., 250.);
     
-    // H1 ID=3-7: Énergie déposée par anneau (par step)
-    analysisManager->CreateH1("hEdepRing0", "Edep Anneau 0 (0-5mm);Energie (keV);Counts", 200, 0., 200.);
-    analysisManager->CreateH1("hEdepRing1", "Edep Anneau 1 (5-10mm);Energie (keV);Counts", 200, 0., 200.);
-    analysisManager->CreateH1("hEdepRing2", "Edep Anneau 2 (10-15mm);Energie (keV);Counts", 200, 0., 200.);
-    analysisManager->CreateH1("hEdepRing3", "Edep Anneau 3 (15-20mm);Energie (keV);Counts", 200, 0., 200.);
-    analysisManager->CreateH1("hEdepRing4", "Edep Anneau 4 (20-25mm);Energie (keV);Counts", 200, 0., 200.);
+    auto detector = static_cast<const DetectorConstruction*>(
+        G4RunManager::GetRunManager()->GetUserDetectorConstruction());
     
-    // H1 ID=8: Profil radial de dose
+    // H1 ID=3..: Énergie déposée par anneau (par step), un par anneau construit
+    // (N = /puits/geometry/rings, fixé à /run/initialize ; les identifiants
+    // suivants dépendent de N, les noms ne changent pas)
+    for (G4int i = 0; i < fNbRings; ++i) {
+        G4int id = analysisManager->CreateH1("hEdepRing" + std::to_string(i),
+                                  "Edep Anneau " + std::to_string(i) + " " + RingRangeLabel(detector, i)
+                                  + ";Energie (keV);Counts", 200, 0., 200.);
+        if (i == 0) fEdepRingFirstH1 = id;
+    }
+    
+    // Profil radial de dose
     analysisManager->CreateH1("hRadialDose", "Profil radial dose;Rayon (mm);Dose (nGy)", 25, 0., 25.);
     
-    // H1 ID=9: Spectre des électrons secondaires dans l'eau
-    analysisManager->CreateH1("hElectronSpectrum", "Electrons secondaires;Energie (keV);Counts", 500, 0., 1500.);
+    // Spectre des électrons secondaires dans l'eau
+    fElectronSpectrumH1 = analysisManager->CreateH1("hElectronSpectrum",
+                              "Electrons secondaires;Energie (keV);Counts", 500, 0., 1500.);
     
     // ─────────────────────────────────────────────────────────────
     // NOUVEAUX HISTOGRAMMES DE DOSE PAR ÉVÉNEMENT (en nGy)
     // ─────────────────────────────────────────────────────────────
     
-    // H1 ID=10-14: Dose par anneau par événement
-    analysisManager->CreateH1("h_dose_ring0", "Dose Anneau 0 (0-5mm);Dose (nGy);Counts", 500, 0., 0.5);
-    analysisManager->CreateH1("h_dose_ring1", "Dose Anneau 1 (5-10mm);Dose (nGy);Counts", 400, 0., 0.2);
-    analysisManager->CreateH1("h_dose_ring2", "Dose Anneau 2 (10-15mm);Dose (nGy);Counts", 100, 0., 0.1);
-    analysisManager->CreateH1("h_dose_ring3", "Dose Anneau 3 (15-20mm);Dose (nGy);Counts", 100, 0., 0.1);
-    analysisManager->CreateH1("h_dose_ring4", "Dose Anneau 4 (20-25mm);Dose (nGy);Counts", 500, 0., 0.1);
+    // Dose par anneau par événement : binning historique des 5 premiers
+    // anneaux (géométrie par défaut), 500 bins jusqu'à 0.1 nGy au-delà
+    const G4int kNbTunedRings = 5;
+    const G4int doseBins[kNbTunedRings] = {500, 400, 100, 100, 500};
+    const G4double doseMax[kNbTunedRings] = {0.5, 0.2, 0.1, 0.1, 0.1};
+    for (G4int i = 0; i < fNbRings; ++i) {
+        G4int id = analysisManager->CreateH1("h_dose_ring" + std::to_string(i),
+                                  "Dose Anneau " + std::to_string(i) + " " + RingRangeLabel(detector, i)
+                                  + ";Dose (nGy);Counts",
+                                  (i < kNbTunedRings) ? doseBins[i] : 500, 0.,
+                                  (i < kNbTunedRings) ? doseMax[i] : 0.1);
+        if (i == 0) fDoseRingFirstH1 = id;
+    }
     
-    // H1 ID=15: Dose totale par événement
-    analysisManager->CreateH1("h_dose_total", "Dose totale eau;Dose (nGy);Counts", 500, 0., 0.03);
+    // Dose totale par événement
+    fDoseTotalH1 = analysisManager->CreateH1("h_dose_total", "Dose totale eau;Dose (nGy);Counts", 500, 0., 0.03);
+    
+    // Spectres aux plans container (PlaneSD), [plan][particule][sens]
+    for (G4int i = 0; i < PlaneSD::kNbTallies; ++i) {
+        G4String name = PlaneSD::GetTallyName(i);
+        G4int id = analysisManager->CreateH1("hPlane_" + name, "Plan " + name + ";Energie (keV);Counts (ponderes)",
+                                  1000, 0., 2000.);
+        if (i == 0) fPlaneSpectrumFirstH1 = id;
+    }
     
     // ─────────────────────────────────────────────────────────────
     // CRÉATION DES HISTOGRAMMES 2D
@@ -179,11 +323,9 @@ void RunAction::BeginOfRunAction(const G4Run* run)
     analysisManager->CreateNtuple("EventData", "Donnees par evenement");
     analysisManager->CreateNtupleIColumn("EventID");
     analysisManager->CreateNtupleDColumn("EdepTotal");
-    analysisManager->CreateNtupleDColumn("EdepRing0");
-    analysisManager->CreateNtupleDColumn("EdepRing1");
-    analysisManager->CreateNtupleDColumn("EdepRing2");
-    analysisManager->CreateNtupleDColumn("EdepRing3");
-    analysisManager->CreateNtupleDColumn("EdepRing4");
+    for (G4int i = 0; i < fNbRings; ++i) {
+        analysisManager->CreateNtupleDColumn("EdepRing" + std::to_string(i));
+    }
     analysisManager->CreateNtupleIColumn("NGammaEmitted");
     analysisManager->CreateNtupleIColumn("NGammaWater");
     analysisManager->FinishNtuple();
@@ -198,6 +340,7 @@ void RunAction::BeginOfRunAction(const G4Run* run)
     analysisManager->CreateNtupleIColumn("RingID");
     analysisManager->CreateNtupleSColumn("ParticleName");
     analysisManager->CreateNtupleSColumn("ProcessName");
+    analysisManager->CreateNtupleDColumn("Weight");
     analysisManager->FinishNtuple();
     
     // Ntuple 2: Données des gammas primaires
@@ -218,6 +361,7 @@ void RunAction::BeginOfRunAction(const G4Run* run)
     analysisManager->CreateNtupleIColumn("absorbedWater");
     analysisManager->CreateNtupleDColumn("waterAbsRate");
     analysisManager->CreateNtupleDColumn("waterEntryRate");
+    analysisManager->CreateNtupleDColumn("absorbedWater_w");   // Somme des poids (collision forcée)
     analysisManager->FinishNtuple();
     
     // ─────────────────────────────────────────────────────────────
@@ -250,83 +394,152 @@ void RunAction::BeginOfRunAction(const G4Run* run)
     // Ntuple 6: doses - Doses par anneau par événement (pour analyse_dose_anneaux.C)
     // ─────────────────────────────────────────────────────────────
     analysisManager->CreateNtuple("doses", "Doses par anneau par evenement");
+    // Une colonne par anneau construit (N = /puits/geometry/rings, 5 par défaut)
     analysisManager->CreateNtupleIColumn("eventID");          // Col 0
-    analysisManager->CreateNtupleDColumn("dose_nGy_ring0");   // Col 1
-    analysisManager->CreateNtupleDColumn("dose_nGy_ring1");   // Col 2
-    analysisManager->CreateNtupleDColumn("dose_nGy_ring2");   // Col 3
-    analysisManager->CreateNtupleDColumn("dose_nGy_ring3");   // Col 4
-    analysisManager->CreateNtupleDColumn("dose_nGy_ring4");   // Col 5
-    analysisManager->CreateNtupleDColumn("dose_nGy_total");   // Col 6
-    analysisManager->CreateNtupleDColumn("edep_keV_total");   // Col 7
-    analysisManager->CreateNtupleIColumn("nPrimaries");       // Col 8
-    analysisManager->CreateNtupleIColumn("nTransmitted");     // Col 9
-    analysisManager->CreateNtupleIColumn("nAbsorbed");        // Col 10
+    for (G4int i = 0; i < fNbRings; ++i) {
+        analysisManager->CreateNtupleDColumn("dose_nGy_ring" + std::to_string(i));   // Col 1..N
+    }
+    analysisManager->CreateNtupleDColumn("dose_nGy_total");   // Col N+1
+    analysisManager->CreateNtupleDColumn("edep_keV_total");   // Col N+2
+    analysisManager->CreateNtupleIColumn("nPrimaries");       // Col N+3
+    analysisManager->CreateNtupleIColumn("nTransmitted");     // Col N+4
+    analysisManager->CreateNtupleIColumn("nAbsorbed");        // Col N+5
     analysisManager->FinishNtuple();
     
-    G4cout << ">>> Histogrammes et Ntuples créés" << G4endl;
+    Logger::GetInstance()->Banner() << ">>> Histogrammes et Ntuples créés" << G4endl;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// DÉBUT DE RUN - AVEC CRÉATION DU FICHIER ROOT
+// ═══════════════════════════════════════════════════════════════
+
+void RunAction::BeginOfRunAction(const G4Run* run)
+{
+    std::ostream& banner = Logger::GetInstance()->Banner();
+    banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║  DÉBUT DU RUN " << run->GetRunID() << " - CONFIGURATION SANS FILTRE              ║" << G4endl;
+    banner << "║  Source à z = " << GetSourcePosZ()/mm << " mm                                        ║" << G4endl;
+    banner << "║  Cône : " << EmissionCone::GetInstance()->GetModeName() << ", demi-angle "
+           << GetConeAngle()/deg << "°, f = " << GetSolidAngleFraction() << "            ║" << G4endl;
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    
+    // Coût de démarrage : les tables de physique sont construites à ce stade
+    if (IsMaster() && run->GetRunID() == 0) {
+        fStartupCPU_s = static_cast<G4double>(std::clock()) / CLOCKS_PER_SEC;
+        fStartupMemory_MB = ProgressReporter::GetResidentMemoryMB();
+        auto physicsList = dynamic_cast<const PhysicsList*>(
+            G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+        banner << "╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+        banner << "║  DÉMARRAGE (géométrie + tables de physique)                   ║" << G4endl;
+        banner << "║  Temps CPU          : " << std::fixed << std::setprecision(2)
+               << fStartupCPU_s << " s" << G4endl;
+        banner << "║  Mémoire résidente  : " << std::setprecision(1)
+               << fStartupMemory_MB << " MB" << G4endl;
+        if (physicsList) {
+            banner << "║  Physique           : EM " << physicsList->GetEmPhysicsName()
+                   << (physicsList->IsHadronicEnabled() ? " + hadronique FTFP_BERT" : " seule") << G4endl;
+        }
+        banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+        banner << std::defaultfloat << std::setprecision(6);
+    }
+    
+    // Graines du moteur au début du run (reproductibilité, fichier de résultats)
+    const long* seeds = G4Random::getTheSeeds();
+    fRunSeeds = {seeds[0], seeds[1]};
+    
+    // Journal par thread de travail en MT (le Logger est G4ThreadLocal)
+    if (IsMaster()) {
+        Logger::GetInstance()->Open(fLogFileName);
+    } else {
+        Logger::GetInstance()->Open(fOutputPrefix + "_t"
+                                    + std::to_string(G4Threading::G4GetThreadId()) + ".log");
+    }
+    Logger::GetInstance()->LogHeader("Démarrage du Run " + std::to_string(run->GetRunID()) + " - SANS FILTRE");
+    
+    // Anneaux construits (fixés à /run/initialize) : bornes des boucles par événement
+    auto detector = static_cast<const DetectorConstruction*>(
+        G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    fNbRings = detector->GetNbWaterRings();
+    fDoseStats.SetNbRings(fNbRings);
+    fKermaStats.SetNbRings(fNbRings);
+    fScanTallies.SetLayout(SourceScan::GetInstance()->GetNbPositions(), fNbRings);
     
     // ═══════════════════════════════════════════════════════════════
-    // CALCUL DES MASSES DES ANNEAUX D'EAU
+    // CRÉATION DU FICHIER ROOT ET DES HISTOGRAMMES
     // ═══════════════════════════════════════════════════════════════
     
-    const G4double waterThickness = 5.0 * mm;
-    const G4double ringWidth = 5.0 * mm;
-    const G4double waterDensity = 1.0 * g/cm3;
-    const G4double pi = CLHEP::pi;
+    auto analysisManager = G4AnalysisManager::Instance();
+    
+    // Configuration du manager
+    analysisManager->SetDefaultFileType("root");
+    analysisManager->SetVerboseLevel(1);
+    // MT : lignes des ntuples fusionnées dans le fichier du maître, ou un
+    // fichier <nom>_t<N>.root par thread de travail (/puits/output/perThread)
+    analysisManager->SetNtupleMerging(!fPerThreadOutput);
+    
+    // Ouvrir le fichier ROOT
+    G4bool fileOpen = analysisManager->OpenFile(fOutputFileName);
+    if (!fileOpen) {
+        G4cerr << "*** ERREUR: Impossible d'ouvrir le fichier " << fOutputFileName << G4endl;
+        return;
+    }
+    banner << ">>> Fichier ROOT ouvert: " << fOutputFileName << G4endl;
+    
+    // Histogrammes et ntuples réservés une seule fois (plusieurs runs par session)
+    if (!fHistogramsBooked) {
+        BookHistograms();
+        fHistogramsBooked = true;
+    }
+    
+    // ═══════════════════════════════════════════════════════════════
+    // MASSES DES ANNEAUX D'EAU (calculées par DetectorConstruction)
+    // ═══════════════════════════════════════════════════════════════
     
-    G4cout << "\n=== MASSES DES ANNEAUX D'EAU ===" << G4endl;
+    banner << "\n=== MASSES DES ANNEAUX D'EAU ===" << G4endl;
     LOG("=== MASSES DES ANNEAUX D'EAU ===");
     
-    for (G4int i = 0; i < DetectorConstruction::kNbWaterRings; ++i) {
-        G4double rInner = i * ringWidth;
-        G4double rOuter = (i + 1) * ringWidth;
-        G4double volume = pi * (rOuter*rOuter - rInner*rInner) * waterThickness;
-        fRingMasses[i] = (volume * waterDensity) / g;
+    fRingMasses.fill(0.);
+    for (G4int i = 0; i < fNbRings; ++i) {
+        fRingMasses[i] = detector->GetRingMass(i) / g;
         
         std::ostringstream oss;
         oss << "  Anneau " << i 
-            << " : r=[" << rInner/mm << "-" << rOuter/mm << "] mm"
-            << " | V=" << std::fixed << std::setprecision(4) << volume/cm3 << " cm³"
-            << " | m=" << fRingMasses[i] << " g";
-        G4cout << oss.str() << G4endl;
+            << " : r=[" << detector->GetRingInnerRadius(i)/mm << "-"
+            << detector->GetRingOuterRadius(i)/mm << "] mm"
+            << " | e=" << detector->GetRingThickness()/mm << " mm"
+            << " | m=" << std::fixed << std::setprecision(4) << fRingMasses[i] << " g";
+        banner << oss.str() << G4endl;
         LOG(oss.str());
     }
     
-    G4double totalMass = 0.;
-    for (const auto& m : fRingMasses) totalMass += m;
-    G4cout << "  TOTAL : " << totalMass << " g" << G4endl;
-    G4cout << "================================\n" << G4endl;
-    
-    // Réinitialiser tous les compteurs
-    fRingTotalEnergy.fill(0.);
-    fRingTotalEnergy2.fill(0.);
-    fRingEventCount.fill(0);
-    
-    for (auto& arr : fRingEnergyByLine) {
-        arr.fill(0.);
-    }
+    fTotalRingMass = 0.;
+    for (const auto& m : fRingMasses) fTotalRingMass += m;
+    banner << "  TOTAL : " << fTotalRingMass << " g" << G4endl;
+    banner << "================================\n" << G4endl;
+    banner << std::defaultfloat << std::setprecision(6);
     
-    fLineEmitted.fill(0);
-    fLineEnteredWater.fill(0);
-    fLineAbsorbedWater.fill(0);
+    // Réinitialiser tous les compteurs (RunCounters et statistiques de dose)
+    fDoseStats.SetBatchSize(fStatsBatchSize);
+    fKermaStats.SetBatchSize(fStatsBatchSize);
+    G4AccumulableManager::Instance()->Reset();
+    fRunStartCPU = std::clock();
+    fRunStartWall = std::chrono::steady_clock::now();
     
-    for (auto& arr : fLineAbsorbedByProcess) {
-        arr.fill(0);
+    // Rapport d'avancement sur minuterie (thread de fond côté maître)
+    fEventsSincePublish = 0;
+    if (IsMaster()) {
+        ProgressReporter::GetInstance()->Start(run->GetRunID(),
+                                               run->GetNumberOfEventToBeProcessed());
+        // Noyau de la plaque : relu du cache, sinon tabulé pendant ce run
+        // (avant le démarrage des threads de travail)
+        AttenuatorKernel::GetInstance()->PrepareForRun();
+        // Bibliothèque de cascades chargée avant les threads (lecture seule ensuite)
+        CascadeLibrary::GetInstance()->PrepareForRun();
+        // Cône tronqué par targetRadius : doses en borne inférieure
+        EmissionCone::GetInstance()->PrepareForRun();
+        // Positions du balayage et cône de chaque position
+        SourceScan::GetInstance()->PrepareForRun();
     }
-    
-    fTotalPrimariesGenerated = 0;
-    fTotalEventsWithZeroGamma = 0;
-    fTotalTransmitted = 0;
-    fTotalAbsorbed = 0;
-    fTotalEvents = 0;
-    fTotalWaterEnergy = 0.;
-    fTotalWaterEventCount = 0;
-    
-    fGammasEnteringContainer = 0;
-    fGammasEnteringWater = 0;
-    fElectronsInWater = 0;
-    fGammasPreContainerPlane = 0;
-    fGammasPostContainerPlane = 0;
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -335,29 +548,55 @@ void RunAction::BeginOfRunAction(const G4Run* run)
 
 void RunAction::EndOfRunAction(const G4Run* run)
 {
+    // Dernière publication AVANT la fusion des threads (le maître MT
+    // publie alors des statistiques vides, sans double comptage)
+    ProgressReporter* progress = ProgressReporter::GetInstance();
+    if (progress->IsEnabled()) {
+        progress->Publish(fProgressSlot, fDoseStats);
+    }
+    if (IsMaster()) {
+        progress->Stop();
+    }
+    
+    auto analysisManager = G4AnalysisManager::Instance();
+    
+    // Thread de travail : ses histogrammes et compteurs sont fusionnés par
+    // le maître, qui seul écrit le rapport et les fichiers de résultats
+    if (!IsMaster()) {
+        analysisManager->Write();
+        analysisManager->CloseFile();
+        Logger::GetInstance()->Close();
+        AllocationCounter::GetInstance()->FlushThread();
+        ProfilingTimers::GetInstance()->FlushThread();
+        return;
+    }
+    
     G4int nEvents = run->GetNumberOfEvent();
     if (nEvents == 0) return;
     
-    auto analysisManager = G4AnalysisManager::Instance();
+    // Fusion des compteurs et statistiques de dose des threads (no-op en séquentiel)
+    G4AccumulableManager::Instance()->Merge();
     
     // ═══════════════════════════════════════════════════════════════
     // REMPLIR LE NTUPLE gamma_lines AVEC LES STATISTIQUES PAR RAIE
+    // (maître uniquement : compteurs fusionnés)
     // ═══════════════════════════════════════════════════════════════
     
     for (G4int i = 0; i < EventAction::kNbGammaLines; ++i) {
         G4double energy_keV = EventAction::GetGammaLineEnergy(i);
-        G4double waterAbsRate = (fLineEnteredWater[i] > 0) ? 
-            100.0 * fLineAbsorbedWater[i] / fLineEnteredWater[i] : 0.0;
-        G4double waterEntryRate = (fLineEmitted[i] > 0) ?
-            100.0 * fLineEnteredWater[i] / fLineEmitted[i] : 0.0;
+        G4double waterAbsRate = (fCounters.lineEnteredWater[i] > 0) ? 
+            100.0 * fCounters.lineAbsorbedWaterWeighted[i] / fCounters.lineEnteredWater[i] : 0.0;
+        G4double waterEntryRate = (fCounters.lineEmitted[i] > 0) ?
+            100.0 * fCounters.lineEnteredWater[i] / fCounters.lineEmitted[i] : 0.0;
         
         analysisManager->FillNtupleIColumn(3, 0, i);
         analysisManager->FillNtupleDColumn(3, 1, energy_keV);
-        analysisManager->FillNtupleIColumn(3, 2, fLineEmitted[i]);
-        analysisManager->FillNtupleIColumn(3, 3, fLineEnteredWater[i]);
-        analysisManager->FillNtupleIColumn(3, 4, fLineAbsorbedWater[i]);
+        analysisManager->FillNtupleIColumn(3, 2, fCounters.lineEmitted[i]);
+        analysisManager->FillNtupleIColumn(3, 3, fCounters.lineEnteredWater[i]);
+        analysisManager->FillNtupleIColumn(3, 4, fCounters.lineAbsorbedWater[i]);
         analysisManager->FillNtupleDColumn(3, 5, waterAbsRate);
         analysisManager->FillNtupleDColumn(3, 6, waterEntryRate);
+        analysisManager->FillNtupleDColumn(3, 7, fCounters.lineAbsorbedWaterWeighted[i]);
         analysisManager->AddNtupleRow(3);
     }
     
@@ -365,7 +604,12 @@ void RunAction::EndOfRunAction(const G4Run* run)
     analysisManager->Write();
     analysisManager->CloseFile();
     
-    G4cout << "\n>>> Fichier ROOT fermé: " << fOutputFileName << G4endl;
+    Logger::GetInstance()->Banner() << "\n>>> Fichier ROOT fermé: " << fOutputFileName << G4endl;
+    
+    // Fichiers par thread : index (lu par puits_analyze) et fusion hadd
+    if (fPerThreadOutput && ThreadingConfig::GetInstance()->GetNumberOfThreads() > 1) {
+        MergePerThreadFiles();
+    }
     
     // Affichage des statistiques
     std::ostringstream oss;
@@ -374,15 +618,42 @@ void RunAction::EndOfRunAction(const G4Run* run)
     oss << "║                              FIN DU RUN " << std::setw(6) << run->GetRunID() << "                                        ║\n";
     oss << "╠═══════════════════════════════════════════════════════════════════════════════════════╣\n";
     oss << "║  Événements simulés         : " << std::setw(12) << nEvents << "                                    ║\n";
-    oss << "║  Gammas primaires générés   : " << std::setw(12) << fTotalPrimariesGenerated << "                                    ║\n";
-    oss << "║  Gammas entrant Water1      : " << std::setw(12) << fGammasEnteringContainer << "                                    ║\n";
-    oss << "║  Gammas entrant anneaux     : " << std::setw(12) << fGammasEnteringWater << "                                    ║\n";
-    oss << "║  Gammas absorbés eau        : " << std::setw(12) << fTotalAbsorbed << "                                    ║\n";
-    oss << "║  Électrons dans eau         : " << std::setw(12) << fElectronsInWater << "                                    ║\n";
-    oss << "║  Énergie totale eau (MeV)   : " << std::setw(12) << std::scientific << std::setprecision(4) << fTotalWaterEnergy/MeV << "                                ║\n";
+    oss << "║  Gammas primaires générés   : " << std::setw(12) << fCounters.primariesGenerated << "                                    ║\n";
+    oss << "║  Gammas entrant Water1      : " << std::setw(12) << fCounters.gammasEnteringContainer << "                                    ║\n";
+    oss << "║  Gammas entrant anneaux     : " << std::setw(12) << fCounters.gammasEnteringWater << "                                    ║\n";
+    oss << "║  Gammas absorbés eau        : " << std::setw(12) << fCounters.absorbed << "                                    ║\n";
+    oss << "║  Électrons dans eau         : " << std::setw(12) << fCounters.electronsInWater << "                                    ║\n";
+    oss << "║  Pas par événement          : " << std::setw(12) << std::fixed << std::setprecision(1)
+        << (nEvents > 0 ? G4double(fCounters.steps)/nEvents : 0.) << "                                    ║\n";
+    oss << "║  Énergie totale eau (MeV)   : " << std::setw(12) << std::scientific << std::setprecision(4) << fCounters.waterEnergy/MeV << "                                ║\n";
     oss << "║  Fichier ROOT               : " << std::setw(20) << fOutputFileName << "                        ║\n";
+    auto detector = dynamic_cast<const DetectorConstruction*>(
+        G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    G4bool forced = detector && detector->IsForceCollisionEnabled();
+    oss << "║  Collision forcée (anneaux) : " << std::setw(12) << (forced ? "OUI" : "non") << "                                    ║\n";
+    // Compteurs fusionnés : le maître MT n'a pas de générateur
+    G4bool stratified = fCounters.stratifiedEvents > 0;
+    oss << "║  Stratification par raie    : " << std::setw(12) << (stratified ? "OUI" : "non") << "                                    ║\n";
+    oss << "║  Source QMC (Sobol)         : " << std::setw(12) << (QmcSampling::GetInstance()->IsEnabled() ? "OUI" : "non")
+        << "  (err. par evt non valide si OUI)  ║\n";
+    const CorrelatedSampling* correlated = CorrelatedSampling::GetInstance();
+    oss << "║  Échantillonnage corrélé    : " << std::setw(12)
+        << (correlated->IsEnabled() ? "graine " + std::to_string(correlated->GetBaseSeed()) : std::string("non"))
+        << "                                    ║\n";
+    const AttenuatorKernel* attenuator = AttenuatorKernel::GetInstance();
+    G4String attenuatorMode = !attenuator->IsEnabled() ? "non"
+                            : (attenuator->IsRecording() ? "tabulation" : "noyau");
+    oss << "║  Atténuateur rapide         : " << std::setw(12) << attenuatorMode << "                                    ║\n";
+    oss << "║  Source par cascades        : " << std::setw(12)
+        << (CascadeLibrary::GetInstance()->IsEnabled() ? std::to_string(fCounters.decays) + " des." : std::string("non"))
+        << "                                    ║\n";
     oss << "╚═══════════════════════════════════════════════════════════════════════════════════════╝\n";
     
+    // Allocation réalisée sur le run, tous threads confondus
+    if (stratified) {
+        PrintStratifiedAllocation(oss);
+    }
+    
     // ═══════════════════════════════════════════════════════════════
     // TABLEAU DES STATISTIQUES PAR RAIE GAMMA
     // ═══════════════════════════════════════════════════════════════
@@ -394,14 +665,14 @@ void RunAction::EndOfRunAction(const G4Run* run)
     oss << "╠════════╬════════════╬═══════════╬═══════════════╬══════════════╬══════════════════════╣\n";
     
     for (G4int i = 0; i < EventAction::kNbGammaLines; ++i) {
-        G4double absRate = (fLineEnteredWater[i] > 0) ? 
-            100.0 * fLineAbsorbedWater[i] / fLineEnteredWater[i] : 0.0;
+        G4double absRate = (fCounters.lineEnteredWater[i] > 0) ? 
+            100.0 * fCounters.lineAbsorbedWaterWeighted[i] / fCounters.lineEnteredWater[i] : 0.0;
         
         oss << "║   " << std::setw(2) << i << "   ║"
             << std::setw(8) << std::fixed << std::setprecision(1) << EventAction::GetGammaLineEnergy(i) << " keV║"
-            << std::setw(10) << fLineEmitted[i] << " ║"
-            << std::setw(14) << fLineEnteredWater[i] << " ║"
-            << std::setw(13) << fLineAbsorbedWater[i] << " ║"
+            << std::setw(10) << fCounters.lineEmitted[i] << " ║"
+            << std::setw(14) << fCounters.lineEnteredWater[i] << " ║"
+            << std::setw(13) << std::setprecision(1) << fCounters.lineAbsorbedWaterWeighted[i] << " ║"
             << std::setw(20) << std::setprecision(2) << absRate << " ║\n";
     }
     oss << "╚════════╩════════════╩═══════════╩═══════════════╩══════════════╩══════════════════════╝\n";
@@ -413,23 +684,97 @@ void RunAction::EndOfRunAction(const G4Run* run)
     oss << "║ Anneau  ║  r_int-r_ext  ║   Masse (g)   ║   Energie (MeV)   ║     Dose (nGy/evt)      ║\n";
     oss << "╠═════════╬═══════════════╬═══════════════╬═══════════════════╬═════════════════════════╣\n";
     
-    for (G4int i = 0; i < DetectorConstruction::kNbWaterRings; ++i) {
-        G4double rIn = i * 5.0;
-        G4double rOut = (i + 1) * 5.0;
+    for (G4int i = 0; i < fNbRings; ++i) {
+        G4double rIn = detector->GetRingInnerRadius(i) / mm;
+        G4double rOut = detector->GetRingOuterRadius(i) / mm;
         G4double mass_g = fRingMasses[i];
-        G4double energy_MeV = fRingTotalEnergy[i] / MeV;
+        G4double energy_MeV = fCounters.ringEnergy[i] / MeV;
         G4double dosePerEvt_nGy = EnergyToNanoGray(energy_MeV, mass_g) / nEvents;
         
-        oss << "║    " << i << "    ║   "
-            << std::setw(2) << std::fixed << std::setprecision(0) << rIn << " - " 
-            << std::setw(2) << rOut << " mm   ║"
+        oss << "║ " << std::setw(5) << i << "   ║ "
+            << std::setw(5) << std::fixed << std::setprecision(2) << rIn << "-"
+            << std::setw(5) << rOut << " mm║"
             << std::setw(13) << std::setprecision(4) << mass_g << "  ║"
             << std::setw(17) << std::scientific << std::setprecision(3) << energy_MeV << "  ║"
             << std::setw(23) << dosePerEvt_nGy << "  ║\n";
     }
     oss << "╚═════════╩═══════════════╩═══════════════╩═══════════════════╩═════════════════════════╝\n";
     
-    G4cout << oss.str();
+    // ═══════════════════════════════════════════════════════════════
+    // RENORMALISATION TEMPORELLE (cône partagé avec le générateur)
+    // ═══════════════════════════════════════════════════════════════
+    
+    G4double fraction = GetSolidAngleFraction();
+    G4double irradiationTime = CalculateIrradiationTime(nEvents);
+    
+    oss << "\n╔═══════════════════════════════════════════════════════════════════════════════════════╗\n";
+    oss << "║                  RENORMALISATION SPATIALE ET TEMPORELLE                               ║\n";
+    oss << "╠═══════════════════════════════════════════════════════════════════════════════════════╣\n";
+    oss << "║  Activité (4π)              : " << std::setw(12) << std::fixed << std::setprecision(0) << fActivity4pi << " Bq                                 ║\n";
+    if (SourceScan::GetInstance()->IsEnabled()) {
+        // Une fraction f par position : pas de T_irr global pour le run
+        oss << "║  Balayage de positions      : f et T_irr globaux non applicables                      ║\n";
+        oss << "║  Débit par position : tableau BALAYAGE DE POSITIONS (dose/evt × f(position) × A)      ║\n";
+        oss << "╚═══════════════════════════════════════════════════════════════════════════════════════╝\n";
+    } else {
+        oss << "║  Mode du cône               : " << std::setw(12) << EmissionCone::GetInstance()->GetModeName() << "                                    ║\n";
+        oss << "║  Demi-angle θ               : " << std::setw(12) << std::setprecision(3) << GetConeAngle()/deg << " deg                                ║\n";
+        oss << "║  Angle solide Ω             : " << std::setw(12) << std::setprecision(4) << 4. * CLHEP::pi * fraction << " sr                                 ║\n";
+        oss << "║  Fraction de 4π (f)         : " << std::setw(12) << std::setprecision(5) << fraction << "                                    ║\n";
+        oss << "║  T_irr = N / (f × A)        : " << std::setw(12) << std::setprecision(3) << irradiationTime << " s                                  ║\n";
+        oss << "╚═══════════════════════════════════════════════════════════════════════════════════════╝\n";
+    }
+    
+    PrintDoseStatistics(oss, true);
+    if (KermaScoring::GetInstance()->IsEnabled()) {
+        PrintKermaComparison(oss);
+    }
+    
+    // Balayage : dose et débit de dose par position de source
+    if (SourceScan::GetInstance()->IsEnabled()) {
+        PrintScanResults(oss);
+    }
+    
+    // Étude QMC : ce run est une réplique du générateur courant
+    QmcSampling* qmc = QmcSampling::GetInstance();
+    if (qmc->IsStudyEnabled()) {
+        G4double cpuTime = GetElapsedCPUTime();
+        std::vector<G4double> ringMeans;
+        for (G4int i = 0; i < fDoseStats.GetNbRings(); ++i) {
+            ringMeans.push_back(fDoseStats.GetSummary(i, cpuTime).mean);
+        }
+        qmc->RecordReplicate(ringMeans, cpuTime);
+        qmc->PrintStudy(oss);
+    }
+    
+    // Sous-run monoénergétique : une ligne de la matrice de réponse
+    if (ResponseMatrix::GetInstance()->IsEnabled()) {
+        RecordResponse(nEvents);
+    }
+    
+    // Run de tabulation : écriture du cache, modèle rapide actif au run suivant
+    AttenuatorKernel::GetInstance()->FinishRun();
+    
+    // Allocations de la boucle d'événements (option PUITS_COUNT_ALLOCATIONS)
+    if (AllocationCounter::IsCompiled()) {
+        AllocationCounter* allocations = AllocationCounter::GetInstance();
+        allocations->FlushThread();
+        allocations->Report(oss);
+    }
+    
+    // Répartition du temps entre actions utilisateur et transport (option PUITS_PROFILING)
+    if (ProfilingTimers::IsCompiled()) {
+        ProfilingTimers* profiling = ProfilingTimers::GetInstance();
+        profiling->FlushThread();
+        profiling->Report(oss);
+    }
+    
+    // Résultats lisibles par machine (à la place de l'analyse des tableaux)
+    if (fWriteResults) {
+        WriteResults(run);
+    }
+    
+    Logger::GetInstance()->Banner() << oss.str();
     
     if (Logger::GetInstance()->IsOpen()) {
         Logger::GetInstance()->GetStream() << oss.str();
@@ -443,98 +788,152 @@ void RunAction::EndOfRunAction(const G4Run* run)
 
 void RunAction::AddRingEnergy(G4int ringIndex, G4double edep)
 {
-    if (ringIndex >= 0 && ringIndex < DetectorConstruction::kNbWaterRings) {
-        fRingTotalEnergy[ringIndex] += edep;
-        fRingTotalEnergy2[ringIndex] += edep * edep;
-        fRingEventCount[ringIndex]++;
-        fTotalWaterEnergy += edep;
+    if (ringIndex >= 0 && ringIndex < fNbRings) {
+        fCounters.ringEnergy[ringIndex] += edep;
+        fCounters.waterEnergy += edep;
+    }
+}
+
+void RunAction::RecordRingDoses(const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringDeposits)
+{
+    PUITS_PROFILE_SCOPE(kDoseStatistics);
+    std::array<G4double, DetectorConstruction::kMaxWaterRings> dose_nGy;
+    for (G4int i = 0; i < fNbRings; ++i) {
+        dose_nGy[i] = (ringDeposits[i] > 0. && fRingMasses[i] > 0.)
+                      ? EnergyToNanoGray(ringDeposits[i] / MeV, fRingMasses[i]) : 0.;
+    }
+    fDoseStats.Fill(dose_nGy.data());
+    
+    // Publication pour le rapport d'avancement (pas d'horloge par événement)
+    if (++fEventsSincePublish == ProgressReporter::kPublishInterval) {
+        fEventsSincePublish = 0;
+        ProgressReporter* progress = ProgressReporter::GetInstance();
+        if (progress->IsEnabled()) {
+            progress->Publish(fProgressSlot, fDoseStats);
+        }
+    }
+    
+    // Rapport intermédiaire (statistiques du thread courant)
+    if (fStatsReportEvery > 0 && fDoseStats.GetNbEvents() % fStatsReportEvery == 0) {
+        std::ostringstream oss;
+        PrintDoseStatistics(oss, false);
+        G4cout << oss.str() << G4endl;
+        LOG(oss.str());
+    }
+}
+
+void RunAction::RecordRingKerma(const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringKerma)
+{
+    PUITS_PROFILE_SCOPE(kDoseStatistics);
+    std::array<G4double, DetectorConstruction::kMaxWaterRings> kerma_nGy;
+    for (G4int i = 0; i < fNbRings; ++i) {
+        kerma_nGy[i] = (ringKerma[i] > 0. && fRingMasses[i] > 0.)
+                       ? EnergyToNanoGray(ringKerma[i] / MeV, fRingMasses[i]) : 0.;
     }
+    fKermaStats.Fill(kerma_nGy.data());
 }
 
 void RunAction::AddRingEnergyByLine(G4int ringIndex, G4int lineIndex, G4double edep)
 {
-    if (ringIndex >= 0 && ringIndex < DetectorConstruction::kNbWaterRings &&
+    if (ringIndex >= 0 && ringIndex < fNbRings &&
         lineIndex >= 0 && lineIndex < EventAction::kNbGammaLines) {
-        fRingEnergyByLine[ringIndex][lineIndex] += edep;
+        fCounters.ringEnergyByLine[ringIndex][lineIndex] += edep;
     }
 }
 
 void RunAction::RecordGammaLineStatistics(G4int lineIndex, G4bool enteredWater, 
-                                           G4bool absorbedInWater, G4int absorptionProcess)
+                                           G4bool absorbedInWater, G4int absorptionProcess,
+                                           G4double absorbedWeight)
 {
     if (lineIndex >= 0 && lineIndex < EventAction::kNbGammaLines) {
-        fLineEmitted[lineIndex]++;
+        fCounters.lineEmitted[lineIndex]++;
         
         if (enteredWater) {
-            fLineEnteredWater[lineIndex]++;
+            fCounters.lineEnteredWater[lineIndex]++;
         }
         
         if (absorbedInWater) {
-            fLineAbsorbedWater[lineIndex]++;
+            fCounters.lineAbsorbedWater[lineIndex]++;
+            fCounters.lineAbsorbedWaterWeighted[lineIndex] += absorbedWeight;
             
             if (absorptionProcess >= 0 && absorptionProcess < EventAction::kNbProcesses) {
-                fLineAbsorbedByProcess[lineIndex][absorptionProcess]++;
+                fCounters.lineAbsorbedByProcess[lineIndex][absorptionProcess]++;
             }
         }
     }
 }
 
 void RunAction::RecordEventStatistics(G4int nPrimaries, 
-                                       const std::vector<G4double>& /*primaryEnergies*/,
                                        G4int nTransmitted, G4int nAbsorbed,
                                        G4double totalDeposit,
-                                       const std::array<G4double, DetectorConstruction::kNbWaterRings>& ringDeposits)
+                                       const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringDeposits)
 {
-    fTotalEvents++;
-    fTotalPrimariesGenerated += nPrimaries;
-    fTotalTransmitted += nTransmitted;
-    fTotalAbsorbed += nAbsorbed;
+    fCounters.events++;
+    fCounters.primariesGenerated += nPrimaries;
+    fCounters.transmitted += nTransmitted;
+    fCounters.absorbed += nAbsorbed;
     
     if (nPrimaries == 0) {
-        fTotalEventsWithZeroGamma++;
+        fCounters.eventsWithZeroGamma++;
     }
     
     if (totalDeposit > 0.) {
-        fTotalWaterEventCount++;
+        fCounters.waterEventCount++;
         
         // ═══════════════════════════════════════════════════════════════
         // REMPLIR LES HISTOGRAMMES DE DOSE PAR ÉVÉNEMENT
         // ═══════════════════════════════════════════════════════════════
         
+        PUITS_PROFILE_SCOPE(kHistogramFill);
+        PUITS_ALLOCATION_ANALYSIS();
         auto analysisManager = G4AnalysisManager::Instance();
         
         G4double totalDose_nGy = 0.;
-        G4double totalMass = 0.;
-        for (G4int i = 0; i < DetectorConstruction::kNbWaterRings; ++i) {
-            totalMass += fRingMasses[i];
-        }
         
-        for (G4int i = 0; i < DetectorConstruction::kNbWaterRings; ++i) {
+        for (G4int i = 0; i < fNbRings; ++i) {
             if (ringDeposits[i] > 0. && fRingMasses[i] > 0.) {
                 G4double dose_nGy = EnergyToNanoGray(ringDeposits[i] / MeV, fRingMasses[i]);
-                analysisManager->FillH1(10 + i, dose_nGy);
+                analysisManager->FillH1(fDoseRingFirstH1 + i, dose_nGy);
                 totalDose_nGy += ringDeposits[i] / MeV * kNanoGrayFactor;  // Non pondéré par masse pour le total
             }
         }
         
         // Dose totale pondérée par les masses
-        if (totalMass > 0.) {
-            G4double totalDoseWeighted = EnergyToNanoGray(totalDeposit / MeV, totalMass);
-            analysisManager->FillH1(15, totalDoseWeighted);
+        if (fTotalRingMass > 0.) {
+            G4double totalDoseWeighted = EnergyToNanoGray(totalDeposit / MeV, fTotalRingMass);
+            analysisManager->FillH1(fDoseTotalH1, totalDoseWeighted);
         }
     }
 }
 
-void RunAction::RecordContainerPlaneStatistics(
-    G4int /*preNPhotons*/, G4double /*preSumEPhotons*/,
-    G4int /*preNElectrons*/, G4double /*preSumEElectrons*/,
-    G4int /*postNPhotonsBack*/, G4double /*postSumEPhotonsBack*/,
-    G4int /*postNElectronsBack*/, G4double /*postSumEElectronsBack*/,
-    G4int /*postNPhotonsFwd*/, G4double /*postSumEPhotonsFwd*/,
-    G4int /*postNElectronsFwd*/, G4double /*postSumEElectronsFwd*/)
+void RunAction::AddPlaneTally(G4int tallyIndex, G4int count, G4double sumEnergy,
+                              G4double weightedCount, G4double weightedEnergy)
+{
+    fCounters.planeCounts[tallyIndex] += count;
+    fCounters.planeEnergy[tallyIndex] += sumEnergy;
+    fCounters.planeWeightedCounts[tallyIndex] += weightedCount;
+    fCounters.planeWeightedEnergy[tallyIndex] += weightedEnergy;
+}
+
+void RunAction::RecordStratifiedLine(G4int lineIndex, G4double weight)
 {
-    // Statistiques additionnelles si nécessaire
-    // Les compteurs principaux sont incrémentés via IncrementXXX()
+    if (lineIndex < 0 || lineIndex >= EventAction::kNbGammaLines) return;
+    fCounters.stratifiedEvents++;
+    fCounters.stratLineEvents[lineIndex]++;
+    fCounters.stratLineWeight[lineIndex] += weight;
+}
+
+void RunAction::RecordScanEvent(G4int position,
+                                const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringDeposits,
+                                G4long decays)
+{
+    PUITS_PROFILE_SCOPE(kDoseStatistics);
+    std::array<G4double, DetectorConstruction::kMaxWaterRings> dose_nGy;
+    for (G4int i = 0; i < fNbRings; ++i) {
+        dose_nGy[i] = (ringDeposits[i] > 0. && fRingMasses[i] > 0.)
+                      ? EnergyToNanoGray(ringDeposits[i] / MeV, fRingMasses[i]) : 0.;
+    }
+    fScanTallies.FillEvent(position, dose_nGy.data(), decays);
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -543,51 +942,82 @@ void RunAction::RecordContainerPlaneStatistics(
 
 void RunAction::FillGammaEmittedSpectrum(G4double energy_keV)
 {
+    PUITS_PROFILE_SCOPE(kHistogramFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
     analysisManager->FillH1(0, energy_keV);
 }
 
 void RunAction::FillGammaEnteringWater(G4double energy_keV)
 {
+    PUITS_PROFILE_SCOPE(kHistogramFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
     analysisManager->FillH1(1, energy_keV);
 }
 
-void RunAction::FillEdepWater(G4double edep_keV)
+void RunAction::FillEdepWater(G4double edep_keV, G4double weight)
 {
+    PUITS_PROFILE_SCOPE(kHistogramFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
-    analysisManager->FillH1(2, edep_keV);
+    analysisManager->FillH1(2, edep_keV, weight);
 }
 
-void RunAction::FillEdepRing(G4int ringID, G4double edep_keV)
+void RunAction::FillEdepRing(G4int ringID, G4double edep_keV, G4double weight)
 {
-    if (ringID < 0 || ringID > 4) return;
+    if (ringID < 0 || ringID >= fNbRings) {
+        G4ExceptionDescription description;
+        description << "Anneau " << ringID << " hors des " << fNbRings
+                    << " anneaux construits : histogramme hEdepRing absent";
+        G4Exception("RunAction::FillEdepRing", "Run001", FatalException, description);
+        return;
+    }
+    PUITS_PROFILE_SCOPE(kHistogramFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
-    analysisManager->FillH1(3 + ringID, edep_keV);
+    analysisManager->FillH1(fEdepRingFirstH1 + ringID, edep_keV, weight);
 }
 
-void RunAction::FillElectronSpectrum(G4double energy_keV)
+void RunAction::FillElectronSpectrum(G4double energy_keV, G4double weight)
 {
+    PUITS_PROFILE_SCOPE(kHistogramFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
-    analysisManager->FillH1(9, energy_keV);
+    analysisManager->FillH1(fElectronSpectrumH1, energy_keV, weight);
+}
+
+void RunAction::FillPlaneSpectrum(G4int tallyIndex, G4double energy_keV, G4double weight)
+{
+    PUITS_PROFILE_SCOPE(kHistogramFill);
+    PUITS_ALLOCATION_ANALYSIS();
+    auto analysisManager = G4AnalysisManager::Instance();
+    analysisManager->FillH1(fPlaneSpectrumFirstH1 + tallyIndex, energy_keV, weight);
 }
 
 void RunAction::FillEdepXY(G4double x_mm, G4double y_mm, G4double weight)
 {
+    PUITS_PROFILE_SCOPE(kHistogramFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
     analysisManager->FillH2(0, x_mm, y_mm, weight);
 }
 
 void RunAction::FillEdepRZ(G4double r_mm, G4double z_mm, G4double weight)
 {
+    PUITS_PROFILE_SCOPE(kHistogramFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
     analysisManager->FillH2(1, r_mm, z_mm, weight);
 }
 
 void RunAction::FillStepNtuple(G4int eventID, G4double x, G4double y, G4double z, 
                                G4double edep, G4int ringID, 
-                               const G4String& particleName, const G4String& processName)
+                               const G4String& particleName, const G4String& processName,
+                               G4double weight)
 {
+    PUITS_PROFILE_SCOPE(kNtupleFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
     analysisManager->FillNtupleIColumn(1, 0, eventID);
     analysisManager->FillNtupleDColumn(1, 1, x);
@@ -597,6 +1027,7 @@ void RunAction::FillStepNtuple(G4int eventID, G4double x, G4double y, G4double z
     analysisManager->FillNtupleIColumn(1, 5, ringID);
     analysisManager->FillNtupleSColumn(1, 6, particleName);
     analysisManager->FillNtupleSColumn(1, 7, processName);
+    analysisManager->FillNtupleDColumn(1, 8, weight);
     analysisManager->AddNtupleRow(1);
 }
 
@@ -608,6 +1039,8 @@ void RunAction::FillPreContainerNtuple(G4int eventID,
                                         G4int nPhotons, G4double sumEPhotons_keV,
                                         G4int nElectrons, G4double sumEElectrons_keV)
 {
+    PUITS_PROFILE_SCOPE(kNtupleFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
     analysisManager->FillNtupleIColumn(4, 0, eventID);
     analysisManager->FillNtupleIColumn(4, 1, nPhotons);
@@ -623,6 +1056,8 @@ void RunAction::FillPostContainerNtuple(G4int eventID,
                                          G4int nElectrons_fwd, G4double sumEElectrons_fwd_keV,
                                          G4int nElectrons_back, G4double sumEElectrons_back_keV)
 {
+    PUITS_PROFILE_SCOPE(kNtupleFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
     analysisManager->FillNtupleIColumn(5, 0, eventID);
     analysisManager->FillNtupleIColumn(5, 1, nPhotons_fwd);
@@ -637,40 +1072,574 @@ void RunAction::FillPostContainerNtuple(G4int eventID,
 }
 
 void RunAction::FillDosesNtuple(G4int eventID,
-                                 const std::array<G4double, DetectorConstruction::kNbWaterRings>& ringDeposits,
+                                 const std::array<G4double, DetectorConstruction::kMaxWaterRings>& ringDeposits,
                                  G4double totalDeposit,
                                  G4int nPrimaries, G4int nTransmitted, G4int nAbsorbed)
 {
+    PUITS_PROFILE_SCOPE(kNtupleFill);
+    PUITS_ALLOCATION_ANALYSIS();
     auto analysisManager = G4AnalysisManager::Instance();
     
-    // Calculer les doses en nGy pour chaque anneau
-    G4double dose_nGy[DetectorConstruction::kNbWaterRings];
+    // Remplir le ntuple (ID = 6) : doses en nGy pour chaque anneau (col 1..N)
+    analysisManager->FillNtupleIColumn(6, 0, eventID);
     G4double totalDose_nGy = 0.;
     
-    for (G4int i = 0; i < DetectorConstruction::kNbWaterRings; ++i) {
+    for (G4int i = 0; i < fNbRings; ++i) {
+        G4double dose_nGy = 0.;
         if (ringDeposits[i] > 0. && fRingMasses[i] > 0.) {
-            dose_nGy[i] = EnergyToNanoGray(ringDeposits[i] / MeV, fRingMasses[i]);
-        } else {
-            dose_nGy[i] = 0.;
+            dose_nGy = EnergyToNanoGray(ringDeposits[i] / MeV, fRingMasses[i]);
         }
-        totalDose_nGy += dose_nGy[i];
+        analysisManager->FillNtupleDColumn(6, 1 + i, dose_nGy);
+        totalDose_nGy += dose_nGy;
     }
     
-    // Remplir le ntuple (ID = 6)
-    analysisManager->FillNtupleIColumn(6, 0, eventID);
-    analysisManager->FillNtupleDColumn(6, 1, dose_nGy[0]);
-    analysisManager->FillNtupleDColumn(6, 2, dose_nGy[1]);
-    analysisManager->FillNtupleDColumn(6, 3, dose_nGy[2]);
-    analysisManager->FillNtupleDColumn(6, 4, dose_nGy[3]);
-    analysisManager->FillNtupleDColumn(6, 5, dose_nGy[4]);
-    analysisManager->FillNtupleDColumn(6, 6, totalDose_nGy);
-    analysisManager->FillNtupleDColumn(6, 7, totalDeposit / keV);
-    analysisManager->FillNtupleIColumn(6, 8, nPrimaries);
-    analysisManager->FillNtupleIColumn(6, 9, nTransmitted);
-    analysisManager->FillNtupleIColumn(6, 10, nAbsorbed);
+    const G4int col = fNbRings + 1;
+    analysisManager->FillNtupleDColumn(6, col, totalDose_nGy);
+    analysisManager->FillNtupleDColumn(6, col + 1, totalDeposit / keV);
+    analysisManager->FillNtupleIColumn(6, col + 2, nPrimaries);
+    analysisManager->FillNtupleIColumn(6, col + 3, nTransmitted);
+    analysisManager->FillNtupleIColumn(6, col + 4, nAbsorbed);
     analysisManager->AddNtupleRow(6);
 }
 
+// ═══════════════════════════════════════════════════════════════
+// INCERTITUDES ET FIGURE DE MÉRITE
+// ═══════════════════════════════════════════════════════════════
+
+G4double RunAction::GetElapsedCPUTime() const
+{
+    return static_cast<G4double>(std::clock() - fRunStartCPU) / CLOCKS_PER_SEC;
+}
+
+void RunAction::PrintDoseStatistics(std::ostream& os, G4bool finalReport) const
+{
+    G4double cpuTime = GetElapsedCPUTime();
+    
+    std::ostringstream oss;
+    if (finalReport) {
+        oss << "\n╔═══════════════════════════════════════════════════════════════════════════════════════╗\n";
+        oss << "║                    INCERTITUDES SUR LA DOSE PAR ANNEAU (Welford + lots)               ║\n";
+    } else {
+        oss << "\n╔═══════════════════════════════════════════════════════════════════════════════════════╗\n";
+        oss << "║  RAPPORT INTERMÉDIAIRE - " << std::setw(12) << fDoseStats.GetNbEvents()
+            << " événements - CPU " << std::setw(10) << std::fixed << std::setprecision(1)
+            << cpuTime << " s                  ║\n";
+    }
+    oss << "╠═════════╦═════════════════╦═════════════════╦═══════════╦═════════════════╦═══════════╣\n";
+    oss << "║ Anneau  ║ Dose (nGy/evt)  ║  Err. std (nGy) ║ Err. rel. ║  FOM (1/s)      ║   Lots    ║\n";
+    oss << "╠═════════╬═════════════════╬═════════════════╬═══════════╬═════════════════╬═══════════╣\n";
+    
+    for (G4int i = 0; i < fDoseStats.GetNbRings(); ++i) {
+        RingDoseStatistics::Summary s = fDoseStats.GetSummary(i, cpuTime);
+        oss << "║    " << i << "    ║"
+            << std::setw(15) << std::scientific << std::setprecision(4) << s.mean << "  ║"
+            << std::setw(15) << s.sigmaMean << "  ║"
+            << std::setw(8) << std::fixed << std::setprecision(3) << 100. * s.relError << " % ║"
+            << std::setw(15) << std::scientific << std::setprecision(4) << s.fom << "  ║"
+            << std::setw(9) << s.nBatches << "  ║\n";
+    }
+    oss << "╠═════════╩═════════════════╩═════════════════╩═══════════╩═════════════════╩═══════════╣\n";
+    oss << "║  Err. std : moyennes de lots de " << std::setw(8) << fDoseStats.GetBatchSize()
+        << " evt si >= " << RingDoseStatistics::kMinBatches << " lots, sinon Welford                       ║\n";
+    oss << "║  FOM = 1 / (err.rel² × T_CPU)                                                         ║\n";
+    oss << "╚═══════════════════════════════════════════════════════════════════════════════════════╝\n";
+    
+    os << oss.str();
+}
+
+void RunAction::PrintStratifiedAllocation(std::ostream& os) const
+{
+    // q réalisé : fraction des événements du run tirés dans la raie (moyenne
+    // sur les lots pilotes et les threads) ; poids moyen p/q des événements
+    std::ostringstream oss;
+    oss << "\n╔═══════════════════════════════════════════════════════════════════════════════════════╗\n";
+    oss << "║                 ALLOCATION STRATIFIÉE PAR RAIE (réalisée sur le run)                  ║\n";
+    oss << "╠════════╦════════════╦════════════╦════════════╦══════════════╦═══════════════════════╣\n";
+    oss << "║  Raie  ║ Energie    ║  p (désint)║  q (alloc) ║  Poids p/q   ║   Photons simulés     ║\n";
+    oss << "╠════════╬════════════╬════════════╬════════════╬══════════════╬═══════════════════════╣\n";
+    for (G4int k = 0; k < EventAction::kNbGammaLines; ++k) {
+        G4long n = fCounters.stratLineEvents[k];
+        G4double q = static_cast<G4double>(n) / fCounters.stratifiedEvents;
+        G4double meanWeight = (n > 0) ? fCounters.stratLineWeight[k] / n : 0.;
+        oss << "║   " << std::setw(2) << k << "   ║"
+            << std::setw(8) << std::fixed << std::setprecision(1) << Eu152::kLineEnergies_keV[k] << " keV║"
+            << std::setw(11) << std::setprecision(4) << Eu152::kLineIntensities_pct[k] / 100. << " ║"
+            << std::setw(11) << q << " ║"
+            << std::setw(13) << std::setprecision(3) << meanWeight << " ║"
+            << std::setw(22) << n << " ║\n";
+    }
+    oss << "╚════════╩════════════╩════════════╩════════════╩══════════════╩═══════════════════════╝\n";
+    oss << std::defaultfloat << std::setprecision(6);
+    
+    os << oss.str();
+}
+
+void RunAction::PrintKermaComparison(std::ostream& os) const
+{
+    G4double cpuTime = GetElapsedCPUTime();
+    
+    std::ostringstream oss;
+    oss << "\n╔═══════════════════════════════════════════════════════════════════════════════════════╗\n";
+    oss << "║           DOSE (DÉPÔT) ET KERMA DE COLLISION (LONGUEUR DE TRACE) PAR ANNEAU           ║\n";
+    oss << "╠═════════╦═════════════════╦═══════════╦═════════════════╦═══════════╦═════════════════╣\n";
+    oss << "║ Anneau  ║ Dose (nGy/evt)  ║ Err. rel. ║ Kerma (nGy/evt) ║ Err. rel. ║  K/D  (FOM K/D) ║\n";
+    oss << "╠═════════╬═════════════════╬═══════════╬═════════════════╬═══════════╬═════════════════╣\n";
+    
+    for (G4int i = 0; i < fDoseStats.GetNbRings(); ++i) {
+        RingDoseStatistics::Summary d = fDoseStats.GetSummary(i, cpuTime);
+        RingDoseStatistics::Summary k = fKermaStats.GetSummary(i, cpuTime);
+        G4double ratio = (d.mean > 0.) ? k.mean / d.mean : 0.;
+        G4double fomGain = (d.fom > 0.) ? k.fom / d.fom : 0.;
+        oss << "║    " << i << "    ║"
+            << std::setw(15) << std::scientific << std::setprecision(4) << d.mean << "  ║"
+            << std::setw(8) << std::fixed << std::setprecision(3) << 100. * d.relError << " % ║"
+            << std::setw(15) << std::scientific << std::setprecision(4) << k.mean << "  ║"
+            << std::setw(8) << std::fixed << std::setprecision(3) << 100. * k.relError << " % ║"
+            << std::setw(6) << std::setprecision(3) << ratio << " ("
+            << std::setw(7) << std::setprecision(1) << fomGain << ") ║\n";
+    }
+    oss << "╠═════════╩═════════════════╩═══════════╩═════════════════╩═══════════╩═════════════════╣\n";
+    oss << "║  Kerma = Σ w·E·ℓ·µen/ρ(E)·ρ sur les pas de photons / masse de l'anneau               ║\n";
+    oss << "║  Transport des électrons dans les anneaux : "
+        << std::setw(3) << (KermaScoring::GetInstance()->IsElectronTransportEnabled() ? "OUI" : "non")
+        << "                                       ║\n";
+    oss << "╚═══════════════════════════════════════════════════════════════════════════════════════╝\n";
+    
+    os << oss.str();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// BALAYAGE DE POSITIONS DE SOURCE (/puits/scan/)
+// ═══════════════════════════════════════════════════════════════
+
+G4double RunAction::GetScanSolidAngleFraction(G4int position) const
+{
+    // Mode cascades : comme GetSolidAngleFraction, position par position
+    if (CascadeLibrary::GetInstance()->IsEnabled() && !ResponseMatrix::GetInstance()->IsEnabled()) {
+        G4long decays = fScanTallies.GetDecays(position);
+        return (decays > 0) ? static_cast<G4double>(fScanTallies.GetEvents(position)) / decays : 1.;
+    }
+    return SourceScan::GetInstance()->GetSolidAngleFraction(position);
+}
+
+void RunAction::PrintScanResults(std::ostream& os) const
+{
+    const SourceScan* scan = SourceScan::GetInstance();
+    
+    std::ostringstream oss;
+    oss << "\n╔═══════════════════════════════════════════════════════════════════════════════════════╗\n";
+    oss << "║                  BALAYAGE DE POSITIONS : DOSE PAR POSITION DE SOURCE                  ║\n";
+    oss << "╠══════╦══════════╦══════════╦══════════╦════════╦═════════════════╦═══════════╦════════╣\n";
+    oss << "║ Pos. ║  d (mm)  ║ rho (mm) ║    N     ║ Anneau ║ Dose (nGy/evt)  ║ Err. rel. ║ nGy/s  ║\n";
+    oss << "╠══════╬══════════╬══════════╬══════════╬════════╬═════════════════╬═══════════╬════════╣\n";
+    
+    for (G4int p = 0; p < fScanTallies.GetNbPositions(); ++p) {
+        const SourceScan::Position& position = scan->GetPosition(p);
+        G4double rho = std::hypot(position.x, position.y);
+        G4double activityInCone = fActivity4pi * GetScanSolidAngleFraction(p);
+        for (G4int i = 0; i < fScanTallies.GetNbRings(); ++i) {
+            G4double mean = fScanTallies.GetMeanDose(p, i);
+            G4double relError = (mean > 0.) ? fScanTallies.GetSemDose(p, i) / mean : 0.;
+            oss << "║ " << std::setw(4) << p << " ║"
+                << std::setw(9) << std::fixed << std::setprecision(2) << position.distance/mm << " ║"
+                << std::setw(9) << rho/mm << " ║"
+                << std::setw(9) << fScanTallies.GetEvents(p) << " ║"
+                << std::setw(7) << i << " ║"
+                << std::setw(15) << std::scientific << std::setprecision(4) << mean << "  ║"
+                << std::setw(8) << std::fixed << std::setprecision(3) << 100. * relError << " % ║"
+                << std::setw(7) << std::scientific << std::setprecision(1) << mean * activityInCone << " ║\n";
+        }
+    }
+    oss << "╠══════╩══════════╩══════════╩══════════╩════════╩═════════════════╩═══════════╩════════╣\n";
+    oss << "║  Débit = dose/evt × f(position) × A : T_irr normalisé position par position           ║\n";
+    oss << "╚═══════════════════════════════════════════════════════════════════════════════════════╝\n";
+    oss << std::defaultfloat << std::setprecision(6);
+    
+    os << oss.str();
+}
+
+void RunAction::WriteScanResults() const
+{
+    const SourceScan* scan = SourceScan::GetInstance();
+    
+    // <préfixe>_scan.csv : une ligne par position et par anneau
+    std::ofstream doses(fOutputPrefix + "_scan.csv");
+    doses << "position,x_mm,y_mm,distance_mm,source_z_mm,cone_half_angle_deg,solid_angle_fraction,"
+             "events,decays,ring,dose_nGy_per_evt,sem_nGy,dose_rate_nGy_per_s,sem_rate_nGy_per_s\n";
+    doses << std::setprecision(10);
+    for (G4int p = 0; p < fScanTallies.GetNbPositions(); ++p) {
+        const SourceScan::Position& position = scan->GetPosition(p);
+        G4double fraction = GetScanSolidAngleFraction(p);
+        G4double activityInCone = fActivity4pi * fraction;
+        for (G4int i = 0; i < fScanTallies.GetNbRings(); ++i) {
+            G4double mean = fScanTallies.GetMeanDose(p, i);
+            G4double sem = fScanTallies.GetSemDose(p, i);
+            doses << p << "," << position.x/mm << "," << position.y/mm << "," << position.distance/mm
+                  << "," << scan->GetSourcePosition(p).z()/mm << "," << scan->GetHalfAngle(p)/deg
+                  << "," << fraction << "," << fScanTallies.GetEvents(p) << "," << fScanTallies.GetDecays(p)
+                  << "," << i << "," << mean << "," << sem
+                  << "," << mean * activityInCone << "," << sem * activityInCone << "\n";
+        }
+    }
+    
+    // <préfixe>_scan_lines.csv : une ligne par position et par raie
+    std::ofstream lines(fOutputPrefix + "_scan_lines.csv");
+    lines << "position,line,energy_keV,emitted,entered_water,absorbed_water,absorbed_water_w\n";
+    lines << std::setprecision(10);
+    for (G4int p = 0; p < fScanTallies.GetNbPositions(); ++p) {
+        for (G4int l = 0; l < EventAction::kNbGammaLines; ++l) {
+            lines << p << "," << l << "," << EventAction::GetGammaLineEnergy(l)
+                  << "," << fScanTallies.GetLineEmitted(p, l) << "," << fScanTallies.GetLineEntered(p, l)
+                  << "," << fScanTallies.GetLineAbsorbed(p, l) << "," << fScanTallies.GetLineAbsorbedWeighted(p, l)
+                  << "\n";
+        }
+    }
+    
+    // <préfixe>_scan_planes.csv : une ligne par position et par comptage de plan
+    std::ofstream planes(fOutputPrefix + "_scan_planes.csv");
+    planes << "position,tally,name,count,sumE_keV,count_w,sumE_w_keV\n";
+    planes << std::setprecision(10);
+    for (G4int p = 0; p < fScanTallies.GetNbPositions(); ++p) {
+        for (G4int t = 0; t < PlaneSD::kNbTallies; ++t) {
+            planes << p << "," << t << "," << PlaneSD::GetTallyName(t)
+                   << "," << fScanTallies.GetPlaneCount(p, t) << "," << fScanTallies.GetPlaneEnergy(p, t)/keV
+                   << "," << fScanTallies.GetPlaneWeightedCount(p, t)
+                   << "," << fScanTallies.GetPlaneWeightedEnergy(p, t)/keV << "\n";
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// MATRICE DE RÉPONSE (un photon émis par événement)
+// ═══════════════════════════════════════════════════════════════
+
+void RunAction::RecordResponse(G4int nEvents) const
+{
+    ResponseMatrix::Row row;
+    row.energy_keV = ResponseMatrix::GetInstance()->GetEnergy() / keV;
+    row.nPhotons = nEvents;
+    row.coneFraction = GetSolidAngleFraction();
+    
+    G4double cpuTime = GetElapsedCPUTime();
+    for (G4int i = 0; i < fDoseStats.GetNbRings(); ++i) {
+        RingDoseStatistics::Summary s = fDoseStats.GetSummary(i, cpuTime);
+        row.dose_nGy.push_back(s.mean);
+        row.doseSem_nGy.push_back(s.sigmaMean);
+    }
+    
+    G4double n = static_cast<G4double>(nEvents);
+    row.prePhotons = fCounters.planeCounts[PlaneSD::GetTallyIndex(PlaneSD::kPreContainer, PlaneSD::kPhoton, PlaneSD::kForward)] / n;
+    row.postPhotonsFwd = fCounters.planeCounts[PlaneSD::GetTallyIndex(PlaneSD::kPostContainer, PlaneSD::kPhoton, PlaneSD::kForward)] / n;
+    row.enteredWater = fCounters.gammasEnteringWater / n;
+    row.absorbedWater = fCounters.absorbed / n;
+    
+    ResponseMatrix::GetInstance()->Record(row);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// FICHIERS ROOT PAR THREAD (maître, fin de run)
+// ═══════════════════════════════════════════════════════════════
+
+void RunAction::MergePerThreadFiles() const
+{
+    // Fichier du maître (histogrammes fusionnés, gamma_lines) puis un fichier
+    // d'ntuples par thread de travail (nommage Geant4 : <nom>_t<N>.root)
+    std::vector<G4String> files = {fOutputFileName};
+    const G4int nThreads = ThreadingConfig::GetInstance()->GetNumberOfThreads();
+    for (G4int t = 0; t < nThreads; ++t) {
+        G4String workerFile = fOutputPrefix + "_t" + std::to_string(t) + ".root";
+        if (std::filesystem::exists(workerFile)) files.push_back(workerFile);
+    }
+    
+    // Index : lu par puits_analyze comme une chaîne de fichiers (TChain)
+    const G4String indexFile = fOutputPrefix + "_files.txt";
+    std::ofstream index(indexFile);
+    for (const auto& file : files) index << file << "\n";
+    index.close();
+    
+    std::ostream& banner = Logger::GetInstance()->Banner();
+    banner << ">>> Index des fichiers par thread : " << indexFile
+           << " (" << files.size() << " fichiers)" << G4endl;
+    
+    if (fMergeMode == "none") return;
+    
+    // Fichier unique : hadd, bloquant en fin de run ou détaché du processus
+    const G4String mergedFile = fOutputPrefix + "_merged.root";
+    std::ostringstream command;
+    command << "hadd -f -k '" << mergedFile << "'";
+    for (const auto& file : files) command << " '" << file << "'";
+    command << " > '" << fOutputPrefix << "_merge.log' 2>&1";
+    if (fMergeMode == "background") command << " &";
+    
+    G4int status = std::system(command.str().c_str());
+    if (status != 0) {
+        G4cerr << "*** ERREUR: fusion hadd impossible (voir " << fOutputPrefix
+               << "_merge.log)" << G4endl;
+        return;
+    }
+    banner << ">>> Fusion " << (fMergeMode == "background" ? "lancee en arriere-plan" : "terminee")
+           << " : " << mergedFile << G4endl;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// FICHIERS DE RÉSULTATS (JSON + CSV)
+// ═══════════════════════════════════════════════════════════════
+
+namespace
+{
+    /// Chaîne JSON (guillemets et barres obliques inverses échappés)
+    std::string JsonString(const std::string& value)
+    {
+        std::string out = "\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+    
+    const char* JsonBool(G4bool value) { return value ? "true" : "false"; }
+    
+    /// Nom de colonne / clé : minuscules, espaces remplacés par « _ »
+    std::string KeyName(const std::string& value)
+    {
+        std::string out;
+        for (char c : value) {
+            out += (c == ' ') ? '_' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return out;
+    }
+}
+
+void RunAction::WriteResults(const G4Run* run) const
+{
+    G4int nEvents = run->GetNumberOfEvent();
+    G4double cpuTime = GetElapsedCPUTime();
+    G4double wallTime = std::chrono::duration<G4double>(
+        std::chrono::steady_clock::now() - fRunStartWall).count();
+    
+    auto runManager = G4RunManager::GetRunManager();
+    auto detector = static_cast<const DetectorConstruction*>(runManager->GetUserDetectorConstruction());
+    auto physicsList = dynamic_cast<const PhysicsList*>(
+        G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+    const EmissionCone* cone = EmissionCone::GetInstance();
+    const CorrelatedSampling* correlated = CorrelatedSampling::GetInstance();
+    const AttenuatorKernel* attenuator = AttenuatorKernel::GetInstance();
+    const G4bool kerma = KermaScoring::GetInstance()->IsEnabled();
+    
+    // ─────────────────────────────────────────────────────────────
+    // <préfixe>_rings.csv : une ligne par anneau
+    // ─────────────────────────────────────────────────────────────
+    std::ofstream rings(fOutputPrefix + "_rings.csv");
+    rings << "ring,r_inner_mm,r_outer_mm,mass_g,edep_MeV,dose_nGy_per_evt,sem_nGy,"
+             "rel_error,sem_welford_nGy,sem_batch_nGy,n_batches,fom_per_s";
+    if (kerma) rings << ",kerma_nGy_per_evt,kerma_sem_nGy";
+    rings << "\n" << std::setprecision(10);
+    for (G4int i = 0; i < fDoseStats.GetNbRings(); ++i) {
+        RingDoseStatistics::Summary s = fDoseStats.GetSummary(i, cpuTime);
+        rings << i << "," << detector->GetRingInnerRadius(i)/mm
+              << "," << detector->GetRingOuterRadius(i)/mm
+              << "," << fRingMasses[i] << "," << fCounters.ringEnergy[i]/MeV
+              << "," << s.mean << "," << s.sigmaMean << "," << s.relError
+              << "," << s.sigmaWelford << "," << s.sigmaBatch << "," << s.nBatches << "," << s.fom;
+        if (kerma) {
+            RingDoseStatistics::Summary k = fKermaStats.GetSummary(i, cpuTime);
+            rings << "," << k.mean << "," << k.sigmaMean;
+        }
+        rings << "\n";
+    }
+    
+    // ─────────────────────────────────────────────────────────────
+    // <préfixe>_lines.csv : une ligne par raie Eu-152
+    // ─────────────────────────────────────────────────────────────
+    std::ofstream lines(fOutputPrefix + "_lines.csv");
+    lines << "line,energy_keV,emitted,entered_water,absorbed_water,absorbed_water_w";
+    for (G4int p = 0; p < EventAction::kNbProcesses; ++p) {
+        lines << ",absorbed_" << KeyName(EventAction::GetProcessName(p));
+    }
+    lines << "\n" << std::setprecision(10);
+    for (G4int i = 0; i < EventAction::kNbGammaLines; ++i) {
+        lines << i << "," << EventAction::GetGammaLineEnergy(i)
+              << "," << fCounters.lineEmitted[i] << "," << fCounters.lineEnteredWater[i]
+              << "," << fCounters.lineAbsorbedWater[i] << "," << fCounters.lineAbsorbedWaterWeighted[i];
+        for (G4int p = 0; p < EventAction::kNbProcesses; ++p) {
+            lines << "," << fCounters.lineAbsorbedByProcess[i][p];
+        }
+        lines << "\n";
+    }
+    
+    // ─────────────────────────────────────────────────────────────
+    // <préfixe>_planes.csv : une ligne par comptage PlaneSD, brut (count,
+    // sumE_keV) puis pondéré par le poids des traces (_w)
+    // ─────────────────────────────────────────────────────────────
+    std::ofstream planes(fOutputPrefix + "_planes.csv");
+    planes << "tally,name,events,count,sumE_keV,count_w,sumE_w_keV\n" << std::setprecision(10);
+    for (G4int t = 0; t < PlaneSD::kNbTallies; ++t) {
+        planes << t << "," << PlaneSD::GetTallyName(t) << "," << nEvents
+               << "," << fCounters.planeCounts[t] << "," << fCounters.planeEnergy[t]/keV
+               << "," << fCounters.planeWeightedCounts[t] << "," << fCounters.planeWeightedEnergy[t]/keV << "\n";
+    }
+    
+    // ─────────────────────────────────────────────────────────────
+    // <préfixe>_results.json : métadonnées et résultats complets
+    // ─────────────────────────────────────────────────────────────
+    const ThreadingConfig* threading = ThreadingConfig::GetInstance();
+    std::ofstream json(fOutputPrefix + "_results.json");
+    json << std::setprecision(10);
+    json << "{\n";
+    json << "  \"run\": {\"id\": " << run->GetRunID()
+         << ", \"events\": " << nEvents
+         << ", \"seeds\": [" << fRunSeeds[0] << ", " << fRunSeeds[1] << "]"
+         << ", \"correlated_seed\": ";
+    if (correlated->IsEnabled()) json << correlated->GetBaseSeed(); else json << "null";
+    json << ", \"wall_s\": " << wallTime
+         << ", \"cpu_s\": " << cpuTime
+         << ", \"startup_cpu_s\": " << fStartupCPU_s
+         << ", \"startup_rss_mb\": " << fStartupMemory_MB
+         << ", \"run_manager\": " << JsonString(threading->GetRunManagerName())
+         << ", \"threads\": " << threading->GetNumberOfThreads()
+         << ", \"grain\": " << threading->GetGrainSize()
+         << ", \"pinning\": " << JsonString(threading->GetPinningName())
+         << ", \"root_file\": " << JsonString(fOutputFileName)
+         << ", \"per_thread_files\": " << JsonBool(fPerThreadOutput && threading->GetNumberOfThreads() > 1) << "},\n";
+    
+    json << "  \"geometry\": {\"container_radius_mm\": " << detector->GetContainerRadius()/mm
+         << ", \"source_to_water_mm\": " << detector->GetSourceToWaterDistance()/mm
+         << ", \"source_z_mm\": " << GetSourcePosZ()/mm
+         << ", \"ring_thickness_mm\": " << detector->GetRingThickness()/mm
+         << ", \"rings\": " << detector->GetNbWaterRings()
+         << ", \"ring_width_mm\": " << detector->GetRingWidth()/mm
+         << ", \"ring_layout\": " << JsonString(detector->GetRingLayoutName())
+         << ", \"tungsten_foil\": " << JsonBool(detector->HasTungstenFoil())
+         << ", \"attenuator_material\": " << JsonString(detector->GetAttenuatorMaterialName())
+         << ", \"attenuator_thickness_mm\": " << detector->GetAttenuatorThickness()/mm
+         << ", \"tight_world\": " << JsonBool(detector->IsTightWorld())
+         << ", \"world_half_xy_mm\": " << detector->GetWorldHalfXY()/mm
+         << ", \"world_half_z_mm\": " << detector->GetWorldHalfZ()/mm
+         << ", \"envelope_half_xy_mm\": " << detector->GetEnvelopeHalfXY()/mm
+         << ", \"envelope_half_z_mm\": " << detector->GetEnvelopeHalfZ()/mm
+         << ", \"envelope_center_z_mm\": " << detector->GetEnvelopeCenterZ()/mm << "},\n";
+    
+    json << "  \"physics\": {\"em\": " << JsonString(physicsList ? physicsList->GetEmPhysicsName() : "unknown")
+         << ", \"hadronic\": " << JsonBool(physicsList && physicsList->IsHadronicEnabled())
+         << ", \"cut_gamma_mm\": " << (physicsList ? physicsList->GetCutValue("gamma")/mm : 0.)
+         << ", \"cut_e_mm\": " << (physicsList ? physicsList->GetCutValue("e-")/mm : 0.)
+         << ", \"forced_collision\": " << JsonBool(detector->IsForceCollisionEnabled())
+         << ", \"kerma_estimator\": " << JsonBool(kerma)
+         << ", \"attenuator_fast_sim\": " << JsonString(!attenuator->IsEnabled() ? "off"
+                                                       : (attenuator->IsRecording() ? "tabulating" : "kernel"))
+         << "},\n";
+    
+    json << "  \"source\": {\"activity_4pi_Bq\": " << fActivity4pi
+         << ", \"cone_mode\": " << JsonString(cone->GetModeName())
+         << ", \"cone_half_angle_deg\": " << GetConeAngle()/deg
+         << ", \"solid_angle_fraction\": ";
+    // Balayage : f et T_irr par position (bloc "scan")
+    if (SourceScan::GetInstance()->IsEnabled()) {
+        json << "null, \"irradiation_time_s\": null";
+    } else {
+        json << GetSolidAngleFraction() << ", \"irradiation_time_s\": " << CalculateIrradiationTime(nEvents);
+    }
+    json << ", \"stratified\": " << JsonBool(fCounters.stratifiedEvents > 0)
+         << ", \"qmc\": " << JsonBool(QmcSampling::GetInstance()->IsEnabled())
+         << ", \"cascades\": " << JsonBool(CascadeLibrary::GetInstance()->IsEnabled())
+         << ", \"decays\": " << fCounters.decays << "},\n";
+    
+    json << "  \"rings\": [";
+    for (G4int i = 0; i < fDoseStats.GetNbRings(); ++i) {
+        RingDoseStatistics::Summary s = fDoseStats.GetSummary(i, cpuTime);
+        json << (i ? ",\n" : "\n") << "    {\"ring\": " << i
+             << ", \"r_inner_mm\": " << detector->GetRingInnerRadius(i)/mm
+             << ", \"r_outer_mm\": " << detector->GetRingOuterRadius(i)/mm
+             << ", \"mass_g\": " << fRingMasses[i]
+             << ", \"edep_MeV\": " << fCounters.ringEnergy[i]/MeV
+             << ", \"dose_nGy_per_evt\": " << s.mean
+             << ", \"sem_nGy\": " << s.sigmaMean
+             << ", \"rel_error\": " << s.relError
+             << ", \"n_batches\": " << s.nBatches
+             << ", \"fom_per_s\": " << s.fom;
+        if (kerma) {
+            RingDoseStatistics::Summary k = fKermaStats.GetSummary(i, cpuTime);
+            json << ", \"kerma_nGy_per_evt\": " << k.mean << ", \"kerma_sem_nGy\": " << k.sigmaMean;
+        }
+        json << "}";
+    }
+    json << "\n  ],\n";
+    
+    json << "  \"lines\": [";
+    for (G4int i = 0; i < EventAction::kNbGammaLines; ++i) {
+        json << (i ? ",\n" : "\n") << "    {\"line\": " << i
+             << ", \"energy_keV\": " << EventAction::GetGammaLineEnergy(i)
+             << ", \"emitted\": " << fCounters.lineEmitted[i]
+             << ", \"entered_water\": " << fCounters.lineEnteredWater[i]
+             << ", \"absorbed_water\": " << fCounters.lineAbsorbedWater[i]
+             << ", \"absorbed_water_w\": " << fCounters.lineAbsorbedWaterWeighted[i] << "}";
+    }
+    json << "\n  ],\n";
+    
+    json << "  \"processes\": {";
+    for (G4int p = 0; p < EventAction::kNbProcesses; ++p) {
+        G4int total = 0;
+        for (G4int i = 0; i < EventAction::kNbGammaLines; ++i) total += fCounters.lineAbsorbedByProcess[i][p];
+        json << (p ? ", " : "") << JsonString(KeyName(EventAction::GetProcessName(p))) << ": " << total;
+    }
+    json << "},\n";
+    
+    json << "  \"counters\": {\"primaries\": " << fCounters.primariesGenerated
+         << ", \"events_without_gamma\": " << fCounters.eventsWithZeroGamma
+         << ", \"gammas_entering_water1\": " << fCounters.gammasEnteringContainer
+         << ", \"gammas_entering_rings\": " << fCounters.gammasEnteringWater
+         << ", \"gammas_absorbed_water\": " << fCounters.absorbed
+         << ", \"gammas_transmitted\": " << fCounters.transmitted
+         << ", \"electrons_in_water\": " << fCounters.electronsInWater
+         << ", \"steps\": " << fCounters.steps
+         << ", \"steps_per_event\": " << (nEvents > 0 ? G4double(fCounters.steps)/nEvents : 0.)
+         << ", \"water_edep_MeV\": " << fCounters.waterEnergy/MeV << "},\n";
+    
+    if (ProfilingTimers::IsCompiled()) {
+        ProfilingTimers::GetInstance()->WriteJson(json);
+        json << ",\n";
+    }
+    
+    const SourceScan* scan = SourceScan::GetInstance();
+    if (scan->IsEnabled()) {
+        json << "  \"scan\": {\"file\": " << JsonString(fOutputPrefix + "_scan.csv") << ", \"positions\": [";
+        for (G4int p = 0; p < fScanTallies.GetNbPositions(); ++p) {
+            const SourceScan::Position& position = scan->GetPosition(p);
+            json << (p ? ",\n" : "\n") << "    {\"position\": " << p
+                 << ", \"x_mm\": " << position.x/mm
+                 << ", \"y_mm\": " << position.y/mm
+                 << ", \"distance_mm\": " << position.distance/mm
+                 << ", \"cone_half_angle_deg\": " << scan->GetHalfAngle(p)/deg
+                 << ", \"solid_angle_fraction\": " << GetScanSolidAngleFraction(p)
+                 << ", \"events\": " << fScanTallies.GetEvents(p)
+                 << ", \"dose_nGy_per_evt\": [";
+            for (G4int i = 0; i < fScanTallies.GetNbRings(); ++i) {
+                json << (i ? ", " : "") << fScanTallies.GetMeanDose(p, i);
+            }
+            json << "]}";
+        }
+        json << "\n  ]},\n";
+        WriteScanResults();
+    }
+    
+    json << "  \"planes\": {";
+    for (G4int t = 0; t < PlaneSD::kNbTallies; ++t) {
+        json << (t ? ",\n" : "\n") << "    " << JsonString(PlaneSD::GetTallyName(t))
+             << ": {\"count\": " << fCounters.planeCounts[t]
+             << ", \"sumE_keV\": " << fCounters.planeEnergy[t]/keV
+             << ", \"count_w\": " << fCounters.planeWeightedCounts[t]
+             << ", \"sumE_w_keV\": " << fCounters.planeWeightedEnergy[t]/keV << "}";
+    }
+    json << "\n  }\n";
+    json << "}\n";
+    
+    Logger::GetInstance()->Banner() << ">>> Resultats : " << fOutputPrefix
+                                    << "_results.json, _rings.csv, _lines.csv, _planes.csv"
+                                    << (scan->IsEnabled() ? ", _scan.csv, _scan_lines.csv, _scan_planes.csv" : "")
+                                    << G4endl;
+}
+
 // ═══════════════════════════════════════════════════════════════
 // CALCULS DE NORMALISATION
 // ═══════════════════════════════════════════════════════════════
@@ -0,0 +1,91 @@
+#include "RunCounters.hh"
+
+RunCounters::RunCounters(const G4String& name)
+: G4VAccumulable(name)
+{
+    Reset();
+}
+
+void RunCounters::Merge(const G4VAccumulable& other)
+{
+    const auto& o = static_cast<const RunCounters&>(other);
+    
+    primariesGenerated += o.primariesGenerated;
+    eventsWithZeroGamma += o.eventsWithZeroGamma;
+    transmitted += o.transmitted;
+    absorbed += o.absorbed;
+    events += o.events;
+    decays += o.decays;
+    waterEnergy += o.waterEnergy;
+    waterEventCount += o.waterEventCount;
+    
+    gammasEnteringContainer += o.gammasEnteringContainer;
+    gammasEnteringWater += o.gammasEnteringWater;
+    electronsInWater += o.electronsInWater;
+    steps += o.steps;
+    
+    for (G4int r = 0; r < kNbRings; ++r) {
+        ringEnergy[r] += o.ringEnergy[r];
+        for (G4int l = 0; l < kNbLines; ++l) {
+            ringEnergyByLine[r][l] += o.ringEnergyByLine[r][l];
+        }
+    }
+    
+    for (G4int l = 0; l < kNbLines; ++l) {
+        lineEmitted[l] += o.lineEmitted[l];
+        lineEnteredWater[l] += o.lineEnteredWater[l];
+        lineAbsorbedWater[l] += o.lineAbsorbedWater[l];
+        lineAbsorbedWaterWeighted[l] += o.lineAbsorbedWaterWeighted[l];
+        for (G4int p = 0; p < kNbProcesses; ++p) {
+            lineAbsorbedByProcess[l][p] += o.lineAbsorbedByProcess[l][p];
+        }
+    }
+    
+    stratifiedEvents += o.stratifiedEvents;
+    for (G4int l = 0; l < kNbLines; ++l) {
+        stratLineEvents[l] += o.stratLineEvents[l];
+        stratLineWeight[l] += o.stratLineWeight[l];
+    }
+    
+    for (G4int t = 0; t < PlaneSD::kNbTallies; ++t) {
+        planeCounts[t] += o.planeCounts[t];
+        planeEnergy[t] += o.planeEnergy[t];
+        planeWeightedCounts[t] += o.planeWeightedCounts[t];
+        planeWeightedEnergy[t] += o.planeWeightedEnergy[t];
+    }
+}
+
+void RunCounters::Reset()
+{
+    primariesGenerated = 0;
+    eventsWithZeroGamma = 0;
+    transmitted = 0;
+    absorbed = 0;
+    events = 0;
+    decays = 0;
+    waterEnergy = 0.;
+    waterEventCount = 0;
+    
+    gammasEnteringContainer = 0;
+    gammasEnteringWater = 0;
+    electronsInWater = 0;
+    steps = 0;
+    
+    ringEnergy.fill(0.);
+    for (auto& arr : ringEnergyByLine) arr.fill(0.);
+    
+    lineEmitted.fill(0);
+    lineEnteredWater.fill(0);
+    lineAbsorbedWater.fill(0);
+    lineAbsorbedWaterWeighted.fill(0.);
+    for (auto& arr : lineAbsorbedByProcess) arr.fill(0);
+    
+    stratifiedEvents = 0;
+    stratLineEvents.fill(0);
+    stratLineWeight.fill(0.);
+    
+    planeCounts.fill(0);
+    planeEnergy.fill(0.);
+    planeWeightedCounts.fill(0.);
+    planeWeightedEnergy.fill(0.);
+}
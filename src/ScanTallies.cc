@@ -0,0 +1,140 @@
+#include "ScanTallies.hh"
+
+#include <algorithm>
+#include <cmath>
+
+ScanTallies::ScanTallies(const G4String& name)
+: G4VAccumulable(name),
+  fNbPositions(0),
+  fNbRings(0)
+{}
+
+void ScanTallies::SetLayout(G4int nPositions, G4int nRings)
+{
+    if (nPositions == fNbPositions && nRings == fNbRings) return;
+    fNbPositions = nPositions;
+    fNbRings = nRings;
+
+    fEvents.resize(nPositions);
+    fDecays.resize(nPositions);
+    fDoseSum.resize(nPositions * nRings);
+    fDoseSum2.resize(nPositions * nRings);
+
+    fLineEmitted.resize(nPositions * kNbLines);
+    fLineEntered.resize(nPositions * kNbLines);
+    fLineAbsorbed.resize(nPositions * kNbLines);
+    fLineAbsorbedWeighted.resize(nPositions * kNbLines);
+
+    fPlaneCounts.resize(nPositions * kNbPlaneTallies);
+    fPlaneEnergy.resize(nPositions * kNbPlaneTallies);
+    fPlaneWeightedCounts.resize(nPositions * kNbPlaneTallies);
+    fPlaneWeightedEnergy.resize(nPositions * kNbPlaneTallies);
+    Reset();
+}
+
+// ═══════════════════════════════════════════════════════════════
+// REMPLISSAGE (EventAction, via RunAction)
+// ═══════════════════════════════════════════════════════════════
+
+void ScanTallies::FillEvent(G4int position, const G4double* dose_nGy, G4long decays)
+{
+    if (position < 0 || position >= fNbPositions) return;
+    fEvents[position]++;
+    fDecays[position] += decays;
+
+    const G4int offset = position * fNbRings;
+    for (G4int i = 0; i < fNbRings; ++i) {
+        fDoseSum[offset + i] += dose_nGy[i];
+        fDoseSum2[offset + i] += dose_nGy[i] * dose_nGy[i];
+    }
+}
+
+void ScanTallies::AddLine(G4int position, G4int line, G4bool enteredWater,
+                          G4bool absorbedInWater, G4double absorbedWeight)
+{
+    if (position < 0 || position >= fNbPositions || line < 0 || line >= kNbLines) return;
+    const G4int index = position * kNbLines + line;
+    fLineEmitted[index]++;
+    if (enteredWater) fLineEntered[index]++;
+    if (absorbedInWater) {
+        fLineAbsorbed[index]++;
+        fLineAbsorbedWeighted[index] += absorbedWeight;
+    }
+}
+
+void ScanTallies::AddPlane(G4int position, G4int tally, G4int count, G4double sumEnergy,
+                           G4double weightedCount, G4double weightedEnergy)
+{
+    if (position < 0 || position >= fNbPositions) return;
+    const G4int index = position * kNbPlaneTallies + tally;
+    fPlaneCounts[index] += count;
+    fPlaneEnergy[index] += sumEnergy;
+    fPlaneWeightedCounts[index] += weightedCount;
+    fPlaneWeightedEnergy[index] += weightedEnergy;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// FUSION DES THREADS
+// ═══════════════════════════════════════════════════════════════
+
+void ScanTallies::Merge(const G4VAccumulable& other)
+{
+    const auto& o = static_cast<const ScanTallies&>(other);
+    if (o.fNbPositions != fNbPositions || o.fNbRings != fNbRings) return;
+
+    for (G4int p = 0; p < fNbPositions; ++p) {
+        fEvents[p] += o.fEvents[p];
+        fDecays[p] += o.fDecays[p];
+    }
+    for (std::size_t i = 0; i < fDoseSum.size(); ++i) {
+        fDoseSum[i] += o.fDoseSum[i];
+        fDoseSum2[i] += o.fDoseSum2[i];
+    }
+    for (std::size_t i = 0; i < fLineEmitted.size(); ++i) {
+        fLineEmitted[i] += o.fLineEmitted[i];
+        fLineEntered[i] += o.fLineEntered[i];
+        fLineAbsorbed[i] += o.fLineAbsorbed[i];
+        fLineAbsorbedWeighted[i] += o.fLineAbsorbedWeighted[i];
+    }
+    for (std::size_t i = 0; i < fPlaneCounts.size(); ++i) {
+        fPlaneCounts[i] += o.fPlaneCounts[i];
+        fPlaneEnergy[i] += o.fPlaneEnergy[i];
+        fPlaneWeightedCounts[i] += o.fPlaneWeightedCounts[i];
+        fPlaneWeightedEnergy[i] += o.fPlaneWeightedEnergy[i];
+    }
+}
+
+void ScanTallies::Reset()
+{
+    std::fill(fEvents.begin(), fEvents.end(), 0);
+    std::fill(fDecays.begin(), fDecays.end(), 0);
+    std::fill(fDoseSum.begin(), fDoseSum.end(), 0.);
+    std::fill(fDoseSum2.begin(), fDoseSum2.end(), 0.);
+    std::fill(fLineEmitted.begin(), fLineEmitted.end(), 0);
+    std::fill(fLineEntered.begin(), fLineEntered.end(), 0);
+    std::fill(fLineAbsorbed.begin(), fLineAbsorbed.end(), 0);
+    std::fill(fLineAbsorbedWeighted.begin(), fLineAbsorbedWeighted.end(), 0.);
+    std::fill(fPlaneCounts.begin(), fPlaneCounts.end(), 0);
+    std::fill(fPlaneEnergy.begin(), fPlaneEnergy.end(), 0.);
+    std::fill(fPlaneWeightedCounts.begin(), fPlaneWeightedCounts.end(), 0.);
+    std::fill(fPlaneWeightedEnergy.begin(), fPlaneWeightedEnergy.end(), 0.);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// RÉSULTATS PAR POSITION
+// ═══════════════════════════════════════════════════════════════
+
+G4double ScanTallies::GetMeanDose(G4int position, G4int ring) const
+{
+    const G4long n = fEvents[position];
+    return (n > 0) ? fDoseSum[position * fNbRings + ring] / n : 0.;
+}
+
+G4double ScanTallies::GetSemDose(G4int position, G4int ring) const
+{
+    const G4long n = fEvents[position];
+    if (n < 2) return 0.;
+    const G4double mean = GetMeanDose(position, ring);
+    const G4double variance = (fDoseSum2[position * fNbRings + ring] - n * mean * mean) / (n - 1);
+    return std::sqrt(std::max(0., variance) / n);
+}
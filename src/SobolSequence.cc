@@ -0,0 +1,92 @@
+#include "SobolSequence.hh"
+
+#include "Randomize.hh"
+
+SobolSequence::SobolSequence()
+: fIndex(0)
+{
+    // ═══════════════════════════════════════════════════════════════
+    // NOMBRES DIRECTEURS (Joe & Kuo, new-joe-kuo-6.21201)
+    // ═══════════════════════════════════════════════════════════════
+    // Dimension 0 : van der Corput, V_k = 2^(32-k)
+    for (G4int k = 0; k < 32; ++k) {
+        fDirections[0][k] = 1u << (31 - k);
+    }
+
+    // Dimensions 1 et 2 : polynôme primitif de degré s, coefficients a, m_1..m_s
+    struct Primitive { G4int s; std::uint32_t a; std::uint32_t m[2]; };
+    const Primitive primitives[2] = {
+        {1, 0, {1, 0}},     // x + 1
+        {2, 1, {1, 3}}      // x² + x + 1
+    };
+
+    for (G4int d = 1; d < kNbDimensions; ++d) {
+        const Primitive& p = primitives[d - 1];
+        auto& v = fDirections[d];
+        for (G4int k = 0; k < p.s; ++k) {
+            v[k] = p.m[k] << (31 - k);
+        }
+        for (G4int k = p.s; k < 32; ++k) {
+            v[k] = v[k - p.s] ^ (v[k - p.s] >> p.s);
+            for (G4int j = 1; j < p.s; ++j) {
+                if ((p.a >> (p.s - 1 - j)) & 1u) v[k] ^= v[k - j];
+            }
+        }
+    }
+
+    fSeeds.fill(0);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// BROUILLAGE D'OWEN PAR HACHAGE
+// ═══════════════════════════════════════════════════════════════
+
+std::uint32_t SobolSequence::ReverseBits(std::uint32_t x)
+{
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+std::uint32_t SobolSequence::NestedUniformScramble(std::uint32_t x, std::uint32_t seed)
+{
+    // Permutation de Laine-Karras sur les bits inversés : chaque bit n'est
+    // modifié qu'en fonction des bits de poids plus fort (Burley 2020)
+    x = ReverseBits(x);
+    x ^= x * 0x3d20adeau;
+    x += seed;
+    x *= (seed >> 16) | 1u;
+    x ^= x * 0x05526c56u;
+    x ^= x * 0x53a22864u;
+    return ReverseBits(x);
+}
+
+void SobolSequence::Rescramble()
+{
+    for (auto& seed : fSeeds) {
+        seed = static_cast<std::uint32_t>(G4UniformRand() * 4294967296.);
+    }
+    fIndex = 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// POINT SUIVANT
+// ═══════════════════════════════════════════════════════════════
+
+void SobolSequence::Next(std::array<G4double, kNbDimensions>& u)
+{
+    for (G4int d = 0; d < kNbDimensions; ++d) {
+        std::uint32_t x = 0;
+        std::uint32_t i = fIndex;
+        for (G4int k = 0; i != 0; ++k, i >>= 1) {
+            if (i & 1u) x ^= fDirections[d][k];
+        }
+        x = NestedUniformScramble(x, fSeeds[d]);
+
+        // Centre de la cellule de 2^-32 : jamais exactement 0 ni 1
+        u[d] = (static_cast<G4double>(x) + 0.5) / 4294967296.;
+    }
+    fIndex++;
+}
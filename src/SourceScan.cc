@@ -0,0 +1,213 @@
+#include "SourceScan.hh"
+#include "EmissionCone.hh"
+#include "Logger.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4UIcommand.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4SystemOfUnits.hh"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+SourceScan* SourceScan::fInstance = nullptr;
+
+namespace
+{
+    // Unité optionnelle en fin de commande (mm par défaut)
+    G4double ReadUnit(std::istringstream& iss)
+    {
+        std::string unit;
+        if (!(iss >> unit)) return mm;
+        return G4UIcommand::ValueOf(unit.c_str());
+    }
+}
+
+SourceScan::SourceScan()
+: fWaterSurfaceZ(100.0*mm),          // Valeur par défaut avant Construct()
+  fMessenger(nullptr)
+{
+    DefineCommands();
+}
+
+SourceScan::~SourceScan()
+{
+    delete fMessenger;
+}
+
+SourceScan* SourceScan::GetInstance()
+{
+    // Premier appel depuis le thread maître (constructeur de DetectorConstruction)
+    if (fInstance == nullptr) {
+        fInstance = new SourceScan();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/scan/)
+// ═══════════════════════════════════════════════════════════════
+
+void SourceScan::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/scan/",
+                                        "Balayage de positions de source dans un seul run");
+
+    auto& positionCmd = fMessenger->DeclareMethod("position", &SourceScan::AddPosition,
+        "Ajoute une position : x y distance [unite] (decalage lateral, distance source-eau)");
+    positionCmd.SetParameterName("position", false);
+    positionCmd.SetStates(G4State_PreInit, G4State_Idle);
+    positionCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& gridCmd = fMessenger->DeclareMethod("grid", &SourceScan::AddGrid,
+        "Ajoute n distances regulieres sur l'axe : dMin dMax n [unite]");
+    gridCmd.SetParameterName("grid", false);
+    gridCmd.SetStates(G4State_PreInit, G4State_Idle);
+    gridCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& clearCmd = fMessenger->DeclareMethod("clear", &SourceScan::Clear,
+        "Vide la liste (source unique de la geometrie)");
+    clearCmd.SetStates(G4State_PreInit, G4State_Idle);
+    clearCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& listCmd = fMessenger->DeclareMethod("list", &SourceScan::List,
+        "Affiche les positions du balayage");
+    listCmd.SetStates(G4State_PreInit, G4State_Idle);
+    listCmd.SetToBeBroadcasted(false);   // singleton du processus
+}
+
+void SourceScan::AddPosition(const G4String& text)
+{
+    std::istringstream iss(text);
+    G4double x = 0., y = 0., distance = 0.;
+    if (!(iss >> x >> y >> distance)) {
+        G4Exception("SourceScan::AddPosition", "Scan001", JustWarning,
+                    ("Position illisible : \"" + text + "\" (attendu : x y distance [unite])").c_str());
+        return;
+    }
+    G4double unit = ReadUnit(iss);
+    if (distance <= 0.) {
+        G4Exception("SourceScan::AddPosition", "Scan001", JustWarning,
+                    "Distance source-eau nulle ou negative : position ignoree");
+        return;
+    }
+    fPositions.push_back({x * unit, y * unit, distance * unit});
+}
+
+void SourceScan::AddGrid(const G4String& text)
+{
+    std::istringstream iss(text);
+    G4double dMin = 0., dMax = 0.;
+    G4int n = 0;
+    if (!(iss >> dMin >> dMax >> n) || n < 1 || dMin <= 0. || dMax <= 0.) {
+        G4Exception("SourceScan::AddGrid", "Scan001", JustWarning,
+                    ("Grille illisible : \"" + text + "\" (attendu : dMin dMax n [unite], d > 0)").c_str());
+        return;
+    }
+    G4double unit = ReadUnit(iss);
+    for (G4int i = 0; i < n; ++i) {
+        G4double distance = (n == 1) ? dMin : dMin + (dMax - dMin) * i / (n - 1);
+        fPositions.push_back({0., 0., distance * unit});
+    }
+}
+
+void SourceScan::Clear()
+{
+    fPositions.clear();
+    fSourcePositions.clear();
+    fHalfAngles.clear();
+}
+
+void SourceScan::List()
+{
+    Print(G4cout);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// GÉOMÉTRIE DU BALAYAGE
+// ═══════════════════════════════════════════════════════════════
+
+G4double SourceScan::GetMinSourceZ() const
+{
+    G4double zMin = fWaterSurfaceZ;
+    for (const Position& p : fPositions) {
+        zMin = std::min(zMin, fWaterSurfaceZ - p.distance);
+    }
+    return zMin;
+}
+
+G4double SourceScan::GetMaxLateralOffset() const
+{
+    G4double rMax = 0.;
+    for (const Position& p : fPositions) {
+        rMax = std::max({rMax, std::abs(p.x), std::abs(p.y)});
+    }
+    return rMax;
+}
+
+void SourceScan::PrepareForRun()
+{
+    fSourcePositions.clear();
+    fHalfAngles.clear();
+    if (!IsEnabled()) return;
+
+    const EmissionCone* cone = EmissionCone::GetInstance();
+    const G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+        ->GetNavigatorForTracking()->GetWorldVolume();
+
+    for (std::size_t i = 0; i < fPositions.size(); ++i) {
+        const Position& p = fPositions[i];
+        G4ThreeVector source(p.x, p.y, fWaterSurfaceZ - p.distance);
+
+        // Source dans l'air, devant l'empilement et dans le monde construit
+        if (source.z() >= cone->GetStackFrontZ()) {
+            std::ostringstream msg;
+            msg << "Position " << i << " : source a z = " << source.z()/mm
+                << " mm, dans ou derriere l'empilement (face avant a z = "
+                << cone->GetStackFrontZ()/mm << " mm)";
+            G4Exception("SourceScan::PrepareForRun", "Scan002", FatalException, msg.str().c_str());
+        }
+        if (world && world->GetLogicalVolume()->GetSolid()->Inside(source) == kOutside) {
+            std::ostringstream msg;
+            msg << "Position " << i << " : source (" << source.x()/mm << ", " << source.y()/mm
+                << ", " << source.z()/mm << ") mm hors du monde"
+                << " (/puits/scan/ avant /run/initialize avec tightWorld)";
+            G4Exception("SourceScan::PrepareForRun", "Scan002", FatalException, msg.str().c_str());
+        }
+
+        fSourcePositions.push_back(source);
+        fHalfAngles.push_back(cone->GetHalfAngle(source));
+    }
+
+    std::ostream& banner = Logger::GetInstance()->Banner();
+    Print(banner);
+}
+
+G4double SourceScan::GetSolidAngleFraction(G4int index) const
+{
+    return (1.0 - std::cos(fHalfAngles[index])) / 2.0;
+}
+
+void SourceScan::Print(std::ostream& os) const
+{
+    os << "\n>>> Balayage de source : " << fPositions.size() << " position(s), "
+       << "surface de l'eau a z = " << fWaterSurfaceZ/mm << " mm\n";
+    const G4bool prepared = (fHalfAngles.size() == fPositions.size());
+    for (std::size_t i = 0; i < fPositions.size(); ++i) {
+        const Position& p = fPositions[i];
+        os << "    " << std::setw(3) << i
+           << " : x = " << std::setw(7) << p.x/mm << " mm, y = " << std::setw(7) << p.y/mm
+           << " mm, d = " << std::setw(7) << p.distance/mm << " mm";
+        if (prepared) {
+            os << ", theta = " << std::setw(7) << fHalfAngles[i]/deg << " deg, f = "
+               << GetSolidAngleFraction(static_cast<G4int>(i));
+        }
+        os << "\n";
+    }
+    os << std::flush;
+}
@@ -2,18 +2,33 @@
 #include "EventAction.hh"
 #include "RunAction.hh"
 #include "DetectorConstruction.hh"
+#include "KermaScoring.hh"
+#include "AttenuatorKernel.hh"
 #include "Logger.hh"
+#include "AllocationCounter.hh"
+#include "ProfilingTimers.hh"
 
 #include "G4Step.hh"
 #include "G4Track.hh"
 #include "G4StepPoint.hh"
 #include "G4VPhysicalVolume.hh"
+#include "G4NavigationHistory.hh"
+#include "G4VTouchable.hh"
+#include "G4LogicalVolume.hh"
 #include "G4VProcess.hh"
+#include "G4Material.hh"
+#include "G4BiasingProcessInterface.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4RunManager.hh"
+#include "G4Gamma.hh"
+#include "G4Electron.hh"
 #include <cmath>
 #include <sstream>
 
+// Noms de repli rendus par référence (aucun G4String construit par pas)
+static const G4String kOutOfWorld = "OutOfWorld";
+static const G4String kUnknownProcess = "Unknown";
+
 SteppingAction::SteppingAction(EventAction* eventAction, RunAction* runAction)
 : G4UserSteppingAction(),
   fEventAction(eventAction),
@@ -21,26 +36,74 @@ SteppingAction::SteppingAction(EventAction* eventAction, RunAction* runAction)
   fVerbose(true),           // ACTIVÉ pour vérification
   fVerboseMaxEvents(10)     // Afficher les 10 premiers événements
 {
-    // Initialiser les noms des volumes d'eau pour identification rapide
-    for (G4int i = 0; i < DetectorConstruction::kNbWaterRings; ++i) {
-        fWaterRingNames.insert(DetectorConstruction::GetWaterRingName(i) + "Log");
-    }
+    fAttenuatorEntries.reserve(8);
     
-    G4cout << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
-    G4cout << "║  SteppingAction: Mode VERBOSE activé pour " << fVerboseMaxEvents << " événements     ║" << G4endl;
-    G4cout << "║  Suivi par raie gamma Eu-152 ACTIVÉ                            ║" << G4endl;
-    G4cout << "║  Comptage aux plans PreContainer et PostContainer ACTIVÉ       ║" << G4endl;
-    G4cout << "║  *** CONFIGURATION SANS FILTRE ***                             ║" << G4endl;
-    G4cout << "║  *** REMPLISSAGE HISTOGRAMMES ROOT ACTIVÉ ***                  ║" << G4endl;
-    G4cout << "║  Diagnostics -> output.log                                     ║" << G4endl;
-    G4cout << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
+    std::ostream& banner = Logger::GetInstance()->Banner();
+    banner << "\n╔═══════════════════════════════════════════════════════════════╗" << G4endl;
+    banner << "║  SteppingAction: Mode VERBOSE activé pour " << fVerboseMaxEvents << " événements     ║" << G4endl;
+    banner << "║  Suivi par raie gamma Eu-152 ACTIVÉ                            ║" << G4endl;
+    banner << "║  Plans PreContainer et PostContainer : détecteurs PlaneSD      ║" << G4endl;
+    banner << "║  *** CONFIGURATION SANS FILTRE ***                             ║" << G4endl;
+    banner << "║  *** REMPLISSAGE HISTOGRAMMES ROOT ACTIVÉ ***                  ║" << G4endl;
+    banner << "║  Diagnostics -> output.log                                     ║" << G4endl;
+    banner << "╚═══════════════════════════════════════════════════════════════╝\n" << G4endl;
 }
 
 SteppingAction::~SteppingAction()
 {}
 
+void SteppingAction::BuildRingLookup()
+{
+    auto detector = static_cast<const DetectorConstruction*>(
+        G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    
+    for (const G4LogicalVolume* logicRing : detector->GetWaterRingLogicals()) {
+        const std::size_t id = logicRing->GetInstanceID();
+        if (id >= fIsRingLogical.size()) fIsRingLogical.resize(id + 1, false);
+        fIsRingLogical[id] = true;
+    }
+}
+
+G4int SteppingAction::GetRingIndex(const G4StepPoint* point) const
+{
+    const G4VTouchable* touchable = point->GetTouchable();
+    const G4VPhysicalVolume* volume = touchable->GetVolume();
+    if (!volume) return -1;
+    
+    const std::size_t id = volume->GetLogicalVolume()->GetInstanceID();
+    if (id >= fIsRingLogical.size() || !fIsRingLogical[id]) return -1;
+    
+    // Numéro de copie = index de l'anneau (copie, replica ou paramétrisation)
+    return touchable->GetCopyNumber();
+}
+
+SteppingAction::AttenuatorEntry* SteppingAction::FindAttenuatorEntry(G4int trackID)
+{
+    for (auto& entry : fAttenuatorEntries) {
+        if (entry.first == trackID) return &entry.second;
+    }
+    return nullptr;
+}
+
+void SteppingAction::EraseAttenuatorEntry(G4int trackID)
+{
+    for (auto& entry : fAttenuatorEntries) {
+        if (entry.first == trackID) {
+            entry = fAttenuatorEntries.back();
+            fAttenuatorEntries.pop_back();
+            return;
+        }
+    }
+}
+
 void SteppingAction::UserSteppingAction(const G4Step* step)
 {
+    PUITS_ALLOCATION_SCOPE(kStep);
+    PUITS_PROFILE_SCOPE(kStepping);
+    
+    // Nombre de pas par événement (comparaison monde ajusté / monde fixe)
+    fRunAction->AddStep();
+    
     // ═══════════════════════════════════════════════════════════════
     // RÉCUPÉRATION DES INFORMATIONS DE BASE
     // ═══════════════════════════════════════════════════════════════
@@ -53,48 +116,47 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
         return;
     }
 
-    G4String preVolumeName = preStepPoint->GetPhysicalVolume()->GetName();
-    
-    G4String postVolumeName = "OutOfWorld";
-    if (postStepPoint->GetPhysicalVolume()) {
-        postVolumeName = postStepPoint->GetPhysicalVolume()->GetName();
-    }
-
     // Informations sur la trace
     G4Track* track = step->GetTrack();
     G4int trackID = track->GetTrackID();
     G4int parentID = track->GetParentID();
-    G4String particleName = track->GetDefinition()->GetParticleName();
+    const G4ParticleDefinition* particle = track->GetDefinition();
+    const G4String& particleName = particle->GetParticleName();
+    const G4bool isGamma = (particle == G4Gamma::Definition());
+    const G4bool isElectron = (particle == G4Electron::Definition());
     G4double kineticEnergy = preStepPoint->GetKineticEnergy();
+    
+    // Poids statistique (1 en transport analogue, < 1 avec la collision forcée)
+    G4double weight = track->GetWeight();
 
     // ID de l'événement pour le debug
     G4int eventID = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
 
-    // Direction du momentum
-    G4ThreeVector momentum = step->GetTrack()->GetMomentumDirection();
-    G4double pz = momentum.z();
-
     // Position
     G4ThreeVector pos = preStepPoint->GetPosition();
     G4double radius = std::sqrt(pos.x()*pos.x() + pos.y()*pos.y());
 
     // Noms des volumes logiques
-    G4String logicalVolumeName = preStepPoint->GetTouchableHandle()
-                                             ->GetVolume()
-                                             ->GetLogicalVolume()
-                                             ->GetName();
+    const G4String& logicalVolumeName = preStepPoint->GetTouchableHandle()
+                                                    ->GetVolume()
+                                                    ->GetLogicalVolume()
+                                                    ->GetName();
     
-    G4String postLogVolName = "OutOfWorld";
-    if (postStepPoint->GetPhysicalVolume()) {
-        postLogVolName = postStepPoint->GetPhysicalVolume()->GetLogicalVolume()->GetName();
-    }
+    const G4VPhysicalVolume* postVolume = postStepPoint->GetPhysicalVolume();
+    const G4String& postLogVolName = postVolume ? postVolume->GetLogicalVolume()->GetName()
+                                                : kOutOfWorld;
+    
+    // Anneaux d'eau du début et de la fin du pas (-1 : hors des anneaux)
+    if (fIsRingLogical.empty()) BuildRingLookup();
+    G4int ringIndex = GetRingIndex(preStepPoint);
+    G4int postRingIndex = postVolume ? GetRingIndex(postStepPoint) : -1;
 
     // ═══════════════════════════════════════════════════════════════
     // ENREGISTREMENT DU SPECTRE DES GAMMAS PRIMAIRES ÉMIS
     // (Premier step de chaque gamma primaire)
     // ═══════════════════════════════════════════════════════════════
     
-    if (parentID == 0 && particleName == "gamma" && track->GetCurrentStepNumber() == 1) {
+    if (parentID == 0 && isGamma && track->GetCurrentStepNumber() == 1) {
         // C'est le premier step d'un gamma primaire - enregistrer son énergie initiale
         G4double initialEnergy = track->GetVertexKineticEnergy();
         fRunAction->FillGammaEmittedSpectrum(initialEnergy / keV);
@@ -108,25 +170,38 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
         G4double phi = std::atan2(momDir.y(), momDir.x());
         fEventAction->RegisterPrimaryGamma(trackID, initialEnergy, theta, phi);
     }
+    
+    // ═══════════════════════════════════════════════════════════════
+    // CLONE D'UN GAMMA PRIMAIRE (COLLISION FORCÉE)
+    // Créé par l'opération non physique de G4BOptrForceCollision : c'est le
+    // même photon, il hérite de la raie et de l'identité du primaire
+    // ═══════════════════════════════════════════════════════════════
+    
+    if (parentID > 0 && isGamma && track->GetCurrentStepNumber() == 1
+        && fEventAction->IsPrimaryTrack(parentID)) {
+        auto creator = dynamic_cast<const G4BiasingProcessInterface*>(track->GetCreatorProcess());
+        if (creator && creator->GetWrappedProcess() == nullptr) {
+            fEventAction->RegisterPrimaryClone(trackID, parentID);
+        }
+    }
+    
+    G4bool isPrimaryGamma = (isGamma && fEventAction->IsPrimaryTrack(trackID));
 
     // ═══════════════════════════════════════════════════════════════
     // DÉTECTION DE L'ABSORPTION DES GAMMAS PRIMAIRES
     // ═══════════════════════════════════════════════════════════════
     
-    // Si un gamma primaire est tué (absorbé), enregistrer où et par quel processus
-    if (parentID == 0 && particleName == "gamma") {
+    // Si un gamma primaire (ou son clone) est tué (absorbé), enregistrer où et par quel processus
+    if (isPrimaryGamma) {
         G4TrackStatus status = track->GetTrackStatus();
         if (status == fStopAndKill || status == fKillTrackAndSecondaries) {
             // Récupérer le processus qui a causé l'absorption
-            G4String processName = "Unknown";
             const G4VProcess* process = postStepPoint->GetProcessDefinedStep();
-            if (process) {
-                processName = process->GetProcessName();
-            }
+            const G4String& processName = process ? process->GetProcessName() : kUnknownProcess;
             
             // CORRECTION : utiliser postLogVolName car l'absorption se produit
             // à la fin du step (dans le volume POST), pas au début (volume PRE)
-            fEventAction->RecordGammaAbsorbed(trackID, postLogVolName, processName);
+            fEventAction->RecordGammaAbsorbed(trackID, postLogVolName, processName, weight);
             
             if (fVerbose && eventID < fVerboseMaxEvents) {
                 std::stringstream ss;
@@ -134,87 +209,139 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
                    << " | trackID=" << trackID
                    << " | in " << postLogVolName
                    << " | E=" << kineticEnergy/keV << " keV"
-                   << " | process=" << processName;
+                   << " | process=" << processName
+                   << " | w=" << weight;
                 Logger::GetInstance()->LogLine(ss.str());
             }
         }
     }
 
+    // ═══════════════════════════════════════════════════════════════
+    // TABULATION DU NOYAU DE LA PLAQUE ATTÉNUATRICE
+    // Run en transport complet : état du gamma incident à sa sortie de la
+    // plaque (ou absorption), par rapport à son entrée par une face
+    // ═══════════════════════════════════════════════════════════════
+    
+    AttenuatorKernel* attenuator = AttenuatorKernel::GetInstance();
+    if (attenuator->IsRecording() && isGamma) {
+        if (postLogVolName == "AttenuatorLog" && logicalVolumeName != "AttenuatorLog") {
+            // Mêmes entrées que celles qui déclenchent le modèle rapide
+            G4ThreeVector entryPosition = postStepPoint->GetPosition();
+            G4ThreeVector entryDirection = postStepPoint->GetMomentumDirection();
+            G4ThreeVector localPosition = postStepPoint->GetTouchableHandle()->GetHistory()
+                                                       ->GetTopTransform().TransformPoint(entryPosition);
+            if (attenuator->IsFaceEntry(localPosition, entryDirection)) {
+                AttenuatorEntry in = {postStepPoint->GetKineticEnergy(), entryPosition, entryDirection};
+                if (AttenuatorEntry* entry = FindAttenuatorEntry(trackID)) {
+                    *entry = in;
+                } else {
+                    fAttenuatorEntries.emplace_back(trackID, in);
+                }
+            } else {
+                EraseAttenuatorEntry(trackID);
+            }
+        } else if (logicalVolumeName == "AttenuatorLog") {
+            if (const AttenuatorEntry* entry = FindAttenuatorEntry(trackID)) {
+                const AttenuatorEntry in = *entry;
+                if (postLogVolName != "AttenuatorLog") {
+                    // Sortie par une face ou par le bord
+                    attenuator->Record(in.energy, in.direction,
+                                       postStepPoint->GetPosition() - in.position,
+                                       postStepPoint->GetMomentumDirection(),
+                                       postStepPoint->GetKineticEnergy());
+                    EraseAttenuatorEntry(trackID);
+                } else if (track->GetTrackStatus() != fAlive) {
+                    // Absorbé dans la plaque
+                    attenuator->Record(in.energy, in.direction, G4ThreeVector(), G4ThreeVector(), 0.);
+                    EraseAttenuatorEntry(trackID);
+                }
+            }
+        }
+    }
+
     // ═══════════════════════════════════════════════════════════════
     // DÉTECTION DANS LES ANNEAUX D'EAU AVEC SUIVI PAR RAIE
     // ═══════════════════════════════════════════════════════════════
 
     // Vérifier si on est dans un anneau d'eau
-    if (fWaterRingNames.find(logicalVolumeName) != fWaterRingNames.end()) {
+    if (ringIndex >= 0) {
+        const KermaScoring* kerma = KermaScoring::GetInstance();
         G4double edep = step->GetTotalEnergyDeposit();
+        
+        // ═══════════════════════════════════════════════════════════════
+        // KERMA PAR LONGUEUR DE TRACE : tout pas de photon contribue,
+        // qu'il interagisse ou non (énergie du photon en début de pas)
+        // ═══════════════════════════════════════════════════════════════
+        if (kerma->IsEnabled() && isGamma) {
+            G4double density = preStepPoint->GetMaterial()->GetDensity();
+            fEventAction->AddRingKerma(ringIndex, weight * kineticEnergy * step->GetStepLength()
+                                                  * kerma->GetMuEnOverRho(kineticEnergy) * density);
+        }
+        
+        // Transport des électrons coupé (mode kerma) : énergie restante déposée sur place
+        if (kerma->IsEnabled() && !kerma->IsElectronTransportEnabled() && isElectron
+            && track->GetTrackStatus() == fAlive) {
+            edep += postStepPoint->GetKineticEnergy();
+            track->SetTrackStatus(fStopAndKill);
+        }
+        
         if (edep > 0.) {
-            // Extraire l'index de l'anneau depuis le nom du volume
-            G4int ringIndex = -1;
+            // Dépôt pondéré par le poids statistique de la trace
+            G4double weightedEdep = edep * weight;
+            fEventAction->AddRingEnergy(ringIndex, weightedEdep);
             
-            // Chercher quel anneau
-            for (G4int i = 0; i < DetectorConstruction::kNbWaterRings; ++i) {
-                G4String ringLogName = DetectorConstruction::GetWaterRingName(i) + "Log";
-                if (logicalVolumeName == ringLogName) {
-                    ringIndex = i;
-                    break;
-                }
+            // ═══════════════════════════════════════════════════════════════
+            // REMPLISSAGE DES HISTOGRAMMES ROOT
+            // ═══════════════════════════════════════════════════════════════
+            fRunAction->FillEdepWater(edep / keV, weight);
+            fRunAction->FillEdepRing(ringIndex, edep / keV, weight);
+            fRunAction->FillEdepXY(pos.x() / mm, pos.y() / mm, weightedEdep / keV);
+            fRunAction->FillEdepRZ(radius / mm, pos.z() / mm, weightedEdep / keV);
+            
+            // Spectre des électrons secondaires
+            if (isElectron && parentID != 0) {
+                fRunAction->FillElectronSpectrum(kineticEnergy / keV, weight);
             }
             
-            if (ringIndex >= 0) {
-                fEventAction->AddRingEnergy(ringIndex, edep);
-                
-                // ═══════════════════════════════════════════════════════════════
-                // REMPLISSAGE DES HISTOGRAMMES ROOT
-                // ═══════════════════════════════════════════════════════════════
-                fRunAction->FillEdepWater(edep / keV);
-                fRunAction->FillEdepRing(ringIndex, edep / keV);
-                fRunAction->FillEdepXY(pos.x() / mm, pos.y() / mm, edep / keV);
-                fRunAction->FillEdepRZ(radius / mm, pos.z() / mm, edep / keV);
-                
-                // Spectre des électrons secondaires
-                if (particleName == "e-" && parentID != 0) {
-                    fRunAction->FillElectronSpectrum(kineticEnergy / keV);
-                }
-                
-                // Remplir le ntuple de steps (optionnel, peut être désactivé pour performance)
-                const G4VProcess* proc = postStepPoint->GetProcessDefinedStep();
-                G4String procName = proc ? proc->GetProcessName() : "Unknown";
-                fRunAction->FillStepNtuple(eventID, pos.x()/mm, pos.y()/mm, pos.z()/mm,
-                                           edep/keV, ringIndex, particleName, procName);
-                
-                // Suivi par raie gamma : identifier la raie du gamma parent
-                // Pour les électrons secondaires, trouver le gamma primaire ancêtre
-                G4int gammaLineIndex = -1;
-                
-                if (parentID == 0 && particleName == "gamma") {
-                    // C'est un gamma primaire
-                    gammaLineIndex = fEventAction->GetGammaLineForTrack(trackID);
-                } else {
-                    // Particule secondaire - essayer de trouver le gamma primaire parent
-                    if (fEventAction->IsPrimaryTrack(parentID)) {
-                        gammaLineIndex = fEventAction->GetGammaLineForTrack(parentID);
-                    }
+            // Remplir le ntuple de steps (optionnel, peut être désactivé pour performance)
+            const G4VProcess* proc = postStepPoint->GetProcessDefinedStep();
+            const G4String& procName = proc ? proc->GetProcessName() : kUnknownProcess;
+            fRunAction->FillStepNtuple(eventID, pos.x()/mm, pos.y()/mm, pos.z()/mm,
+                                       edep/keV, ringIndex, particleName, procName, weight);
+            
+            // Suivi par raie gamma : identifier la raie du gamma parent
+            // Pour les électrons secondaires, trouver le gamma primaire ancêtre
+            G4int gammaLineIndex = -1;
+            
+            if (isPrimaryGamma) {
+                // C'est un gamma primaire (ou son clone)
+                gammaLineIndex = fEventAction->GetGammaLineForTrack(trackID);
+            } else {
+                // Particule secondaire - essayer de trouver le gamma primaire parent
+                if (fEventAction->IsPrimaryTrack(parentID)) {
+                    gammaLineIndex = fEventAction->GetGammaLineForTrack(parentID);
                 }
-                
-                // Enregistrer le dépôt par raie si identifié
+            }
+            
+            // Enregistrer le dépôt par raie si identifié
+            if (gammaLineIndex >= 0) {
+                fEventAction->AddRingEnergyByLine(ringIndex, gammaLineIndex, weightedEdep);
+            }
+            
+            if (fVerbose && eventID < fVerboseMaxEvents) {
+                std::stringstream ss;
+                ss << "WATER_DEPOSIT | Event " << eventID
+                   << " | Ring " << ringIndex
+                   << " | " << particleName
+                   << " | E_kin=" << kineticEnergy/keV << " keV"
+                   << " | edep=" << edep/keV << " keV"
+                   << " | w=" << weight
+                   << " | r=" << radius/mm << " mm"
+                   << " | z=" << pos.z()/mm << " mm";
                 if (gammaLineIndex >= 0) {
-                    fEventAction->AddRingEnergyByLine(ringIndex, gammaLineIndex, edep);
-                }
-                
-                if (fVerbose && eventID < fVerboseMaxEvents) {
-                    std::stringstream ss;
-                    ss << "WATER_DEPOSIT | Event " << eventID
-                       << " | Ring " << ringIndex
-                       << " | " << particleName
-                       << " | E_kin=" << kineticEnergy/keV << " keV"
-                       << " | edep=" << edep/keV << " keV"
-                       << " | r=" << radius/mm << " mm"
-                       << " | z=" << pos.z()/mm << " mm";
-                    if (gammaLineIndex >= 0) {
-                        ss << " | Line=" << EventAction::GetGammaLineName(gammaLineIndex);
-                    }
-                    Logger::GetInstance()->LogLine(ss.str());
+                    ss << " | Line=" << EventAction::GetGammaLineName(gammaLineIndex);
                 }
+                Logger::GetInstance()->LogLine(ss.str());
             }
         }
     }
@@ -226,7 +353,7 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
     // Entrée dans le container = entrée dans Water1 (premier volume d'eau, z=100-102mm)
     // C'est le premier volume d'eau rencontré par les gammas venant de la source
     if (postLogVolName == "Water1Log" && logicalVolumeName != "Water1Log") {
-        if (parentID == 0 && particleName == "gamma") {
+        if (parentID == 0 && isGamma) {
             // Vérifier si ce gamma n'a pas déjà été compté
             if (!fEventAction->HasEnteredContainer(trackID)) {
                 fRunAction->IncrementContainerEntry();
@@ -251,11 +378,10 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
     // - Pas de double-comptage grâce à HasEnteredWater()
     // ═══════════════════════════════════════════════════════════════
     
-    if (fWaterRingNames.find(postLogVolName) != fWaterRingNames.end() 
-        && fWaterRingNames.find(logicalVolumeName) == fWaterRingNames.end()) {
+    if (postRingIndex >= 0 && ringIndex < 0) {
         
         // Ne compter que les gammas PRIMAIRES
-        if (particleName == "gamma" && parentID == 0) {
+        if (isGamma && parentID == 0) {
             // Vérifier si ce gamma n'a pas déjà été compté (via EventAction)
             if (!fEventAction->HasEnteredWater(trackID)) {
                 fRunAction->IncrementWaterEntry();
@@ -286,122 +412,8 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
         }
         
         // Compter les électrons entrant dans l'eau (tous, pas seulement primaires)
-        if (particleName == "e-") {
+        if (isElectron) {
             fRunAction->IncrementElectronsInWater();
         }
     }
-    
-    // ═══════════════════════════════════════════════════════════════
-    // PLAN PRE-CONTAINER (dans eau, entrée)
-    // Comptage des photons et électrons vers l'eau (+z)
-    // ═══════════════════════════════════════════════════════════════
-    
-    if (postLogVolName == "PreContainerPlaneLog" && logicalVolumeName != "PreContainerPlaneLog") {
-        // Photons vers l'eau (+z)
-        if (particleName == "gamma" && pz > 0) {
-            fRunAction->IncrementPreContainerPlane();
-            fEventAction->AddPreContainerPhoton(kineticEnergy);
-            
-            if (fVerbose && eventID < fVerboseMaxEvents) {
-                G4ThreeVector posPost = postStepPoint->GetPosition();
-                std::stringstream ss;
-                ss << "PRE_CONTAINER_PLANE | Event " << eventID
-                   << " | PHOTON +z"
-                   << " | trackID=" << trackID
-                   << " | E=" << kineticEnergy/keV << " keV"
-                   << " | z=" << posPost.z()/mm << " mm";
-                Logger::GetInstance()->LogLine(ss.str());
-            }
-        }
-        // Électrons vers l'eau (+z)
-        if (particleName == "e-" && pz > 0) {
-            fEventAction->AddPreContainerElectron(kineticEnergy);
-            
-            if (fVerbose && eventID < fVerboseMaxEvents) {
-                G4ThreeVector posPost = postStepPoint->GetPosition();
-                std::stringstream ss;
-                ss << "PRE_CONTAINER_PLANE | Event " << eventID
-                   << " | ELECTRON +z"
-                   << " | trackID=" << trackID
-                   << " | E=" << kineticEnergy/keV << " keV"
-                   << " | z=" << posPost.z()/mm << " mm";
-                Logger::GetInstance()->LogLine(ss.str());
-            }
-        }
-    }
-    
-    // ═══════════════════════════════════════════════════════════════
-    // PLAN POST-CONTAINER (après eau, matériau eau)
-    // Comptage des particules dans les deux sens
-    // ═══════════════════════════════════════════════════════════════
-    
-    if (postLogVolName == "PostContainerPlaneLog" && logicalVolumeName != "PostContainerPlaneLog") {
-        
-        // --- PHOTONS ---
-        if (particleName == "gamma") {
-            if (pz > 0) {
-                // Photons TRANSMIS vers la sortie (+z)
-                fRunAction->IncrementPostContainerPlane();
-                fEventAction->AddPostContainerPhotonFwd(kineticEnergy);
-                
-                if (fVerbose && eventID < fVerboseMaxEvents) {
-                    G4ThreeVector posPost = postStepPoint->GetPosition();
-                    std::stringstream ss;
-                    ss << "POST_CONTAINER_PLANE | Event " << eventID
-                       << " | PHOTON +z (transmis)"
-                       << " | trackID=" << trackID
-                       << " | E=" << kineticEnergy/keV << " keV"
-                       << " | z=" << posPost.z()/mm << " mm";
-                    Logger::GetInstance()->LogLine(ss.str());
-                }
-            } else {
-                // Photons RÉTRODIFFUSÉS depuis la sortie (-z)
-                fEventAction->AddPostContainerPhotonBack(kineticEnergy);
-                
-                if (fVerbose && eventID < fVerboseMaxEvents) {
-                    G4ThreeVector posPost = postStepPoint->GetPosition();
-                    std::stringstream ss;
-                    ss << "POST_CONTAINER_PLANE | Event " << eventID
-                       << " | PHOTON -z (backscatter)"
-                       << " | trackID=" << trackID
-                       << " | E=" << kineticEnergy/keV << " keV"
-                       << " | z=" << posPost.z()/mm << " mm";
-                    Logger::GetInstance()->LogLine(ss.str());
-                }
-            }
-        }
-        
-        // --- ÉLECTRONS ---
-        if (particleName == "e-") {
-            if (pz > 0) {
-                // Électrons vers la sortie (+z)
-                fEventAction->AddPostContainerElectronFwd(kineticEnergy);
-                
-                if (fVerbose && eventID < fVerboseMaxEvents) {
-                    G4ThreeVector posPost = postStepPoint->GetPosition();
-                    std::stringstream ss;
-                    ss << "POST_CONTAINER_PLANE | Event " << eventID
-                       << " | ELECTRON +z"
-                       << " | trackID=" << trackID
-                       << " | E=" << kineticEnergy/keV << " keV"
-                       << " | z=" << posPost.z()/mm << " mm";
-                    Logger::GetInstance()->LogLine(ss.str());
-                }
-            } else {
-                // Électrons depuis la sortie (-z)
-                fEventAction->AddPostContainerElectronBack(kineticEnergy);
-                
-                if (fVerbose && eventID < fVerboseMaxEvents) {
-                    G4ThreeVector posPost = postStepPoint->GetPosition();
-                    std::stringstream ss;
-                    ss << "POST_CONTAINER_PLANE | Event " << eventID
-                       << " | ELECTRON -z (backscatter)"
-                       << " | trackID=" << trackID
-                       << " | E=" << kineticEnergy/keV << " keV"
-                       << " | z=" << posPost.z()/mm << " mm";
-                    Logger::GetInstance()->LogLine(ss.str());
-                }
-            }
-        }
-    }
 }
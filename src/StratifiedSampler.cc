@@ -0,0 +1,169 @@
+#include "StratifiedSampler.hh"
+#include "Eu152Data.hh"
+
+#include "G4GenericMessenger.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+G4bool StratifiedSampler::fEnabled = false;
+G4int StratifiedSampler::fBatchSize = 10000;
+G4double StratifiedSampler::fDefensiveFraction = 0.1;
+G4GenericMessenger* StratifiedSampler::fMessenger = nullptr;
+
+StratifiedSampler::StratifiedSampler(const std::vector<G4double>& probabilities)
+: fProbabilities(probabilities),
+  fEventsInBatch(0),
+  fNbUpdates(0)
+{
+    const size_t nLines = fProbabilities.size();
+    fCount.assign(nLines, 0);
+    fSumScore.assign(nLines, 0.);
+    fSumTime.assign(nLines, 0.);
+
+    // Allocation initiale proportionnelle aux intensités (mélange analogue)
+    G4double total = 0.;
+    for (const auto& p : fProbabilities) total += p;
+    fAllocation.resize(nLines);
+    fCumulative.resize(nLines);
+    for (size_t k = 0; k < nLines; ++k) {
+        fAllocation[k] = (total > 0.) ? fProbabilities[k] / total : 1. / nLines;
+    }
+    G4double cumul = 0.;
+    for (size_t k = 0; k < nLines; ++k) {
+        cumul += fAllocation[k];
+        fCumulative[k] = cumul;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/strat/)
+// ═══════════════════════════════════════════════════════════════
+
+void StratifiedSampler::DefineCommands()
+{
+    // Premier appel depuis le thread maître (constructeur de RunAction)
+    if (fMessenger != nullptr) return;
+
+    fMessenger = new G4GenericMessenger(nullptr, "/puits/strat/",
+                                        "Allocation stratifiee des histoires par raie");
+
+    auto& enableCmd = fMessenger->DeclareProperty("enable", fEnabled,
+        "Un photon par evenement, raie tiree selon l'allocation optimisee (poids p/q)");
+    enableCmd.SetParameterName("enable", true);
+    enableCmd.SetDefaultValue("true");
+    enableCmd.SetStates(G4State_PreInit, G4State_Idle);
+    enableCmd.SetToBeBroadcasted(false);   // réglage du processus
+
+    auto& batchCmd = fMessenger->DeclareProperty("batchSize", fBatchSize,
+        "Evenements par lot pilote entre deux mises a jour de l'allocation");
+    batchCmd.SetParameterName("nEvents", false);
+    batchCmd.SetRange("nEvents>0");
+    batchCmd.SetStates(G4State_PreInit, G4State_Idle);
+    batchCmd.SetToBeBroadcasted(false);
+
+    auto& defensiveCmd = fMessenger->DeclareProperty("defensiveFraction", fDefensiveFraction,
+        "Fraction des histoires repartie uniformement entre les raies (borne les poids)");
+    defensiveCmd.SetParameterName("epsilon", false);
+    defensiveCmd.SetRange("epsilon>0. && epsilon<=1.");
+    defensiveCmd.SetStates(G4State_PreInit, G4State_Idle);
+    defensiveCmd.SetToBeBroadcasted(false);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// TIRAGE DE LA RAIE
+// ═══════════════════════════════════════════════════════════════
+
+G4int StratifiedSampler::SampleLine(G4double& weight) const
+{
+    return SampleLine(G4UniformRand(), weight);
+}
+
+G4int StratifiedSampler::SampleLine(G4double u, G4double& weight) const
+{
+    auto it = std::upper_bound(fCumulative.begin(), fCumulative.end(), u);
+    G4int line = static_cast<G4int>(it - fCumulative.begin());
+    if (line >= static_cast<G4int>(fCumulative.size())) line = fCumulative.size() - 1;
+
+    weight = fProbabilities[line] / fAllocation[line];
+    return line;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// LOTS PILOTES ET ALLOCATION DE NEYMAN
+// ═══════════════════════════════════════════════════════════════
+
+void StratifiedSampler::RecordEvent(G4int line, G4double sumDoseSquared, G4double cpuTime_s)
+{
+    if (line < 0 || line >= static_cast<G4int>(fCount.size())) return;
+
+    fCount[line]++;
+    fSumScore[line] += sumDoseSquared;
+    fSumTime[line] += cpuTime_s;
+
+    if (++fEventsInBatch >= fBatchSize) {
+        fEventsInBatch = 0;
+        UpdateAllocation();
+    }
+}
+
+void StratifiedSampler::UpdateAllocation()
+{
+    const size_t nLines = fProbabilities.size();
+
+    // Temps moyen de référence pour les raies sans mesure
+    G4long nTotal = 0;
+    G4double timeTotal = 0.;
+    for (size_t k = 0; k < nLines; ++k) {
+        nTotal += fCount[k];
+        timeTotal += fSumTime[k];
+    }
+    if (nTotal == 0) return;
+    G4double meanTime = (timeTotal > 0.) ? timeTotal / nTotal : 1.;
+
+    std::vector<G4double> neyman(nLines, 0.);
+    G4double sum = 0.;
+    for (size_t k = 0; k < nLines; ++k) {
+        if (fCount[k] == 0) continue;
+        G4double secondMoment = fSumScore[k] / fCount[k];
+        G4double cost = (fSumTime[k] > 0.) ? fSumTime[k] / fCount[k] : meanTime;
+        neyman[k] = fProbabilities[k] * std::sqrt(secondMoment / cost);
+        sum += neyman[k];
+    }
+    // Aucune raie n'a encore déposé : garder l'allocation courante
+    if (sum <= 0.) return;
+
+    G4double cumul = 0.;
+    for (size_t k = 0; k < nLines; ++k) {
+        fAllocation[k] = (1. - fDefensiveFraction) * neyman[k] / sum
+                       + fDefensiveFraction / nLines;
+        cumul += fAllocation[k];
+        fCumulative[k] = cumul;
+    }
+    fNbUpdates++;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// AFFICHAGE
+// ═══════════════════════════════════════════════════════════════
+
+void StratifiedSampler::Print(std::ostream& os) const
+{
+    os << "\n╔═══════════════════════════════════════════════════════════════════════════════════════╗\n";
+    os << "║                    ALLOCATION STRATIFIÉE PAR RAIE (" << std::setw(4) << fNbUpdates
+       << " mises à jour)                    ║\n";
+    os << "╠════════╦════════════╦════════════╦════════════╦══════════════╦═══════════════════════╣\n";
+    os << "║  Raie  ║ Energie    ║  p (désint)║  q (alloc) ║  Poids p/q   ║   Photons simulés     ║\n";
+    os << "╠════════╬════════════╬════════════╬════════════╬══════════════╬═══════════════════════╣\n";
+    for (size_t k = 0; k < fProbabilities.size(); ++k) {
+        os << "║   " << std::setw(2) << k << "   ║"
+           << std::setw(8) << std::fixed << std::setprecision(1) << Eu152::kLineEnergies_keV[k] << " keV║"
+           << std::setw(11) << std::setprecision(4) << fProbabilities[k] << " ║"
+           << std::setw(11) << fAllocation[k] << " ║"
+           << std::setw(13) << std::setprecision(3) << fProbabilities[k] / fAllocation[k] << " ║"
+           << std::setw(22) << fCount[k] << " ║\n";
+    }
+    os << "╚════════╩════════════╩════════════╩════════════╩══════════════╩═══════════════════════╝\n";
+}
@@ -0,0 +1,213 @@
+#include "ThreadingConfig.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4RunManager.hh"
+#include "G4MTRunManager.hh"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+ThreadingConfig* ThreadingConfig::fInstance = nullptr;
+
+namespace {
+
+// Liste de CPU au format du noyau Linux : "0-15,32-47"
+std::vector<G4int> ParseCpuList(const std::string& text)
+{
+    std::vector<G4int> cpus;
+    std::istringstream iss(text);
+    std::string range;
+    while (std::getline(iss, range, ',')) {
+        if (range.empty()) continue;
+        std::size_t dash = range.find('-');
+        try {
+            G4int first = std::stoi(range.substr(0, dash));
+            G4int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+            for (G4int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            // Entrée illisible : ignorée
+        }
+    }
+    return cpus;
+}
+
+}
+
+ThreadingConfig::ThreadingConfig()
+: fRunManagerName("serial"),
+  fNbThreads(1),
+  fGrainSize(0),
+  fPinning(kNone),
+  fMessenger(nullptr)
+{
+    DefineCommands();
+}
+
+ThreadingConfig::~ThreadingConfig()
+{
+    delete fMessenger;
+}
+
+ThreadingConfig* ThreadingConfig::GetInstance()
+{
+    // Premier appel depuis main, avant la création du gestionnaire de run
+    if (fInstance == nullptr) {
+        fInstance = new ThreadingConfig();
+    }
+    return fInstance;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// COMMANDES UTILISATEUR (/puits/mt/)
+// ═══════════════════════════════════════════════════════════════
+
+void ThreadingConfig::DefineCommands()
+{
+    fMessenger = new G4GenericMessenger(this, "/puits/mt/",
+                                        "Granularite des taches et placement des threads");
+
+    auto& grainCmd = fMessenger->DeclareMethod("grain", &ThreadingConfig::SetGrainSize,
+        "Evenements par tache (tasking) ou par lot distribue (mt), 0 = defaut Geant4");
+    grainCmd.SetParameterName("nEvents", false);
+    grainCmd.SetRange("nEvents>=0");
+    grainCmd.SetStates(G4State_PreInit, G4State_Idle);
+    grainCmd.SetToBeBroadcasted(false);   // singleton du processus
+
+    auto& pinCmd = fMessenger->DeclareMethod("pinning", &ThreadingConfig::SetPinningByName,
+        "Placement des threads de travail : none, compact ou scatter (noeuds NUMA)");
+    pinCmd.SetParameterName("policy", false);
+    pinCmd.SetCandidates("none compact scatter");
+    pinCmd.SetStates(G4State_PreInit);    // appliqué au démarrage des threads
+    pinCmd.SetToBeBroadcasted(false);
+}
+
+void ThreadingConfig::SetRunManager(const G4String& type, G4int nThreads)
+{
+    fRunManagerName = type;
+    fNbThreads = (type == "serial") ? 1 : std::max(nThreads, 1);
+}
+
+void ThreadingConfig::SetGrainSize(G4int nEvents)
+{
+    fGrainSize = nEvents;
+
+    // G4TaskRunManager dérive de G4MTRunManager : dans les deux cas, la
+    // taille des lots vient de eventModulo (plafonnée par Geant4 à
+    // N / grainsize événements, grainsize = nombre de threads par défaut)
+    auto mtManager = dynamic_cast<G4MTRunManager*>(G4RunManager::GetRunManager());
+    if (mtManager && nEvents > 0) {
+        mtManager->SetEventModulo(nEvents);
+    }
+}
+
+void ThreadingConfig::SetPinningByName(const G4String& name)
+{
+    if (name == "compact") {
+        fPinning = kCompact;
+    } else if (name == "scatter") {
+        fPinning = kScatter;
+    } else {
+        fPinning = kNone;
+    }
+}
+
+G4String ThreadingConfig::GetPinningName() const
+{
+    switch (fPinning) {
+        case kCompact: return "compact";
+        case kScatter: return "scatter";
+        default:       return "none";
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+// PLACEMENT DES THREADS
+// ═══════════════════════════════════════════════════════════════
+
+std::vector<std::vector<G4int>> ThreadingConfig::GetNodeCpus() const
+{
+    std::vector<std::vector<G4int>> nodes;
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return nodes;
+
+    // Un nœud par /sys/devices/system/node/nodeN (ordre numérique)
+    std::vector<std::pair<G4int, std::vector<G4int>>> numaNodes;
+    std::error_code error;
+    const std::filesystem::path nodeRoot("/sys/devices/system/node");
+    for (const auto& entry : std::filesystem::directory_iterator(nodeRoot, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() <= 4) continue;
+        if (!std::all_of(name.begin() + 4, name.end(), ::isdigit)) continue;
+
+        std::ifstream file(entry.path() / "cpulist");
+        std::string text;
+        std::getline(file, text);
+        numaNodes.emplace_back(std::stoi(name.substr(4)), ParseCpuList(text));
+    }
+    std::sort(numaNodes.begin(), numaNodes.end());
+
+    // Nœuds restreints aux CPU autorisés (taskset, cgroups)
+    for (const auto& node : numaNodes) {
+        std::vector<G4int> cpus;
+        for (G4int cpu : node.second) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) nodes.push_back(cpus);
+    }
+
+    // Pas d'information NUMA : un seul nœud avec tous les CPU autorisés
+    if (nodes.empty()) {
+        std::vector<G4int> cpus;
+        for (G4int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) nodes.push_back(cpus);
+    }
+#endif
+
+    return nodes;
+}
+
+void ThreadingConfig::PinCurrentThread(G4int threadId) const
+{
+    if (fPinning == kNone || threadId < 0) return;
+
+#ifdef __linux__
+    const auto nodes = GetNodeCpus();
+    if (nodes.empty()) return;
+
+    G4int cpu = -1;
+    if (fPinning == kCompact) {
+        // Nœuds à la suite : thread i sur le i-ème CPU autorisé
+        std::vector<G4int> all;
+        for (const auto& node : nodes) all.insert(all.end(), node.begin(), node.end());
+        cpu = all[threadId % all.size()];
+    } else {
+        // Nœud i mod n, puis CPU suivant de ce nœud
+        const auto& node = nodes[threadId % nodes.size()];
+        cpu = node[(threadId / nodes.size()) % node.size()];
+    }
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) != 0) {
+        G4cerr << "ThreadingConfig : placement du thread " << threadId
+               << " sur le CPU " << cpu << " impossible" << G4endl;
+        return;
+    }
+    G4cout << "ThreadingConfig : thread " << threadId << " -> CPU " << cpu
+           << " (" << GetPinningName() << ")" << G4endl;
+#else
+    G4cerr << "ThreadingConfig : placement des threads disponible sous Linux uniquement" << G4endl;
+#endif
+}
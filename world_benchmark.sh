@@ -0,0 +1,77 @@
+#!/bin/sh
+# ═══════════════════════════════════════════════════════════════════════════
+# MONDE AJUSTÉ : PAS PAR ÉVÉNEMENT, TEMPS CPU ET DOSES (monde fixe / ajusté)
+# ═══════════════════════════════════════════════════════════════════════════
+#
+# Usage :
+#   ./world_benchmark.sh [exécutable] [événements] [marge mm] [threads]
+#   ./world_benchmark.sh ./puits_couronne 500000 10 1
+#
+# Deux processus exécutent bench_world.mac : monde de 50 cm (référence) puis
+# monde ajusté à l'empilement et à la source (+ marge). Le gain est donné en
+# pas par événement et en temps CPU (section "run" et "counters" du JSON).
+# Les doses par anneau (<nom>_rings.csv) sont comparées par
+#   z = |D_ajusté - D_fixe| / sqrt(sem_ajusté² + sem_fixe²)
+# avec des graines différentes : z > 3 signale un écart hors statistique
+# (diffusion dans l'air retiré). Code de sortie 2 dans ce cas.
+# ═══════════════════════════════════════════════════════════════════════════
+
+EXE=${1:-./puits_couronne}
+EVENTS=${2:-500000}
+MARGIN=${3:-10}
+THREADS=${4:-1}
+
+mkdir -p bench
+export PUITS_BENCH_EVENTS=$EVENTS
+export PUITS_BENCH_MARGIN=$MARGIN
+
+# Valeur numérique d'une clé du fichier de résultats
+json_value() {
+    sed -n "s/.*\"$2\": \([0-9.eE+-]*\).*/\1/p" "$1" | head -n 1
+}
+
+SEED=1001
+for config in fixed tight; do
+    NAME=bench/world_$config
+    export PUITS_BENCH_NAME=$NAME
+    export PUITS_BENCH_SEED1=$SEED
+    export PUITS_BENCH_SEED2=$((SEED + 1))
+    if [ "$config" = tight ]; then export PUITS_BENCH_TIGHT=true; else export PUITS_BENCH_TIGHT=false; fi
+    "$EXE" --quiet --threads "$THREADS" bench_world.mac \
+        > $NAME.out 2>&1 || { echo "echec : monde $config (voir $NAME.out)"; exit 1; }
+    SEED=$((SEED + 1000))
+done
+
+echo "world,events,steps_per_event,cpu_s,us_cpu_per_event" > bench/world.csv
+printf "\n%8s %12s %14s %10s %14s\n" monde events pas/evt cpu_s us_cpu/evt
+for config in fixed tight; do
+    RESULTS=bench/world_$config"_results.json"
+    NEVT=$(json_value "$RESULTS" events)
+    STEPS=$(json_value "$RESULTS" steps_per_event)
+    CPU=$(json_value "$RESULTS" cpu_s)
+    LINE=$(awk -v c="$config" -v n="$NEVT" -v s="$STEPS" -v t="$CPU" 'BEGIN {
+        printf "%s,%d,%.2f,%.3f,%.3f", c, n, s, t, (n > 0) ? 1e6 * t / n : 0
+    }')
+    echo "$LINE" >> bench/world.csv
+    echo "$LINE" | awk -F, '{ printf "%8s %12d %14.2f %10.2f %14.3f\n", $1, $2, $3, $4, $5 }'
+done
+
+awk -F, '$1 == "fixed" { s = $3; t = $5 }
+         $1 == "tight" && s > 0 && t > 0 {
+             printf "\nReduction : %.1f %% de pas, %.1f %% de CPU par evenement\n",
+                    100 * (1 - $3 / s), 100 * (1 - $5 / t) }' bench/world.csv
+
+# Doses par anneau : colonnes dose_nGy_per_evt (6) et sem_nGy (7)
+printf "\n%6s %16s %16s %8s\n" anneau fixe_nGy ajuste_nGy z
+awk -F, 'FNR == 1 { next }
+         NR == FNR { d[$1] = $6; s[$1] = $7; next }
+         {
+             sigma = sqrt(s[$1]^2 + $7^2)
+             z = (sigma > 0) ? ($6 - d[$1]) / sigma : 0
+             if (z < 0) z = -z
+             printf "%6d %16.6e %16.6e %8.2f%s\n", $1, d[$1], $6, z, (z > 3) ? "  <<<" : ""
+             if (z > 3) bad++
+         }
+         END { if (bad) { printf "\n%d anneau(x) hors statistique (z > 3)\n", bad; exit 2 }
+               print "\nDoses compatibles (z <= 3 pour tous les anneaux)" }' \
+    bench/world_fixed_rings.csv bench/world_tight_rings.csv